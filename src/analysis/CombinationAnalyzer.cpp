@@ -11,10 +11,9 @@
 #include <sstream>
 #include <cmath>
 #include <unordered_map>
-#include <random>
+#include <unordered_set>
 #include <thread>
 #include <atomic>
-#include <queue>
 #include <functional>
 
 namespace BoxStrategy {
@@ -37,6 +36,45 @@ CombinationAnalyzer::CombinationAnalyzer(
     m_logger(logger) {
     
     m_logger->info("Initializing CombinationAnalyzer");
+    
+    m_universeListenerId = m_marketDataManager->addUniverseListener(
+        [this](const InstrumentUniverseDelta& delta) { invalidateCaches(delta); });
+}
+
+CombinationAnalyzer::~CombinationAnalyzer() {
+    m_marketDataManager->removeUniverseListener(m_universeListenerId);
+}
+
+void CombinationAnalyzer::invalidateCaches(const InstrumentUniverseDelta& delta) {
+    std::lock_guard<std::mutex> lock(m_cacheMutex);
+    
+    if (delta.rebuilt) {
+        m_strikesCache.clear();
+        m_optionsCache.clear();
+        return;
+    }
+    
+    // Both cache keys start with underlying:exchange:expiry:
+    size_t dropped = 0;
+    for (const auto& chain : delta.affectedChains) {
+        std::string prefix = chain.underlying + ":" + chain.exchange.str() + ":" + chain.expiry.toString() + ":";
+        
+        auto dropMatching = [&](auto& cache) {
+            for (auto it = cache.begin(); it != cache.end();) {
+                if (it->first.compare(0, prefix.size(), prefix) == 0) {
+                    it = cache.erase(it);
+                    dropped++;
+                } else {
+                    ++it;
+                }
+            }
+        };
+        dropMatching(m_strikesCache);
+        dropMatching(m_optionsCache);
+    }
+    
+    m_logger->debug("Universe version {} touched {} chains, dropped {} cached entries", 
+                  delta.toVersion, delta.affectedChains.size(), dropped);
 }
 
 std::vector<BoxSpreadModel> CombinationAnalyzer::findProfitableSpreads(
@@ -56,22 +94,19 @@ std::vector<BoxSpreadModel> CombinationAnalyzer::findProfitableSpreads(
     // Check if we should process expiries in parallel or sequentially
     bool processInParallel = m_configManager->getBoolValue("expiry/process_in_parallel", false);
     
-    if (processInParallel) {
-        // Process expiries in parallel
-        std::vector<std::future<std::vector<BoxSpreadModel>>> futures;
-        for (const auto& expiry : expiries) {
-            futures.push_back(m_threadPool->enqueue(
-                [this, underlying, exchange, expiry]() {
-                    return this->findProfitableSpreadsForExpiry(underlying, exchange, expiry);
-                }
-            ));
-        }
+    if (processInParallel && m_scanThreadPool) {
+        // One expiry per chunk on the scan threads, which may block on quotes; the analysis pool
+        // only runs the CPU-bound loops. The calling thread claims expiries too rather than
+        // waiting on queued tasks, so this completes even when every scan thread is busy
+        auto spreadsByExpiry = m_scanThreadPool->parallelTransform(0, expiries.size(),
+            [this, &underlying, &exchange, &expiries](size_t i) {
+                return findProfitableSpreadsForExpiry(underlying, exchange, expiries[i]);
+            }, 1);
         
-        // Collect results
-        for (auto& future : futures) {
-            auto spreads = future.get();
-            m_logger->info("Found {} profitable spreads for an expiry", spreads.size());
-            result.insert(result.end(), spreads.begin(), spreads.end());
+        for (size_t i = 0; i < spreadsByExpiry.size(); ++i) {
+            m_logger->info("Found {} profitable spreads for expiry {}", 
+                         spreadsByExpiry[i].size(), InstrumentModel::formatDate(expiries[i]));
+            result.insert(result.end(), spreadsByExpiry[i].begin(), spreadsByExpiry[i].end());
         }
     } else {
         // Process expiries sequentially
@@ -81,12 +116,6 @@ std::vector<BoxSpreadModel> CombinationAnalyzer::findProfitableSpreads(
             m_logger->info("Found {} profitable spreads for expiry {}", 
                          spreads.size(), InstrumentModel::formatDate(expiry));
             result.insert(result.end(), spreads.begin(), spreads.end());
-            
-            // Add a delay between expiries to avoid rate limiting
-            int delayMs = m_configManager->getIntValue("option_chain/pipeline/delay_between_expiries_ms", 1000);
-            if (delayMs > 0) {
-                std::this_thread::sleep_for(std::chrono::milliseconds(delayMs));
-            }
         }
     }
     
@@ -143,351 +172,220 @@ std::vector<BoxSpreadModel> CombinationAnalyzer::findProfitableSpreadsForExpiry(
     std::vector<std::pair<double, double>> combinations = generateStrikeCombinationsParallel(underlying, exchange, expiry, strikes);
     m_logger->info("Generated {} strike combinations", combinations.size());
     
-    // Configure batch processing 
-    size_t batchSize = m_configManager->getIntValue("option_chain/pipeline/batch_size", 50);
-    int delayBetweenBatchesMs = m_configManager->getIntValue("option_chain/pipeline/delay_between_batches_ms", 2000);
-    
-    // Optimize thread pool size based on workload
-    size_t maxThreads = std::min<size_t>(
-        m_threadPool->getNumThreads() * 2,  // Use double the current threads as maximum
-        combinations.size()                 // But no more than number of combinations
-    );
-    // Resize thread pool to match workload
-    m_threadPool->resize(maxThreads);
-    
-    // Process in smaller batches to avoid rate limits
-    std::vector<BoxSpreadModel> allSpreads;
-    
     // Step 1: Pre-load all required options for all combinations
     // This has two benefits:
-    // 1. We cache the option data to reduce redundant getAllInstruments calls
+    // 1. Each strike's call/put pair is resolved once from the option chain index
     // 2. We can make fewer, larger batched quote requests instead of many small ones
     
     m_logger->info("Pre-loading options for all combinations");
     
-    std::unordered_map<double, std::pair<InstrumentModel, InstrumentModel>> optionsByStrike;
-    std::vector<uint64_t> allRequiredOptionTokens;
+    // Quotes land in the store of this universe; legs are addressed by their ordinals in it
+    auto quoteStore = m_marketDataManager->getQuoteStore();
+    const auto& universe = quoteStore->getUniverse();
     
-    // Get all instruments once
-    auto instrumentsFuture = m_marketDataManager->getAllInstruments();
-    auto allInstruments = instrumentsFuture.get();
+    // Strike -> index of its call/put pair in legOrdinals (call at 2*i, put at 2*i+1)
+    std::unordered_map<double, size_t> optionsByStrike;
+    std::vector<uint32_t> legOrdinals;
+    std::vector<uint64_t> allRequiredOptionTokens;
+    std::vector<uint64_t> legTokens;
     
-    // First pass: Find all required options by strike
+    // First pass: Look up the call/put pair of each strike in the option chain index
     {
-        // Use a separate thread pool to find options by strike
-        size_t numThreads = std::min(m_threadPool->getNumThreads(), strikes.size());
-        std::vector<std::future<std::pair<double, std::pair<InstrumentModel, InstrumentModel>>>> optionFutures;
-        std::mutex tokensMutex;
+        const OptionChain* chain = universe->findOptionChain(underlying, exchange, ExpiryDay::fromTimePoint(expiry));
         
-        // Process strikes in parallel to find corresponding options
-        for (const auto& strike : strikes) {
-            optionFutures.push_back(m_threadPool->enqueue(
-                [this, &allInstruments, &tokensMutex, &allRequiredOptionTokens, strike, underlying, exchange, expiry]() {
-                    // Find call option for this strike
-                    InstrumentModel callOption;
-                    InstrumentModel putOption;
-                    
-                    for (const auto& instrument : allInstruments) {
-                        if (instrument.type == InstrumentType::OPTION && 
-                            instrument.underlying == underlying &&
-                            instrument.exchange == exchange &&
-                            instrument.expiry == expiry &&
-                            std::abs(instrument.strikePrice - strike) < 0.01) {
-                            
-                            if (instrument.optionType == OptionType::CALL && callOption.instrumentToken == 0) {
-                                callOption = instrument;
-                            } else if (instrument.optionType == OptionType::PUT && putOption.instrumentToken == 0) {
-                                putOption = instrument;
-                            }
-                            
-                            // If we found both, break early
-                            if (callOption.instrumentToken != 0 && putOption.instrumentToken != 0) {
-                                break;
-                            }
-                        }
-                    }
-                    
-                    // Add tokens to the list of required quotes (thread-safe)
-                    if (callOption.instrumentToken != 0 && putOption.instrumentToken != 0) {
-                        std::lock_guard<std::mutex> lock(tokensMutex);
-                        allRequiredOptionTokens.push_back(callOption.instrumentToken);
-                        allRequiredOptionTokens.push_back(putOption.instrumentToken);
-                    }
-                    
-                    return std::make_pair(strike, std::make_pair(callOption, putOption));
-                }
-            ));
+        // Lookups run in parallel only for chains long enough to be worth splitting
+        std::vector<const OptionChainEntry*> entries;
+        if (chain) {
+            entries = m_threadPool->parallelTransform(0, strikes.size(), [&](size_t i) {
+                return findChainStrike(*chain, strikes[i]);
+            }, 256);
         }
         
-        // Collect results from futures
-        for (auto& future : optionFutures) {
-            auto result = future.get();
-            if (result.second.first.instrumentToken != 0 && result.second.second.instrumentToken != 0) {
-                optionsByStrike[result.first] = result.second;
+        for (size_t i = 0; i < entries.size(); ++i) {
+            const double strike = strikes[i];
+            const OptionChainEntry* entry = entries[i];
+            
+            if (entry && entry->call && entry->put) {
+                optionsByStrike[strike] = legOrdinals.size() / 2;
+                legOrdinals.push_back(universe->ordinalOf(entry->call));
+                legOrdinals.push_back(universe->ordinalOf(entry->put));
+                allRequiredOptionTokens.push_back(entry->call->instrumentToken);
+                allRequiredOptionTokens.push_back(entry->put->instrumentToken);
             }
         }
+        
+        legTokens = allRequiredOptionTokens;
     }
     
     m_logger->info("Found options for {} strikes, requiring {} quotes", 
                  optionsByStrike.size(), allRequiredOptionTokens.size());
     
-    // Step 2: Fetch all required quotes in batches of up to 500 instruments per API call
-    std::unordered_map<uint64_t, InstrumentModel> quotesCache;
-    const size_t maxQuoteBatchSize = m_configManager->getIntValue("api/quote_batch_size", 500); // Zerodha API limit
+    // With a live tick feed the legs are streamed into the quote store; only legs that
+    // have not ticked within ticker/max_quote_age_ms still need a REST quote
+    auto tickFeed = m_marketDataManager->getTickFeed();
+    if (tickFeed && tickFeed->isConnected()) {
+        tickFeed->subscribe(allRequiredOptionTokens, TickMode::FULL);
+        
+        const auto maxQuoteAge = std::chrono::milliseconds(
+            std::max(0, m_configManager->getIntValue("ticker/max_quote_age_ms", 2000)));
+        
+        std::vector<uint64_t> unstreamedTokens;
+        for (size_t i = 0; i < allRequiredOptionTokens.size(); ++i) {
+            if (!tickFeed->isSubscribed(allRequiredOptionTokens[i], TickMode::FULL) ||
+                !quoteStore->hasFreshQuote(legOrdinals[i], maxQuoteAge)) {
+                unstreamedTokens.push_back(allRequiredOptionTokens[i]);
+            }
+        }
+        
+        m_logger->info("Tick feed covers {}/{} legs", 
+                     allRequiredOptionTokens.size() - unstreamedTokens.size(), allRequiredOptionTokens.size());
+        allRequiredOptionTokens.swap(unstreamedTokens);
+    }
     
-    // Implement parallel quote fetching for multiple batches
-    {
-        std::vector<std::future<std::unordered_map<uint64_t, InstrumentModel>>> quoteFutures;
-        std::mutex quotesCacheMutex;
+    // The spot rides along in this scan's LTP sweep and quote batches, so the strike filter
+    // of the next expiry finds a fresh spot price in the store instead of requesting one
+    uint64_t spotToken = m_marketDataManager->resolveSpotToken(underlying, "NSE");
+    
+    // Two-phase acquisition: price the chain from last traded prices first (an LTP entry is a
+    // fraction of a full quote and a batch holds more of them), then fetch full depth only for
+    // legs of strike pairs that could still be profitable
+    bool twoPhase = m_configManager->getBoolValue("option_chain/two_phase/enabled", true);
+    if (twoPhase && !allRequiredOptionTokens.empty()) {
+        // Streamed legs are priced from the store, the rest from the LTP sweep
+        std::vector<double> sweepPrices;
+        std::vector<double> sweepBids;
+        std::vector<double> sweepAsks;
+        quoteStore->gatherPrices(legOrdinals, sweepPrices, sweepBids, sweepAsks);
         
-        for (size_t i = 0; i < allRequiredOptionTokens.size(); i += maxQuoteBatchSize) {
-            size_t batchEnd = std::min(i + maxQuoteBatchSize, allRequiredOptionTokens.size());
-            std::vector<uint64_t> batchTokens(allRequiredOptionTokens.begin() + i, 
-                                          allRequiredOptionTokens.begin() + batchEnd);
-            
-            m_logger->info("Preparing to fetch quotes for batch of {} options", batchTokens.size());
-            
-            // Enqueue the quote fetching task
-            quoteFutures.push_back(m_threadPool->enqueue(
-                [this, batchTokens, delayBetweenBatchesMs]() {
-                    // Add a small random delay to spread out API calls
-                    std::random_device rd;
-                    std::mt19937 gen(rd());
-                    std::uniform_int_distribution<> distr(0, 200); // 0-200ms random delay
-                    std::this_thread::sleep_for(std::chrono::milliseconds(distr(gen)));
-                    
-                    m_logger->info("Fetching quotes for batch of {} options", batchTokens.size());
-                    auto quotesFuture = m_marketDataManager->getQuotes(batchTokens);
-                    auto quotes = quotesFuture.get();
-                    
-                    return quotes;
-                }
-            ));
-            
-            // Add a small delay between submitting batches to avoid rate limiting
-            if (batchEnd < allRequiredOptionTokens.size()) {
-                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        std::vector<uint64_t> sweepTokens = allRequiredOptionTokens;
+        if (spotToken != 0) {
+            sweepTokens.push_back(spotToken);
+        }
+        
+        auto lastPrices = m_marketDataManager->getLTPs(sweepTokens, underlying, quoteStore).get();
+        for (size_t i = 0; i < legTokens.size(); ++i) {
+            auto it = lastPrices.find(legTokens[i]);
+            if (it != lastPrices.end()) {
+                sweepPrices[i] = it->second;
+            }
+        }
+        
+        // A failed sweep (timeout, rate limit, bad response) leaves legs unpriced, which would
+        // drop every combination on them; below the coverage floor fetch full depth instead
+        size_t pricedTokens = 0;
+        for (uint64_t token : allRequiredOptionTokens) {
+            auto it = lastPrices.find(token);
+            if (it != lastPrices.end() && it->second > 0.0) {
+                pricedTokens++;
             }
         }
         
-        // Collect results from quote futures
-        for (auto& future : quoteFutures) {
-            auto batchQuotes = future.get();
+        double minCoverage = m_configManager->getDoubleValue("option_chain/two_phase/min_sweep_coverage", 0.5);
+        if (pricedTokens < minCoverage * allRequiredOptionTokens.size()) {
+            m_logger->warn("LTP sweep priced only {} of {} legs; fetching full depth for all {} combinations",
+                         pricedTokens, allRequiredOptionTokens.size(), combinations.size());
+        } else {
+            size_t sweptCombinations = combinations.size();
+            std::vector<bool> candidateLegs = filterCombinationsByLastPrice(combinations, optionsByStrike, sweepPrices);
+            
+            std::unordered_set<uint64_t> candidateTokens;
+            for (size_t i = 0; i < legTokens.size(); ++i) {
+                if (candidateLegs[i]) {
+                    candidateTokens.insert(legTokens[i]);
+                }
+            }
             
-            // Merge with the main quotes cache
-            std::lock_guard<std::mutex> lock(quotesCacheMutex);
-            quotesCache.insert(batchQuotes.begin(), batchQuotes.end());
+            size_t sweptTokens = allRequiredOptionTokens.size();
+            allRequiredOptionTokens.erase(
+                std::remove_if(allRequiredOptionTokens.begin(), allRequiredOptionTokens.end(),
+                               [&](uint64_t token) { return candidateTokens.count(token) == 0; }),
+                allRequiredOptionTokens.end());
+            
+            m_logger->info("LTP sweep: {} of {} combinations pass the price bound; fetching depth for {} of {} legs",
+                         combinations.size(), sweptCombinations, allRequiredOptionTokens.size(), sweptTokens);
         }
     }
     
-    m_logger->info("Successfully fetched quotes for {}/{} options", 
-                 quotesCache.size(), allRequiredOptionTokens.size());
+    if (spotToken != 0 && !allRequiredOptionTokens.empty()) {
+        allRequiredOptionTokens.push_back(spotToken);
+    }
     
-    // Step 3: Now process combinations using highly parallel processing
-    // Dynamically adjust based on system capabilities
+    // Step 2: Fetch all required quotes. The coalescer splits them into /quote batches of up to
+    // api/quote_batch_size and the scheduler paces those, so one request covers the whole chain
+    m_logger->info("Fetching quotes for {} options", allRequiredOptionTokens.size());
     
-    // Get the optimal concurrency level based on system resources
-    size_t optimalThreads = m_threadPool->getNumThreads();
-    size_t maxConcurrentJobs = optimalThreads * 4; // Allow more jobs than threads for I/O-bound work
+    // Only the count is needed here; the quotes themselves are read back from the quote store
+    size_t quotedCount = m_marketDataManager->getQuotes(allRequiredOptionTokens, underlying, quoteStore).get().size();
     
-    // We'll use this to track the progress of all the parallel tasks
-    std::atomic<size_t> completedCombinations(0);
-    size_t totalCombinations = combinations.size();
+    m_logger->info("Successfully fetched quotes for {}/{} options", 
+                 quotedCount, allRequiredOptionTokens.size());
     
-    // We'll use this to track the progress of all the parallel tasks
-    std::atomic<size_t> processedItems(0);
+    // Copy the last price of every leg out of the store in one pass so combinations
+    // with an unquoted leg can be rejected without touching the full quotes
+    std::vector<double> legLastPrices;
+    std::vector<double> legBestBids;
+    std::vector<double> legBestAsks;
+    quoteStore->gatherPrices(legOrdinals, legLastPrices, legBestBids, legBestAsks);
+    
+    // Step 3: Analyze the combinations in parallel on the pool. Each chunk collects
+    // its spreads in its own buffer, merged in combination order once all are done
+    size_t totalCombinations = combinations.size();
     auto startTime = std::chrono::high_resolution_clock::now();
     
-    // Variables for progress tracking
-    std::function<void()> stopProgressMonitoring = [](){}; // Default no-op
-    std::atomic<bool> progressTimerRunning(true);
-    
-    // For results collection
-    std::vector<BoxSpreadModel> validSpreads;
-    std::mutex spreadsMutex;
-    
-    // Process combinations in parallel with adaptive batch sizes
-    m_logger->info("Processing {} combinations with up to {} concurrent jobs", 
-                 totalCombinations, maxThreads);
-    
-    // If we have the thread pool optimizer, use it for progress monitoring
-    if (m_threadPoolOptimizer) {
-        stopProgressMonitoring = m_threadPoolOptimizer->monitorProgress(
-            totalCombinations, 
-            processedItems, 
-            5.0, 
-            "Processing combinations"
-        );
-    } else {
-        // Original progress reporting code
-        auto lastProgressTime = startTime;
-        
-        // Start a progress reporting thread
-        std::thread progressThread([&]() {
-            while (progressTimerRunning.load()) {
-                std::this_thread::sleep_for(std::chrono::seconds(5));
-                
-                auto now = std::chrono::high_resolution_clock::now();
-                auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - startTime).count();
-                auto completed = completedCombinations.load();
-                
-                if (completed > 0 && totalCombinations > 0) {
-                    double percentComplete = (double)completed / totalCombinations * 100.0;
-                    double itemsPerSecond = (double)completed / std::max(1.0, (double)elapsed);
-                    double estimatedSecondsRemaining = (totalCombinations - completed) / std::max(0.1, itemsPerSecond);
-                    
-                    m_logger->info("Progress: {:.1f}% ({}/{}) - {:.1f} combinations/sec - Est. remaining: {:.0f} sec", 
-                                 percentComplete, completed, totalCombinations, 
-                                 itemsPerSecond, estimatedSecondsRemaining);
-                }
-            }
-        });
-        
-        // Detach the thread so it runs independently
-        progressThread.detach();
-    }
+    m_logger->info("Processing {} combinations on {} threads", 
+                 totalCombinations, m_threadPool->getNumThreads());
     
-    // Create a work queue for all combinations
-    std::queue<std::pair<double, double>> workQueue;
-    for (const auto& combo : combinations) {
-        workQueue.push(combo);
-    }
-    std::mutex workQueueMutex;
+    ProgressTracker progress(m_logger, totalCombinations, 5.0, "Processing combinations");
     
-    // Function to process a batch of combinations
-    auto processBatch = [&](size_t batchSize) {
-        std::vector<std::pair<double, double>> batchCombinations;
-        
-        // Get a batch of work from the queue
-        {
-            std::lock_guard<std::mutex> lock(workQueueMutex);
-            for (size_t i = 0; i < batchSize && !workQueue.empty(); ++i) {
-                batchCombinations.push_back(workQueue.front());
-                workQueue.pop();
-            }
-        }
-        
-        if (batchCombinations.empty()) {
-            return; // No more work
-        }
-        
-        // Process each combination in the batch
-        std::vector<BoxSpreadModel> batchResults;
-        
-        for (const auto& combination : batchCombinations) {
-            // Create box spread with cached options
-            BoxSpreadModel boxSpread(underlying, exchange, combination.first, combination.second, expiry);
-            
-            // Get options from cache
-            auto lowerStrikeIt = optionsByStrike.find(combination.first);
-            auto higherStrikeIt = optionsByStrike.find(combination.second);
-            
-            if (lowerStrikeIt != optionsByStrike.end() && higherStrikeIt != optionsByStrike.end()) {
-                // Set options
-                boxSpread.longCallLower = lowerStrikeIt->second.first;    // Call at lower strike
-                boxSpread.shortPutLower = lowerStrikeIt->second.second;   // Put at lower strike
-                boxSpread.shortCallHigher = higherStrikeIt->second.first; // Call at higher strike
-                boxSpread.longPutHigher = higherStrikeIt->second.second;  // Put at higher strike
+    std::vector<BoxSpreadModel> validSpreads = m_threadPool->parallelReduce(
+        0, totalCombinations, std::vector<BoxSpreadModel>(),
+        [&](size_t from, size_t to, std::vector<BoxSpreadModel>& chunkSpreads) {
+            for (size_t c = from; c < to; ++c) {
+                const auto& combination = combinations[c];
+                auto lowerStrikeIt = optionsByStrike.find(combination.first);
+                auto higherStrikeIt = optionsByStrike.find(combination.second);
                 
-                // Get market data from quotes cache
-                auto updateFromCache = [&quotesCache](InstrumentModel& option) {
-                    auto it = quotesCache.find(option.instrumentToken);
-                    if (it != quotesCache.end()) {
-                        option = it->second;
-                        return true;
-                    }
-                    return false;
-                };
+                if (lowerStrikeIt == optionsByStrike.end() || higherStrikeIt == optionsByStrike.end()) {
+                    continue;
+                }
                 
-                // Update all options with market data
-                bool dataComplete = 
-                    updateFromCache(boxSpread.longCallLower) &&
-                    updateFromCache(boxSpread.shortPutLower) &&
-                    updateFromCache(boxSpread.shortCallHigher) &&
-                    updateFromCache(boxSpread.longPutHigher);
+                size_t lowerCall = lowerStrikeIt->second * 2;
+                size_t higherCall = higherStrikeIt->second * 2;
                 
-                if (!dataComplete) {
-                    m_logger->warn("Box spread does not have complete market data: {}", boxSpread.id);
+                // A box needs a traded price on all four legs; check the price column first
+                if (legLastPrices[lowerCall] <= 0.0 || legLastPrices[lowerCall + 1] <= 0.0 ||
+                    legLastPrices[higherCall] <= 0.0 || legLastPrices[higherCall + 1] <= 0.0) {
+                    continue;
                 }
                 
+                auto loadLeg = [&](size_t leg, InstrumentModel& option) {
+                    option = InstrumentModel(universe->at(legOrdinals[leg]));
+                    quoteStore->read(legOrdinals[leg], option);
+                };
+                
+                BoxSpreadModel boxSpread(underlying, exchange, combination.first, combination.second, expiry);
+                loadLeg(lowerCall, boxSpread.longCallLower);        // Call at lower strike
+                loadLeg(lowerCall + 1, boxSpread.shortPutLower);    // Put at lower strike
+                loadLeg(higherCall, boxSpread.shortCallHigher);     // Call at higher strike
+                loadLeg(higherCall + 1, boxSpread.longPutHigher);   // Put at higher strike
+                
                 // Analyze the box spread
                 BoxSpreadModel analyzedBoxSpread = analyzeBoxSpread(boxSpread);
                 
                 // Only keep valid spreads
                 if (analyzedBoxSpread.hasCompleteMarketData()) {
-                    batchResults.push_back(analyzedBoxSpread);
+                    chunkSpreads.push_back(std::move(analyzedBoxSpread));
                 }
             }
-            
-            // Update completed count
-            size_t processed = processedItems.fetch_add(1) + 1;
-            completedCombinations++;
-            
-            // Log progress every 512 items for efficiency
-            if ((processed & 0x1FF) == 0) {  // Log every 512 items (0x1FF = 511 in binary)
-                auto now = std::chrono::high_resolution_clock::now();
-                auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - startTime).count();
-                if (elapsed > 0) {
-                    double itemsPerSecond = (double)processed / elapsed;
-                    double percentComplete = (double)processed / totalCombinations * 100.0;
-                    
-                    m_logger->debug("Progress: {:.1f}% ({}/{}) - {:.1f} items/sec", 
-                                 percentComplete, processed, totalCombinations,
-                                 itemsPerSecond);
-                }
-            }
-        }
-        
-        // Add results to the main result vector
-        if (!batchResults.empty()) {
-            std::lock_guard<std::mutex> lock(spreadsMutex);
-            validSpreads.insert(validSpreads.end(), batchResults.begin(), batchResults.end());
-        }
-    };
-    
-    // Create worker threads to process batches
-    std::vector<std::thread> workers;
-    for (size_t i = 0; i < optimalThreads; i++) {
-        workers.push_back(std::thread([&, i]() {
-            // Each worker processes batches until the queue is empty
-            while (true) {
-                // Check if there's work to do
-                {
-                    std::lock_guard<std::mutex> lock(workQueueMutex);
-                    if (workQueue.empty()) {
-                        break; // No more work
-                    }
-                }
-                
-                // Process a batch (adaptive size based on remaining work)
-                size_t adaptiveBatchSize;
-                {
-                    std::lock_guard<std::mutex> lock(workQueueMutex);
-                    // Start with smaller batches and increase as we make progress
-                    double progress = (double)completedCombinations.load() / totalCombinations;
-                    adaptiveBatchSize = std::max<size_t>(1, std::min<size_t>(50, workQueue.size() / optimalThreads));
-                }
-                
-                processBatch(adaptiveBatchSize);
-            }
-        }));
-    }
+            progress.advance(to - from);
+        },
+        [](std::vector<BoxSpreadModel> all, std::vector<BoxSpreadModel> chunkSpreads) {
+            all.insert(all.end(), std::make_move_iterator(chunkSpreads.begin()),
+                       std::make_move_iterator(chunkSpreads.end()));
+            return all;
+        });
     
-    // Wait for all workers to complete
-    for (auto& worker : workers) {
-        if (worker.joinable()) {
-            worker.join();
-        }
-    }
-    
-    // Stop progress monitoring
-    if (m_threadPoolOptimizer) {
-        stopProgressMonitoring();
-    } else {
-        // Stop the original progress thread
-        progressTimerRunning.store(false);
-        // We detached the thread, so we don't need to join it
-    }
+    progress.finish();
     
     // Log final statistics
     auto endTime = std::chrono::high_resolution_clock::now();
@@ -505,6 +403,57 @@ std::vector<BoxSpreadModel> CombinationAnalyzer::findProfitableSpreadsForExpiry(
     return profitableSpreads;
 }
 
+std::vector<bool> CombinationAnalyzer::filterCombinationsByLastPrice(
+    std::vector<std::pair<double, double>>& combinations,
+    const std::unordered_map<double, size_t>& optionsByStrike,
+    const std::vector<double>& legPrices) {
+    
+    // Depth can fill better than the last trade, so allow for that on every leg
+    double tolerancePercent = m_configManager->getDoubleValue("option_chain/two_phase/ltp_tolerance_percent", 1.0);
+    double minEdge = m_configManager->getDoubleValue("option_chain/two_phase/min_ltp_edge", 0.0);
+    
+    std::vector<bool> candidateLegs(legPrices.size(), false);
+    
+    auto isCandidate = [&](const std::pair<double, double>& combination) {
+        auto lowerStrikeIt = optionsByStrike.find(combination.first);
+        auto higherStrikeIt = optionsByStrike.find(combination.second);
+        if (lowerStrikeIt == optionsByStrike.end() || higherStrikeIt == optionsByStrike.end()) {
+            return false;
+        }
+        
+        size_t lowerCall = lowerStrikeIt->second * 2;
+        size_t higherCall = higherStrikeIt->second * 2;
+        double callLower = legPrices[lowerCall];
+        double putLower = legPrices[lowerCall + 1];
+        double callHigher = legPrices[higherCall];
+        double putHigher = legPrices[higherCall + 1];
+        
+        if (callLower <= 0.0 || putLower <= 0.0 || callHigher <= 0.0 || putHigher <= 0.0) {
+            return false;
+        }
+        
+        // Same profit/loss as BoxSpreadModel::calculateProfitLoss, on last prices
+        double profitLoss = (combination.second - combination.first) -
+                            BoxSpreadModel::netPremiumFromPrices(callLower, callHigher, putHigher, putLower);
+        double tolerance = (callLower + putLower + callHigher + putHigher) * tolerancePercent / 100.0;
+        
+        if (profitLoss + tolerance < minEdge) {
+            return false;
+        }
+        
+        candidateLegs[lowerCall] = candidateLegs[lowerCall + 1] = true;
+        candidateLegs[higherCall] = candidateLegs[higherCall + 1] = true;
+        return true;
+    };
+    
+    combinations.erase(
+        std::remove_if(combinations.begin(), combinations.end(),
+                       [&](const std::pair<double, double>& combination) { return !isCandidate(combination); }),
+        combinations.end());
+    
+    return candidateLegs;
+}
+
 std::vector<double> CombinationAnalyzer::findAvailableStrikes(
     const std::string& underlying, 
     const std::string& exchange,
@@ -524,25 +473,18 @@ std::vector<double> CombinationAnalyzer::findAvailableStrikes(
         }
     }
     
-    // Get all instruments
-    auto instrumentsFuture = m_marketDataManager->getAllInstruments();
-    auto instruments = instrumentsFuture.get();
-    
-    // Filter for options of the given underlying, exchange, and expiry
-    std::set<double, std::less<double>> uniqueStrikes;
-    for (const auto& instrument : instruments) {
-        if (instrument.type == InstrumentType::OPTION && 
-            instrument.underlying == underlying &&
-            instrument.exchange == exchange &&
-            instrument.expiry == expiry) {
-            uniqueStrikes.insert(instrument.strikePrice);
+    // Read the strikes straight from the option chain index (already sorted)
+    auto universe = m_marketDataManager->getInstrumentUniverse();
+    const OptionChain* chain = universe->findOptionChain(underlying, exchange, ExpiryDay::fromTimePoint(expiry));
+    
+    std::vector<double> result;
+    if (chain) {
+        result.reserve(chain->size());
+        for (const auto& entry : *chain) {
+            result.push_back(entry.strike);
         }
     }
     
-    // Convert to vector and sort
-    std::vector<double> result(uniqueStrikes.begin(), uniqueStrikes.end());
-    std::sort(result.begin(), result.end());
-    
     // Update cache
     {
         std::lock_guard<std::mutex> lock(m_cacheMutex);
@@ -601,54 +543,33 @@ std::vector<std::pair<double, double>> CombinationAnalyzer::generateStrikeCombin
     double minStrikeDiff = m_configManager->getDoubleValue("strategy/min_strike_diff", 50.0);
     double maxStrikeDiff = m_configManager->getDoubleValue("strategy/max_strike_diff", 500.0);
     
-    std::vector<std::pair<double, double>> combinations;
-    std::mutex combinationsMutex;
-    
-    // Determine number of threads to use
-    size_t numThreads = m_threadPool->getNumThreads();
-    size_t numChunks = std::min(numThreads, strikes.size());
-    
     // If we have a very small dataset, just use the sequential version
-    if (numChunks < 2 || strikes.size() < 10) {
+    if (m_threadPool->getNumThreads() < 2 || strikes.size() < 10) {
         return generateStrikeCombinations(underlying, exchange, expiry, strikes);
     }
     
-    // Split the work into chunks
-    std::vector<std::future<void>> futures;
-    for (size_t chunk = 0; chunk < numChunks; ++chunk) {
-        futures.push_back(m_threadPool->enqueue(
-            [&strikes, &combinations, &combinationsMutex, chunk, numChunks, minStrikeDiff, maxStrikeDiff]() {
-                std::vector<std::pair<double, double>> localCombinations;
-                
-                // Process a chunk of the strike combinations
-                for (size_t i = chunk; i < strikes.size(); i += numChunks) {
-                    for (size_t j = i + 1; j < strikes.size(); ++j) {
-                        double lowerStrike = strikes[i];
-                        double higherStrike = strikes[j];
-                        double diff = higherStrike - lowerStrike;
-                        
-                        // Check if strike difference is within range
-                        if (diff >= minStrikeDiff && diff <= maxStrikeDiff) {
-                            localCombinations.emplace_back(lowerStrike, higherStrike);
-                        }
+    // Split the lower strikes into ranges; each range pairs its strikes with every
+    // higher strike into its own buffer, and the buffers are joined in strike order
+    using Combinations = std::vector<std::pair<double, double>>;
+    Combinations combinations = m_threadPool->parallelReduce(0, strikes.size(), Combinations(),
+        [&strikes, minStrikeDiff, maxStrikeDiff](size_t from, size_t to, Combinations& localCombinations) {
+            for (size_t i = from; i < to; ++i) {
+                for (size_t j = i + 1; j < strikes.size(); ++j) {
+                    double lowerStrike = strikes[i];
+                    double higherStrike = strikes[j];
+                    double diff = higherStrike - lowerStrike;
+                    
+                    // Check if strike difference is within range
+                    if (diff >= minStrikeDiff && diff <= maxStrikeDiff) {
+                        localCombinations.emplace_back(lowerStrike, higherStrike);
                     }
                 }
-                
-                // Add local combinations to the global vector
-                if (!localCombinations.empty()) {
-                    std::lock_guard<std::mutex> lock(combinationsMutex);
-                    combinations.insert(combinations.end(), 
-                                      localCombinations.begin(), 
-                                      localCombinations.end());
-                }
             }
-        ));
-    }
-    
-    // Wait for all chunks to complete
-    for (auto& future : futures) {
-        future.wait();
-    }
+        },
+        [](Combinations all, Combinations localCombinations) {
+            all.insert(all.end(), localCombinations.begin(), localCombinations.end());
+            return all;
+        });
     
     m_logger->debug("Generated {} combinations in parallel with strike difference between {} and {}", 
                  combinations.size(), minStrikeDiff, maxStrikeDiff);
@@ -744,7 +665,7 @@ BoxSpreadModel CombinationAnalyzer::getBoxSpreadOptions(
         boxSpread.shortPutLower.instrumentToken
     };
     
-    auto quotesFuture = m_marketDataManager->getQuotes(instrumentTokens);
+    auto quotesFuture = m_marketDataManager->getQuotes(instrumentTokens, underlying);
     auto quotes = quotesFuture.get();
     
     // Update market data
@@ -796,59 +717,31 @@ InstrumentModel CombinationAnalyzer::findMostLiquidOption(
         }
     }
     
-    // Get all instruments
-    auto instrumentsFuture = m_marketDataManager->getAllInstruments();
-    auto instruments = instrumentsFuture.get();
-    
-    // Filter for options of the given underlying, exchange, expiry, strike, and type
-    std::vector<InstrumentModel> matchingOptions;
-    for (const auto& instrument : instruments) {
-        if (instrument.type == InstrumentType::OPTION && 
-            instrument.underlying == underlying &&
-            instrument.exchange == exchange &&
-            instrument.expiry == expiry &&
-            std::abs(instrument.strikePrice - strike) < 0.01 &&
-            instrument.optionType == optionType) {
-            matchingOptions.push_back(instrument);
-        }
+    // Look the strike up in the option chain index
+    auto universe = m_marketDataManager->getInstrumentUniverse();
+    const OptionChainEntry* entry = universe->findOptionStrike(
+        underlying, exchange, ExpiryDay::fromTimePoint(expiry), strike);
+    const InstrumentRef* option = nullptr;
+    if (entry) {
+        option = optionType == OptionType::CALL ? entry->call : entry->put;
     }
     
-    if (matchingOptions.empty()) {
+    if (!option) {
         m_logger->warn("No matching options found");
         return InstrumentModel();
     }
     
-    // Sort by trading symbol (to get a deterministic result if there are multiple matches)
-    std::sort(matchingOptions.begin(), matchingOptions.end(),
-             [](const InstrumentModel& a, const InstrumentModel& b) {
-                 return a.tradingSymbol < b.tradingSymbol;
-             });
+    // Get market data for the option
+    InstrumentModel mostLiquid(*option);
     
-    // Get market data for all matching options
-    std::vector<uint64_t> instrumentTokens;
-    for (const auto& option : matchingOptions) {
-        instrumentTokens.push_back(option.instrumentToken);
-    }
-    
-    auto quotesFuture = m_marketDataManager->getQuotes(instrumentTokens);
+    auto quotesFuture = m_marketDataManager->getQuotes({option->instrumentToken});
     auto quotes = quotesFuture.get();
     
-    // Update market data
-    for (auto& option : matchingOptions) {
-        auto it = quotes.find(option.instrumentToken);
-        if (it != quotes.end()) {
-            option = it->second;
-        }
+    auto quoteIt = quotes.find(option->instrumentToken);
+    if (quoteIt != quotes.end()) {
+        mostLiquid = quoteIt->second;
     }
     
-    // Find the most liquid option (highest volume)
-    auto mostLiquidIt = std::max_element(matchingOptions.begin(), matchingOptions.end(),
-                                        [](const InstrumentModel& a, const InstrumentModel& b) {
-                                            return a.volume < b.volume;
-                                        });
-    
-    InstrumentModel mostLiquid = (mostLiquidIt != matchingOptions.end()) ? *mostLiquidIt : matchingOptions[0];
-    
     // Update cache
     {
         std::lock_guard<std::mutex> lock(m_cacheMutex);
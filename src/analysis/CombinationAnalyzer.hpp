@@ -13,6 +13,7 @@
 #include <atomic>
 #include <future>
 #include <map>
+#include <unordered_map>
 #include "../utils/Logger.hpp"
 #include "../utils/ThreadPool.hpp"
 #include "../config/ConfigManager.hpp"
@@ -54,7 +55,7 @@ public:
     /**
      * @brief Destructor
      */
-    ~CombinationAnalyzer() = default;
+    ~CombinationAnalyzer();
     
     /**
      * @brief Set the ThreadPoolOptimizer for enhanced workload management
@@ -64,6 +65,16 @@ public:
         m_threadPoolOptimizer = optimizer;
     }
     
+    /**
+     * @brief Set the pool that runs the expiries of a scan in parallel
+     * @param scanThreadPool Unpinned pool of threads that may block on the API
+     *
+     * Without it, expiry/process_in_parallel is ignored and expiries are scanned one after another.
+     */
+    void setScanThreadPool(std::shared_ptr<ThreadPool> scanThreadPool) {
+        m_scanThreadPool = scanThreadPool;
+    }
+    
     /**
      * @brief Find profitable box spreads for an underlying
      * @param underlying Underlying instrument
@@ -182,6 +193,22 @@ public:
         const std::vector<BoxSpreadModel>& boxSpreads);
 
 private:
+    /**
+     * @brief Drop strike pairs whose last traded prices cannot make a profitable box
+     *
+     * The bound is optimistic: the edge implied by last prices is widened by a
+     * tolerance for the gap between last price and the executable depth.
+     *
+     * @param combinations Strike pairs, filtered in place
+     * @param optionsByStrike Strike -> index of its call/put pair in legPrices (call at 2*i, put at 2*i+1)
+     * @param legPrices Last traded price of every leg, 0 if unknown
+     * @return Per leg, whether a remaining strike pair uses it
+     */
+    std::vector<bool> filterCombinationsByLastPrice(
+        std::vector<std::pair<double, double>>& combinations,
+        const std::unordered_map<double, size_t>& optionsByStrike,
+        const std::vector<double>& legPrices);
+
     std::shared_ptr<ConfigManager> m_configManager;        ///< Configuration manager
     std::shared_ptr<MarketDataManager> m_marketDataManager; ///< Market data manager
     std::shared_ptr<ExpiryManager> m_expiryManager;        ///< Expiry manager
@@ -190,6 +217,7 @@ private:
     std::shared_ptr<ThreadPool> m_threadPool;              ///< Thread pool
     std::shared_ptr<Logger> m_logger;                      ///< Logger instance
     std::shared_ptr<ThreadPoolOptimizer> m_threadPoolOptimizer; ///< Thread pool optimizer instance
+    std::shared_ptr<ThreadPool> m_scanThreadPool;          ///< Runs the expiry scans, which wait on the API
     
     // Cache for available strikes and instruments
     std::unordered_map<std::string, std::vector<double>> m_strikesCache;
@@ -198,6 +226,14 @@ private:
     // Mutex for thread safety
     std::mutex m_cacheMutex;
     
+    size_t m_universeListenerId = 0;  ///< Registration with the market data manager
+    
+    /**
+     * @brief Drop cached strikes and options of the chains a universe change touched
+     * @param delta Universe change
+     */
+    void invalidateCaches(const InstrumentUniverseDelta& delta);
+    
     /**
      * @brief Generate cache key for strikes
      * @param underlying Underlying instrument
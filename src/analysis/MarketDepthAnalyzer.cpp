@@ -191,7 +191,7 @@ BoxSpreadModel MarketDepthAnalyzer::refreshMarketDepth(BoxSpreadModel boxSpread)
     };
     
     // Get quotes for all instruments
-    auto quotesFuture = m_marketDataManager->getQuotes(instrumentTokens);
+    auto quotesFuture = m_marketDataManager->getQuotes(instrumentTokens, boxSpread.underlying);
     auto quotes = quotesFuture.get();
     
     // Update box spread with fresh market depth data
@@ -27,6 +27,12 @@ AuthManager::AuthManager(
     m_apiKey = m_configManager->getStringValue("api/key");
     m_apiSecret = m_configManager->getStringValue("api/secret");
     
+    // Overridable so the application can run against a local stand-in
+    m_apiBaseUrl = m_configManager->getStringValue("api/base_url", "https://api.kite.trade");
+    while (!m_apiBaseUrl.empty() && m_apiBaseUrl.back() == '/') {
+        m_apiBaseUrl.pop_back();
+    }
+    
     if (m_apiKey.empty() || m_apiSecret.empty()) {
         m_logger->error("API key or secret not found in configuration");
     } else {
@@ -68,7 +74,7 @@ bool AuthManager::generateAccessToken(const std::string& requestToken) {
     
     HttpResponse response = m_httpClient->request(
         HttpMethod::POST,
-        "https://api.kite.trade/session/token",
+        m_apiBaseUrl + "/session/token",
         headers,
         requestBody
     );
@@ -140,7 +146,7 @@ bool AuthManager::invalidateAccessToken() {
     
     HttpResponse response = m_httpClient->request(
         HttpMethod::DELETE,
-        "https://api.kite.trade/session/token",
+        m_apiBaseUrl + "/session/token",
         headers
     );
     
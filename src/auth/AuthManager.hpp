@@ -83,6 +83,12 @@ public:
      */
     std::string getApiKey() const;
     
+    /**
+     * @brief Get the base URL of the REST API (api/base_url)
+     * @return Base URL without a trailing slash, e.g. "https://api.kite.trade"
+     */
+    const std::string& getApiBaseUrl() const { return m_apiBaseUrl; }
+    
     /**
      * @brief Get the API secret
      * @return API secret
@@ -115,6 +121,7 @@ private:
     
     std::string m_apiKey;                            ///< API key
     std::string m_apiSecret;                         ///< API secret
+    std::string m_apiBaseUrl;                        ///< REST API base URL
     std::string m_accessToken;                       ///< Access token
     std::chrono::system_clock::time_point m_accessTokenExpiry;  ///< Access token expiry time
     
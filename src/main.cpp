@@ -10,11 +10,14 @@
 #include <thread>
 #include <csignal>
 #include <atomic>
+#include <vector>
+#include <future>
 
 #include "utils/Logger.hpp"
 #include "utils/HttpClient.hpp"
 #include "utils/ThreadPool.hpp"
 #include "utils/ThreadPoolOptimizer.hpp"
+#include "utils/ThreadTopology.hpp"
 #include "config/ConfigManager.hpp"
 #include "auth/AuthManager.hpp"
 #include "market/MarketDataManager.hpp"
@@ -65,31 +68,79 @@ int main(int argc, char* argv[]) {
         
         // Get configuration values
         std::string underlying = configManager->getStringValue("strategy/underlying", "NIFTY");
+        std::vector<std::string> underlyings = configManager->getStringArray("strategy/underlyings");
         std::string exchange = configManager->getStringValue("strategy/exchange", "NFO");
         uint64_t quantity = configManager->getIntValue("strategy/quantity", 1);
         int maxExpiries = configManager->getIntValue("expiry/max_count", 3);
-        int numThreads = configManager->getIntValue("system/num_threads", 4);
         bool isPaperTrading = configManager->getBoolValue("strategy/paper_trading", true);
         int scanIntervalSeconds = configManager->getIntValue("strategy/scan_interval_seconds", 60);
+        bool isReplay = configManager->getBoolValue("replay/enabled", false);
         
-        logger->info("Configuration loaded. Underlying: {}, Exchange: {}, Quantity: {}", 
-                   underlying, exchange, quantity);
+        // A replay never reaches the exchange, so it can only paper trade
+        if (isReplay && !isPaperTrading) {
+            logger->warn("Replay mode forces paper trading");
+            isPaperTrading = true;
+        }
+        
+        // strategy/underlyings supersedes the single strategy/underlying
+        if (underlyings.empty()) {
+            underlyings.push_back(underlying);
+        }
+        
+        std::string underlyingList;
+        for (const auto& name : underlyings) {
+            underlyingList += (underlyingList.empty() ? "" : ", ") + name;
+        }
+        
+        logger->info("Configuration loaded. Underlyings: {}, Exchange: {}, Quantity: {}", 
+                   underlyingList, exchange, quantity);
+        
+        // Lay out analysis workers and I/O threads over the CPUs once, for the whole run
+        TopologyOptions topologyOptions = TopologyOptions::fromConfig(*configManager);
+        ThreadTopology topology(topologyOptions, logger);
         
         // Create thread pool
-        auto threadPool = std::make_shared<ThreadPool>(numThreads, logger);
-        logger->info("Thread pool initialized with {} threads", numThreads);
+        auto threadPool = std::make_shared<ThreadPool>(topologyOptions.numThreads, logger, 
+                                                       topology.getWorkerPlacements());
+        logger->info("Thread pool initialized with {} threads", topologyOptions.numThreads);
+        
+        // Scans wait on the API, so they run on their own unpinned threads and leave the
+        // analysis workers to the CPU-bound loops
+        size_t scanThreads = topologyOptions.numScanThreads;
+        if (scanThreads == 0) {
+            bool parallelExpiries = configManager->getBoolValue("expiry/process_in_parallel", false);
+            scanThreads = underlyings.size() * (parallelExpiries ? static_cast<size_t>(std::max(1, maxExpiries)) : 1);
+        }
+        auto scanThreadPool = std::make_shared<ThreadPool>(scanThreads, logger);
+        logger->info("Scan pool initialized with {} threads", scanThreads);
         
         // Create thread pool optimizer
         auto threadPoolOptimizer = std::make_shared<ThreadPoolOptimizer>(threadPool, logger);
         
-        // Create HTTP client
-        auto httpClient = std::make_shared<HttpClient>(logger);
+        // Create HTTP client; its I/O loop runs on the I/O CPUs, if any are reserved
+        auto httpClient = std::make_shared<HttpClient>(logger, topology.getIoCpus());
+        httpClient->setMaxIdleConnections(configManager->getIntValue("api/connection_pool_size", 32));
         
         // Create authentication manager
         auto authManager = std::make_shared<AuthManager>(configManager, httpClient, logger);
         
+        // Replay from a journal if configured; it needs no access token
+        std::shared_ptr<ReplayEngine> replayEngine;
+        if (isReplay) {
+            std::string replayPath = configManager->getStringValue("replay/path", "market_data.journal");
+            replayEngine = std::make_shared<ReplayEngine>(
+                logger, configManager->getDoubleValue("replay/speed", 0.0));
+            
+            if (!replayEngine->load(replayPath)) {
+                logger->fatal("Failed to load replay journal {}", replayPath);
+                return 1;
+            }
+        }
+        
         // Check if we need to authenticate
-        if (!authManager->isAccessTokenValid()) {
+        if (isReplay) {
+            logger->info("Replaying market data at speed {} (0 = as fast as possible)", replayEngine->getSpeed());
+        } else if (!authManager->isAccessTokenValid()) {
             logger->info("Access token is not valid. Please authenticate.");
             
             // Generate login URL
@@ -113,9 +164,40 @@ int main(int argc, char* argv[]) {
             logger->info("Using existing access token");
         }
         
+        // Open connections to the API now so the first scan does not pay for the handshakes
+        int prewarmConnections = configManager->getIntValue("api/prewarm_connections", 4);
+        if (!isReplay && prewarmConnections > 0) {
+            httpClient->prewarm(authManager->getApiBaseUrl() + "/", prewarmConnections);
+        }
+        
         // Initialize MarketDataManager
         std::shared_ptr<MarketDataManager> marketDataManager = std::make_shared<MarketDataManager>(
             authManager, httpClient, logger, configManager);
+        marketDataManager->setThreadPool(threadPool);
+        marketDataManager->setIoCpus(topology.getIoCpus());
+        
+        // Record raw market data for later replays
+        std::shared_ptr<MarketDataJournal> journal;
+        if (isReplay) {
+            marketDataManager->setReplayEngine(replayEngine);
+        } else if (configManager->getBoolValue("journal/enabled", false)) {
+            journal = std::make_shared<MarketDataJournal>(logger);
+            if (journal->open(configManager->getStringValue("journal/path", "market_data.journal"))) {
+                marketDataManager->setJournal(journal);
+            }
+        }
+        
+        // Keep the instrument universe fresh off the scan path
+        if (!isReplay && configManager->getBoolValue("api/instruments_background_refresh", true)) {
+            marketDataManager->startInstrumentRefresher();
+        }
+        
+        // Start streaming quotes if a ticker is configured, or play the recorded ones
+        if (isReplay) {
+            marketDataManager->startTickReplay();
+        } else if (configManager->getBoolValue("ticker/enabled", false)) {
+            marketDataManager->startTickFeed();
+        }
         
         // Create expiry manager
         auto expiryManager = std::make_shared<ExpiryManager>(configManager, marketDataManager, logger);
@@ -137,6 +219,7 @@ int main(int argc, char* argv[]) {
         
         // Set the thread pool optimizer on the combination analyzer
         combinationAnalyzer->setThreadPoolOptimizer(threadPoolOptimizer);
+        combinationAnalyzer->setScanThreadPool(scanThreadPool);
         
         // Create order manager
         auto orderManager = std::make_shared<OrderManager>(configManager, authManager, httpClient, logger);
@@ -252,69 +335,94 @@ int main(int argc, char* argv[]) {
         
         while (g_running) {
             try {
-                logger->info("Scanning for profitable box spreads");
+                logger->info("Scanning {} for profitable box spreads", underlyingList);
                 
-                // Find profitable box spreads
-                auto boxSpreads = combinationAnalyzer->findProfitableSpreads(underlying, exchange);
+                // Scan every underlying at once on the scan pool; the scans share the instrument
+                // universe, the quote store and the API budget, which the scheduler splits between
+                // them in turns
+                std::vector<std::future<std::vector<BoxSpreadModel>>> scans;
+                for (const auto& scanUnderlying : underlyings) {
+                    scans.push_back(scanThreadPool->enqueue([&, scanUnderlying]() {
+                        auto spreads = combinationAnalyzer->findProfitableSpreads(scanUnderlying, exchange);
+                        
+                        if (!spreads.empty()) {
+                            logger->info("Found {} profitable box spreads for {}", spreads.size(), scanUnderlying);
+                            
+                            // Filter by market depth
+                            spreads = marketDepthAnalyzer->filterByLiquidity(spreads, quantity);
+                            logger->info("{} box spreads for {} have sufficient liquidity", 
+                                       spreads.size(), scanUnderlying);
+                        }
+                        return spreads;
+                    }));
+                }
                 
-                if (boxSpreads.empty()) {
-                    logger->info("No profitable box spreads found. Waiting for next scan...");
-                } else {
-                    logger->info("Found {} profitable box spreads", boxSpreads.size());
+                // Trade the results one underlying at a time
+                for (size_t u = 0; u < underlyings.size(); ++u) {
+                    const std::string& scanUnderlying = underlyings[u];
+                    
+                    std::vector<BoxSpreadModel> boxSpreads;
+                    try {
+                        boxSpreads = scans[u].get();
+                    } catch (const std::exception& e) {
+                        logger->error("Scan of {} failed: {}", scanUnderlying, e.what());
+                        continue;
+                    }
                     
-                    // Filter by market depth
-                    boxSpreads = marketDepthAnalyzer->filterByLiquidity(boxSpreads, quantity);
-                    logger->info("{} box spreads have sufficient liquidity", boxSpreads.size());
+                    if (boxSpreads.empty()) {
+                        logger->info("No profitable box spreads with sufficient liquidity for {}", scanUnderlying);
+                        continue;
+                    }
                     
                     // Export profitable spreads to CSV if paper trading is enabled
-                    if (isPaperTrading && !boxSpreads.empty()) {
-                        std::string filename = "profitable_spreads_" + 
+                    if (isPaperTrading) {
+                        std::string filename = "profitable_spreads_" + scanUnderlying + "_" +
                             std::to_string(std::chrono::system_clock::to_time_t(std::chrono::system_clock::now())) + ".csv";
                         paperTrader->exportProfitableSpreadsToCsv(boxSpreads, filename);
                         logger->info("Exported profitable spreads to {}", filename);
                     }
                     
-                    if (!boxSpreads.empty()) {
-                        // Get the most profitable box spread
-                        BoxSpreadModel bestBoxSpread = boxSpreads[0];
-                        
-                        logger->info("Selected box spread: {}", bestBoxSpread.id);
-                        logger->info("Theoretical value: {}, Net premium: {}, ROI: {}%, Profitability: {}",
-                                   bestBoxSpread.calculateTheoreticalValue(),
-                                   bestBoxSpread.calculateNetPremium(),
-                                   bestBoxSpread.roi,
-                                   bestBoxSpread.profitability);
+                    // Get the most profitable box spread
+                    BoxSpreadModel bestBoxSpread = boxSpreads[0];
+                    
+                    logger->info("Selected box spread: {}", bestBoxSpread.id);
+                    logger->info("Theoretical value: {}, Net premium: {}, ROI: {}%, Profitability: {}",
+                               bestBoxSpread.calculateTheoreticalValue(),
+                               bestBoxSpread.calculateNetPremium(),
+                               bestBoxSpread.roi,
+                               bestBoxSpread.profitability);
+                    
+                    // Execute the box spread
+                    if (isPaperTrading) {
+                        logger->info("Simulating box spread trade (paper trading mode)");
+                        PaperTradeResult result = paperTrader->simulateBoxSpreadTrade(bestBoxSpread, quantity);
+                        logger->info("Paper trade result: ID: {}, Profit: {}", result.id, result.profit);
                         
-                        // Execute the box spread
-                        if (isPaperTrading) {
-                            logger->info("Simulating box spread trade (paper trading mode)");
-                            PaperTradeResult result = paperTrader->simulateBoxSpreadTrade(bestBoxSpread, quantity);
-                            logger->info("Paper trade result: ID: {}, Profit: {}", result.id, result.profit);
+                        // Export trade results after each trade
+                        paperTrader->exportTradesToCSV();
+                        logger->info("Exported updated trade results to CSV");
+                    } else {
+                        logger->info("Executing box spread trade (live trading mode)");
+                        bool orderPlaced = orderManager->placeBoxSpreadOrder(bestBoxSpread, quantity);
+                        if (orderPlaced) {
+                            logger->info("Box spread order placed successfully");
                             
-                            // Export trade results after each trade
-                            paperTrader->exportTradesToCSV();
-                            logger->info("Exported updated trade results to CSV");
-                        } else {
-                            logger->info("Executing box spread trade (live trading mode)");
-                            bool orderPlaced = orderManager->placeBoxSpreadOrder(bestBoxSpread, quantity);
-                            if (orderPlaced) {
-                                logger->info("Box spread order placed successfully");
-                                
-                                // Wait for execution
-                                bestBoxSpread = orderManager->waitForBoxSpreadExecution(bestBoxSpread, 300);
-                                
-                                if (bestBoxSpread.allLegsExecuted) {
-                                    logger->info("Box spread order fully executed");
-                                } else {
-                                    logger->warn("Box spread order not fully executed within timeout");
-                                }
+                            // Wait for execution
+                            bestBoxSpread = orderManager->waitForBoxSpreadExecution(bestBoxSpread, 300);
+                            
+                            if (bestBoxSpread.allLegsExecuted) {
+                                logger->info("Box spread order fully executed");
                             } else {
-                                logger->error("Failed to place box spread order");
+                                logger->warn("Box spread order not fully executed within timeout");
                             }
+                        } else {
+                            logger->error("Failed to place box spread order");
                         }
                     }
                 }
                 
+                marketDataManager->logApiUtilization();
+                
                 // Wait for the next scan
                 logger->info("Waiting {} seconds for next scan", scanIntervalSeconds);
                 
@@ -331,6 +439,18 @@ int main(int argc, char* argv[]) {
         
         logger->info("Main trading loop terminated");
         
+        if (replayEngine) {
+            replayEngine->stop();
+            ReplayStats stats = replayEngine->getStats();
+            logger->info("Replay served {} requests ({} exact, {} covered by a larger record), {} misses, "
+                       "{} tick messages", stats.served, stats.exact, stats.fallback, stats.misses, 
+                       stats.tickMessages);
+        }
+        
+        if (journal) {
+            journal->close();
+        }
+        
         // Print paper trading results if applicable
         if (isPaperTrading) {
             double totalProfit = paperTrader->getTotalProfitLoss();
@@ -47,6 +47,25 @@ ExpiryManager::ExpiryManager(
     m_logger(logger) {
     
     m_logger->info("ExpiryManager initialized");
+    
+    // Expiries only change when a chain of the underlying gains or loses options
+    m_universeListenerId = m_marketDataManager->addUniverseListener(
+        [this](const InstrumentUniverseDelta& delta) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            
+            if (delta.rebuilt) {
+                m_expiriesCache.clear();
+                return;
+            }
+            
+            for (const auto& chain : delta.affectedChains) {
+                m_expiriesCache.erase(generateCacheKey(chain.underlying, chain.exchange));
+            }
+        });
+}
+
+ExpiryManager::~ExpiryManager() {
+    m_marketDataManager->removeUniverseListener(m_universeListenerId);
 }
 
 std::pair<std::vector<std::chrono::system_clock::time_point>, 
@@ -62,14 +81,15 @@ ExpiryManager::getExpiries(bool includeWeekly, bool includeMonthly) {
     m_logger->info("Getting expiries for underlying: {}, exchange: {}", underlying, exchange);
     
     // Get all option instruments for the underlying from Market Data Manager
-    auto futureInstruments = m_marketDataManager->getInstrumentsByExchange(exchange);
-    std::vector<InstrumentModel> instruments = futureInstruments.get();
+    auto universe = m_marketDataManager->getInstrumentUniverse();
+    const auto& instruments = universe->getByExchange(exchange);
     
     m_logger->info("Retrieved {} instruments from exchange {}", instruments.size(), exchange);
     
     // Debug: Log first few instruments to see what's being returned
     int debugCount = 0;
-    for (const auto& instrument : instruments) {
+    for (const InstrumentRef* instrumentPtr : instruments) {
+        const InstrumentRef& instrument = *instrumentPtr;
         if (debugCount < 5) {
             m_logger->debug("Sample instrument: type={}, symbol={}, underlying={}, exchange={}", 
                          InstrumentModel::instrumentTypeToString(instrument.type),
@@ -86,7 +106,8 @@ ExpiryManager::getExpiries(bool includeWeekly, bool includeMonthly) {
     int filteredOptionCount = 0;
     int niftyOptionsWithExpiryCount = 0;
     
-    for (const auto& instrument : instruments) {
+    for (const InstrumentRef* instrumentPtr : instruments) {
+        const InstrumentRef& instrument = *instrumentPtr;
         // First check if it's an option
         if (instrument.type == InstrumentType::OPTION) {
             totalOptionCount++;
@@ -109,27 +130,19 @@ ExpiryManager::getExpiries(bool includeWeekly, bool includeMonthly) {
             if (isTargetOption) {
                 filteredOptionCount++;
                 
-                // Debug expiry value
-                auto timeValue = std::chrono::system_clock::to_time_t(instrument.expiry);
-                auto time_t_val = std::chrono::system_clock::to_time_t(instrument.expiry);
-                std::tm* tm = std::localtime(&time_t_val);
-                
-                std::stringstream ss;
-                ss << std::put_time(tm, "%Y-%m-%d");
-                
-                // Only add non-zero expiry dates
-                if (timeValue > 0) {
+                // Only add options that have an expiry date
+                if (instrument.expiry.isSet()) {
                     niftyOptionsWithExpiryCount++;
-                    uniqueExpiries.insert(instrument.expiry);
+                    uniqueExpiries.insert(instrument.expiry.timePoint());
                     
                     m_logger->debug("Found option with valid expiry: tradingSymbol={}, expiry={}, strike={}, type={}",
                                  instrument.tradingSymbol,
-                                 ss.str(),
+                                 instrument.expiry,
                                  instrument.strikePrice,
                                  InstrumentModel::optionTypeToString(instrument.optionType));
                 } else {
-                    m_logger->warn("Found option with INVALID expiry: tradingSymbol={}, expiry time value={}",
-                                 instrument.tradingSymbol, timeValue);
+                    m_logger->warn("Found option with INVALID expiry: tradingSymbol={}, expiry day={}",
+                                 instrument.tradingSymbol, instrument.expiry.day());
                 }
             }
         }
@@ -228,7 +241,7 @@ std::vector<std::chrono::system_clock::time_point> ExpiryManager::getAvailableEx
     const std::string& underlying, 
     const std::string& exchange) {
     
-    std::lock_guard<std::mutex> lock(m_mutex);
+    std::unique_lock<std::mutex> lock(m_mutex);
     
     std::string key = generateCacheKey(underlying, exchange);
     auto it = m_expiriesCache.find(key);
@@ -239,7 +252,7 @@ std::vector<std::chrono::system_clock::time_point> ExpiryManager::getAvailableEx
     }
     
     // Release the lock before making the API call
-    lock.~lock_guard();
+    lock.unlock();
     
     // Cache not found or empty, refresh
     return refreshExpiries(underlying, exchange);
@@ -38,7 +38,7 @@ public:
     /**
      * @brief Destructor
      */
-    ~ExpiryManager() = default;
+    ~ExpiryManager();
     
     /**
      * @brief Get weekly and monthly expiries 
@@ -135,6 +135,8 @@ private:
     // Lock for thread safety
     std::mutex m_mutex;
     
+    size_t m_universeListenerId = 0;  ///< Registration with the market data manager
+    
     /**
      * @brief Generate key for expiry cache
      * @param underlying Underlying instrument
@@ -0,0 +1,373 @@
+/**
+ * @file InstrumentCsvParser.cpp
+ * @brief Implementation of the InstrumentCsvParser class
+ */
+
+#include "../market/InstrumentCsvParser.hpp"
+#include <charconv>
+#include <algorithm>
+
+namespace BoxStrategy {
+
+namespace {
+
+/**
+ * @brief Parse an unsigned integer field, the whole field must be consumed
+ */
+bool parseUnsigned(std::string_view field, uint64_t& value) {
+    auto result = std::from_chars(field.data(), field.data() + field.size(), value);
+    return result.ec == std::errc() && result.ptr == field.data() + field.size();
+}
+
+/**
+ * @brief Parse an optional decimal field, empty fields leave the value untouched
+ */
+bool parseDecimal(std::string_view field, double& value) {
+    if (field.empty()) {
+        return true;
+    }
+
+    auto result = std::from_chars(field.data(), field.data() + field.size(), value);
+    return result.ec == std::errc() && result.ptr == field.data() + field.size();
+}
+
+/**
+ * @brief Parse a YYYY-MM-DD date into an expiry day
+ */
+bool parseExpiryDate(std::string_view field, ExpiryDay& value) {
+    if (field.size() != 10 || field[4] != '-' || field[7] != '-') {
+        return false;
+    }
+
+    int year = 0;
+    unsigned month = 0;
+    unsigned day = 0;
+    if (std::from_chars(field.data(), field.data() + 4, year).ptr != field.data() + 4 ||
+        std::from_chars(field.data() + 5, field.data() + 7, month).ptr != field.data() + 7 ||
+        std::from_chars(field.data() + 8, field.data() + 10, day).ptr != field.data() + 10 ||
+        month < 1 || month > 12 || day < 1 || day > 31) {
+        return false;
+    }
+
+    value = ExpiryDay::fromDate(year, month, day);
+    return true;
+}
+
+}  // namespace
+
+InstrumentCsvParser::InstrumentCsvParser(size_t numThreads, ThreadPool* pool)
+    : m_numThreads(pool ? numThreads : 1), m_pool(pool) {
+
+    if (m_numThreads == 0) {
+        m_numThreads = m_pool->getNumThreads() + 1;
+    }
+}
+
+CsvParseResult InstrumentCsvParser::parse(std::string_view csvData) const {
+    // Skip header line
+    size_t headerEnd = csvData.find('\n');
+    if (headerEnd == std::string_view::npos) {
+        return CsvParseResult();
+    }
+    std::string_view body = csvData.substr(headerEnd + 1);
+
+    // Split the body into line-aligned chunks of at least MIN_CHUNK_SIZE bytes
+    size_t numChunks = std::min(m_numThreads, std::max<size_t>(1, body.size() / MIN_CHUNK_SIZE));
+    std::vector<std::string_view> chunks;
+    chunks.reserve(numChunks);
+
+    size_t chunkStart = 0;
+    for (size_t i = 1; i < numChunks && chunkStart < body.size(); ++i) {
+        size_t target = std::max(chunkStart, body.size() * i / numChunks);
+        size_t chunkEnd = body.find('\n', target);
+        if (chunkEnd == std::string_view::npos) {
+            break;
+        }
+
+        chunks.push_back(body.substr(chunkStart, chunkEnd + 1 - chunkStart));
+        chunkStart = chunkEnd + 1;
+    }
+    if (chunkStart < body.size()) {
+        chunks.push_back(body.substr(chunkStart));
+    }
+
+    std::vector<CsvParseResult> partials(chunks.size());
+
+    if (chunks.size() <= 1) {
+        if (!chunks.empty()) {
+            parseChunk(chunks[0], partials[0]);
+        }
+    } else {
+        // One chunk at a time; the calling thread works through chunks too
+        m_pool->parallelFor(0, chunks.size(), [&chunks, &partials](size_t from, size_t to) {
+            for (size_t i = from; i < to; ++i) {
+                parseChunk(chunks[i], partials[i]);
+            }
+        }, 1);
+    }
+
+    // Concatenate the chunks in file order
+    CsvParseResult result;
+    if (partials.empty()) {
+        return result;
+    }
+
+    result = std::move(partials[0]);
+
+    size_t totalInstruments = result.instruments.size();
+    for (size_t i = 1; i < partials.size(); ++i) {
+        totalInstruments += partials[i].instruments.size();
+    }
+    result.instruments.reserve(totalInstruments);
+
+    for (size_t i = 1; i < partials.size(); ++i) {
+        auto& partial = partials[i];
+
+        if (result.firstError == CsvParseError::NONE && partial.firstError != CsvParseError::NONE) {
+            result.firstError = partial.firstError;
+            result.firstErrorLine = result.lineCount + partial.firstErrorLine;
+        }
+
+        result.lineCount += partial.lineCount;
+        result.errorCount += partial.errorCount;
+        std::move(partial.instruments.begin(), partial.instruments.end(),
+                  std::back_inserter(result.instruments));
+    }
+
+    return result;
+}
+
+void InstrumentCsvParser::Stream::feed(std::string_view data) {
+    // Complete the line left over from the previous piece
+    if (!m_partialLine.empty()) {
+        size_t lineEnd = data.find('\n');
+        if (lineEnd == std::string_view::npos) {
+            m_partialLine.append(data);
+            return;
+        }
+
+        m_partialLine.append(data.substr(0, lineEnd + 1));
+        data.remove_prefix(lineEnd + 1);
+
+        if (m_headerSkipped) {
+            parseChunk(m_partialLine, m_result);
+        }
+        m_headerSkipped = true;
+        m_partialLine.clear();
+    }
+
+    if (!m_headerSkipped) {
+        size_t headerEnd = data.find('\n');
+        if (headerEnd == std::string_view::npos) {
+            m_partialLine.assign(data);
+            return;
+        }
+
+        data.remove_prefix(headerEnd + 1);
+        m_headerSkipped = true;
+    }
+
+    // Parse up to the last newline and keep the rest for the next piece
+    size_t lastNewline = data.rfind('\n');
+    if (lastNewline == std::string_view::npos) {
+        m_partialLine.assign(data);
+        return;
+    }
+
+    parseChunk(data.substr(0, lastNewline + 1), m_result);
+    m_partialLine.assign(data.substr(lastNewline + 1));
+}
+
+CsvParseResult InstrumentCsvParser::Stream::finish() {
+    // A dump without a trailing newline ends in a partial line
+    if (m_headerSkipped && !m_partialLine.empty()) {
+        parseChunk(m_partialLine, m_result);
+    }
+    m_partialLine.clear();
+
+    return std::move(m_result);
+}
+
+void InstrumentCsvParser::parseChunk(std::string_view chunk, CsvParseResult& result) {
+    // Kite rows average a bit over 80 bytes; streamed pieces rely on normal growth
+    if (result.instruments.empty()) {
+        result.instruments.reserve(chunk.size() / 80 + 1);
+    }
+
+    size_t pos = 0;
+    while (pos < chunk.size()) {
+        size_t lineEnd = chunk.find('\n', pos);
+        if (lineEnd == std::string_view::npos) {
+            lineEnd = chunk.size();
+        }
+
+        std::string_view line = chunk.substr(pos, lineEnd - pos);
+        pos = lineEnd + 1;
+
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        if (line.empty()) {
+            continue;
+        }
+
+        result.lineCount++;
+
+        InstrumentRef instrument;
+        CsvParseError error = parseLine(line, instrument);
+
+        if (error != CsvParseError::NONE) {
+            if (result.errorCount == 0) {
+                result.firstError = error;
+                result.firstErrorLine = result.lineCount;
+            }
+            result.errorCount++;
+            continue;
+        }
+
+        result.instruments.push_back(std::move(instrument));
+    }
+}
+
+CsvParseError InstrumentCsvParser::tokenize(std::string_view line, Fields& fields, size_t& fieldCount) {
+    fieldCount = 0;
+
+    size_t pos = 0;
+    while (fieldCount < FIELD_COUNT) {
+        if (pos < line.size() && line[pos] == '"') {
+            // Quoted field; the quotes are stripped and embedded commas kept
+            size_t closing = line.find('"', pos + 1);
+            while (closing != std::string_view::npos &&
+                   closing + 1 < line.size() && line[closing + 1] == '"') {
+                closing = line.find('"', closing + 2);
+            }
+            if (closing == std::string_view::npos) {
+                return CsvParseError::UNTERMINATED_QUOTE;
+            }
+
+            fields[fieldCount++] = line.substr(pos + 1, closing - pos - 1);
+            pos = closing + 1;
+        } else {
+            size_t comma = std::min(line.find(',', pos), line.size());
+            fields[fieldCount++] = line.substr(pos, comma - pos);
+            pos = comma;
+        }
+
+        if (pos >= line.size()) {
+            break;
+        }
+
+        // Skip the separator
+        pos++;
+    }
+
+    return CsvParseError::NONE;
+}
+
+CsvParseError InstrumentCsvParser::parseLine(std::string_view line, InstrumentRef& instrument) {
+    Fields fields;
+    size_t fieldCount = 0;
+
+    CsvParseError error = tokenize(line, fields, fieldCount);
+    if (error != CsvParseError::NONE) {
+        return error;
+    }
+
+    // Ensure we have enough fields
+    if (fieldCount < 11) {
+        return CsvParseError::MISSING_FIELDS;
+    }
+
+    if (!parseUnsigned(fields[0], instrument.instrumentToken)) {
+        return CsvParseError::BAD_INSTRUMENT_TOKEN;
+    }
+
+    instrument.exchangeToken = fields[1];
+    instrument.tradingSymbol = fields[2];
+    instrument.name = fields[3];
+
+    if (!parseDecimal(fields[4], instrument.listedPrice)) {
+        return CsvParseError::BAD_LAST_PRICE;
+    }
+
+    // Expiries are stored as day counts, so no time zone conversion is needed per row
+    if (!fields[5].empty() && !parseExpiryDate(fields[5], instrument.expiry)) {
+        return CsvParseError::BAD_EXPIRY;
+    }
+
+    if (!parseDecimal(fields[6], instrument.strikePrice)) {
+        return CsvParseError::BAD_STRIKE_PRICE;
+    }
+
+    // Tick size (fields[7]) and lot size (fields[8]) are not used in our model
+
+    // Parse instrument type from Kite API
+    std::string_view typeStr = fields[9];
+    instrument.type = toInstrumentType(typeStr);
+    if (typeStr == "CE") {
+        instrument.optionType = OptionType::CALL;
+    } else if (typeStr == "PE") {
+        instrument.optionType = OptionType::PUT;
+    }
+
+    // Use segment to assist with instrument type detection
+    instrument.segment = fields[10];
+    if (fields[10].find("NFO-OPT") != std::string_view::npos) {
+        instrument.type = InstrumentType::OPTION;
+    } else if (fields[10].find("NFO-FUT") != std::string_view::npos) {
+        instrument.type = InstrumentType::FUTURE;
+    }
+
+    if (fieldCount > 11) {
+        instrument.exchange = fields[11];
+    }
+
+    // For NIFTY options/futures set the underlying field and extract info from trading symbol
+    std::string_view symbol = fields[2];
+    if (symbol.substr(0, 5) == "NIFTY") {
+        instrument.underlying = "NIFTY";
+
+        // Check for OPTION by examining trading symbol pattern (e.g., NIFTY23JUN2118000CE)
+        if (symbol.find("CE") != std::string_view::npos) {
+            instrument.type = InstrumentType::OPTION;
+            instrument.optionType = OptionType::CALL;
+        } else if (symbol.find("PE") != std::string_view::npos) {
+            instrument.type = InstrumentType::OPTION;
+            instrument.optionType = OptionType::PUT;
+        }
+        // Check for FUTURE by examining trading symbol pattern (e.g., NIFTYJUN23FUT)
+        else if (symbol.find("FUT") != std::string_view::npos) {
+            instrument.type = InstrumentType::FUTURE;
+        }
+    }
+
+    return CsvParseError::NONE;
+}
+
+InstrumentType InstrumentCsvParser::toInstrumentType(std::string_view typeStr) {
+    // Same mapping as InstrumentModel::stringToInstrumentType without building a std::string
+    if (typeStr == "INDEX" || typeStr == "INDICES")                 return InstrumentType::INDEX;
+    if (typeStr == "EQUITY" || typeStr == "EQ")                     return InstrumentType::EQUITY;
+    if (typeStr == "FUTURE" || typeStr == "FUT")                    return InstrumentType::FUTURE;
+    if (typeStr == "OPTION" || typeStr == "OPT" ||
+        typeStr == "CE" || typeStr == "PE")                         return InstrumentType::OPTION;
+    if (typeStr == "CURRENCY")                                      return InstrumentType::CURRENCY;
+    if (typeStr == "COMMODITY")                                     return InstrumentType::COMMODITY;
+
+    return InstrumentType::UNKNOWN;
+}
+
+const char* InstrumentCsvParser::errorToString(CsvParseError error) {
+    switch (error) {
+        case CsvParseError::NONE:                 return "none";
+        case CsvParseError::MISSING_FIELDS:       return "missing fields";
+        case CsvParseError::BAD_INSTRUMENT_TOKEN: return "bad instrument token";
+        case CsvParseError::BAD_LAST_PRICE:       return "bad last price";
+        case CsvParseError::BAD_STRIKE_PRICE:     return "bad strike price";
+        case CsvParseError::BAD_EXPIRY:           return "bad expiry";
+        case CsvParseError::UNTERMINATED_QUOTE:   return "unterminated quote";
+        default:                                  return "unknown";
+    }
+}
+
+}  // namespace BoxStrategy
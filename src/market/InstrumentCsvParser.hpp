@@ -0,0 +1,151 @@
+/**
+ * @file InstrumentCsvParser.hpp
+ * @brief Fast parser for the Kite instruments CSV dump
+ */
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <array>
+#include <cstddef>
+#include "../models/InstrumentModel.hpp"
+#include "../utils/ThreadPool.hpp"
+
+namespace BoxStrategy {
+
+/**
+ * @enum CsvParseError
+ * @brief Reasons a CSV line can be rejected
+ */
+enum class CsvParseError {
+    NONE,
+    MISSING_FIELDS,
+    BAD_INSTRUMENT_TOKEN,
+    BAD_LAST_PRICE,
+    BAD_STRIKE_PRICE,
+    BAD_EXPIRY,
+    UNTERMINATED_QUOTE
+};
+
+/**
+ * @struct CsvParseResult
+ * @brief Instruments and statistics produced by one parse
+ */
+struct CsvParseResult {
+    std::vector<InstrumentRef> instruments;            ///< Parsed instruments in file order
+    size_t lineCount = 0;                              ///< Data lines seen (header excluded)
+    size_t errorCount = 0;                             ///< Lines rejected
+    size_t firstErrorLine = 0;                         ///< 1-based data line of the first error
+    CsvParseError firstError = CsvParseError::NONE;    ///< First error code
+};
+
+/**
+ * @class InstrumentCsvParser
+ * @brief Tokenizes the instruments CSV in place with std::string_view
+ *
+ * Fields are sliced out of the input buffer without copies, numbers and
+ * expiry dates are converted with std::from_chars, and low-cardinality
+ * columns are interned. Bad lines are reported as error codes rather
+ * than exceptions. Large buffers are split on newline boundaries and
+ * parsed on a thread pool.
+ */
+class InstrumentCsvParser {
+public:
+    /**
+     * @class Stream
+     * @brief Parses a CSV dump that arrives in arbitrary pieces
+     *
+     * Complete lines are parsed as soon as they are fed; a trailing partial
+     * line is kept until the rest of it arrives. Parsing happens on the
+     * calling thread.
+     */
+    class Stream {
+    public:
+        /**
+         * @brief Parse the complete lines in the next piece of the dump
+         * @param data Next piece, header line included in the first pieces
+         */
+        void feed(std::string_view data);
+
+        /**
+         * @brief Parse any unterminated last line and return the result
+         * @return Parsed instruments and statistics
+         */
+        CsvParseResult finish();
+
+        /**
+         * @brief Get the number of instruments parsed so far
+         */
+        size_t instrumentCount() const { return m_result.instruments.size(); }
+
+    private:
+        std::string m_partialLine;      ///< Start of a line whose end has not arrived
+        bool m_headerSkipped = false;   ///< Whether the header line has been consumed
+        CsvParseResult m_result;        ///< Accumulated result
+    };
+
+    static constexpr size_t FIELD_COUNT = 12;          ///< Columns in the Kite instruments dump
+    static constexpr size_t MIN_CHUNK_SIZE = 256 * 1024; ///< Smallest buffer slice parsed as one chunk
+
+    /**
+     * @brief Constructor
+     * @param numThreads Maximum number of chunks parsed at once (0 = the pool's workers and the caller)
+     * @param pool Pool the chunks are parsed on; without one the caller parses the whole buffer
+     */
+    explicit InstrumentCsvParser(size_t numThreads = 1, ThreadPool* pool = nullptr);
+
+    /**
+     * @brief Parse a full CSV dump, header line included
+     * @param csvData CSV data
+     * @return Parsed instruments and statistics
+     */
+    CsvParseResult parse(std::string_view csvData) const;
+
+    /**
+     * @brief Convert an error code to a string
+     * @param error Error code
+     * @return Description of the error
+     */
+    static const char* errorToString(CsvParseError error);
+
+private:
+    using Fields = std::array<std::string_view, FIELD_COUNT>;
+
+    /**
+     * @brief Parse a range of complete lines
+     * @param chunk Buffer slice starting at a line boundary
+     * @param result Output for instruments and statistics
+     */
+    static void parseChunk(std::string_view chunk, CsvParseResult& result);
+
+    /**
+     * @brief Split a line into fields
+     * @param line Line without terminator
+     * @param fields Output fields (views into the line)
+     * @param fieldCount Output for the number of fields found
+     * @return NONE or UNTERMINATED_QUOTE
+     */
+    static CsvParseError tokenize(std::string_view line, Fields& fields, size_t& fieldCount);
+
+    /**
+     * @brief Convert one line into an instrument
+     * @param line Line without terminator
+     * @param instrument Output instrument
+     * @return NONE if successful, error code otherwise
+     */
+    static CsvParseError parseLine(std::string_view line, InstrumentRef& instrument);
+
+    /**
+     * @brief Map a Kite instrument type column to an instrument type
+     * @param typeStr Instrument type column
+     * @return Instrument type
+     */
+    static InstrumentType toInstrumentType(std::string_view typeStr);
+
+    size_t m_numThreads;  ///< Maximum number of chunks parsed at once
+    ThreadPool* m_pool;   ///< Pool the chunks are parsed on, or nullptr
+};
+
+}  // namespace BoxStrategy
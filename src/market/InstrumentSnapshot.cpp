@@ -0,0 +1,271 @@
+/**
+ * @file InstrumentSnapshot.cpp
+ * @brief Implementation of the InstrumentSnapshot class
+ */
+
+#include "../market/InstrumentSnapshot.hpp"
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+#include <unordered_map>
+#include <chrono>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace BoxStrategy {
+
+namespace {
+
+constexpr char SNAPSHOT_MAGIC[8] = {'B', 'X', 'I', 'N', 'S', 'T', 'R', '\0'};
+constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+/**
+ * @brief Builds the deduplicated string table while records are written
+ */
+class StringTableBuilder {
+public:
+    SnapshotString add(const std::string& value) {
+        auto it = m_offsets.find(value);
+        if (it != m_offsets.end()) {
+            return it->second;
+        }
+
+        SnapshotString ref{static_cast<uint32_t>(m_data.size()), static_cast<uint32_t>(value.size())};
+        m_data.append(value);
+        m_offsets.emplace(value, ref);
+        return ref;
+    }
+
+    const std::string& data() const { return m_data; }
+
+private:
+    std::string m_data;
+    std::unordered_map<std::string, SnapshotString> m_offsets;
+};
+
+}  // namespace
+
+InstrumentSnapshot::~InstrumentSnapshot() {
+    close();
+}
+
+bool InstrumentSnapshot::write(const std::string& path,
+                               const std::vector<InstrumentRef>& instruments,
+                               std::chrono::system_clock::time_point sourceTime,
+                               std::string* error) {
+    StringTableBuilder strings;
+    std::vector<InstrumentSnapshotRecord> records;
+    records.reserve(instruments.size());
+
+    for (const auto& instrument : instruments) {
+        InstrumentSnapshotRecord record;
+        std::memset(&record, 0, sizeof(record));
+
+        record.instrumentToken = instrument.instrumentToken;
+        record.strikePrice = instrument.strikePrice;
+        record.listedPrice = instrument.listedPrice;
+        record.expiryDay = instrument.expiry.day();
+        record.tradingSymbol = strings.add(instrument.tradingSymbol);
+        record.exchange = strings.add(instrument.exchange);
+        record.exchangeToken = strings.add(instrument.exchangeToken);
+        record.name = strings.add(instrument.name);
+        record.segment = strings.add(instrument.segment);
+        record.underlying = strings.add(instrument.underlying);
+        record.type = static_cast<uint8_t>(instrument.type);
+        record.optionType = static_cast<uint8_t>(instrument.optionType);
+
+        records.push_back(record);
+    }
+
+    InstrumentSnapshotHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = VERSION;
+    header.byteOrderMark = BYTE_ORDER_MARK;
+    header.headerSize = sizeof(InstrumentSnapshotHeader);
+    header.recordSize = sizeof(InstrumentSnapshotRecord);
+    header.recordCount = records.size();
+    header.recordsOffset = sizeof(InstrumentSnapshotHeader);
+    header.stringsOffset = header.recordsOffset + records.size() * sizeof(InstrumentSnapshotRecord);
+    header.stringsSize = strings.data().size();
+    header.createdAt = static_cast<int64_t>(
+        std::chrono::system_clock::to_time_t(std::chrono::system_clock::now()));
+    header.sourceTime = static_cast<int64_t>(std::chrono::system_clock::to_time_t(sourceTime));
+
+    // Write to a temporary file and rename so readers never map a partial snapshot
+    std::string tempPath = path + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            if (error) *error = "failed to open " + tempPath + " for writing";
+            return false;
+        }
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(records.data()),
+                   static_cast<std::streamsize>(records.size() * sizeof(InstrumentSnapshotRecord)));
+        file.write(strings.data().data(), static_cast<std::streamsize>(strings.data().size()));
+
+        if (!file.good()) {
+            if (error) *error = "failed to write " + tempPath;
+            std::remove(tempPath.c_str());
+            return false;
+        }
+    }
+
+    if (std::rename(tempPath.c_str(), path.c_str()) != 0) {
+        if (error) *error = "failed to rename " + tempPath + " to " + path;
+        std::remove(tempPath.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+bool InstrumentSnapshot::open(const std::string& path) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        m_lastError = "failed to open " + path;
+        return false;
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(InstrumentSnapshotHeader))) {
+        ::close(fd);
+        m_lastError = "snapshot " + path + " is truncated";
+        return false;
+    }
+
+    void* mapping = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+
+    if (mapping == MAP_FAILED) {
+        m_lastError = "failed to mmap " + path;
+        return false;
+    }
+
+    m_data = static_cast<const char*>(mapping);
+    m_size = static_cast<size_t>(st.st_size);
+    m_path = path;
+
+    if (!validate()) {
+        std::string reason = m_lastError;
+        close();
+        m_lastError = reason;
+        return false;
+    }
+
+    // Records are read sequentially when the universe is materialized
+    ::madvise(const_cast<char*>(m_data), m_size, MADV_SEQUENTIAL);
+
+    m_lastError.clear();
+    return true;
+}
+
+void InstrumentSnapshot::close() {
+    if (m_data) {
+        ::munmap(const_cast<char*>(m_data), m_size);
+    }
+
+    m_data = nullptr;
+    m_size = 0;
+    m_records = nullptr;
+    m_strings = nullptr;
+    m_path.clear();
+}
+
+bool InstrumentSnapshot::validate() {
+    const auto& hdr = header();
+
+    if (std::memcmp(hdr.magic, SNAPSHOT_MAGIC, sizeof(hdr.magic)) != 0) {
+        m_lastError = "bad magic";
+        return false;
+    }
+
+    if (hdr.version != VERSION) {
+        m_lastError = "unsupported version " + std::to_string(hdr.version);
+        return false;
+    }
+
+    if (hdr.byteOrderMark != BYTE_ORDER_MARK) {
+        m_lastError = "byte order mismatch";
+        return false;
+    }
+
+    if (hdr.headerSize != sizeof(InstrumentSnapshotHeader) ||
+        hdr.recordSize != sizeof(InstrumentSnapshotRecord)) {
+        m_lastError = "layout mismatch";
+        return false;
+    }
+
+    // Compare counts against the room left in the file so corrupt sizes cannot overflow
+    if (hdr.recordsOffset < sizeof(InstrumentSnapshotHeader) ||
+        hdr.recordsOffset % alignof(InstrumentSnapshotRecord) != 0 ||
+        hdr.recordsOffset > m_size ||
+        hdr.recordCount > (m_size - hdr.recordsOffset) / sizeof(InstrumentSnapshotRecord)) {
+        m_lastError = "section bounds exceed file size";
+        return false;
+    }
+
+    uint64_t recordsEnd = hdr.recordsOffset + hdr.recordCount * sizeof(InstrumentSnapshotRecord);
+    if (hdr.stringsOffset < recordsEnd ||
+        hdr.stringsOffset > m_size ||
+        hdr.stringsSize > m_size - hdr.stringsOffset) {
+        m_lastError = "section bounds exceed file size";
+        return false;
+    }
+
+    m_records = reinterpret_cast<const InstrumentSnapshotRecord*>(m_data + hdr.recordsOffset);
+    m_strings = m_data + hdr.stringsOffset;
+
+    // Every string reference must stay inside the string table
+    for (size_t i = 0; i < hdr.recordCount; ++i) {
+        const auto& rec = m_records[i];
+        for (const SnapshotString* ref : {&rec.tradingSymbol, &rec.exchange, &rec.exchangeToken,
+                                          &rec.name, &rec.segment, &rec.underlying}) {
+            if (static_cast<uint64_t>(ref->offset) + ref->length > hdr.stringsSize) {
+                m_lastError = "string reference out of range in record " + std::to_string(i);
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+InstrumentRef InstrumentSnapshot::toInstrument(size_t index) const {
+    const auto& rec = m_records[index];
+
+    InstrumentRef instrument;
+    instrument.instrumentToken = rec.instrumentToken;
+    instrument.tradingSymbol = std::string(string(rec.tradingSymbol));
+    instrument.exchange = string(rec.exchange);
+    instrument.exchangeToken = std::string(string(rec.exchangeToken));
+    instrument.name = string(rec.name);
+    instrument.segment = string(rec.segment);
+    instrument.underlying = string(rec.underlying);
+    instrument.type = static_cast<InstrumentType>(rec.type);
+    instrument.optionType = static_cast<OptionType>(rec.optionType);
+    instrument.strikePrice = rec.strikePrice;
+    instrument.listedPrice = rec.listedPrice;
+    instrument.expiry = ExpiryDay(rec.expiryDay);
+
+    return instrument;
+}
+
+std::vector<InstrumentRef> InstrumentSnapshot::toInstruments() const {
+    std::vector<InstrumentRef> instruments;
+    instruments.reserve(size());
+
+    for (size_t i = 0; i < size(); ++i) {
+        instruments.push_back(toInstrument(i));
+    }
+
+    return instruments;
+}
+
+}  // namespace BoxStrategy
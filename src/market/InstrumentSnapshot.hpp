@@ -0,0 +1,204 @@
+/**
+ * @file InstrumentSnapshot.hpp
+ * @brief Versioned, fixed-layout binary snapshot of the instrument universe
+ */
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <chrono>
+#include "../models/InstrumentModel.hpp"
+
+namespace BoxStrategy {
+
+/**
+ * @struct SnapshotString
+ * @brief Reference to a string stored in the snapshot string table
+ */
+struct SnapshotString {
+    uint32_t offset;                     ///< Byte offset into the string table
+    uint32_t length;                     ///< Length of the string in bytes
+};
+
+/**
+ * @struct InstrumentSnapshotHeader
+ * @brief Fixed header at the start of every snapshot file
+ */
+struct InstrumentSnapshotHeader {
+    char magic[8];                       ///< File magic, "BXINSTR" followed by a NUL
+    uint32_t version;                    ///< Format version
+    uint32_t byteOrderMark;              ///< Written as 0x01020304 in host byte order
+    uint32_t headerSize;                 ///< sizeof(InstrumentSnapshotHeader)
+    uint32_t recordSize;                 ///< sizeof(InstrumentSnapshotRecord)
+    uint64_t recordCount;                ///< Number of instrument records
+    uint64_t recordsOffset;              ///< Byte offset of the record array
+    uint64_t stringsOffset;              ///< Byte offset of the string table
+    uint64_t stringsSize;                ///< Size of the string table in bytes
+    int64_t createdAt;                   ///< Creation time in seconds since epoch
+    int64_t sourceTime;                  ///< Download time of the dump the snapshot was built from, seconds since epoch
+};
+
+/**
+ * @struct InstrumentSnapshotRecord
+ * @brief Fixed-size on-disk representation of one instrument
+ */
+struct InstrumentSnapshotRecord {
+    uint64_t instrumentToken;            ///< Unique identifier for the instrument
+    double strikePrice;                  ///< Strike price for options
+    double listedPrice;                  ///< Last price from the instruments dump
+    int32_t expiryDay;                   ///< Expiry in days since 1970-01-01 (0 if none)
+    uint32_t reserved0;                  ///< Padding, always zero
+    SnapshotString tradingSymbol;        ///< Trading symbol
+    SnapshotString exchange;             ///< Exchange
+    SnapshotString exchangeToken;        ///< Exchange token
+    SnapshotString name;                 ///< Name
+    SnapshotString segment;              ///< Segment
+    SnapshotString underlying;           ///< Underlying for derivatives
+    uint8_t type;                        ///< InstrumentType
+    uint8_t optionType;                  ///< OptionType
+    uint8_t reserved[6];                 ///< Padding, always zero
+};
+
+static_assert(sizeof(InstrumentSnapshotHeader) == 72, "Snapshot header layout changed");
+static_assert(sizeof(InstrumentSnapshotRecord) == 88, "Snapshot record layout changed");
+
+/**
+ * @class InstrumentSnapshot
+ * @brief Read-only, memory-mapped view of a binary instrument snapshot
+ *
+ * The snapshot is written once after each instruments download and opened
+ * with mmap on later loads, so reading it costs page faults instead of a
+ * full CSV parse. Its freshness is that of the dump it was built from
+ * (sourceTime), not of the file, so rewriting it never extends the TTL.
+ */
+class InstrumentSnapshot {
+public:
+    static constexpr uint32_t VERSION = 3;   ///< Current format version
+
+    /**
+     * @brief Constructor
+     */
+    InstrumentSnapshot() = default;
+
+    /**
+     * @brief Destructor, unmaps the file if open
+     */
+    ~InstrumentSnapshot();
+
+    InstrumentSnapshot(const InstrumentSnapshot&) = delete;
+    InstrumentSnapshot& operator=(const InstrumentSnapshot&) = delete;
+
+    /**
+     * @brief Write a snapshot file for the given instruments
+     * @param path Destination path (written via a temporary file and renamed)
+     * @param instruments Instruments to write
+     * @param sourceTime When the instruments dump was downloaded
+     * @param error Optional output for a description of the failure
+     * @return True if successful, false otherwise
+     */
+    static bool write(const std::string& path,
+                      const std::vector<InstrumentRef>& instruments,
+                      std::chrono::system_clock::time_point sourceTime,
+                      std::string* error = nullptr);
+
+    /**
+     * @brief Map and validate a snapshot file
+     * @param path Snapshot path
+     * @return True if the file was mapped and passed validation
+     */
+    bool open(const std::string& path);
+
+    /**
+     * @brief Unmap the current file
+     */
+    void close();
+
+    /**
+     * @brief Whether a snapshot is currently mapped
+     * @return True if mapped
+     */
+    bool isOpen() const { return m_data != nullptr; }
+
+    /**
+     * @brief Get the number of records
+     * @return Record count
+     */
+    size_t size() const { return m_records ? static_cast<size_t>(header().recordCount) : 0; }
+
+    /**
+     * @brief Get the mapped header
+     * @return Snapshot header
+     */
+    const InstrumentSnapshotHeader& header() const {
+        return *reinterpret_cast<const InstrumentSnapshotHeader*>(m_data);
+    }
+
+    /**
+     * @brief Get when the dump the snapshot was built from was downloaded
+     * @return Download time
+     */
+    std::chrono::system_clock::time_point sourceTime() const {
+        return std::chrono::system_clock::time_point(std::chrono::seconds(header().sourceTime));
+    }
+
+    /**
+     * @brief Get a record by index
+     * @param index Record index
+     * @return Record reference into the mapping
+     */
+    const InstrumentSnapshotRecord& record(size_t index) const { return m_records[index]; }
+
+    /**
+     * @brief Resolve a string reference against the string table
+     * @param ref String reference
+     * @return View into the mapping
+     */
+    std::string_view string(const SnapshotString& ref) const {
+        return std::string_view(m_strings + ref.offset, ref.length);
+    }
+
+    /**
+     * @brief Materialize a record as an InstrumentRef
+     * @param index Record index
+     * @return Instrument model
+     */
+    InstrumentRef toInstrument(size_t index) const;
+
+    /**
+     * @brief Materialize all records
+     * @return Vector of instrument models
+     */
+    std::vector<InstrumentRef> toInstruments() const;
+
+    /**
+     * @brief Get the path of the mapped file
+     * @return File path
+     */
+    const std::string& path() const { return m_path; }
+
+    /**
+     * @brief Get a description of the last open failure
+     * @return Error text
+     */
+    const std::string& lastError() const { return m_lastError; }
+
+private:
+    /**
+     * @brief Validate the mapped header and section bounds
+     * @return True if valid
+     */
+    bool validate();
+
+    const char* m_data = nullptr;                        ///< Start of the mapping
+    size_t m_size = 0;                                   ///< Size of the mapping
+    const InstrumentSnapshotRecord* m_records = nullptr; ///< Record array
+    const char* m_strings = nullptr;                     ///< String table
+    std::string m_path;                                  ///< Mapped file path
+    std::string m_lastError;                             ///< Last error description
+};
+
+}  // namespace BoxStrategy
@@ -0,0 +1,325 @@
+/**
+ * @file InstrumentUniverse.cpp
+ * @brief Implementation of the InstrumentUniverse class
+ */
+
+#include "../market/InstrumentUniverse.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace BoxStrategy {
+
+InstrumentUniverse::InstrumentUniverse(std::vector<InstrumentRef> instruments, uint64_t version)
+    : m_instruments(std::move(instruments)),
+      m_version(version),
+      m_buildTime(std::chrono::system_clock::now()) {
+
+    buildIndexes();
+    buildOptionChainIndex();
+}
+
+InstrumentUniverse::InstrumentUniverse(const InstrumentUniverse& previous,
+                                       std::vector<InstrumentRef> instruments,
+                                       const std::vector<uint32_t>& ordinalMap,
+                                       const std::set<ChainSlot>& rebuild,
+                                       uint64_t version)
+    : m_instruments(std::move(instruments)),
+      m_version(version),
+      m_buildTime(std::chrono::system_clock::now()) {
+
+    buildIndexes();
+
+    // Untouched chains keep their order; only their pointers move to the new instruments
+    auto remap = [&](const InstrumentRef* instrument) -> const InstrumentRef* {
+        return instrument ? &m_instruments[ordinalMap[previous.ordinalOf(instrument)]] : nullptr;
+    };
+
+    for (const auto& chains : previous.m_optionChainIndex) {
+        for (const auto& expiryChain : chains.second) {
+            if (rebuild.count(ChainSlot(chains.first, expiryChain.first)) != 0) {
+                continue;
+            }
+
+            OptionChain& chain = m_optionChainIndex[chains.first][expiryChain.first];
+            chain.reserve(expiryChain.second.size());
+            for (const auto& entry : expiryChain.second) {
+                chain.push_back(OptionChainEntry{entry.strike, remap(entry.call), remap(entry.put)});
+            }
+        }
+    }
+
+    buildOptionChainIndex(&rebuild);
+}
+
+void InstrumentUniverse::buildIndexes() {
+    m_tokenIndex.reserve(m_instruments.size());
+    m_symbolIndex.reserve(m_instruments.size());
+
+    for (size_t i = 0; i < m_instruments.size(); ++i) {
+        const auto& instrument = m_instruments[i];
+
+        m_tokenIndex[instrument.instrumentToken] = i;
+        m_symbolIndex[symbolKey(instrument.tradingSymbol, instrument.exchange)] = i;
+        m_exchangeIndex[instrument.exchange].push_back(&instrument);
+    }
+}
+
+bool InstrumentUniverse::chainSlotOf(const InstrumentRef& instrument, ChainSlot& slot) {
+    if (instrument.type != InstrumentType::OPTION ||
+        (instrument.optionType != OptionType::CALL && instrument.optionType != OptionType::PUT)) {
+        return false;
+    }
+
+    // Prefer the parsed underlying, fall back to the instrument name
+    InternedString underlying = instrument.underlying.empty() ? instrument.name : instrument.underlying;
+    if (underlying.empty()) {
+        return false;
+    }
+
+    slot = ChainSlot(chainKey(underlying, instrument.exchange), instrument.expiry);
+    return true;
+}
+
+void InstrumentUniverse::buildOptionChainIndex(const std::set<ChainSlot>* only) {
+    std::vector<OptionChain*> built;
+    ChainSlot slot;
+
+    for (const auto& instrument : m_instruments) {
+        if (!chainSlotOf(instrument, slot) || (only && only->count(slot) == 0)) {
+            continue;
+        }
+
+        OptionChain& chain = m_optionChainIndex[slot.first][slot.second];
+        if (chain.empty()) {
+            built.push_back(&chain);
+        }
+
+        chain.push_back(OptionChainEntry{instrument.strikePrice,
+                                         instrument.optionType == OptionType::CALL ? &instrument : nullptr,
+                                         instrument.optionType == OptionType::PUT ? &instrument : nullptr});
+    }
+
+    // Sort each chain by strike and merge calls and puts of the same strike.
+    // If a strike is listed twice for one side, the first instrument in load order wins.
+    for (OptionChain* chain : built) {
+        std::stable_sort(chain->begin(), chain->end(),
+                         [](const OptionChainEntry& a, const OptionChainEntry& b) {
+                             return a.strike < b.strike;
+                         });
+
+        OptionChain merged;
+        merged.reserve(chain->size() / 2 + 1);
+
+        for (const auto& entry : *chain) {
+            if (merged.empty() || std::abs(merged.back().strike - entry.strike) >= 0.01) {
+                merged.push_back(entry);
+                continue;
+            }
+
+            OptionChainEntry& last = merged.back();
+            if (!last.call) last.call = entry.call;
+            if (!last.put) last.put = entry.put;
+        }
+
+        merged.shrink_to_fit();
+        *chain = std::move(merged);
+    }
+}
+
+InstrumentUniverseDelta InstrumentUniverse::diff(const std::vector<InstrumentRef>& instruments) const {
+    InstrumentUniverseDelta delta;
+    delta.fromVersion = m_version;
+
+    std::set<ChainSlot> slots;
+    std::vector<bool> seen(m_instruments.size(), false);
+    ChainSlot slot;
+
+    auto touch = [&](const InstrumentRef& instrument) {
+        if (chainSlotOf(instrument, slot) && slots.insert(slot).second) {
+            InternedString underlying = instrument.underlying.empty() ? instrument.name : instrument.underlying;
+            delta.affectedChains.push_back(OptionChainId{underlying, instrument.exchange, instrument.expiry});
+        }
+    };
+
+    for (const auto& instrument : instruments) {
+        auto it = m_tokenIndex.find(instrument.instrumentToken);
+        if (it == m_tokenIndex.end()) {
+            delta.added.push_back(instrument.instrumentToken);
+            touch(instrument);
+            continue;
+        }
+
+        seen[it->second] = true;
+        const InstrumentRef& current = m_instruments[it->second];
+
+        if (!sameReferenceData(current, instrument)) {
+            delta.changed.push_back(instrument.instrumentToken);
+            touch(current);
+            touch(instrument);
+        }
+    }
+
+    for (size_t i = 0; i < m_instruments.size(); ++i) {
+        if (!seen[i]) {
+            delta.removed.push_back(m_instruments[i].instrumentToken);
+            touch(m_instruments[i]);
+        }
+    }
+
+    return delta;
+}
+
+std::shared_ptr<const InstrumentUniverse> InstrumentUniverse::applyDelta(
+    std::vector<InstrumentRef> instruments,
+    const InstrumentUniverseDelta& delta,
+    uint64_t version,
+    std::vector<uint32_t>& ordinalMap) const {
+
+    std::unordered_map<uint64_t, size_t> incoming;
+    incoming.reserve(instruments.size());
+    for (size_t i = 0; i < instruments.size(); ++i) {
+        incoming.emplace(instruments[i].instrumentToken, i);
+    }
+
+    // Survivors first, in their old order, then the added instruments in dump order
+    std::vector<InstrumentRef> ordered;
+    ordered.reserve(instruments.size());
+    ordinalMap.assign(m_instruments.size(), NO_ORDINAL);
+
+    for (size_t i = 0; i < m_instruments.size(); ++i) {
+        auto it = incoming.find(m_instruments[i].instrumentToken);
+        if (it != incoming.end()) {
+            ordinalMap[i] = static_cast<uint32_t>(ordered.size());
+            ordered.push_back(std::move(instruments[it->second]));
+            incoming.erase(it);
+        }
+    }
+
+    // A token listed twice in the dump is taken once
+    for (uint64_t token : delta.added) {
+        auto it = incoming.find(token);
+        if (it != incoming.end()) {
+            ordered.push_back(std::move(instruments[it->second]));
+            incoming.erase(it);
+        }
+    }
+
+    std::set<ChainSlot> rebuild;
+    for (const auto& chain : delta.affectedChains) {
+        rebuild.emplace(chainKey(chain.underlying, chain.exchange), chain.expiry);
+    }
+
+    return std::shared_ptr<const InstrumentUniverse>(
+        new InstrumentUniverse(*this, std::move(ordered), ordinalMap, rebuild, version));
+}
+
+bool InstrumentUniverse::sameReferenceData(const InstrumentRef& a, const InstrumentRef& b) {
+    return a.instrumentToken == b.instrumentToken &&
+           a.tradingSymbol == b.tradingSymbol &&
+           a.exchange == b.exchange &&
+           a.exchangeToken == b.exchangeToken &&
+           a.name == b.name &&
+           a.type == b.type &&
+           a.segment == b.segment &&
+           a.underlying == b.underlying &&
+           a.strikePrice == b.strikePrice &&
+           a.optionType == b.optionType &&
+           a.expiry == b.expiry;
+}
+
+bool InstrumentUniverseDelta::affectsUnderlying(InternedString underlying, InternedString exchange) const {
+    if (rebuilt) {
+        return true;
+    }
+
+    for (const auto& chain : affectedChains) {
+        if (chain.underlying == underlying && chain.exchange == exchange) {
+            return true;
+        }
+    }
+    return false;
+}
+
+const InstrumentRef* InstrumentUniverse::findByToken(uint64_t instrumentToken) const {
+    auto it = m_tokenIndex.find(instrumentToken);
+    return it != m_tokenIndex.end() ? &m_instruments[it->second] : nullptr;
+}
+
+bool InstrumentUniverse::findOrdinal(uint64_t instrumentToken, uint32_t& ordinal) const {
+    auto it = m_tokenIndex.find(instrumentToken);
+    if (it == m_tokenIndex.end()) {
+        return false;
+    }
+
+    ordinal = static_cast<uint32_t>(it->second);
+    return true;
+}
+
+const InstrumentRef* InstrumentUniverse::findBySymbol(
+    const std::string& tradingSymbol, const std::string& exchange) const {
+
+    auto it = m_symbolIndex.find(symbolKey(tradingSymbol, exchange));
+    return it != m_symbolIndex.end() ? &m_instruments[it->second] : nullptr;
+}
+
+const std::vector<const InstrumentRef*>& InstrumentUniverse::getByExchange(
+    InternedString exchange) const {
+
+    static const std::vector<const InstrumentRef*> empty;
+
+    auto it = m_exchangeIndex.find(exchange);
+    return it != m_exchangeIndex.end() ? it->second : empty;
+}
+
+const OptionChainsByExpiry& InstrumentUniverse::getOptionChains(
+    InternedString underlying, InternedString exchange) const {
+
+    static const OptionChainsByExpiry empty;
+
+    auto it = m_optionChainIndex.find(chainKey(underlying, exchange));
+    return it != m_optionChainIndex.end() ? it->second : empty;
+}
+
+const OptionChain* InstrumentUniverse::findOptionChain(
+    InternedString underlying,
+    InternedString exchange,
+    ExpiryDay expiry) const {
+
+    const auto& chains = getOptionChains(underlying, exchange);
+
+    auto it = chains.find(expiry);
+    return it != chains.end() ? &it->second : nullptr;
+}
+
+const OptionChainEntry* InstrumentUniverse::findOptionStrike(
+    InternedString underlying,
+    InternedString exchange,
+    ExpiryDay expiry,
+    double strike) const {
+
+    const OptionChain* chain = findOptionChain(underlying, exchange, expiry);
+    return chain ? findChainStrike(*chain, strike) : nullptr;
+}
+
+const OptionChainEntry* findChainStrike(const OptionChain& chain, double strike) {
+    auto it = std::lower_bound(chain.begin(), chain.end(), strike - 0.01,
+                               [](const OptionChainEntry& entry, double value) {
+                                   return entry.strike < value;
+                               });
+
+    if (it != chain.end() && std::abs(it->strike - strike) < 0.01) {
+        return &*it;
+    }
+
+    return nullptr;
+}
+
+uint64_t InstrumentUniverse::chainKey(InternedString underlying, InternedString exchange) {
+    return (static_cast<uint64_t>(underlying.id()) << 32) | exchange.id();
+}
+
+std::string InstrumentUniverse::symbolKey(const std::string& tradingSymbol, const std::string& exchange) {
+    return tradingSymbol + ":" + exchange;
+}
+
+}  // namespace BoxStrategy
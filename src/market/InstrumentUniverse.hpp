@@ -0,0 +1,322 @@
+/**
+ * @file InstrumentUniverse.hpp
+ * @brief Immutable, indexed set of all instruments from one instruments refresh
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <map>
+#include <set>
+#include <limits>
+#include <memory>
+#include <chrono>
+#include <cstdint>
+#include "../models/InstrumentModel.hpp"
+
+namespace BoxStrategy {
+
+/**
+ * @struct OptionChainEntry
+ * @brief Call and put of one strike in an option chain
+ */
+struct OptionChainEntry {
+    double strike = 0.0;                       ///< Strike price
+    const InstrumentRef* call = nullptr;     ///< Call option (nullptr if not listed)
+    const InstrumentRef* put = nullptr;      ///< Put option (nullptr if not listed)
+};
+
+/**
+ * @brief Option chain of one expiry, sorted by strike
+ */
+using OptionChain = std::vector<OptionChainEntry>;
+
+/**
+ * @brief Option chains of one underlying, ordered by expiry
+ */
+using OptionChainsByExpiry = std::map<ExpiryDay, OptionChain>;
+
+/**
+ * @brief Find a strike in a chain using binary search
+ * @param chain Chain sorted by strike
+ * @param strike Strike price (matched within 0.01)
+ * @return Chain entry, or nullptr if not found
+ */
+const OptionChainEntry* findChainStrike(const OptionChain& chain, double strike);
+
+/**
+ * @struct OptionChainId
+ * @brief Identifies the option chain of one underlying, exchange and expiry
+ */
+struct OptionChainId {
+    InternedString underlying;     ///< Underlying name
+    InternedString exchange;       ///< Exchange name
+    ExpiryDay expiry;              ///< Expiry day
+};
+
+/**
+ * @struct InstrumentUniverseDelta
+ * @brief Difference between two instrument universes
+ *
+ * Tokens are reported as added, removed or changed, where changed means the
+ * same token with different reference data. The dump's listed price does
+ * not count as a change. Option chains that gained, lost or changed an
+ * option are listed so caches can drop just those chains.
+ */
+struct InstrumentUniverseDelta {
+    uint64_t fromVersion = 0;                  ///< Version of the universe that was replaced
+    uint64_t toVersion = 0;                    ///< Version of the new universe
+    bool rebuilt = false;                      ///< True if the universe was rebuilt without a diff
+    std::vector<uint64_t> added;               ///< Tokens only in the new universe
+    std::vector<uint64_t> removed;             ///< Tokens only in the old universe
+    std::vector<uint64_t> changed;             ///< Tokens whose reference data changed
+    std::vector<OptionChainId> affectedChains; ///< Chains with an added, removed or changed option
+
+    /**
+     * @brief Check if nothing changed
+     * @return True if there are no added, removed or changed tokens
+     */
+    bool empty() const { return !rebuilt && added.empty() && removed.empty() && changed.empty(); }
+
+    /**
+     * @brief Check if any chain of an underlying was affected
+     * @param underlying Underlying name
+     * @param exchange Exchange name
+     * @return True if rebuilt or any expiry of the underlying is in affectedChains
+     */
+    bool affectsUnderlying(InternedString underlying, InternedString exchange) const;
+};
+
+/**
+ * @class InstrumentUniverse
+ * @brief Immutable instrument universe built once per instruments refresh
+ *
+ * A universe is built once from a parsed instruments dump and published as
+ * std::shared_ptr<const InstrumentUniverse>. All readers share the same
+ * snapshot without copying; a refresh builds and publishes a new universe
+ * while readers holding the old pointer keep using it safely.
+ */
+class InstrumentUniverse {
+public:
+    static constexpr uint32_t NO_ORDINAL = std::numeric_limits<uint32_t>::max();  ///< Instrument not carried over
+
+    /**
+     * @brief Constructor, builds all lookup indexes
+     * @param instruments Parsed instruments (moved into the universe)
+     * @param version Monotonic version number of this universe
+     */
+    InstrumentUniverse(std::vector<InstrumentRef> instruments, uint64_t version);
+
+    InstrumentUniverse(const InstrumentUniverse&) = delete;
+    InstrumentUniverse& operator=(const InstrumentUniverse&) = delete;
+
+    /**
+     * @brief Get all instruments
+     * @return Instruments in load order; an instrument's index is its ordinal
+     */
+    const std::vector<InstrumentRef>& getInstruments() const { return m_instruments; }
+
+    /**
+     * @brief Get the number of instruments
+     * @return Instrument count
+     */
+    size_t size() const { return m_instruments.size(); }
+
+    /**
+     * @brief Check if the universe is empty
+     * @return True if there are no instruments
+     */
+    bool empty() const { return m_instruments.empty(); }
+
+    /**
+     * @brief Find an instrument by token
+     * @param instrumentToken Instrument token
+     * @return Pointer to the instrument or nullptr if not found
+     */
+    const InstrumentRef* findByToken(uint64_t instrumentToken) const;
+
+    /**
+     * @brief Get an instrument by its ordinal
+     * @param ordinal Dense index in [0, size())
+     * @return Instrument reference data
+     */
+    const InstrumentRef& at(uint32_t ordinal) const { return m_instruments[ordinal]; }
+
+    /**
+     * @brief Get the dense ordinal of an instrument owned by this universe
+     * @param instrument Instrument returned by this universe
+     * @return Ordinal, usable as an index into per-instrument columns
+     */
+    uint32_t ordinalOf(const InstrumentRef* instrument) const {
+        return static_cast<uint32_t>(instrument - m_instruments.data());
+    }
+
+    /**
+     * @brief Find the ordinal of an instrument by token
+     * @param instrumentToken Instrument token
+     * @param ordinal Output ordinal
+     * @return True if found
+     */
+    bool findOrdinal(uint64_t instrumentToken, uint32_t& ordinal) const;
+
+    /**
+     * @brief Find an instrument by trading symbol and exchange
+     * @param tradingSymbol Trading symbol
+     * @param exchange Exchange name
+     * @return Pointer to the instrument or nullptr if not found
+     */
+    const InstrumentRef* findBySymbol(const std::string& tradingSymbol,
+                                        const std::string& exchange) const;
+
+    /**
+     * @brief Get all instruments of an exchange
+     * @param exchange Exchange name
+     * @return Instruments of the exchange in load order (empty if unknown)
+     */
+    const std::vector<const InstrumentRef*>& getByExchange(InternedString exchange) const;
+
+    /**
+     * @brief Get all option chains of an underlying
+     * @param underlying Underlying name (e.g. "NIFTY")
+     * @param exchange Exchange name
+     * @return Chains ordered by expiry (empty if unknown)
+     */
+    const OptionChainsByExpiry& getOptionChains(InternedString underlying,
+                                                InternedString exchange) const;
+
+    /**
+     * @brief Find the option chain of one expiry
+     * @param underlying Underlying name
+     * @param exchange Exchange name
+     * @param expiry Expiry day
+     * @return Chain sorted by strike, or nullptr if not found
+     */
+    const OptionChain* findOptionChain(InternedString underlying,
+                                       InternedString exchange,
+                                       ExpiryDay expiry) const;
+
+    /**
+     * @brief Find the call/put entry of one strike using binary search
+     * @param underlying Underlying name
+     * @param exchange Exchange name
+     * @param expiry Expiry day
+     * @param strike Strike price (matched within 0.01)
+     * @return Chain entry, or nullptr if not found
+     */
+    const OptionChainEntry* findOptionStrike(InternedString underlying,
+                                             InternedString exchange,
+                                             ExpiryDay expiry,
+                                             double strike) const;
+
+    /**
+     * @brief Compare a freshly parsed dump against this universe
+     * @param instruments Parsed instruments of the new dump
+     * @return Added, removed and changed tokens and the affected chains
+     */
+    InstrumentUniverseDelta diff(const std::vector<InstrumentRef>& instruments) const;
+
+    /**
+     * @brief Build the universe that follows this one
+     *
+     * Instruments that survive keep their relative order and added ones are
+     * appended, so old ordinals map onto new ones. Option chains the delta
+     * does not touch are copied over rather than re-sorted; only the
+     * affected chains are rebuilt.
+     *
+     * @param instruments Parsed instruments of the new dump (the one diffed)
+     * @param delta Result of diff() on the same instruments
+     * @param version Version of the new universe
+     * @param ordinalMap Output: new ordinal for every old ordinal, or NO_ORDINAL if removed
+     * @return New universe
+     */
+    std::shared_ptr<const InstrumentUniverse> applyDelta(
+        std::vector<InstrumentRef> instruments,
+        const InstrumentUniverseDelta& delta,
+        uint64_t version,
+        std::vector<uint32_t>& ordinalMap) const;
+
+    /**
+     * @brief Get the version of this universe
+     * @return Version number, increases with every refresh
+     */
+    uint64_t getVersion() const { return m_version; }
+
+    /**
+     * @brief Get the time this universe was built
+     * @return Build time
+     */
+    std::chrono::system_clock::time_point getBuildTime() const { return m_buildTime; }
+
+private:
+    /**
+     * @brief Chain index key plus expiry, used to select chains to rebuild
+     */
+    using ChainSlot = std::pair<uint64_t, ExpiryDay>;
+
+    /**
+     * @brief Constructor for applyDelta, reuses the chains of the previous universe
+     * @param previous Universe being replaced
+     * @param instruments Instruments already in successor order
+     * @param ordinalMap Old ordinal to new ordinal
+     * @param rebuild Chains to rebuild from the instruments
+     * @param version Version of this universe
+     */
+    InstrumentUniverse(const InstrumentUniverse& previous,
+                       std::vector<InstrumentRef> instruments,
+                       const std::vector<uint32_t>& ordinalMap,
+                       const std::set<ChainSlot>& rebuild,
+                       uint64_t version);
+
+    /**
+     * @brief Build the token, symbol and exchange indexes
+     */
+    void buildIndexes();
+
+    /**
+     * @brief Build a symbol lookup key
+     * @param tradingSymbol Trading symbol
+     * @param exchange Exchange name
+     * @return Lookup key
+     */
+    static std::string symbolKey(const std::string& tradingSymbol, const std::string& exchange);
+
+    /**
+     * @brief Build an option chain lookup key from the interned IDs
+     * @param underlying Underlying name
+     * @param exchange Exchange name
+     * @return Lookup key
+     */
+    static uint64_t chainKey(InternedString underlying, InternedString exchange);
+
+    /**
+     * @brief Get the chain an instrument belongs to
+     * @param instrument Instrument
+     * @param slot Output chain key and expiry
+     * @return False if the instrument is not a call or put with an underlying
+     */
+    static bool chainSlotOf(const InstrumentRef& instrument, ChainSlot& slot);
+
+    /**
+     * @brief Compare reference data, ignoring the listed price
+     * @return True if both describe the same contract
+     */
+    static bool sameReferenceData(const InstrumentRef& a, const InstrumentRef& b);
+
+    /**
+     * @brief Build the option chain index from the loaded instruments
+     * @param only Build just these chains (nullptr = all)
+     */
+    void buildOptionChainIndex(const std::set<ChainSlot>* only = nullptr);
+
+    std::vector<InstrumentRef> m_instruments;                                  ///< All instruments
+    std::unordered_map<uint64_t, size_t> m_tokenIndex;                           ///< Token to index
+    std::unordered_map<std::string, size_t> m_symbolIndex;                       ///< Symbol:exchange to index
+    std::unordered_map<InternedString, std::vector<const InstrumentRef*>> m_exchangeIndex; ///< Exchange to instruments
+    std::unordered_map<uint64_t, OptionChainsByExpiry> m_optionChainIndex;     ///< Underlying:exchange to chains
+    uint64_t m_version;                                                          ///< Universe version
+    std::chrono::system_clock::time_point m_buildTime;                           ///< Build time
+};
+
+}  // namespace BoxStrategy
@@ -0,0 +1,274 @@
+/**
+ * @file MarketDataJournal.cpp
+ * @brief Implementation of the MarketDataJournal and JournalReader classes
+ */
+
+#include "../market/MarketDataJournal.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <map>
+
+namespace BoxStrategy {
+
+namespace {
+
+constexpr char JOURNAL_MAGIC[8] = {'B', 'X', 'J', 'R', 'N', 'L', '\0', '\0'};
+constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+}  // namespace
+
+MarketDataJournal::MarketDataJournal(std::shared_ptr<Logger> logger)
+    : m_logger(std::move(logger)) {}
+
+MarketDataJournal::~MarketDataJournal() {
+    close();
+}
+
+bool MarketDataJournal::open(const std::string& path) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_file.is_open()) {
+        m_file.close();
+    }
+
+    std::error_code sizeError;
+    auto existingSize = std::filesystem::file_size(path, sizeError);
+    bool fresh = sizeError || existingSize == 0;
+
+    // An existing journal is appended to only if it was written in this format
+    if (!fresh) {
+        JournalReader reader;
+        if (!reader.open(path)) {
+            m_logger->error("Refusing to append to journal {}: {}", path, reader.lastError());
+            return false;
+        }
+
+        // Cut off a record left incomplete by a crash, or later records would be unreachable
+        uint64_t validSize = reader.completeSize(existingSize);
+        if (validSize < existingSize) {
+            m_logger->warn("Truncating incomplete record at the end of journal {} ({} bytes)",
+                           path, existingSize - validSize);
+            std::filesystem::resize_file(path, validSize, sizeError);
+        }
+    }
+
+    m_file.open(path, std::ios::out | std::ios::binary | std::ios::app);
+    if (!m_file.is_open()) {
+        m_logger->error("Failed to open journal {} for appending", path);
+        return false;
+    }
+
+    if (fresh) {
+        JournalFileHeader header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, JOURNAL_MAGIC, sizeof(header.magic));
+        header.version = VERSION;
+        header.byteOrderMark = BYTE_ORDER_MARK;
+        header.headerSize = sizeof(JournalFileHeader);
+        header.recordHeaderSize = sizeof(JournalRecordHeader);
+        header.createdAt = std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+
+        m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        m_file.flush();
+    }
+
+    m_path = path;
+    m_records = 0;
+    m_bytes = 0;
+
+    m_logger->info("Journaling market data to {}", path);
+    return m_file.good();
+}
+
+bool MarketDataJournal::isOpen() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_file.is_open();
+}
+
+void MarketDataJournal::append(JournalRecordKind kind, std::string_view key, std::string_view payload) {
+    JournalRecordHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.timestampUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    header.keySize = static_cast<uint32_t>(key.size());
+    header.payloadSize = static_cast<uint32_t>(payload.size());
+    header.kind = static_cast<uint8_t>(kind);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (!m_file.is_open()) {
+        return;
+    }
+
+    m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    m_file.write(key.data(), key.size());
+    m_file.write(payload.data(), payload.size());
+
+    // Ticks arrive many times a second; responses are rare enough to flush each one
+    if (kind != JournalRecordKind::TICKS) {
+        m_file.flush();
+    }
+
+    if (!m_file.good()) {
+        m_logger->error("Failed to write to journal {}, closing it", m_path);
+        m_file.close();
+        return;
+    }
+
+    m_records++;
+    m_bytes += sizeof(header) + key.size() + payload.size();
+}
+
+void MarketDataJournal::flush() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_file.is_open()) {
+        m_file.flush();
+    }
+}
+
+void MarketDataJournal::close() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_file.is_open()) {
+        m_file.close();
+        m_logger->info("Closed journal {} after {} records ({:.1f} MB)",
+                       m_path, m_records.load(), m_bytes.load() / (1024.0 * 1024.0));
+    }
+}
+
+std::string MarketDataJournal::requestKey(const std::string& endpoint,
+                                          const std::unordered_map<std::string, std::string>& params) {
+    std::map<std::string, std::string> ordered(params.begin(), params.end());
+    std::string key = endpoint;
+    char separator = '?';
+
+    for (const auto& param : ordered) {
+        // Split "a&i=b&i=c" back into its values
+        std::vector<std::string> values;
+        std::string repeat = "&" + param.first + "=";
+        size_t start = 0;
+
+        while (true) {
+            size_t end = param.second.find(repeat, start);
+            values.push_back(param.second.substr(start, end == std::string::npos ? std::string::npos : end - start));
+            if (end == std::string::npos) {
+                break;
+            }
+            start = end + repeat.size();
+        }
+
+        std::sort(values.begin(), values.end());
+
+        key += separator;
+        key += param.first;
+        key += '=';
+        for (size_t i = 0; i < values.size(); ++i) {
+            if (i > 0) {
+                key += ',';
+            }
+            key += values[i];
+        }
+        separator = '&';
+    }
+
+    return key;
+}
+
+JournalRecordKind MarketDataJournal::kindForEndpoint(const std::string& endpoint) {
+    if (endpoint == "/instruments") return JournalRecordKind::INSTRUMENTS;
+    if (endpoint == "/quote") return JournalRecordKind::QUOTE;
+    if (endpoint == "/quote/ltp") return JournalRecordKind::LTP;
+    if (endpoint == "/quote/ohlc") return JournalRecordKind::OHLC;
+    return JournalRecordKind::OTHER;
+}
+
+bool JournalReader::open(const std::string& path) {
+    m_file.close();
+    m_file.clear();
+    m_file.open(path, std::ios::in | std::ios::binary);
+
+    if (!m_file.is_open()) {
+        m_error = "cannot open file";
+        return false;
+    }
+
+    if (!m_file.read(reinterpret_cast<char*>(&m_header), sizeof(m_header))) {
+        m_error = "file is shorter than the journal header";
+        return false;
+    }
+
+    if (std::memcmp(m_header.magic, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC)) != 0) {
+        m_error = "not a journal file";
+        return false;
+    }
+
+    if (m_header.byteOrderMark != BYTE_ORDER_MARK) {
+        m_error = "journal was written with a different byte order";
+        return false;
+    }
+
+    if (m_header.version != MarketDataJournal::VERSION ||
+        m_header.headerSize != sizeof(JournalFileHeader) ||
+        m_header.recordHeaderSize != sizeof(JournalRecordHeader)) {
+        m_error = "unsupported journal version " + std::to_string(m_header.version);
+        return false;
+    }
+
+    m_error.clear();
+    return true;
+}
+
+uint64_t JournalReader::completeSize(uint64_t fileSize) {
+    uint64_t offset = sizeof(JournalFileHeader);
+    JournalRecordHeader header;
+
+    // Walk the record headers only; payloads are skipped by offset
+    while (offset + sizeof(header) <= fileSize) {
+        m_file.seekg(static_cast<std::streamoff>(offset));
+        if (!m_file.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+            break;
+        }
+
+        uint64_t end = offset + sizeof(header) + header.keySize + header.payloadSize;
+        if (end > fileSize) {
+            break;
+        }
+        offset = end;
+    }
+
+    m_file.clear();
+    m_file.seekg(sizeof(JournalFileHeader));
+    return offset;
+}
+
+bool JournalReader::next(JournalRecord& record) {
+    JournalRecordHeader header;
+    if (!m_file.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+        return false;
+    }
+
+    record.kind = static_cast<JournalRecordKind>(header.kind);
+    record.timestampUs = header.timestampUs;
+    record.key.resize(header.keySize);
+    record.payload.resize(header.payloadSize);
+
+    // A record cut short by a crash ends the journal
+    return static_cast<bool>(m_file.read(&record.key[0], header.keySize)) &&
+           static_cast<bool>(m_file.read(&record.payload[0], header.payloadSize));
+}
+
+const char* journalRecordKindToString(JournalRecordKind kind) {
+    switch (kind) {
+        case JournalRecordKind::INSTRUMENTS: return "instruments";
+        case JournalRecordKind::QUOTE: return "quote";
+        case JournalRecordKind::LTP: return "ltp";
+        case JournalRecordKind::OHLC: return "ohlc";
+        case JournalRecordKind::TICKS: return "ticks";
+        case JournalRecordKind::OTHER: return "other";
+    }
+    return "unknown";
+}
+
+}  // namespace BoxStrategy
@@ -0,0 +1,226 @@
+/**
+ * @file MarketDataJournal.hpp
+ * @brief Append-only binary journal of raw market data responses and tick messages
+ */
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <fstream>
+#include <cstdint>
+#include "../utils/Logger.hpp"
+
+namespace BoxStrategy {
+
+/**
+ * @enum JournalRecordKind
+ * @brief What a journal record holds
+ */
+enum class JournalRecordKind : uint8_t {
+    INSTRUMENTS = 1,    ///< /instruments CSV body
+    QUOTE = 2,          ///< /quote JSON body
+    LTP = 3,            ///< /quote/ltp JSON body
+    OHLC = 4,           ///< /quote/ohlc JSON body
+    TICKS = 5,          ///< Binary tick message as received from the ticker
+    OTHER = 6           ///< Any other API response body
+};
+
+/**
+ * @struct JournalFileHeader
+ * @brief Fixed header at the start of every journal file
+ */
+struct JournalFileHeader {
+    char magic[8];                       ///< File magic, "BXJRNL" followed by two NULs
+    uint32_t version;                    ///< Format version
+    uint32_t byteOrderMark;              ///< Written as 0x01020304 in host byte order
+    uint32_t headerSize;                 ///< sizeof(JournalFileHeader)
+    uint32_t recordHeaderSize;           ///< sizeof(JournalRecordHeader)
+    int64_t createdAt;                   ///< Creation time in seconds since epoch
+};
+
+/**
+ * @struct JournalRecordHeader
+ * @brief Fixed header in front of every record; the key and payload bytes follow it
+ */
+struct JournalRecordHeader {
+    int64_t timestampUs;                 ///< Receive time in microseconds since epoch
+    uint32_t keySize;                    ///< Length of the request key
+    uint32_t payloadSize;                ///< Length of the payload
+    uint8_t kind;                        ///< JournalRecordKind
+    uint8_t reserved[7];                 ///< Padding, always zero
+};
+
+static_assert(sizeof(JournalFileHeader) == 32, "Journal header layout changed");
+static_assert(sizeof(JournalRecordHeader) == 24, "Journal record header layout changed");
+
+/**
+ * @struct JournalRecord
+ * @brief One record read back from a journal
+ */
+struct JournalRecord {
+    JournalRecordKind kind = JournalRecordKind::OTHER;  ///< What the payload is
+    int64_t timestampUs = 0;                            ///< Receive time in microseconds since epoch
+    std::string key;                                    ///< Request key (empty for ticks)
+    std::string payload;                                ///< Response body or tick message
+};
+
+/**
+ * @class MarketDataJournal
+ * @brief Appends timestamped raw responses and tick messages to a journal file
+ *
+ * Records are written as a fixed header followed by the request key and
+ * the unmodified payload, so a journal can be replayed through the same
+ * parsers that handled the live data. Appends are serialized by a mutex;
+ * API responses are flushed immediately, tick messages are left to the
+ * stream buffer. A crash can only lose the tail, which readers skip.
+ */
+class MarketDataJournal {
+public:
+    static constexpr uint32_t VERSION = 1;   ///< Current format version
+
+    /**
+     * @brief Constructor
+     * @param logger Logger instance
+     */
+    explicit MarketDataJournal(std::shared_ptr<Logger> logger);
+
+    /**
+     * @brief Destructor, flushes and closes the file
+     */
+    ~MarketDataJournal();
+
+    MarketDataJournal(const MarketDataJournal&) = delete;
+    MarketDataJournal& operator=(const MarketDataJournal&) = delete;
+
+    /**
+     * @brief Open a journal for appending, writing the header if the file is new
+     * @param path Journal file path
+     * @return True if the journal is ready for appends
+     */
+    bool open(const std::string& path);
+
+    /**
+     * @brief Check if the journal is open
+     * @return True if open
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Append a record stamped with the current time
+     * @param kind Record kind
+     * @param key Request key (see requestKey), empty for ticks
+     * @param payload Raw payload
+     */
+    void append(JournalRecordKind kind, std::string_view key, std::string_view payload);
+
+    /**
+     * @brief Flush buffered records to the file
+     */
+    void flush();
+
+    /**
+     * @brief Flush and close the file
+     */
+    void close();
+
+    /**
+     * @brief Get the number of records appended since open
+     * @return Record count
+     */
+    uint64_t getRecordCount() const { return m_records.load(); }
+
+    /**
+     * @brief Get the number of bytes appended since open
+     * @return Byte count
+     */
+    uint64_t getBytesWritten() const { return m_bytes.load(); }
+
+    /**
+     * @brief Build the key a request is journaled and replayed under
+     *
+     * Parameters are ordered by name and the values of repeated parameters
+     * (encoded as "a&i=b&i=c" by the market data manager) are sorted, so the
+     * key does not depend on hash map order or on the order of tokens in a batch.
+     *
+     * @param endpoint API endpoint (e.g. "/quote")
+     * @param params Query parameters
+     * @return Request key, e.g. "/quote?i=256265,260105"
+     */
+    static std::string requestKey(const std::string& endpoint,
+                                  const std::unordered_map<std::string, std::string>& params);
+
+    /**
+     * @brief Get the record kind for an API endpoint
+     * @param endpoint API endpoint
+     * @return Record kind
+     */
+    static JournalRecordKind kindForEndpoint(const std::string& endpoint);
+
+private:
+    std::shared_ptr<Logger> m_logger;      ///< Logger instance
+    std::ofstream m_file;                  ///< Journal file
+    std::string m_path;                    ///< Journal file path
+    mutable std::mutex m_mutex;            ///< Serializes appends
+    std::atomic<uint64_t> m_records{0};    ///< Records appended
+    std::atomic<uint64_t> m_bytes{0};      ///< Bytes appended
+};
+
+/**
+ * @class JournalReader
+ * @brief Reads the records of a journal file in order
+ */
+class JournalReader {
+public:
+    /**
+     * @brief Open a journal and validate its header
+     * @param path Journal file path
+     * @return True if the header is valid
+     */
+    bool open(const std::string& path);
+
+    /**
+     * @brief Read the next record
+     * @param record Output record
+     * @return False at the end of the journal or at a truncated record
+     */
+    bool next(JournalRecord& record);
+
+    /**
+     * @brief Find where the last complete record ends, then rewind to the first record
+     * @param fileSize Size of the journal file
+     * @return Offset just past the last complete record
+     */
+    uint64_t completeSize(uint64_t fileSize);
+
+    /**
+     * @brief Get the error of the last failed open
+     * @return Error description
+     */
+    const std::string& lastError() const { return m_error; }
+
+    /**
+     * @brief Get the journal header
+     * @return Header (valid after a successful open)
+     */
+    const JournalFileHeader& header() const { return m_header; }
+
+private:
+    std::ifstream m_file;                  ///< Journal file
+    JournalFileHeader m_header{};          ///< File header
+    std::string m_error;                   ///< Last error
+};
+
+/**
+ * @brief Convert a record kind to a string
+ * @param kind Record kind
+ * @return Name of the kind
+ */
+const char* journalRecordKindToString(JournalRecordKind kind);
+
+}  // namespace BoxStrategy
@@ -4,12 +4,16 @@
  */
 
 #include "../market/MarketDataManager.hpp"
+#include "../market/InstrumentCsvParser.hpp"
+#include "../market/QuoteResponseParser.hpp"
 #include <sstream>
 #include <algorithm>
+#include <thread>
 #include <iterator>
 #include "../external/json.hpp"
 #include <fstream>
 #include <filesystem>
+#include <deque>
 
 using json = nlohmann::json;
 
@@ -27,143 +31,400 @@ MarketDataManager::MarketDataManager(
     
     m_logger->info("Initializing MarketDataManager");
     
-    // Initialize rate limits for various endpoints
-    // These are conservative defaults, adjust based on your API usage
-    {
-        std::lock_guard<std::mutex> lock(m_rateLimitMutex);
-        m_rateLimits["/instruments"] = RateLimitInfo(1);    // 1 request per minute
-        m_rateLimits["/quote"] = RateLimitInfo(15);          // 15 requests per minute
-        m_rateLimits["/quote/ltp"] = RateLimitInfo(15);      // 15 requests per minute
-        m_rateLimits["/quote/ohlc"] = RateLimitInfo(15);     // 15 requests per minute
-        m_rateLimits["default"] = RateLimitInfo(10);        // 10 requests per minute for other endpoints
-    }
-    
-    // Override from config if available
-    int instrumentsRateLimit = m_configManager->getIntValue("api/rate_limits/instruments", 1);
-    int quoteRateLimit = m_configManager->getIntValue("api/rate_limits/quote", 15);
-    int ltpRateLimit = m_configManager->getIntValue("api/rate_limits/ltp", 15);
-    int ohlcRateLimit = m_configManager->getIntValue("api/rate_limits/ohlc", 15);
-    int defaultRateLimit = m_configManager->getIntValue("api/rate_limits/default", 10);
-    
-    // Update with config values
-    {
-        std::lock_guard<std::mutex> lock(m_rateLimitMutex);
-        m_rateLimits["/instruments"].requestsPerMinute = instrumentsRateLimit;
-        m_rateLimits["/quote"].requestsPerMinute = quoteRateLimit;
-        m_rateLimits["/quote/ltp"].requestsPerMinute = ltpRateLimit;
-        m_rateLimits["/quote/ohlc"].requestsPerMinute = ohlcRateLimit;
-        m_rateLimits["default"].requestsPerMinute = defaultRateLimit;
-    }
+    // Requests are paced per endpoint by a token bucket; a burst of 1 spaces them evenly
+    int schedulerThreads = m_configManager->getIntValue("api/scheduler_threads", 4);
+    int rateLimitBurst = m_configManager->getIntValue("api/rate_limit_burst", 1);
+    m_apiScheduler = std::make_shared<ApiScheduler>(
+        m_logger, static_cast<size_t>(std::max(1, schedulerThreads)), static_cast<double>(std::max(1, rateLimitBurst)));
     
-    // Set the instruments cache TTL
-    int cacheTTLMinutes = m_configManager->getIntValue("api/instruments_cache_ttl_minutes", 1440);
-    m_instrumentsCacheTTL = std::chrono::minutes(cacheTTLMinutes);
+    // Conservative defaults, adjust based on your API usage
+    m_apiScheduler->setRateLimit("/instruments", m_configManager->getIntValue("api/rate_limits/instruments", 1));
+    m_apiScheduler->setRateLimit("/quote", m_configManager->getIntValue("api/rate_limits/quote", 15));
+    m_apiScheduler->setRateLimit("/quote/ltp", m_configManager->getIntValue("api/rate_limits/ltp", 15));
+    m_apiScheduler->setRateLimit("/quote/ohlc", m_configManager->getIntValue("api/rate_limits/ohlc", 15));
+    m_apiScheduler->setRateLimit(ApiScheduler::DEFAULT_ENDPOINT, m_configManager->getIntValue("api/rate_limits/default", 10));
+    m_apiScheduler->setRecoveryPeriod(std::chrono::seconds(
+        m_configManager->getIntValue("api/rate_limit_recovery_seconds", 60)));
     
-    m_logger->info("MarketDataManager initialized with cache TTL: {} minutes", cacheTTLMinutes);
+    m_logger->info("MarketDataManager initialized with cache TTL: {} minutes", getInstrumentsCacheTTL().count());
 }
 
 MarketDataManager::~MarketDataManager() {
+    stopInstrumentRefresher();
+    stopQuoteFlusher();
+    stopTickFeed();
+    logApiUtilization();
+    m_apiScheduler->stop();
     m_logger->info("MarketDataManager destroyed");
 }
 
-std::future<std::vector<InstrumentModel>> MarketDataManager::getAllInstruments() {
-    return std::async(std::launch::async, [this]() {
+Future<std::vector<InstrumentModel>> MarketDataManager::getAllInstruments() {
+    return makeReadyFuture([&]() {
         m_logger->info("Getting all instruments");
         
+        // Copy out of the shared universe for callers that need an owned vector
+        auto store = getQuoteStore();
+        const auto& refs = store->getUniverse()->getInstruments();
+        
         std::vector<InstrumentModel> instruments;
+        instruments.reserve(refs.size());
+        for (const auto& instrument : refs) {
+            instruments.push_back(materialize(*store, instrument));
+        }
+        
+        return instruments;
+    }());
+}
+
+std::shared_ptr<const InstrumentUniverse> MarketDataManager::getInstrumentUniverse() {
+    // Fast path: a valid universe is already published
+    auto universe = std::atomic_load(&m_universe);
+    if (universe && std::chrono::system_clock::now() < m_universeValidUntil.load()) {
+        return universe;
+    }
+    
+    // Scans never wait for a download the refresher can do for them
+    if (universe && m_refresherRunning.load()) {
+        {
+            std::lock_guard<std::mutex> lock(m_refreshMutex);
+            m_refreshRequested = true;
+        }
+        m_refreshCondition.notify_all();
+        return universe;
+    }
+    
+    // Only one thread loads; the others wait and then pick up the published universe
+    std::lock_guard<std::mutex> loadLock(m_universeLoadMutex);
+    
+    universe = std::atomic_load(&m_universe);
+    if (universe && std::chrono::system_clock::now() < m_universeValidUntil.load()) {
+        return universe;
+    }
+    
+    std::chrono::system_clock::time_point validUntil;
+    std::vector<InstrumentRef> instruments = loadInstruments(validUntil);
+    
+    if (instruments.empty()) {
+        if (universe) {
+            m_logger->warn("Failed to reload instruments, keeping universe version {}", 
+                         universe->getVersion());
+            return universe;
+        }
+        
+        m_logger->error("No instruments available");
+        return std::make_shared<const InstrumentUniverse>(std::vector<InstrumentRef>(), 0);
+    }
+    
+    return publishInstrumentUniverse(std::move(instruments), validUntil);
+}
+
+std::vector<InstrumentRef> MarketDataManager::loadInstruments(
+    std::chrono::system_clock::time_point& validUntil) {
+    
+    std::vector<InstrumentRef> instruments;
+    std::chrono::seconds age{0};
+    
+    // A replay takes its instruments from the journal, never from the caches of a live run
+    bool replaying = std::atomic_load(&m_replayEngine) != nullptr;
+    
+    // First, check if we have a binary snapshot of a dump that is still fresh
+    if (!replaying) {
+        instruments = loadInstrumentsFromSnapshot(age);
+        
+        if (!instruments.empty()) {
+            m_logger->info("Loaded {} instruments from snapshot", instruments.size());
+            validUntil = std::chrono::system_clock::now() + getInstrumentsCacheTTL() - age;
+            return instruments;
+        }
+    }
+    
+    // Fall back to the raw CSV download if it is still valid
+    if (!replaying && isInstrumentsCacheValid() && getCacheFileAge(getInstrumentsCacheFilePath(), age)) {
+        m_logger->info("Using cached instruments data");
+        std::string csvData = loadInstrumentsFromCache();
         
-        // First, check if we have a valid cache
-        if (isInstrumentsCacheValid()) {
-            m_logger->info("Using cached instruments data");
-            std::string csvData = loadInstrumentsFromCache();
+        if (!csvData.empty()) {
+            instruments = parseInstrumentsCSV(csvData);
             
-            if (!csvData.empty()) {
-                instruments = parseInstrumentsCSV(csvData);
+            if (!instruments.empty()) {
+                m_logger->info("Loaded {} instruments from cache", instruments.size());
                 
-                if (!instruments.empty()) {
-                    m_logger->info("Loaded {} instruments from cache", instruments.size());
-                    
-                    // Update memory cache
-                    {
-                        std::lock_guard<std::mutex> lock(m_cacheMutex);
-                        
-                        for (const auto& instrument : instruments) {
-                            m_instrumentCache[instrument.instrumentToken] = instrument;
-                            
-                            std::string key = instrument.tradingSymbol + ":" + instrument.exchange;
-                            m_symbolToTokenMap[key] = instrument.instrumentToken;
-                        }
-                        
-                        m_instrumentsCached = true;
-                    }
-                    
-                    return instruments;
-                }
+                // Write the snapshot so later loads skip the CSV parse; it keeps the
+                // CSV's download time so the snapshot expires with the CSV
+                auto downloadedAt = std::chrono::system_clock::now() - age;
+                saveInstrumentsSnapshot(instruments, downloadedAt);
+                validUntil = downloadedAt + getInstrumentsCacheTTL();
+                return instruments;
             }
-            
-            m_logger->warn("Failed to load instruments from cache");
         }
         
-        // Cache not valid or failed to load, fetch from API
-        m_logger->info("Fetching instruments from API");
+        m_logger->warn("Failed to load instruments from cache");
+    }
+    
+    // Cache not valid or failed to load, fetch from API
+    m_logger->info("Fetching instruments from API");
+    
+    if (downloadInstruments(instruments)) {
+        if (!replaying) {
+            saveInstrumentsSnapshot(instruments, std::chrono::system_clock::now());
+        }
+        validUntil = std::chrono::system_clock::now() + getInstrumentsCacheTTL();
+        
+        m_logger->info("Fetched {} instruments", instruments.size());
+    }
+    
+    return instruments;
+}
+
+bool MarketDataManager::downloadInstruments(std::vector<InstrumentRef>& instruments) {
+    bool replaying = std::atomic_load(&m_replayEngine) != nullptr;
+    
+    if (!m_configManager->getBoolValue("api/instruments_streaming", true)) {
+        HttpResponse response = makeRateLimitedApiRequest(HttpMethod::GET, "/instruments", {}, "", RequestPriority::LOW);
+        
+        if (response.statusCode != 200) {
+            m_logger->error("Failed to fetch instruments. Status code: {}, Response: {}", 
+                          response.statusCode, response.body);
+            return false;
+        }
         
-        HttpResponse response = makeRateLimitedApiRequest(HttpMethod::GET, "/instruments");
+        // Cache the response to file
+        if (replaying) {
+            // Replayed instruments stay out of the live cache
+        } else if (saveInstrumentsToCache(response.body)) {
+            m_logger->info("Saved instruments data to cache");
+        } else {
+            m_logger->warn("Failed to save instruments data to cache");
+        }
         
-        if (response.statusCode == 200) {
-            // Cache the response to file
-            if (saveInstrumentsToCache(response.body)) {
-                m_logger->info("Saved instruments data to cache");
+        instruments = parseInstrumentsCSV(response.body);
+        return true;
+    }
+    
+    // The body goes to a temporary file so a broken download never replaces a good cache
+    std::string cacheFilePath = getInstrumentsCacheFilePath();
+    std::string partFilePath = cacheFilePath + ".part";
+    std::ofstream partFile;
+    if (!replaying) {
+        partFile.open(partFilePath, std::ios::out | std::ios::binary | std::ios::trunc);
+    }
+    
+    if (!replaying && !partFile.is_open()) {
+        m_logger->warn("Failed to open {} for writing, instruments will not be cached", partFilePath);
+    }
+    
+    // The transfer thread only queues chunks; this thread writes and parses them meanwhile
+    std::mutex chunkMutex;
+    std::condition_variable chunkCondition;
+    std::deque<std::string> chunks;
+    bool transferDone = false;
+    HttpResponse response;
+    std::chrono::steady_clock::time_point transferEnd;
+    
+    auto startTime = std::chrono::steady_clock::now();
+    size_t bytesReceived = 0;
+    
+    HttpClient::BodySink sink = [&](const char* data, size_t size) {
+        bytesReceived += size;
+        {
+            // Coalesce curl's small writes so the parse thread wakes less often
+            std::lock_guard<std::mutex> lock(chunkMutex);
+            if (!chunks.empty() && chunks.back().size() < 256 * 1024) {
+                chunks.back().append(data, size);
             } else {
-                m_logger->warn("Failed to save instruments data to cache");
+                chunks.emplace_back(data, size);
+            }
+        }
+        chunkCondition.notify_one();
+        return true;
+    };
+    
+    // Failed requests complete with an error response, so the continuation always ends the parse loop
+    auto transfer = submitApiRequest(
+        HttpMethod::GET, "/instruments", {}, "", RequestPriority::LOW,
+        ApiScheduler::Clock::time_point::max(), sink).then([&](HttpResponse transferResponse) {
+            {
+                std::lock_guard<std::mutex> lock(chunkMutex);
+                response = std::move(transferResponse);
+                transferEnd = std::chrono::steady_clock::now();
+                transferDone = true;
             }
+            chunkCondition.notify_one();
+            return true;
+        });
+    
+    InstrumentCsvParser::Stream stream;
+    
+    while (true) {
+        std::string chunk;
+        {
+            std::unique_lock<std::mutex> lock(chunkMutex);
+            chunkCondition.wait(lock, [&]() { return !chunks.empty() || transferDone; });
             
-            instruments = parseInstrumentsCSV(response.body);
+            if (chunks.empty()) {
+                break;
+            }
             
+            chunk = std::move(chunks.front());
+            chunks.pop_front();
+        }
+        
+        if (partFile.is_open()) {
+            partFile.write(chunk.data(), chunk.size());
+        }
+        stream.feed(chunk);
+    }
+    
+    // The continuation still holds references to these locals until it returns
+    transfer.get();
+    
+    CsvParseResult result = stream.finish();
+    auto parseEnd = std::chrono::steady_clock::now();
+    
+    bool cacheOpened = partFile.is_open();
+    partFile.close();
+    bool cacheWritten = cacheOpened && !partFile.fail();
+    
+    if (response.statusCode != 200) {
+        m_logger->error("Failed to fetch instruments. Status code: {}, Response: {}", 
+                      response.statusCode, response.body);
+        std::error_code ignored;
+        std::filesystem::remove(partFilePath, ignored);
+        return false;
+    }
+    
+    std::error_code renameError;
+    if (cacheWritten) {
+        std::filesystem::rename(partFilePath, cacheFilePath, renameError);
+    }
+    
+    if (replaying) {
+        // Replayed instruments stay out of the live cache
+    } else if (cacheWritten && !renameError) {
+        m_logger->info("Saved instruments data to cache");
+    } else {
+        m_logger->warn("Failed to save instruments data to cache");
+        std::error_code ignored;
+        std::filesystem::remove(partFilePath, ignored);
+    }
+    
+    auto transferMs = std::chrono::duration_cast<std::chrono::milliseconds>(transferEnd - startTime).count();
+    auto tailMs = std::chrono::duration_cast<std::chrono::milliseconds>(parseEnd - transferEnd).count();
+    m_logger->info("Streamed {:.1f} MB of instruments in {} ms; parsing finished {} ms after the last byte", 
+                 bytesReceived / (1024.0 * 1024.0), transferMs, tailMs);
+    
+    instruments = summarizeInstruments(std::move(result), 
+        std::chrono::duration_cast<std::chrono::milliseconds>(parseEnd - startTime).count());
+    return true;
+}
+
+std::shared_ptr<const InstrumentUniverse> MarketDataManager::publishInstrumentUniverse(
+    std::vector<InstrumentRef> instruments,
+    std::chrono::system_clock::time_point validUntil) {
+    
+    auto previous = std::atomic_load(&m_universe);
+    auto previousStore = std::atomic_load(&m_quoteStore);
+    
+    std::shared_ptr<const InstrumentUniverse> universe;
+    std::shared_ptr<QuoteStore> store;
+    InstrumentUniverseDelta delta;
+    size_t carried = 0;
+    auto startTime = std::chrono::steady_clock::now();
+    
+    if (previous && !previous->empty() && 
+        m_configManager->getBoolValue("api/instruments_incremental_refresh", true)) {
+        delta = previous->diff(instruments);
+        
+        if (delta.empty()) {
+            // Same contracts as before: keep the universe, its indexes and its quotes
+            m_universeValidUntil.store(validUntil);
             {
-                std::lock_guard<std::mutex> lock(m_cacheMutex);
-                
-                // Update cache
-                for (const auto& instrument : instruments) {
-                    m_instrumentCache[instrument.instrumentToken] = instrument;
-                    
-                    std::string key = instrument.tradingSymbol + ":" + instrument.exchange;
-                    m_symbolToTokenMap[key] = instrument.instrumentToken;
-                }
-                
-                m_instrumentsCached = true;
-                m_lastInstrumentsFetch = std::chrono::system_clock::now();
+                std::lock_guard<std::mutex> lock(m_refreshMutex);
+                m_refreshRequested = false;
             }
-            
-            m_logger->info("Fetched {} instruments", instruments.size());
-            return instruments;
-        } else {
-            m_logger->error("Failed to fetch instruments. Status code: {}, Response: {}", 
-                          response.statusCode, response.body);
-            return std::vector<InstrumentModel>();
+            m_refreshCondition.notify_all();
+            m_logger->info("Instruments unchanged, keeping universe version {}", previous->getVersion());
+            return previous;
         }
-    });
+        
+        std::vector<uint32_t> ordinalMap;
+        universe = previous->applyDelta(std::move(instruments), delta, ++m_universeVersion, ordinalMap);
+        store = std::make_shared<QuoteStore>(universe);
+        if (previousStore && previousStore->getUniverse() == previous) {
+            carried = store->carryOver(*previousStore, ordinalMap);
+        }
+    } else {
+        universe = std::make_shared<const InstrumentUniverse>(std::move(instruments), ++m_universeVersion);
+        store = std::make_shared<QuoteStore>(universe);
+        delta.fromVersion = previous ? previous->getVersion() : 0;
+        delta.rebuilt = true;
+    }
+    delta.toVersion = universe->getVersion();
+    
+    // The store is published first so a reader that sees the new universe also finds its quotes
+    std::atomic_store(&m_quoteStore, store);
+    std::atomic_store(&m_universe, universe);
+    m_universeValidUntil.store(validUntil);
+    
+    // Let the refresher plan its next download from the new validity
+    {
+        std::lock_guard<std::mutex> lock(m_refreshMutex);
+        m_refreshRequested = false;
+    }
+    m_refreshCondition.notify_all();
+    
+    auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - startTime).count();
+    
+    if (delta.rebuilt) {
+        m_logger->info("Published instrument universe version {} with {} instruments in {} ms", 
+                     universe->getVersion(), universe->size(), elapsedMs);
+    } else {
+        m_logger->info("Published instrument universe version {} with {} instruments in {} ms: "
+                     "{} added, {} removed, {} changed, {} chains rebuilt, {} quotes carried over", 
+                     universe->getVersion(), universe->size(), elapsedMs, delta.added.size(), 
+                     delta.removed.size(), delta.changed.size(), delta.affectedChains.size(), carried);
+    }
+    
+    if (previous) {
+        std::lock_guard<std::mutex> lock(m_universeListenerMutex);
+        for (const auto& listener : m_universeListeners) {
+            listener.second(delta);
+        }
+    }
+    
+    return universe;
+}
+
+size_t MarketDataManager::addUniverseListener(UniverseListener listener) {
+    std::lock_guard<std::mutex> lock(m_universeListenerMutex);
+    size_t listenerId = m_nextUniverseListenerId++;
+    m_universeListeners.emplace(listenerId, std::move(listener));
+    return listenerId;
+}
+
+void MarketDataManager::removeUniverseListener(size_t listenerId) {
+    std::lock_guard<std::mutex> lock(m_universeListenerMutex);
+    m_universeListeners.erase(listenerId);
 }
 
-std::future<std::vector<InstrumentModel>> MarketDataManager::getInstrumentsByExchange(
+Future<std::vector<InstrumentModel>> MarketDataManager::getInstrumentsByExchange(
     const std::string& exchange) {
     
-    return std::async(std::launch::async, [this, exchange]() {
+    return makeReadyFuture([&]() {
         m_logger->info("Fetching instruments for exchange: {}", exchange);
         
-        // First, ensure we have all instruments
-        auto allInstrumentsFuture = getAllInstruments();
-        std::vector<InstrumentModel> allInstruments = allInstrumentsFuture.get();
+        // Copy the exchange slice out of the shared universe
+        auto store = getQuoteStore();
+        const auto& exchangeInstruments = store->getUniverse()->getByExchange(exchange);
         
-        // Filter by exchange
         std::vector<InstrumentModel> filteredInstruments;
-        std::copy_if(allInstruments.begin(), allInstruments.end(), 
-                    std::back_inserter(filteredInstruments),
-                    [&exchange](const InstrumentModel& instrument) {
-                        return instrument.exchange == exchange;
-                    });
+        filteredInstruments.reserve(exchangeInstruments.size());
+        for (const InstrumentRef* instrument : exchangeInstruments) {
+            filteredInstruments.push_back(materialize(*store, *instrument));
+        }
         
         m_logger->info("Fetched {} instruments for exchange {}", filteredInstruments.size(), exchange);
-        
         // Debug: Count instrument types
         int optionCount = 0;
         int futureCount = 0;
@@ -219,482 +480,577 @@ std::future<std::vector<InstrumentModel>> MarketDataManager::getInstrumentsByExc
         m_logger->info("Found {} NIFTY instruments, including {} NIFTY options", niftyInstrumentCount, niftyOptionCount);
         
         return filteredInstruments;
-    });
+    }());
 }
 
-std::future<InstrumentModel> MarketDataManager::getInstrumentByToken(uint64_t instrumentToken) {
-    return std::async(std::launch::async, [this, instrumentToken]() {
+Future<InstrumentModel> MarketDataManager::getInstrumentByToken(uint64_t instrumentToken) {
+    return makeReadyFuture([&]() {
         m_logger->debug("Getting instrument by token: {}", instrumentToken);
         
-        {
-            std::lock_guard<std::mutex> lock(m_cacheMutex);
-            
-            // Check cache first
-            auto it = m_instrumentCache.find(instrumentToken);
-            if (it != m_instrumentCache.end()) {
-                return it->second;
-            }
-        }
-        
-        // Not in cache, fetch all instruments and find the one we want
-        auto allInstrumentsFuture = getAllInstruments();
-        std::vector<InstrumentModel> allInstruments = allInstrumentsFuture.get();
-        
-        for (const auto& instrument : allInstruments) {
-            if (instrument.instrumentToken == instrumentToken) {
-                return instrument;
-            }
+        auto store = getQuoteStore();
+        if (const InstrumentRef* instrument = store->getUniverse()->findByToken(instrumentToken)) {
+            return materialize(*store, *instrument);
         }
         
         // Not found
         m_logger->warn("Instrument with token {} not found", instrumentToken);
         return InstrumentModel();
-    });
+    }());
 }
 
-std::future<InstrumentModel> MarketDataManager::getInstrumentBySymbol(
+Future<InstrumentModel> MarketDataManager::getInstrumentBySymbol(
     const std::string& tradingSymbol, const std::string& exchange) {
     
-    return std::async(std::launch::async, [this, tradingSymbol, exchange]() {
+    return makeReadyFuture([&]() {
         m_logger->debug("Getting instrument by symbol: {}:{}", tradingSymbol, exchange);
         
-        std::string key = tradingSymbol + ":" + exchange;
-        
-        {
-            std::lock_guard<std::mutex> lock(m_cacheMutex);
-            
-            // Check cache first
-            auto it = m_symbolToTokenMap.find(key);
-            if (it != m_symbolToTokenMap.end()) {
-                uint64_t token = it->second;
-                auto instrumentIt = m_instrumentCache.find(token);
-                if (instrumentIt != m_instrumentCache.end()) {
-                    return instrumentIt->second;
-                }
-            }
-        }
-        
-        // Not in cache, fetch all instruments and find the one we want
-        auto allInstrumentsFuture = getAllInstruments();
-        std::vector<InstrumentModel> allInstruments = allInstrumentsFuture.get();
-        
-        for (const auto& instrument : allInstruments) {
-            if (instrument.tradingSymbol == tradingSymbol && instrument.exchange == exchange) {
-                return instrument;
-            }
+        auto store = getQuoteStore();
+        if (const InstrumentRef* instrument = store->getUniverse()->findBySymbol(tradingSymbol, exchange)) {
+            return materialize(*store, *instrument);
         }
         
-        // Not found
         m_logger->warn("Instrument with symbol {}:{} not found", tradingSymbol, exchange);
         return InstrumentModel();
-    });
+    }());
 }
 
-std::future<InstrumentModel> MarketDataManager::getQuote(uint64_t instrumentToken) {
-    return std::async(std::launch::async, [this, instrumentToken]() {
-        m_logger->debug("Getting quote for instrument: {}", instrumentToken);
-        
-        // Construct query parameters
-        std::unordered_map<std::string, std::string> params = {
-            {"i", std::to_string(instrumentToken)}
-        };
-        
-        HttpResponse response = makeRateLimitedApiRequest(HttpMethod::GET, "/quote", params);
-        
-        if (response.statusCode == 200) {
-            try {
-                json responseJson = json::parse(response.body);
-                
-                if (responseJson["status"] == "success") {
-                    json data = responseJson["data"];
-                    
-                    auto instrumentTokenStr = std::to_string(instrumentToken);
-                    if (data.find(instrumentTokenStr) != data.end()) {
-                        InstrumentModel instrument = parseQuoteJson(instrumentTokenStr, data[instrumentTokenStr]);
-                        
-                        // Update cache
-                        {
-                            std::lock_guard<std::mutex> lock(m_cacheMutex);
-                            
-                            auto it = m_instrumentCache.find(instrumentToken);
-                            if (it != m_instrumentCache.end()) {
-                                // Update existing instrument with new quote data
-                                it->second.lastPrice = instrument.lastPrice;
-                                it->second.openPrice = instrument.openPrice;
-                                it->second.highPrice = instrument.highPrice;
-                                it->second.lowPrice = instrument.lowPrice;
-                                it->second.closePrice = instrument.closePrice;
-                                it->second.averagePrice = instrument.averagePrice;
-                                it->second.volume = instrument.volume;
-                                it->second.buyQuantity = instrument.buyQuantity;
-                                it->second.sellQuantity = instrument.sellQuantity;
-                                it->second.openInterest = instrument.openInterest;
-                                it->second.buyDepth = instrument.buyDepth;
-                                it->second.sellDepth = instrument.sellDepth;
-                                
-                                instrument = it->second;
-                            } else {
-                                m_instrumentCache[instrumentToken] = instrument;
-                                
-                                // If we have the trading symbol, add to symbol to token map
-                                if (!instrument.tradingSymbol.empty() && !instrument.exchange.empty()) {
-                                    std::string key = instrument.tradingSymbol + ":" + instrument.exchange;
-                                    m_symbolToTokenMap[key] = instrumentToken;
-                                }
-                            }
-                        }
-                        
-                        m_logger->debug("Got quote for instrument: {}", instrumentToken);
-                        return instrument;
-                    } else {
-                        m_logger->warn("Quote data for instrument {} not found in response", instrumentToken);
-                    }
-                } else {
-                    m_logger->error("Failed to get quote: {}", responseJson["message"].get<std::string>());
-                }
-            } catch (const std::exception& e) {
-                m_logger->error("Exception while parsing quote response: {}", e.what());
+std::shared_ptr<QuoteStore> MarketDataManager::getQuoteStore() {
+    // Make sure a universe is loaded, then take the store published with it
+    auto universe = getInstrumentUniverse();
+    auto store = std::atomic_load(&m_quoteStore);
+    
+    if (!store || store->getUniverse() != universe) {
+        // Nothing could be loaded; hand out an empty store for the empty universe
+        return std::make_shared<QuoteStore>(universe);
+    }
+    
+    return store;
+}
+
+InstrumentModel MarketDataManager::materialize(const QuoteStore& store, const InstrumentRef& instrument) {
+    InstrumentModel model(instrument);
+    store.read(store.getUniverse()->ordinalOf(&instrument), model);
+    return model;
+}
+
+Future<InstrumentModel> MarketDataManager::getQuote(uint64_t instrumentToken) {
+    m_logger->debug("Getting quote for instrument: {}", instrumentToken);
+    
+    // Single quotes go through the same coalescing path as batches
+    return fetchQuotesCoalesced({instrumentToken}, "", std::atomic_load(&m_quoteStore)).then(
+        [this, instrumentToken](std::unordered_map<uint64_t, InstrumentModel> quotes) {
+            auto it = quotes.find(instrumentToken);
+            if (it == quotes.end()) {
+                m_logger->warn("Quote data for instrument {} not found in response", instrumentToken);
+                return InstrumentModel();
             }
-        } else {
-            m_logger->error("Failed to get quote. Status code: {}, Response: {}", 
-                          response.statusCode, response.body);
-        }
-        
-        return InstrumentModel();
-    });
+            
+            m_logger->debug("Got quote for instrument: {}", instrumentToken);
+            return it->second;
+        });
 }
 
-std::future<std::unordered_map<uint64_t, InstrumentModel>> MarketDataManager::getQuotes(
-    const std::vector<uint64_t>& instrumentTokens) {
+Future<std::unordered_map<uint64_t, InstrumentModel>> MarketDataManager::getQuotes(
+    const std::vector<uint64_t>& instrumentTokens,
+    const std::string& flow,
+    std::shared_ptr<QuoteStore> store) {
     
-    return std::async(std::launch::async, [this, instrumentTokens]() {
-        m_logger->debug("Getting quotes for {} instruments", instrumentTokens.size());
-        
-        std::unordered_map<uint64_t, InstrumentModel> result;
+    m_logger->debug("Getting quotes for {} instruments", instrumentTokens.size());
+    
+    // Responses land in the store the caller reads from, even if a new universe is published meanwhile
+    if (!store) {
+        store = std::atomic_load(&m_quoteStore);
+    }
+    
+    return fetchQuotesCoalesced(instrumentTokens, flow, std::move(store)).then(
+        [this](std::unordered_map<uint64_t, InstrumentModel> result) {
+            m_logger->debug("Got quotes for {} instruments", result.size());
+            return result;
+        });
+}
+
+/**
+ * @brief One /quote request shared by every caller that needs its tokens
+ */
+struct MarketDataManager::QuoteFlight {
+    std::vector<uint64_t> tokens;                              ///< Tokens fetched by this request
+    std::string flow;                                          ///< Scheduler flow of the caller that opened it
+    std::shared_ptr<QuoteStore> store;                         ///< Store the response is parsed into
+    std::chrono::steady_clock::time_point sealAt;              ///< When an unfilled batch stops accepting tokens
+    bool sealed = false;                                       ///< No more tokens can join
+    bool done = false;                                         ///< The request has completed
+    std::unordered_map<uint64_t, InstrumentModel> quotes;      ///< Results, valid once done
+    std::vector<std::function<void()>> waiters;                ///< Run by the completing thread once done
+};
+
+Future<std::unordered_map<uint64_t, InstrumentModel>> MarketDataManager::fetchQuotesCoalesced(
+    const std::vector<uint64_t>& instrumentTokens,
+    const std::string& flow,
+    std::shared_ptr<QuoteStore> store) {
+    
+    const size_t batchSize = getQuoteBatchSize();
+    const auto window = std::chrono::milliseconds(
+        std::max(0, m_configManager->getIntValue("api/quote_coalesce_window_ms", 20)));
+    
+    // Flights this caller waits on, and the full ones it has to send itself
+    std::vector<std::shared_ptr<QuoteFlight>> attached;
+    std::vector<std::shared_ptr<QuoteFlight>> sealed;
+    size_t joined = 0;
+    
+    {
+        std::lock_guard<std::mutex> lock(m_quoteFlightMutex);
         
-        // Zerodha API allows up to 250 instruments in one go
-        const size_t maxBatchSize = 250;
+        // A batch opened for the previous universe's store cannot take tokens for this one
+        if (m_collectingQuoteFlight && m_collectingQuoteFlight->store != store) {
+            m_collectingQuoteFlight->sealed = true;
+            sealed.push_back(m_collectingQuoteFlight);
+            m_collectingQuoteFlight.reset();
+        }
         
-        for (size_t i = 0; i < instrumentTokens.size(); i += maxBatchSize) {
-            size_t batchSize = std::min(maxBatchSize, instrumentTokens.size() - i);
-            std::vector<uint64_t> batch(instrumentTokens.begin() + i, 
-                                       instrumentTokens.begin() + i + batchSize);
+        for (uint64_t token : instrumentTokens) {
+            auto it = m_quoteFlights.find(token);
+            if (it != m_quoteFlights.end() && it->second->store == store) {
+                // Already requested (or about to be) by someone
+                attached.push_back(it->second);
+                joined++;
+                continue;
+            }
             
-            // Construct query parameters
-            std::unordered_map<std::string, std::string> params;
-            for (size_t j = 0; j < batch.size(); ++j) {
-                params["i"] = params["i"].empty() ? 
-                    std::to_string(batch[j]) : 
-                    params["i"] + "&i=" + std::to_string(batch[j]);
+            if (!m_collectingQuoteFlight) {
+                m_collectingQuoteFlight = std::make_shared<QuoteFlight>();
+                m_collectingQuoteFlight->tokens.reserve(batchSize);
+                m_collectingQuoteFlight->flow = flow;
+                m_collectingQuoteFlight->store = store;
+                m_collectingQuoteFlight->sealAt = std::chrono::steady_clock::now() + window;
             }
             
-            HttpResponse response = makeRateLimitedApiRequest(HttpMethod::GET, "/quote", params);
+            auto flight = m_collectingQuoteFlight;
+            flight->tokens.push_back(token);
+            m_quoteFlights[token] = flight;
+            attached.push_back(flight);
             
-            if (response.statusCode == 200) {
-                try {
-                    json responseJson = json::parse(response.body);
-                    
-                    if (responseJson["status"] == "success") {
-                        json data = responseJson["data"];
-                        
-                        for (const auto& token : batch) {
-                            auto tokenStr = std::to_string(token);
-                            if (data.find(tokenStr) != data.end()) {
-                                InstrumentModel instrument = parseQuoteJson(tokenStr, data[tokenStr]);
-                                
-                                // Update cache
-                                {
-                                    std::lock_guard<std::mutex> lock(m_cacheMutex);
-                                    
-                                    auto it = m_instrumentCache.find(token);
-                                    if (it != m_instrumentCache.end()) {
-                                        // Update existing instrument with new quote data
-                                        it->second.lastPrice = instrument.lastPrice;
-                                        it->second.openPrice = instrument.openPrice;
-                                        it->second.highPrice = instrument.highPrice;
-                                        it->second.lowPrice = instrument.lowPrice;
-                                        it->second.closePrice = instrument.closePrice;
-                                        it->second.averagePrice = instrument.averagePrice;
-                                        it->second.volume = instrument.volume;
-                                        it->second.buyQuantity = instrument.buyQuantity;
-                                        it->second.sellQuantity = instrument.sellQuantity;
-                                        it->second.openInterest = instrument.openInterest;
-                                        it->second.buyDepth = instrument.buyDepth;
-                                        it->second.sellDepth = instrument.sellDepth;
-                                        
-                                        instrument = it->second;
-                                    } else {
-                                        m_instrumentCache[token] = instrument;
-                                        
-                                        // If we have the trading symbol, add to symbol to token map
-                                        if (!instrument.tradingSymbol.empty() && !instrument.exchange.empty()) {
-                                            std::string key = instrument.tradingSymbol + ":" + instrument.exchange;
-                                            m_symbolToTokenMap[key] = token;
-                                        }
-                                    }
-                                }
-                                
-                                result[token] = instrument;
-                            }
-                        }
-                    } else {
-                        m_logger->error("Failed to get quotes: {}", responseJson["message"].get<std::string>());
-                    }
-                } catch (const std::exception& e) {
-                    m_logger->error("Exception while parsing quotes response: {}", e.what());
-                }
-            } else {
-                m_logger->error("Failed to get quotes. Status code: {}, Response: {}", 
-                              response.statusCode, response.body);
+            if (flight->tokens.size() >= batchSize) {
+                // Whoever fills a batch sends it right away
+                flight->sealed = true;
+                m_collectingQuoteFlight.reset();
+                sealed.push_back(flight);
             }
         }
         
-        m_logger->debug("Got quotes for {} instruments", result.size());
-        return result;
-    });
-}
-
-std::future<double> MarketDataManager::getLTP(uint64_t instrumentToken) {
-    return std::async(std::launch::async, [this, instrumentToken]() {
-        m_logger->debug("Getting LTP for instrument: {}", instrumentToken);
-        
-        // Construct query parameters
-        std::unordered_map<std::string, std::string> params = {
-            {"i", std::to_string(instrumentToken)}
-        };
-        
-        HttpResponse response = makeRateLimitedApiRequest(HttpMethod::GET, "/quote/ltp", params);
-        
-        if (response.statusCode == 200) {
-            try {
-                json responseJson = json::parse(response.body);
-                
-                if (responseJson["status"] == "success") {
-                    json data = responseJson["data"];
-                    
-                    auto instrumentTokenStr = std::to_string(instrumentToken);
-                    if (data.find(instrumentTokenStr) != data.end()) {
-                        double ltp = parseLTPJson(instrumentTokenStr, data[instrumentTokenStr]);
-                        
-                        // Update cache
-                        {
-                            std::lock_guard<std::mutex> lock(m_cacheMutex);
-                            
-                            auto it = m_instrumentCache.find(instrumentToken);
-                            if (it != m_instrumentCache.end()) {
-                                it->second.lastPrice = ltp;
-                            }
-                        }
-                        
-                        m_logger->debug("Got LTP for instrument {}: {}", instrumentToken, ltp);
-                        return ltp;
-                    } else {
-                        m_logger->warn("LTP data for instrument {} not found in response", instrumentToken);
-                    }
-                } else {
-                    m_logger->error("Failed to get LTP: {}", responseJson["message"].get<std::string>());
+        // An unfilled batch stays open for concurrent callers; the flusher sends it when its window ends
+        if (m_collectingQuoteFlight && !m_collectingQuoteFlight->sealed) {
+            if (window.count() == 0) {
+                m_collectingQuoteFlight->sealed = true;
+                sealed.push_back(m_collectingQuoteFlight);
+                m_collectingQuoteFlight.reset();
+            } else {
+                if (!m_quoteFlusherThread.joinable()) {
+                    m_quoteFlusherThread = std::thread(&MarketDataManager::runQuoteFlusher, this);
                 }
-            } catch (const std::exception& e) {
-                m_logger->error("Exception while parsing LTP response: {}", e.what());
+                m_quoteFlightCondition.notify_all();
             }
-        } else {
-            m_logger->error("Failed to get LTP. Status code: {}, Response: {}", 
-                          response.statusCode, response.body);
+        }
+    }
+    
+    if (joined > 0) {
+        m_logger->debug("Coalesced {} of {} quote tokens into requests already in flight", 
+                      joined, instrumentTokens.size());
+    }
+    
+    // The caller's quotes are gathered once the last flight it attached to completes
+    struct Gather {
+        std::vector<uint64_t> tokens;
+        std::vector<std::shared_ptr<QuoteFlight>> attached;
+        std::atomic<size_t> remaining{0};
+        Promise<std::unordered_map<uint64_t, InstrumentModel>> promise;
+    };
+    
+    auto gather = std::make_shared<Gather>();
+    gather->tokens = instrumentTokens;
+    gather->attached = attached;
+    auto result = gather->promise.getFuture();
+    
+    auto onFlightDone = [gather]() {
+        if (--gather->remaining > 0) {
+            return;
         }
         
-        return 0.0;
-    });
+        std::unordered_map<uint64_t, InstrumentModel> quotes;
+        quotes.reserve(gather->tokens.size());
+        for (size_t i = 0; i < gather->tokens.size(); ++i) {
+            auto it = gather->attached[i]->quotes.find(gather->tokens[i]);
+            if (it != gather->attached[i]->quotes.end()) {
+                quotes[gather->tokens[i]] = it->second;
+            }
+        }
+        gather->promise.setValue(std::move(quotes));
+    };
+    
+    std::vector<std::shared_ptr<QuoteFlight>> flights = attached;
+    std::sort(flights.begin(), flights.end());
+    flights.erase(std::unique(flights.begin(), flights.end()), flights.end());
+    gather->remaining = flights.size() + 1;
+    
+    size_t alreadyDone = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_quoteFlightMutex);
+        for (auto& flight : flights) {
+            if (flight->done) {
+                alreadyDone++;
+            } else {
+                flight->waiters.push_back(onFlightDone);
+            }
+        }
+    }
+    
+    // The extra count keeps an empty or completed request from resolving before this point
+    for (size_t i = 0; i <= alreadyDone; ++i) {
+        onFlightDone();
+    }
+    
+    for (auto& flight : sealed) {
+        sendQuoteFlight(flight);
+    }
+    
+    return result;
 }
 
-std::future<std::unordered_map<uint64_t, double>> MarketDataManager::getLTPs(
-    const std::vector<uint64_t>& instrumentTokens) {
+void MarketDataManager::sendQuoteFlight(std::shared_ptr<QuoteFlight> flight) {
+    m_logger->debug("Sending one quote request for {} tokens", flight->tokens.size());
     
-    return std::async(std::launch::async, [this, instrumentTokens]() {
-        m_logger->debug("Getting LTPs for {} instruments", instrumentTokens.size());
-        
-        std::unordered_map<uint64_t, double> result;
-        
-        // Zerodha API allows up to 250 instruments in one go
-        const size_t maxBatchSize = 250;
-        
-        for (size_t i = 0; i < instrumentTokens.size(); i += maxBatchSize) {
-            size_t batchSize = std::min(maxBatchSize, instrumentTokens.size() - i);
-            std::vector<uint64_t> batch(instrumentTokens.begin() + i, 
-                                       instrumentTokens.begin() + i + batchSize);
+    fetchQuoteBatch(flight->tokens, flight->flow, flight->store).then(
+        [this, flight](std::unordered_map<uint64_t, InstrumentModel> quotes) {
+            std::vector<std::function<void()>> waiters;
             
-            // Construct query parameters
-            std::unordered_map<std::string, std::string> params;
-            for (size_t j = 0; j < batch.size(); ++j) {
-                params["i"] = params["i"].empty() ? 
-                    std::to_string(batch[j]) : 
-                    params["i"] + "&i=" + std::to_string(batch[j]);
+            // Later requests for these tokens must fetch again rather than reuse this response
+            {
+                std::lock_guard<std::mutex> lock(m_quoteFlightMutex);
+                flight->quotes = std::move(quotes);
+                flight->done = true;
+                waiters.swap(flight->waiters);
+                
+                for (uint64_t token : flight->tokens) {
+                    auto it = m_quoteFlights.find(token);
+                    if (it != m_quoteFlights.end() && it->second == flight) {
+                        m_quoteFlights.erase(it);
+                    }
+                }
             }
             
-            HttpResponse response = makeRateLimitedApiRequest(HttpMethod::GET, "/quote/ltp", params);
+            for (auto& waiter : waiters) {
+                waiter();
+            }
+            return true;
+        });
+}
+
+void MarketDataManager::runQuoteFlusher() {
+    std::unique_lock<std::mutex> lock(m_quoteFlightMutex);
+    
+    while (!m_quoteFlusherStop) {
+        if (!m_collectingQuoteFlight) {
+            m_quoteFlightCondition.wait(lock, [this]() { 
+                return m_quoteFlusherStop || m_collectingQuoteFlight; 
+            });
+            continue;
+        }
+        
+        // Wait out the batch's window unless a caller fills it first
+        auto flight = m_collectingQuoteFlight;
+        m_quoteFlightCondition.wait_until(lock, flight->sealAt, [this, &flight]() {
+            return m_quoteFlusherStop || m_collectingQuoteFlight != flight;
+        });
+        
+        if (m_collectingQuoteFlight != flight) {
+            continue;
+        }
+        
+        // Window over (or shutting down): nobody else can join, so send what was collected
+        flight->sealed = true;
+        m_collectingQuoteFlight.reset();
+        
+        lock.unlock();
+        sendQuoteFlight(flight);
+        lock.lock();
+    }
+}
+
+void MarketDataManager::stopQuoteFlusher() {
+    {
+        std::lock_guard<std::mutex> lock(m_quoteFlightMutex);
+        m_quoteFlusherStop = true;
+    }
+    m_quoteFlightCondition.notify_all();
+    
+    if (m_quoteFlusherThread.joinable()) {
+        m_quoteFlusherThread.join();
+    }
+}
+
+Future<std::unordered_map<uint64_t, InstrumentModel>> MarketDataManager::fetchQuoteBatch(
+    const std::vector<uint64_t>& batch,
+    const std::string& flow,
+    std::shared_ptr<QuoteStore> store) {
+    
+    // Construct query parameters
+    std::unordered_map<std::string, std::string> params;
+    for (size_t j = 0; j < batch.size(); ++j) {
+        params["i"] = params["i"].empty() ? 
+            std::to_string(batch[j]) : 
+            params["i"] + "&i=" + std::to_string(batch[j]);
+    }
+    
+    // Quotes feed a running scan; a quote that waited past the deadline is too stale to be worth the budget
+    int deadlineMs = m_configManager->getIntValue("api/quote_deadline_ms", 30000);
+    auto deadline = deadlineMs > 0 ?
+        ApiScheduler::Clock::now() + std::chrono::milliseconds(deadlineMs) :
+        ApiScheduler::Clock::time_point::max();
+    
+    return submitApiRequest(
+        HttpMethod::GET, "/quote", params, "", RequestPriority::HIGH, deadline, nullptr, flow).then(
+        [this, store](HttpResponse response) {
+            std::unordered_map<uint64_t, InstrumentModel> result;
             
             if (response.statusCode == 200) {
-                try {
-                    json responseJson = json::parse(response.body);
-                    
-                    if (responseJson["status"] == "success") {
-                        json data = responseJson["data"];
-                        
-                        for (const auto& token : batch) {
-                            auto tokenStr = std::to_string(token);
-                            if (data.find(tokenStr) != data.end()) {
-                                double ltp = parseLTPJson(tokenStr, data[tokenStr]);
-                                
-                                // Update cache
-                                {
-                                    std::lock_guard<std::mutex> lock(m_cacheMutex);
-                                    
-                                    auto it = m_instrumentCache.find(token);
-                                    if (it != m_instrumentCache.end()) {
-                                        it->second.lastPrice = ltp;
-                                    }
-                                }
-                                
-                                result[token] = ltp;
-                            }
+                // Quotes are parsed straight into the store; each is then combined with the static instrument fields
+                QuoteParseResult parsed = QuoteResponseParser::parse(
+                    response.body, QuoteResponseKind::QUOTE, store.get(),
+                    [&](uint64_t token, uint32_t ordinal, const QuoteModel& quote) {
+                        if (ordinal != QuoteResponseParser::NO_ORDINAL) {
+                            result[token] = InstrumentModel(store->getUniverse()->at(ordinal), quote);
+                        } else {
+                            InstrumentRef instrument;
+                            instrument.instrumentToken = token;
+                            result[token] = InstrumentModel(instrument, quote);
                         }
-                    } else {
-                        m_logger->error("Failed to get LTPs: {}", responseJson["message"].get<std::string>());
-                    }
-                } catch (const std::exception& e) {
-                    m_logger->error("Exception while parsing LTPs response: {}", e.what());
+                    });
+                
+                if (!parsed.success) {
+                    m_logger->error("Failed to get quotes: {}", parsed.error);
                 }
             } else {
-                m_logger->error("Failed to get LTPs. Status code: {}, Response: {}", 
+                m_logger->error("Failed to get quotes. Status code: {}, Response: {}", 
                               response.statusCode, response.body);
             }
-        }
-        
-        m_logger->debug("Got LTPs for {} instruments", result.size());
-        return result;
-    });
+            
+            return result;
+        });
 }
 
-std::future<std::tuple<double, double, double, double>> MarketDataManager::getOHLC(
-    uint64_t instrumentToken) {
+size_t MarketDataManager::getQuoteBatchSize() const {
+    // Kite accepts up to 500 instruments per /quote request
+    int batchSize = m_configManager->getIntValue("api/quote_batch_size", 500);
+    return static_cast<size_t>(std::clamp(batchSize, 1, 500));
+}
+
+size_t MarketDataManager::getLtpBatchSize() const {
+    // Kite accepts up to 1000 instruments per /quote/ltp and /quote/ohlc request
+    int batchSize = m_configManager->getIntValue("api/ltp_batch_size", 1000);
+    return static_cast<size_t>(std::clamp(batchSize, 1, 1000));
+}
+
+Future<double> MarketDataManager::getLTP(uint64_t instrumentToken) {
+    m_logger->debug("Getting LTP for instrument: {}", instrumentToken);
     
-    return std::async(std::launch::async, [this, instrumentToken]() {
-        m_logger->debug("Getting OHLC for instrument: {}", instrumentToken);
-        
-        // Construct query parameters
-        std::unordered_map<std::string, std::string> params = {
-            {"i", std::to_string(instrumentToken)}
-        };
-        
-        HttpResponse response = makeRateLimitedApiRequest(HttpMethod::GET, "/quote/ohlc", params);
-        
-        if (response.statusCode == 200) {
-            try {
-                json responseJson = json::parse(response.body);
+    // Construct query parameters
+    std::unordered_map<std::string, std::string> params = {
+        {"i", std::to_string(instrumentToken)}
+    };
+    
+    auto store = std::atomic_load(&m_quoteStore);
+    
+    return submitApiRequest(HttpMethod::GET, "/quote/ltp", params, "", RequestPriority::NORMAL).then(
+        [this, instrumentToken, store](HttpResponse response) {
+            if (response.statusCode == 200) {
+                double ltp = 0.0;
+                bool found = false;
                 
-                if (responseJson["status"] == "success") {
-                    json data = responseJson["data"];
-                    
-                    auto instrumentTokenStr = std::to_string(instrumentToken);
-                    if (data.find(instrumentTokenStr) != data.end()) {
-                        auto ohlc = parseOHLCJson(instrumentTokenStr, data[instrumentTokenStr]);
-                        
-                        // Update cache
-                        {
-                            std::lock_guard<std::mutex> lock(m_cacheMutex);
-                            
-                            auto it = m_instrumentCache.find(instrumentToken);
-                            if (it != m_instrumentCache.end()) {
-                                it->second.openPrice = std::get<0>(ohlc);
-                                it->second.highPrice = std::get<1>(ohlc);
-                                it->second.lowPrice = std::get<2>(ohlc);
-                                it->second.closePrice = std::get<3>(ohlc);
-                            }
+                QuoteParseResult parsed = QuoteResponseParser::parse(
+                    response.body, QuoteResponseKind::LTP, store.get(),
+                    [&](uint64_t token, uint32_t, const QuoteModel& quote) {
+                        if (token == instrumentToken) {
+                            ltp = quote.lastPrice;
+                            found = true;
                         }
-                        
-                        m_logger->debug("Got OHLC for instrument: {}", instrumentToken);
-                        return ohlc;
-                    } else {
-                        m_logger->warn("OHLC data for instrument {} not found in response", instrumentToken);
-                    }
+                    });
+                
+                if (!parsed.success) {
+                    m_logger->error("Failed to get LTP: {}", parsed.error);
+                } else if (found) {
+                    m_logger->debug("Got LTP for instrument {}: {}", instrumentToken, ltp);
+                    return ltp;
                 } else {
-                    m_logger->error("Failed to get OHLC: {}", responseJson["message"].get<std::string>());
+                    m_logger->warn("LTP data for instrument {} not found in response", instrumentToken);
                 }
-            } catch (const std::exception& e) {
-                m_logger->error("Exception while parsing OHLC response: {}", e.what());
+            } else {
+                m_logger->error("Failed to get LTP. Status code: {}, Response: {}", 
+                              response.statusCode, response.body);
             }
-        } else {
-            m_logger->error("Failed to get OHLC. Status code: {}, Response: {}", 
-                          response.statusCode, response.body);
-        }
-        
-        return std::make_tuple(0.0, 0.0, 0.0, 0.0);
-    });
+            
+            return 0.0;
+        });
 }
 
-std::future<std::unordered_map<uint64_t, std::tuple<double, double, double, double>>> 
-MarketDataManager::getOHLCs(const std::vector<uint64_t>& instrumentTokens) {
+Future<std::unordered_map<uint64_t, double>> MarketDataManager::getLTPs(
+    const std::vector<uint64_t>& instrumentTokens,
+    const std::string& flow,
+    std::shared_ptr<QuoteStore> store) {
     
-    return std::async(std::launch::async, [this, instrumentTokens]() {
-        m_logger->debug("Getting OHLCs for {} instruments", instrumentTokens.size());
-        
-        std::unordered_map<uint64_t, std::tuple<double, double, double, double>> result;
+    m_logger->debug("Getting LTPs for {} instruments", instrumentTokens.size());
+    
+    if (!store) {
+        store = std::atomic_load(&m_quoteStore);
+    }
+    
+    const size_t maxBatchSize = getLtpBatchSize();
+    std::vector<Future<std::unordered_map<uint64_t, double>>> batches;
+    
+    for (size_t i = 0; i < instrumentTokens.size(); i += maxBatchSize) {
+        size_t batchSize = std::min(maxBatchSize, instrumentTokens.size() - i);
+        std::vector<uint64_t> batch(instrumentTokens.begin() + i, 
+                                   instrumentTokens.begin() + i + batchSize);
         
-        // Zerodha API allows up to 250 instruments in one go
-        const size_t maxBatchSize = 250;
+        // Construct query parameters
+        std::unordered_map<std::string, std::string> params;
+        for (size_t j = 0; j < batch.size(); ++j) {
+            params["i"] = params["i"].empty() ? 
+                std::to_string(batch[j]) : 
+                params["i"] + "&i=" + std::to_string(batch[j]);
+        }
         
-        for (size_t i = 0; i < instrumentTokens.size(); i += maxBatchSize) {
-            size_t batchSize = std::min(maxBatchSize, instrumentTokens.size() - i);
-            std::vector<uint64_t> batch(instrumentTokens.begin() + i, 
-                                       instrumentTokens.begin() + i + batchSize);
-            
-            // Construct query parameters
-            std::unordered_map<std::string, std::string> params;
-            for (size_t j = 0; j < batch.size(); ++j) {
-                params["i"] = params["i"].empty() ? 
-                    std::to_string(batch[j]) : 
-                    params["i"] + "&i=" + std::to_string(batch[j]);
+        batches.push_back(submitApiRequest(
+            HttpMethod::GET, "/quote/ltp", params, "", RequestPriority::NORMAL,
+            ApiScheduler::Clock::time_point::max(), nullptr, flow).then(
+            [this, store](HttpResponse response) {
+                std::unordered_map<uint64_t, double> result;
+                
+                if (response.statusCode == 200) {
+                    QuoteParseResult parsed = QuoteResponseParser::parse(
+                        response.body, QuoteResponseKind::LTP, store.get(),
+                        [&](uint64_t token, uint32_t, const QuoteModel& quote) {
+                            result[token] = quote.lastPrice;
+                        });
+                    
+                    if (!parsed.success) {
+                        m_logger->error("Failed to get LTPs: {}", parsed.error);
+                    }
+                } else {
+                    m_logger->error("Failed to get LTPs. Status code: {}, Response: {}", 
+                                  response.statusCode, response.body);
+                }
+                
+                return result;
+            }));
+    }
+    
+    return whenAll(std::move(batches)).then(
+        [this](std::vector<std::unordered_map<uint64_t, double>> batchResults) {
+            std::unordered_map<uint64_t, double> result;
+            for (auto& batchResult : batchResults) {
+                result.insert(batchResult.begin(), batchResult.end());
             }
             
-            HttpResponse response = makeRateLimitedApiRequest(HttpMethod::GET, "/quote/ohlc", params);
-            
+            m_logger->debug("Got LTPs for {} instruments", result.size());
+            return result;
+        });
+}
+
+Future<std::tuple<double, double, double, double>> MarketDataManager::getOHLC(
+    uint64_t instrumentToken) {
+    
+    m_logger->debug("Getting OHLC for instrument: {}", instrumentToken);
+    
+    // Construct query parameters
+    std::unordered_map<std::string, std::string> params = {
+        {"i", std::to_string(instrumentToken)}
+    };
+    
+    auto store = std::atomic_load(&m_quoteStore);
+    
+    return submitApiRequest(HttpMethod::GET, "/quote/ohlc", params, "", RequestPriority::NORMAL).then(
+        [this, instrumentToken, store](HttpResponse response) {
             if (response.statusCode == 200) {
-                try {
-                    json responseJson = json::parse(response.body);
-                    
-                    if (responseJson["status"] == "success") {
-                        json data = responseJson["data"];
-                        
-                        for (const auto& token : batch) {
-                            auto tokenStr = std::to_string(token);
-                            if (data.find(tokenStr) != data.end()) {
-                                auto ohlc = parseOHLCJson(tokenStr, data[tokenStr]);
-                                
-                                // Update cache
-                                {
-                                    std::lock_guard<std::mutex> lock(m_cacheMutex);
-                                    
-                                    auto it = m_instrumentCache.find(token);
-                                    if (it != m_instrumentCache.end()) {
-                                        it->second.openPrice = std::get<0>(ohlc);
-                                        it->second.highPrice = std::get<1>(ohlc);
-                                        it->second.lowPrice = std::get<2>(ohlc);
-                                        it->second.closePrice = std::get<3>(ohlc);
-                                    }
-                                }
-                                
-                                result[token] = ohlc;
-                            }
+                std::tuple<double, double, double, double> ohlc;
+                bool found = false;
+                
+                QuoteParseResult parsed = QuoteResponseParser::parse(
+                    response.body, QuoteResponseKind::OHLC, store.get(),
+                    [&](uint64_t token, uint32_t, const QuoteModel& quote) {
+                        if (token == instrumentToken) {
+                            ohlc = std::make_tuple(quote.openPrice, quote.highPrice, quote.lowPrice, quote.closePrice);
+                            found = true;
                         }
-                    } else {
-                        m_logger->error("Failed to get OHLCs: {}", responseJson["message"].get<std::string>());
-                    }
-                } catch (const std::exception& e) {
-                    m_logger->error("Exception while parsing OHLCs response: {}", e.what());
+                    });
+                
+                if (!parsed.success) {
+                    m_logger->error("Failed to get OHLC: {}", parsed.error);
+                } else if (found) {
+                    m_logger->debug("Got OHLC for instrument: {}", instrumentToken);
+                    return ohlc;
+                } else {
+                    m_logger->warn("OHLC data for instrument {} not found in response", instrumentToken);
                 }
             } else {
-                m_logger->error("Failed to get OHLCs. Status code: {}, Response: {}", 
+                m_logger->error("Failed to get OHLC. Status code: {}, Response: {}", 
                               response.statusCode, response.body);
             }
+            
+            return std::make_tuple(0.0, 0.0, 0.0, 0.0);
+        });
+}
+
+Future<std::unordered_map<uint64_t, std::tuple<double, double, double, double>>> 
+MarketDataManager::getOHLCs(const std::vector<uint64_t>& instrumentTokens) {
+    
+    using OHLCMap = std::unordered_map<uint64_t, std::tuple<double, double, double, double>>;
+    
+    m_logger->debug("Getting OHLCs for {} instruments", instrumentTokens.size());
+    
+    auto store = std::atomic_load(&m_quoteStore);
+    
+    const size_t maxBatchSize = getLtpBatchSize();
+    std::vector<Future<OHLCMap>> batches;
+    
+    for (size_t i = 0; i < instrumentTokens.size(); i += maxBatchSize) {
+        size_t batchSize = std::min(maxBatchSize, instrumentTokens.size() - i);
+        std::vector<uint64_t> batch(instrumentTokens.begin() + i, 
+                                   instrumentTokens.begin() + i + batchSize);
+        
+        // Construct query parameters
+        std::unordered_map<std::string, std::string> params;
+        for (size_t j = 0; j < batch.size(); ++j) {
+            params["i"] = params["i"].empty() ? 
+                std::to_string(batch[j]) : 
+                params["i"] + "&i=" + std::to_string(batch[j]);
+        }
+        
+        batches.push_back(submitApiRequest(HttpMethod::GET, "/quote/ohlc", params, "", RequestPriority::NORMAL).then(
+            [this, store](HttpResponse response) {
+                OHLCMap result;
+                
+                if (response.statusCode == 200) {
+                    QuoteParseResult parsed = QuoteResponseParser::parse(
+                        response.body, QuoteResponseKind::OHLC, store.get(),
+                        [&](uint64_t token, uint32_t, const QuoteModel& quote) {
+                            result[token] = std::make_tuple(quote.openPrice, quote.highPrice, quote.lowPrice, quote.closePrice);
+                        });
+                    
+                    if (!parsed.success) {
+                        m_logger->error("Failed to get OHLCs: {}", parsed.error);
+                    }
+                } else {
+                    m_logger->error("Failed to get OHLCs. Status code: {}, Response: {}", 
+                                  response.statusCode, response.body);
+                }
+                
+                return result;
+            }));
+    }
+    
+    return whenAll(std::move(batches)).then([this](std::vector<OHLCMap> batchResults) {
+        OHLCMap result;
+        for (auto& batchResult : batchResults) {
+            result.insert(batchResult.begin(), batchResult.end());
         }
         
         m_logger->debug("Got OHLCs for {} instruments", result.size());
@@ -702,151 +1058,59 @@ MarketDataManager::getOHLCs(const std::vector<uint64_t>& instrumentTokens) {
     });
 }
 
-std::future<InstrumentModel> MarketDataManager::getMarketDepth(uint64_t instrumentToken) {
+Future<InstrumentModel> MarketDataManager::getMarketDepth(uint64_t instrumentToken) {
     // Market depth is included in quote response, so we can just call getQuote
     return getQuote(instrumentToken);
 }
 
-std::vector<InstrumentModel> MarketDataManager::parseInstrumentsCSV(const std::string& csvData) {
-    std::vector<InstrumentModel> instruments;
+std::vector<InstrumentRef> MarketDataManager::parseInstrumentsCSV(const std::string& csvData) {
+    // Debug info about header
+    if (m_configManager->getBoolValue("debug/verbose", false)) {
+        m_logger->debug("CSV Header: {}", csvData.substr(0, csvData.find('\n')));
+    }
     
-    std::istringstream stream(csvData);
-    std::string line;
+    auto startTime = std::chrono::steady_clock::now();
     
-    // Skip header line
-    std::getline(stream, line);
+    int parseThreads = m_configManager->getIntValue("api/instruments_parse_threads", 0);
+    InstrumentCsvParser parser(static_cast<size_t>(std::max(0, parseThreads)), std::atomic_load(&m_threadPool).get());
+    CsvParseResult result = parser.parse(csvData);
     
-    // Debug info about header
-    if (m_configManager->getBoolValue("debug/verbose", false)) {
-        m_logger->debug("CSV Header: {}", line);
+    auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - startTime).count();
+    
+    return summarizeInstruments(std::move(result), elapsedMs);
+}
+
+std::vector<InstrumentRef> MarketDataManager::summarizeInstruments(CsvParseResult result, int64_t elapsedMs) {
+    if (result.errorCount > 0) {
+        m_logger->warn("Skipped {} of {} instrument CSV lines (first error on line {}: {})", 
+                     result.errorCount, result.lineCount, result.firstErrorLine, 
+                     InstrumentCsvParser::errorToString(result.firstError));
     }
     
-    int lineCount = 0;
+    std::vector<InstrumentRef> instruments = std::move(result.instruments);
+    
     int optionCount = 0;
     int futureCount = 0;
     int equityCount = 0;
     int niftyOptionCount = 0;
     
-    while (std::getline(stream, line)) {
-        lineCount++;
-        std::istringstream lineStream(line);
-        std::string field;
-        std::vector<std::string> fields;
-        
-        while (std::getline(lineStream, field, ',')) {
-            fields.push_back(field);
-        }
-        
-        // Ensure we have enough fields
-        if (fields.size() < 11) {
-            continue;
-        }
-        
-        InstrumentModel instrument;
-        
-        try {
-            // Parse instrument token
-            instrument.instrumentToken = std::stoull(fields[0]);
-            
-            // Parse exchange token
-            instrument.exchangeToken = fields[1];
-            
-            // Parse trading symbol
-            instrument.tradingSymbol = fields[2];
-            
-            // Parse name
-            instrument.name = fields[3];
-            
-            // Parse last price
-            if (!fields[4].empty()) {
-                instrument.lastPrice = std::stod(fields[4]);
-            }
-            
-            // Parse expiry
-            if (fields.size() > 5 && !fields[5].empty()) {
-                instrument.expiry = InstrumentModel::parseDate(fields[5]);
-            }
-            
-            // Parse strike price
-            if (fields.size() > 6 && !fields[6].empty()) {
-                instrument.strikePrice = std::stod(fields[6]);
-            }
-            
-            // Parse tick size
-            // Not used in our model but available in fields[7]
-            
-            // Parse lot size
-            // Not used in our model but available in fields[8]
-            
-            // Parse instrument type from Kite API
-            if (fields.size() > 9) {
-                instrument.type = InstrumentModel::stringToInstrumentType(fields[9]);
-                
-                // For options, special handling may be needed
-                if (fields[9] == "CE") {
-                    instrument.type = InstrumentType::OPTION;
-                    instrument.optionType = OptionType::CALL;
-                } else if (fields[9] == "PE") {
-                    instrument.type = InstrumentType::OPTION;
-                    instrument.optionType = OptionType::PUT;
-                }
-            }
-            
-            // Parse segment
-            if (fields.size() > 10) {
-                instrument.segment = fields[10];
-                
-                // Use segment to assist with instrument type detection
-                if (instrument.segment.find("NFO-OPT") != std::string::npos) {
-                    instrument.type = InstrumentType::OPTION;
-                } else if (instrument.segment.find("NFO-FUT") != std::string::npos) {
-                    instrument.type = InstrumentType::FUTURE;
-                }
-            }
-            
-            // Parse exchange
-            if (fields.size() > 11) {
-                instrument.exchange = fields[11];
-            }
-            
-            // For NIFTY options/futures set the underlying field and extract info from trading symbol
-            if (instrument.tradingSymbol.find("NIFTY") == 0) {
-                instrument.underlying = "NIFTY";
-                
-                // Check for OPTION by examining trading symbol pattern (e.g., NIFTY23JUN2118000CE)
-                if (instrument.tradingSymbol.find("CE") != std::string::npos) {
-                    instrument.type = InstrumentType::OPTION;
-                    instrument.optionType = OptionType::CALL;
-                    niftyOptionCount++;
-                } else if (instrument.tradingSymbol.find("PE") != std::string::npos) {
-                    instrument.type = InstrumentType::OPTION;
-                    instrument.optionType = OptionType::PUT;
-                    niftyOptionCount++;
-                }
-                // Check for FUTURE by examining trading symbol pattern (e.g., NIFTYJUN23FUT)
-                else if (instrument.tradingSymbol.find("FUT") != std::string::npos) {
-                    instrument.type = InstrumentType::FUTURE;
-                    futureCount++;
-                }
-            }
-            
-            // Count instrument types for logging
-            if (instrument.type == InstrumentType::OPTION) {
-                optionCount++;
-            } else if (instrument.type == InstrumentType::FUTURE) {
-                futureCount++;
-            } else if (instrument.type == InstrumentType::EQUITY) {
-                equityCount++;
+    // Count instrument types for logging
+    for (const auto& instrument : instruments) {
+        if (instrument.type == InstrumentType::OPTION) {
+            optionCount++;
+            if (instrument.underlying == "NIFTY") {
+                niftyOptionCount++;
             }
-            
-            instruments.push_back(instrument);
-        } catch (const std::exception& e) {
-            m_logger->error("Exception while parsing instrument CSV line {}: {}", lineCount, e.what());
+        } else if (instrument.type == InstrumentType::FUTURE) {
+            futureCount++;
+        } else if (instrument.type == InstrumentType::EQUITY) {
+            equityCount++;
         }
     }
     
     // Log statistics
-    m_logger->info("Parsed {} instruments from CSV data", instruments.size());
+    m_logger->info("Parsed {} instruments from CSV data in {} ms", instruments.size(), elapsedMs);
     m_logger->info("Instrument counts: OPTIONS={}, FUTURES={}, EQUITY={}, NIFTY OPTIONS={}", 
                  optionCount, futureCount, equityCount, niftyOptionCount);
     
@@ -854,15 +1118,9 @@ std::vector<InstrumentModel> MarketDataManager::parseInstrumentsCSV(const std::s
     int debugCount = 0;
     for (const auto& instrument : instruments) {
         if (instrument.underlying == "NIFTY" && instrument.type == InstrumentType::OPTION && debugCount < 5) {
-            auto time_t_val = std::chrono::system_clock::to_time_t(instrument.expiry);
-            std::tm* tm = std::localtime(&time_t_val);
-            
-            std::stringstream ss;
-            ss << std::put_time(tm, "%Y-%m-%d");
-            
             m_logger->debug("NIFTY Option: symbol={}, expiry={}, strike={}, type={}", 
                           instrument.tradingSymbol, 
-                          ss.str(),
+                          instrument.expiry,
                           instrument.strikePrice,
                           InstrumentModel::optionTypeToString(instrument.optionType));
             debugCount++;
@@ -872,251 +1130,105 @@ std::vector<InstrumentModel> MarketDataManager::parseInstrumentsCSV(const std::s
     return instruments;
 }
 
-InstrumentModel MarketDataManager::parseQuoteJson(
-    const std::string& instrumentTokenStr, const nlohmann::json& quoteJson) {
+HttpResponse MarketDataManager::makeRateLimitedApiRequest(
+    HttpMethod method,
+    const std::string& endpoint,
+    const std::unordered_map<std::string, std::string>& params,
+    const std::string& body,
+    RequestPriority priority) {
     
-    InstrumentModel instrument;
+    return submitApiRequest(method, endpoint, params, body, priority).get();
+}
+
+Future<HttpResponse> MarketDataManager::submitApiRequest(
+    HttpMethod method,
+    const std::string& endpoint,
+    const std::unordered_map<std::string, std::string>& params,
+    const std::string& body,
+    RequestPriority priority,
+    ApiScheduler::Clock::time_point deadline,
+    const HttpClient::BodySink& sink,
+    const std::string& flow) {
     
-    try {
-        // Parse instrument token
-        instrument.instrumentToken = std::stoull(instrumentTokenStr);
-        
-        // Parse last price
-        if (quoteJson.contains("last_price")) {
-            instrument.lastPrice = quoteJson["last_price"].get<double>();
-        }
-        
-        // Parse OHLC
-        if (quoteJson.contains("ohlc")) {
-            auto& ohlc = quoteJson["ohlc"];
-            
-            if (ohlc.contains("open")) {
-                instrument.openPrice = ohlc["open"].get<double>();
-            }
-            
-            if (ohlc.contains("high")) {
-                instrument.highPrice = ohlc["high"].get<double>();
-            }
-            
-            if (ohlc.contains("low")) {
-                instrument.lowPrice = ohlc["low"].get<double>();
-            }
-            
-            if (ohlc.contains("close")) {
-                instrument.closePrice = ohlc["close"].get<double>();
-            }
-        }
-        
-        // Parse average price
-        if (quoteJson.contains("average_price")) {
-            instrument.averagePrice = quoteJson["average_price"].get<double>();
-        }
-        
-        // Parse volume
-        if (quoteJson.contains("volume")) {
-            instrument.volume = quoteJson["volume"].get<uint64_t>();
-        }
-        
-        // Parse buy quantity
-        if (quoteJson.contains("buy_quantity")) {
-            instrument.buyQuantity = quoteJson["buy_quantity"].get<uint64_t>();
-        }
-        
-        // Parse sell quantity
-        if (quoteJson.contains("sell_quantity")) {
-            instrument.sellQuantity = quoteJson["sell_quantity"].get<uint64_t>();
-        }
-        
-        // Parse open interest
-        if (quoteJson.contains("open_interest")) {
-            instrument.openInterest = quoteJson["open_interest"].get<double>();
+    // A replay answers from the journal: no token, no rate limit, no network
+    if (auto replayEngine = std::atomic_load(&m_replayEngine)) {
+        HttpResponse response = replayEngine->respond(endpoint, params);
+        
+        // Streamed bodies go to the sink, as they would from the HTTP client
+        if (sink && response.statusCode == 200) {
+            sink(response.body.data(), response.body.size());
+            response.body.clear();
         }
+        return makeReadyFuture(std::move(response));
+    }
+    
+    // Check if token is valid
+    if (!m_authManager->isAccessTokenValid()) {
+        m_logger->error("Access token is not valid for API request");
         
-        // Parse market depth
-        if (quoteJson.contains("depth")) {
-            auto& depth = quoteJson["depth"];
-            
-            // Parse buy depth
-            if (depth.contains("buy")) {
-                for (const auto& level : depth["buy"]) {
-                    InstrumentModel::DepthItem item;
-                    
-                    if (level.contains("price")) {
-                        item.price = level["price"].get<double>();
-                    }
-                    
-                    if (level.contains("quantity")) {
-                        item.quantity = level["quantity"].get<uint64_t>();
-                    }
-                    
-                    if (level.contains("orders")) {
-                        item.orders = level["orders"].get<uint32_t>();
-                    }
-                    
-                    instrument.buyDepth.push_back(item);
-                }
-            }
-            
-            // Parse sell depth
-            if (depth.contains("sell")) {
-                for (const auto& level : depth["sell"]) {
-                    InstrumentModel::DepthItem item;
-                    
-                    if (level.contains("price")) {
-                        item.price = level["price"].get<double>();
-                    }
-                    
-                    if (level.contains("quantity")) {
-                        item.quantity = level["quantity"].get<uint64_t>();
-                    }
-                    
-                    if (level.contains("orders")) {
-                        item.orders = level["orders"].get<uint32_t>();
-                    }
-                    
-                    instrument.sellDepth.push_back(item);
-                }
-            }
-        }
-    } catch (const std::exception& e) {
-        m_logger->error("Exception while parsing quote JSON: {}", e.what());
+        return makeReadyFuture(HttpResponse{401, "Access token is not valid", {}, {}});
     }
     
-    return instrument;
+    // The scheduler dispatches the request once the endpoint's budget allows it. Failures become
+    // responses so that continuations chained on the future always run
+    return m_apiScheduler->submit(
+        endpoint,
+        [this, method, endpoint, params, body, sink](ApiScheduler::Completion done) {
+            try {
+                performApiRequest(method, endpoint, params, body, sink, done);
+            } catch (const std::exception& e) {
+                m_logger->error("API request to {} failed: {}", endpoint, e.what());
+                done(HttpResponse{0, e.what(), {}, {}});
+            }
+        },
+        priority,
+        deadline,
+        flow);
 }
 
-double MarketDataManager::parseLTPJson(
-    const std::string& instrumentTokenStr, const nlohmann::json& ltpJson) {
-    
-    try {
-        if (ltpJson.contains("last_price")) {
-            return ltpJson["last_price"].get<double>();
-        }
-    } catch (const std::exception& e) {
-        m_logger->error("Exception while parsing LTP JSON: {}", e.what());
-    }
-    
-    return 0.0;
+std::vector<EndpointUtilization> MarketDataManager::getApiUtilization() const {
+    return m_apiScheduler->getUtilization();
 }
 
-std::tuple<double, double, double, double> MarketDataManager::parseOHLCJson(
-    const std::string& instrumentTokenStr, const nlohmann::json& ohlcJson) {
-    
-    double open = 0.0;
-    double high = 0.0;
-    double low = 0.0;
-    double close = 0.0;
-    
-    try {
-        if (ohlcJson.contains("ohlc")) {
-            auto& ohlc = ohlcJson["ohlc"];
-            
-            if (ohlc.contains("open")) {
-                open = ohlc["open"].get<double>();
-            }
-            
-            if (ohlc.contains("high")) {
-                high = ohlc["high"].get<double>();
-            }
-            
-            if (ohlc.contains("low")) {
-                low = ohlc["low"].get<double>();
-            }
-            
-            if (ohlc.contains("close")) {
-                close = ohlc["close"].get<double>();
+void MarketDataManager::logApiUtilization() const {
+    for (const auto& endpoint : m_apiScheduler->getUtilization()) {
+        if (endpoint.dispatched == 0 && endpoint.expired == 0) {
+            continue;
+        }
+        
+        m_logger->info("API {}: {} requests at {:.1f}/min, {:.0f}% of budget used, "
+                     "{:.0f} ms average wait, {} queued, {} expired",
+                     endpoint.endpoint, endpoint.dispatched, endpoint.requestsPerMinute,
+                     endpoint.utilization * 100.0, endpoint.averageWaitMs, endpoint.queued, endpoint.expired);
+        
+        // How the budget was split between concurrent scans
+        if (endpoint.dispatchedByFlow.size() > 1) {
+            std::string split;
+            for (const auto& [flow, dispatched] : endpoint.dispatchedByFlow) {
+                split += fmt::format("{}{} {}", split.empty() ? "" : ", ", flow, dispatched);
             }
+            m_logger->info("API {} by underlying: {}", endpoint.endpoint, split);
         }
-    } catch (const std::exception& e) {
-        m_logger->error("Exception while parsing OHLC JSON: {}", e.what());
-    }
-    
-    return std::make_tuple(open, high, low, close);
-}
-
-bool MarketDataManager::checkRateLimit(const std::string& endpoint) {
-    // Get current time
-    auto now = std::chrono::system_clock::now();
-    
-    // Find rate limit info for this endpoint or use default
-    std::string rateKey = endpoint;
-    std::lock_guard<std::mutex> globalLock(m_rateLimitMutex);
-    
-    if (m_rateLimits.find(endpoint) == m_rateLimits.end()) {
-        rateKey = "default";
-    }
-    
-    RateLimitInfo& rateInfo = m_rateLimits[rateKey];
-    std::lock_guard<std::mutex> lock(*rateInfo.mtx);
-    
-    // Remove requests older than 1 minute
-    auto oneMinuteAgo = now - std::chrono::minutes(1);
-    while (!rateInfo.requestTimes.empty() && rateInfo.requestTimes.front() < oneMinuteAgo) {
-        rateInfo.requestTimes.pop();
     }
     
-    // Check if we can make a new request
-    if (rateInfo.requestTimes.size() < static_cast<size_t>(rateInfo.requestsPerMinute)) {
-        // Add this request to the queue
-        rateInfo.requestTimes.push(now);
-        return true;
+    HttpClientStats http = m_httpClient->getStats();
+    if (http.requests > 0) {
+        m_logger->info("HTTP: {} requests, {:.0f}% on kept-alive connections, new connections took "
+                     "{:.1f} ms to connect and {:.1f} ms for TLS, {:.1f} ms average to first byte",
+                     http.requests, 100.0 * http.reused / http.requests, http.averageConnectMs,
+                     http.averageTlsMs, http.averageFirstByteMs);
     }
-    
-    // Calculate wait time if rate limit is exceeded
-    auto oldestRequest = rateInfo.requestTimes.front();
-    auto waitTime = std::chrono::duration_cast<std::chrono::milliseconds>(
-        (oldestRequest + std::chrono::minutes(1)) - now);
-    
-    m_logger->warn("Rate limit exceeded for {}. Waiting {} ms before retrying", 
-                 endpoint, waitTime.count());
-    
-    // Release locks before sleeping
-    lock.~lock_guard();
-    globalLock.~lock_guard();
-    
-    // Sleep for the required wait time
-    std::this_thread::sleep_for(waitTime);
-    
-    // Try again
-    return checkRateLimit(endpoint);
 }
 
-HttpResponse MarketDataManager::makeRateLimitedApiRequest(
+void MarketDataManager::performApiRequest(
     HttpMethod method,
     const std::string& endpoint,
     const std::unordered_map<std::string, std::string>& params,
-    const std::string& body) {
-    
-    // Check if token is valid
-    if (!m_authManager->isAccessTokenValid()) {
-        m_logger->error("Access token is not valid for API request");
-        return HttpResponse{401, "Access token is not valid", {}};
-    }
-    
-    // Check and enforce rate limits
-    if (!checkRateLimit(endpoint)) {
-        m_logger->error("Rate limit exceeded for {}", endpoint);
-        return HttpResponse{429, "Rate limit exceeded", {}};
-    }
+    const std::string& body,
+    const HttpClient::BodySink& sink,
+    HttpClient::Callback callback) {
     
-    // Special handling for instrument list - use cached version if available
-    if (endpoint == "/instruments") {
-        auto now = std::chrono::system_clock::now();
-        if (m_instrumentsCached && (now - m_lastInstrumentsFetch) < m_instrumentsCacheTTL) {
-            m_logger->info("Using cached instruments (cache valid for {} more minutes)", 
-                         std::chrono::duration_cast<std::chrono::minutes>(
-                             m_lastInstrumentsFetch + m_instrumentsCacheTTL - now).count());
-            
-            // Return cached instruments
-            // But update the last fetch time to avoid multiple threads requesting at once
-            m_lastInstrumentsFetch = now;
-            
-            // This would return the cached data, but since we don't have it yet,
-            // we'll proceed with the API call for now
-        }
-    }
-    
-    std::string url = "https://api.kite.trade" + endpoint;
+    std::string url = m_authManager->getApiBaseUrl() + endpoint;
     
     // Add query parameters to URL
     if (!params.empty()) {
@@ -1139,245 +1251,320 @@ HttpResponse MarketDataManager::makeRateLimitedApiRequest(
         {"Authorization", "token " + m_authManager->getApiKey() + ":" + m_authManager->getAccessToken()}
     };
     
-    // Make the request
-    HttpResponse response = m_httpClient->request(method, url, headers, body);
+    // A streamed body is copied aside on its way to the sink when it has to be journaled
+    auto journal = std::atomic_load(&m_journal);
+    auto streamedBody = std::make_shared<std::string>();
+    HttpClient::BodySink requestSink = sink;
     
-    // Update instrument cache metadata if instruments were fetched
-    if (endpoint == "/instruments" && response.statusCode == 200) {
-        m_instrumentsCached = true;
-        m_lastInstrumentsFetch = std::chrono::system_clock::now();
-        m_logger->info("Updated instruments cache");
-    }
-    
-    // Check for authentication error
-    if (response.statusCode == 403 || response.statusCode == 401) {
-        m_logger->warn("Authentication error in API request. Status code: {}", response.statusCode);
-        
-        // Clear the access token so that it's renewed on the next request
-        m_authManager->invalidateAccessToken();
+    if (sink && journal) {
+        requestSink = [sink, streamedBody](const char* data, size_t size) {
+            streamedBody->append(data, size);
+            return sink(data, size);
+        };
     }
     
-    // Handle rate limit errors
-    if (response.statusCode == 429) {
-        m_logger->warn("Rate limit error from API. Consider adjusting rate limits in config.");
-        
-        // Increase the backoff for this endpoint
-        std::lock_guard<std::mutex> lock(m_rateLimitMutex);
-        std::string rateKey = endpoint;
+    // The checks below are quick, so they run on the I/O thread before the response is handed on
+    bool streamed = static_cast<bool>(sink);
+    HttpClient::Callback onResponse = [this, endpoint, params, journal, streamedBody, streamed, 
+                                       callback = std::move(callback)](HttpResponse response) {
+        if (journal && response.statusCode == 200) {
+            journal->append(MarketDataJournal::kindForEndpoint(endpoint),
+                            MarketDataJournal::requestKey(endpoint, params),
+                            streamed ? *streamedBody : response.body);
+        }
         
-        if (m_rateLimits.find(endpoint) == m_rateLimits.end()) {
-            rateKey = "default";
+        // Check for authentication error
+        if (response.statusCode == 403 || response.statusCode == 401) {
+            m_logger->warn("Authentication error in API request. Status code: {}", response.statusCode);
+            
+            // Clear the access token so that it's renewed on the next request
+            m_authManager->invalidateAccessToken();
         }
         
-        // Reduce rate limit by 20%
-        m_rateLimits[rateKey].requestsPerMinute = 
-            std::max(1, static_cast<int>(m_rateLimits[rateKey].requestsPerMinute * 0.8));
+        // Handle rate limit errors
+        if (response.statusCode == 429) {
+            m_logger->warn("Rate limit error from API. Consider adjusting rate limits in config.");
+            
+            // Reduce rate limit by 20%
+            double requestsPerMinute = m_apiScheduler->reduceRateLimit(endpoint, 0.8, 1.0);
+            
+            m_logger->info("Adjusted rate limit for {} to {:.1f} requests per minute", 
+                         endpoint, requestsPerMinute);
+        }
         
-        m_logger->info("Adjusted rate limit for {} to {} requests per minute", 
-                     endpoint, m_rateLimits[rateKey].requestsPerMinute);
-    }
+        callback(std::move(response));
+    };
     
-    return response;
+    // Make the request
+    if (requestSink) {
+        m_httpClient->requestAsync(method, url, headers, body, requestSink, std::move(onResponse));
+    } else {
+        m_httpClient->requestAsync(method, url, headers, body, std::move(onResponse));
+    }
 }
 
-std::future<std::vector<InstrumentModel>> MarketDataManager::getOptionChain(
+Future<std::vector<InstrumentModel>> MarketDataManager::getOptionChain(
     const std::string& underlying,
     const std::chrono::system_clock::time_point& expiry,
-    const std::string& exchange,
-    double minStrike,
-    double maxStrike) {
-    
-    return std::async(std::launch::async, [this, underlying, expiry, exchange, minStrike, maxStrike]() {
-        m_logger->info("Getting option chain for {}, expiry: {}", 
-                     underlying, InstrumentModel::formatDate(expiry));
-        
-        // Get all instruments from the specified exchange
-        auto instrumentsFuture = getInstrumentsByExchange(exchange);
-        std::vector<InstrumentModel> allInstruments = instrumentsFuture.get();
-        
-        // Filter for options with matching underlying and expiry
-        std::vector<InstrumentModel> optionChain;
-        int callCount = 0;
-        int putCount = 0;
-        
-        for (const auto& instrument : allInstruments) {
-            if (instrument.type == InstrumentType::OPTION) {
-                // Check if it's for our underlying
-                bool isTargetOption = false;
-                
-                if (instrument.underlying == underlying) {
-                    isTargetOption = true;
-                }
-                else if (instrument.tradingSymbol.find(underlying) == 0) {
-                    isTargetOption = true;
-                }
-                
-                // Check if it's for our expiry date (within 1 day tolerance)
-                if (isTargetOption) {
-                    auto expiryDiff = std::abs(std::chrono::duration_cast<std::chrono::hours>(
-                        instrument.expiry - expiry).count());
-                    
-                    if (expiryDiff <= 24) { // Within 1 day
-                        // Apply strike price filter if specified
-                        if ((minStrike <= 0.0 || instrument.strikePrice >= minStrike) &&
-                            (maxStrike <= 0.0 || instrument.strikePrice <= maxStrike)) {
-                            
-                            optionChain.push_back(instrument);
-                            
-                            if (instrument.optionType == OptionType::CALL) {
-                                callCount++;
-                            } else if (instrument.optionType == OptionType::PUT) {
-                                putCount++;
-                            }
-                        }
-                    }
-                }
-            }
-        }
-        
-        // Sort by strike price
-        std::sort(optionChain.begin(), optionChain.end(), 
-                 [](const InstrumentModel& a, const InstrumentModel& b) {
-                     return a.strikePrice < b.strikePrice;
-                 });
-        
-        m_logger->info("Found {} options ({} calls, {} puts) for {} with expiry {}",
-                     optionChain.size(), callCount, putCount, underlying, 
-                     InstrumentModel::formatDate(expiry));
-        
-        return optionChain;
-    });
+    const std::string& exchange,
+    double minStrike,
+    double maxStrike) {
+    
+    return makeReadyFuture(findOptionChain(*getInstrumentUniverse(), underlying, expiry, exchange, 
+                                           minStrike, maxStrike));
 }
 
-std::future<std::vector<InstrumentModel>> MarketDataManager::getOptionChainWithQuotes(
+std::vector<InstrumentModel> MarketDataManager::findOptionChain(
+    const InstrumentUniverse& universe,
     const std::string& underlying,
     const std::chrono::system_clock::time_point& expiry,
     const std::string& exchange,
     double minStrike,
     double maxStrike) {
     
-    return std::async(std::launch::async, [this, underlying, expiry, exchange, minStrike, maxStrike]() {
-        m_logger->info("Getting option chain with quotes for {}, expiry: {}", 
-                     underlying, InstrumentModel::formatDate(expiry));
-        
-        // First get the option chain
-        auto optionChainFuture = getOptionChain(underlying, expiry, exchange, minStrike, maxStrike);
-        std::vector<InstrumentModel> optionChain = optionChainFuture.get();
-        
-        if (optionChain.empty()) {
-            m_logger->warn("No options found for {} with expiry {}", 
-                         underlying, InstrumentModel::formatDate(expiry));
-            return optionChain;
-        }
-        
-        // Extract instrument tokens for quote requests
-        std::vector<uint64_t> instrumentTokens;
-        for (const auto& option : optionChain) {
-            instrumentTokens.push_back(option.instrumentToken);
+    m_logger->info("Getting option chain for {}, expiry: {}", 
+                 underlying, InstrumentModel::formatDate(expiry));
+    
+    // Look the chain up in the universe's option chain index
+    const auto& chains = universe.getOptionChains(underlying, exchange);
+    
+    std::vector<InstrumentModel> optionChain;
+    int callCount = 0;
+    int putCount = 0;
+    
+    // Accept expiries within 1 day of the requested one
+    auto firstExpiry = chains.lower_bound(ExpiryDay::fromTimePoint(expiry - std::chrono::hours(24)));
+    auto lastExpiry = chains.upper_bound(ExpiryDay::fromTimePoint(expiry + std::chrono::hours(24)));
+    
+    for (auto chainIt = firstExpiry; chainIt != lastExpiry; ++chainIt) {
+        const OptionChain& chain = chainIt->second;
+        
+        // Apply strike price filter if specified; the chain is sorted by strike
+        auto entryIt = chain.begin();
+        if (minStrike > 0.0) {
+            entryIt = std::lower_bound(chain.begin(), chain.end(), minStrike,
+                                       [](const OptionChainEntry& entry, double value) {
+                                           return entry.strike < value;
+                                       });
         }
         
-        // Batch the quote requests to respect API limits
-        const size_t batchSize = 250; // Kite API limit per request
-        std::vector<InstrumentModel> resultChain;
-        
-        for (size_t i = 0; i < instrumentTokens.size(); i += batchSize) {
-            size_t currentBatchSize = std::min(batchSize, instrumentTokens.size() - i);
-            std::vector<uint64_t> batch(instrumentTokens.begin() + i, 
-                                      instrumentTokens.begin() + i + currentBatchSize);
-            
-            // Get quotes for this batch
-            auto quotesFuture = getQuotes(batch);
-            auto quotes = quotesFuture.get();
+        for (; entryIt != chain.end(); ++entryIt) {
+            if (maxStrike > 0.0 && entryIt->strike > maxStrike) {
+                break;
+            }
             
-            // Add quotes to our result chain
-            for (size_t j = 0; j < currentBatchSize; j++) {
-                uint64_t token = batch[j];
-                if (quotes.find(token) != quotes.end()) {
-                    resultChain.push_back(quotes[token]);
-                }
+            if (entryIt->call) {
+                optionChain.push_back(InstrumentModel(*entryIt->call));
+                callCount++;
             }
             
-            // Add a small delay to avoid rate limiting
-            if (i + batchSize < instrumentTokens.size()) {
-                std::this_thread::sleep_for(std::chrono::milliseconds(200));
+            if (entryIt->put) {
+                optionChain.push_back(InstrumentModel(*entryIt->put));
+                putCount++;
             }
         }
-        
-        m_logger->info("Got quotes for {}/{} options in the chain", 
-                     resultChain.size(), optionChain.size());
-        
-        // Re-sort by strike price
-        std::sort(resultChain.begin(), resultChain.end(), 
-                 [](const InstrumentModel& a, const InstrumentModel& b) {
-                     return a.strikePrice < b.strikePrice;
-                 });
-        
-        return resultChain;
-    });
+    }
+    
+    // Sort by strike price
+    std::sort(optionChain.begin(), optionChain.end(), 
+             [](const InstrumentModel& a, const InstrumentModel& b) {
+                 return a.strikePrice < b.strikePrice;
+             });
+    
+    m_logger->info("Found {} options ({} calls, {} puts) for {} with expiry {}",
+                 optionChain.size(), callCount, putCount, underlying, 
+                 InstrumentModel::formatDate(expiry));
+    
+    return optionChain;
 }
 
-bool MarketDataManager::refreshInstrumentsCache() {
-    m_logger->info("Forcing refresh of instruments cache");
+Future<std::vector<InstrumentModel>> MarketDataManager::getOptionChainWithQuotes(
+    const std::string& underlying,
+    const std::chrono::system_clock::time_point& expiry,
+    const std::string& exchange,
+    double minStrike,
+    double maxStrike) {
     
-    HttpResponse response = makeRateLimitedApiRequest(HttpMethod::GET, "/instruments");
+    m_logger->info("Getting option chain with quotes for {}, expiry: {}", 
+                 underlying, InstrumentModel::formatDate(expiry));
     
-    if (response.statusCode == 200) {
-        // Cache the response to file
-        if (saveInstrumentsToCache(response.body)) {
-            m_logger->info("Saved instruments data to cache");
-            
-            // Update in-memory cache
-            auto instruments = parseInstrumentsCSV(response.body);
-            
-            {
-                std::lock_guard<std::mutex> lock(m_cacheMutex);
-                
-                // Clear existing cache
-                m_instrumentCache.clear();
-                m_symbolToTokenMap.clear();
-                
-                // Update cache
-                for (const auto& instrument : instruments) {
-                    m_instrumentCache[instrument.instrumentToken] = instrument;
-                    
-                    std::string key = instrument.tradingSymbol + ":" + instrument.exchange;
-                    m_symbolToTokenMap[key] = instrument.instrumentToken;
+    return getOptionChain(underlying, expiry, exchange, minStrike, maxStrike).then(
+        [this, underlying, expiry](std::vector<InstrumentModel> optionChain) {
+            if (optionChain.empty()) {
+                m_logger->warn("No options found for {} with expiry {}", 
+                             underlying, InstrumentModel::formatDate(expiry));
+            }
+            return quoteOptionChain(std::move(optionChain));
+        });
+}
+
+Future<std::vector<InstrumentModel>> MarketDataManager::quoteOptionChain(std::vector<InstrumentModel> optionChain) {
+    if (optionChain.empty()) {
+        return makeReadyFuture(std::move(optionChain));
+    }
+    
+    // The coalescer splits the tokens into /quote batches and the scheduler paces them
+    std::vector<uint64_t> instrumentTokens;
+    instrumentTokens.reserve(optionChain.size());
+    for (const auto& option : optionChain) {
+        instrumentTokens.push_back(option.instrumentToken);
+    }
+    
+    size_t chainSize = optionChain.size();
+    return getQuotes(instrumentTokens).then(
+        [this, instrumentTokens, chainSize](std::unordered_map<uint64_t, InstrumentModel> quotes) {
+            std::vector<InstrumentModel> resultChain;
+            resultChain.reserve(instrumentTokens.size());
+            for (uint64_t token : instrumentTokens) {
+                auto it = quotes.find(token);
+                if (it != quotes.end()) {
+                    resultChain.push_back(std::move(it->second));
                 }
-                
-                m_instrumentsCached = true;
-                m_lastInstrumentsFetch = std::chrono::system_clock::now();
             }
             
-            return true;
+            m_logger->info("Got quotes for {}/{} options in the chain", resultChain.size(), chainSize);
+            
+            // Re-sort by strike price
+            std::sort(resultChain.begin(), resultChain.end(), 
+                     [](const InstrumentModel& a, const InstrumentModel& b) {
+                         return a.strikePrice < b.strikePrice;
+                     });
+            
+            return resultChain;
+        });
+}
+
+bool MarketDataManager::refreshInstrumentsCache() {
+    m_logger->info("Forcing refresh of instruments cache");
+    
+    std::vector<InstrumentRef> instruments;
+    if (!downloadInstruments(instruments)) {
+        return false;
+    }
+    
+    if (instruments.empty()) {
+        m_logger->error("Refreshed instruments dump contained no instruments");
+        return false;
+    }
+    
+    if (!std::atomic_load(&m_replayEngine)) {
+        saveInstrumentsSnapshot(instruments, std::chrono::system_clock::now());
+    }
+    
+    // Publish a new universe; readers holding the old one keep using it
+    std::lock_guard<std::mutex> loadLock(m_universeLoadMutex);
+    publishInstrumentUniverse(std::move(instruments), 
+                              std::chrono::system_clock::now() + getInstrumentsCacheTTL());
+    
+    return true;
+}
+
+bool MarketDataManager::startInstrumentRefresher() {
+    std::lock_guard<std::mutex> lock(m_refreshMutex);
+    
+    if (m_refresherRunning.load()) {
+        return true;
+    }
+    
+    if (m_refreshThread.joinable()) {
+        m_refreshThread.join();
+    }
+    
+    m_refreshStop = false;
+    m_refreshRequested = false;
+    m_refresherRunning.store(true);
+    m_refreshThread = std::thread(&MarketDataManager::runInstrumentRefresher, this);
+    
+    m_logger->info("Started background instrument refresher");
+    return true;
+}
+
+void MarketDataManager::stopInstrumentRefresher() {
+    {
+        std::lock_guard<std::mutex> lock(m_refreshMutex);
+        m_refreshStop = true;
+    }
+    m_refreshCondition.notify_all();
+    
+    if (m_refreshThread.joinable()) {
+        m_refreshThread.join();
+    }
+    m_refresherRunning.store(false);
+}
+
+void MarketDataManager::runInstrumentRefresher() {
+    auto lead = std::chrono::seconds(std::max(0, 
+        m_configManager->getIntValue("api/instruments_refresh_lead_seconds", 300)));
+    auto retryDelay = std::chrono::seconds(std::max(1, 
+        m_configManager->getIntValue("api/instruments_refresh_retry_seconds", 65)));
+    auto retryAt = std::chrono::system_clock::time_point::min();
+    
+    std::unique_lock<std::mutex> lock(m_refreshMutex);
+    
+    while (!m_refreshStop) {
+        // Nothing to refresh before the first universe is loaded
+        if (!std::atomic_load(&m_universe)) {
+            m_refreshCondition.wait_for(lock, std::chrono::seconds(1));
+            continue;
+        }
+        
+        auto validUntil = m_universeValidUntil.load();
+        // A cleared cache stores time_point::min(); subtracting the lead would overflow
+        auto dueAt = validUntil <= std::chrono::system_clock::time_point::min() + lead
+            ? std::chrono::system_clock::time_point::min()
+            : validUntil - lead;
+        dueAt = std::max(dueAt, retryAt);
+        bool requested = m_refreshRequested && std::chrono::system_clock::now() >= retryAt;
+        
+        if (!requested && std::chrono::system_clock::now() < dueAt) {
+            // Wake when due, asked for, stopped, or when a publish moved the validity
+            m_refreshCondition.wait_until(lock, dueAt, [&]() {
+                return m_refreshStop || m_universeValidUntil.load() != validUntil ||
+                       (m_refreshRequested && std::chrono::system_clock::now() >= retryAt);
+            });
+            continue;
+        }
+        
+        lock.unlock();
+        
+        auto startTime = std::chrono::steady_clock::now();
+        bool refreshed = refreshInstrumentsCache();
+        auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - startTime).count();
+        
+        lock.lock();
+        
+        if (refreshed) {
+            retryAt = std::chrono::system_clock::time_point::min();
+            m_logger->info("Background instrument refresh finished in {} ms", elapsedMs);
         } else {
-            m_logger->warn("Failed to save instruments data to cache");
+            // /instruments allows one request a minute; keep serving the current universe meanwhile
+            retryAt = std::chrono::system_clock::now() + retryDelay;
+            m_logger->warn("Background instrument refresh failed after {} ms, retrying in {} s", 
+                         elapsedMs, retryDelay.count());
         }
     }
     
-    return false;
+    m_refresherRunning.store(false);
 }
 
 void MarketDataManager::clearInstrumentsCache() {
     m_logger->info("Clearing instruments cache");
     
-    // Remove file if it exists
-    std::string cacheFilePath = getInstrumentsCacheFilePath();
-    if (std::filesystem::exists(cacheFilePath)) {
-        try {
-            std::filesystem::remove(cacheFilePath);
-            m_logger->info("Removed instruments cache file: {}", cacheFilePath);
-        } catch (const std::exception& e) {
-            m_logger->error("Failed to remove instruments cache file: {}", e.what());
+    // Remove files if they exist
+    for (const auto& cacheFilePath : {getInstrumentsCacheFilePath(), getInstrumentsSnapshotFilePath()}) {
+        if (std::filesystem::exists(cacheFilePath)) {
+            try {
+                std::filesystem::remove(cacheFilePath);
+                m_logger->info("Removed instruments cache file: {}", cacheFilePath);
+            } catch (const std::exception& e) {
+                m_logger->error("Failed to remove instruments cache file: {}", e.what());
+            }
         }
     }
     
-    // Clear memory cache
-    {
-        std::lock_guard<std::mutex> lock(m_cacheMutex);
-        m_instrumentCache.clear();
-        m_symbolToTokenMap.clear();
-        m_instrumentsCached = false;
-    }
+    // Force the next reader to reload; the current universe stays valid for its holders
+    m_universeValidUntil.store(std::chrono::system_clock::time_point::min());
 }
 
 bool MarketDataManager::saveInstrumentsToCache(const std::string& csvData) {
@@ -1393,9 +1580,6 @@ bool MarketDataManager::saveInstrumentsToCache(const std::string& csvData) {
         cacheFile.write(csvData.c_str(), csvData.size());
         cacheFile.close();
         
-        // Update timestamp by touching the file
-        m_lastInstrumentsFetch = std::chrono::system_clock::now();
-        
         return true;
     } catch (const std::exception& e) {
         m_logger->error("Exception while saving instruments to cache: {}", e.what());
@@ -1436,46 +1620,103 @@ std::string MarketDataManager::loadInstrumentsFromCache() {
     }
 }
 
+bool MarketDataManager::saveInstrumentsSnapshot(const std::vector<InstrumentRef>& instruments,
+                                                std::chrono::system_clock::time_point downloadedAt) {
+    if (instruments.empty()) {
+        return false;
+    }
+    
+    std::string snapshotFilePath = getInstrumentsSnapshotFilePath();
+    std::string error;
+    
+    if (!InstrumentSnapshot::write(snapshotFilePath, instruments, downloadedAt, &error)) {
+        m_logger->error("Failed to write instruments snapshot: {}", error);
+        return false;
+    }
+    
+    m_logger->info("Wrote snapshot of {} instruments to {}", instruments.size(), snapshotFilePath);
+    return true;
+}
+
+std::vector<InstrumentRef> MarketDataManager::loadInstrumentsFromSnapshot(std::chrono::seconds& age) {
+    std::string snapshotFilePath = getInstrumentsSnapshotFilePath();
+    if (!std::filesystem::exists(snapshotFilePath)) {
+        return {};
+    }
+    
+    // The mapping only lives while the universe is materialized; the universe owns the result
+    InstrumentSnapshot snapshot;
+    if (!snapshot.open(snapshotFilePath)) {
+        m_logger->warn("Failed to open instruments snapshot {}: {}", 
+                     snapshotFilePath, snapshot.lastError());
+        return {};
+    }
+    
+    // Freshness comes from the dump the snapshot was built from, not from the file
+    age = std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now() - snapshot.sourceTime());
+    if (age >= getInstrumentsCacheTTL()) {
+        m_logger->debug("Instruments snapshot {} is expired (dump age: {} minutes, TTL: {} minutes)", 
+                      snapshotFilePath, std::chrono::duration_cast<std::chrono::minutes>(age).count(),
+                      getInstrumentsCacheTTL().count());
+        return {};
+    }
+    
+    m_logger->info("Mapped instruments snapshot {} ({} records, format version {})", 
+                 snapshotFilePath, snapshot.size(), snapshot.header().version);
+    
+    return snapshot.toInstruments();
+}
+
 bool MarketDataManager::isInstrumentsCacheValid() {
+    return isCacheFileFresh(getInstrumentsCacheFilePath());
+}
+
+bool MarketDataManager::isCacheFileFresh(const std::string& cacheFilePath) {
+    std::chrono::seconds age{0};
+    if (!getCacheFileAge(cacheFilePath, age)) {
+        return false;
+    }
+    
+    auto ageMinutes = std::chrono::duration_cast<std::chrono::minutes>(age).count();
+    auto cacheTTLMinutes = getInstrumentsCacheTTL().count();
+    
+    // Cache is valid if it's less than TTL minutes old
+    bool isValid = ageMinutes < cacheTTLMinutes;
+    
+    if (isValid) {
+        m_logger->debug("Instruments cache {} is valid (age: {} minutes, TTL: {} minutes)", 
+                      cacheFilePath, ageMinutes, cacheTTLMinutes);
+    } else {
+        m_logger->debug("Instruments cache {} is expired (age: {} minutes, TTL: {} minutes)", 
+                      cacheFilePath, ageMinutes, cacheTTLMinutes);
+    }
+    
+    return isValid;
+}
+
+bool MarketDataManager::getCacheFileAge(const std::string& cacheFilePath, std::chrono::seconds& age) {
     try {
-        std::string cacheFilePath = getInstrumentsCacheFilePath();
-        
         if (!std::filesystem::exists(cacheFilePath)) {
             return false;
         }
         
-        // Get file creation/modification timestamp
+        // Both times come from the filesystem clock, so no clock conversion is needed
         auto cacheLastModified = std::filesystem::last_write_time(cacheFilePath);
         auto now = std::filesystem::file_time_type::clock::now();
         
-        // Compute time difference (C++20 has std::chrono::clock_cast but we'll use a simpler approach)
-        auto age = now - cacheLastModified;
-        
-        // Convert to a duration we can work with more easily
-        auto age_seconds = std::chrono::duration_cast<std::chrono::seconds>(age).count();
-        auto age_minutes = age_seconds / 60;
-        
-        // Get cache TTL from config
-        int cacheTTLMinutes = m_configManager->getIntValue("api/instruments_cache_ttl_minutes", 1440);
-        
-        // Cache is valid if it's less than TTL minutes old
-        bool isValid = age_minutes < cacheTTLMinutes;
-        
-        if (isValid) {
-            m_logger->debug("Instruments cache is valid (age: {} minutes, TTL: {} minutes)", 
-                          age_minutes, cacheTTLMinutes);
-        } else {
-            m_logger->debug("Instruments cache is expired (age: {} minutes, TTL: {} minutes)", 
-                          age_minutes, cacheTTLMinutes);
-        }
-        
-        return isValid;
+        age = std::chrono::duration_cast<std::chrono::seconds>(now - cacheLastModified);
+        return true;
     } catch (const std::exception& e) {
         m_logger->error("Exception while checking cache validity: {}", e.what());
         return false;
     }
 }
 
+std::chrono::minutes MarketDataManager::getInstrumentsCacheTTL() {
+    return std::chrono::minutes(m_configManager->getIntValue("api/instruments_cache_ttl_minutes", 1440));
+}
+
 std::string MarketDataManager::getInstrumentsCacheFilePath() {
     // First check config for cache file path
     std::string cacheFileName = m_configManager->getStringValue(
@@ -1492,49 +1733,139 @@ std::string MarketDataManager::getInstrumentsCacheFilePath() {
     return cacheFileName;
 }
 
+std::string MarketDataManager::getInstrumentsSnapshotFilePath() {
+    std::string snapshotFileName = m_configManager->getStringValue("api/instruments_snapshot_file", "");
+    
+    // Default to the CSV cache path with a .bin extension
+    if (snapshotFileName.empty()) {
+        std::filesystem::path cachePath(getInstrumentsCacheFilePath());
+        cachePath.replace_extension(".bin");
+        return cachePath.string();
+    }
+    
+    if (snapshotFileName[0] != '/') {
+        std::filesystem::path snapshotPath = std::filesystem::current_path() / snapshotFileName;
+        return snapshotPath.string();
+    }
+    
+    return snapshotFileName;
+}
+
 // New methods implementation
-std::future<double> MarketDataManager::getSpotPrice(const std::string& underlying, const std::string& exchange) {
-    return std::async(std::launch::async, [this, underlying, exchange]() -> double {
-        m_logger->debug("Getting spot price for {}:{}", underlying, exchange);
-        
-        try {
-            // Try different variations of the symbol name for indices
-            std::vector<std::string> symbolVariations;
-            if (underlying == "NIFTY") {
-                symbolVariations = {"NIFTY 50", "NIFTY50", "NIFTY", "^NSEI"};
-            } else {
-                symbolVariations = {underlying};
-            }
-            
-            // Try all variations until we find one
-            for (const auto& symbol : symbolVariations) {
-                auto spotInstrumentFuture = getInstrumentBySymbol(symbol, exchange);
-                auto spotInstrument = spotInstrumentFuture.get();
-                
-                if (spotInstrument.instrumentToken != 0) {
-                    auto ltpFuture = getLTP(spotInstrument.instrumentToken);
-                    double spotPrice = ltpFuture.get();
-                    
-                    m_logger->info("Found spot price for {} using symbol {}: {}", 
-                                 underlying, symbol, spotPrice);
-                    return spotPrice;
-                }
-            }
+uint64_t MarketDataManager::resolveSpotToken(const std::string& underlying, const std::string& exchange) {
+    auto universe = getInstrumentUniverse();
+    std::string key = underlying + ":" + exchange;
+    
+    {
+        std::lock_guard<std::mutex> lock(m_spotTokenMutex);
+        if (m_spotTokensVersion != universe->getVersion()) {
+            m_spotTokens.clear();
+            m_spotTokensVersion = universe->getVersion();
+        }
+        
+        auto it = m_spotTokens.find(key);
+        if (it != m_spotTokens.end()) {
+            return it->second;
+        }
+    }
+    
+    // Index option underlyings are named differently from the index itself
+    static const std::unordered_map<std::string, std::vector<std::pair<std::string, std::string>>> indexSymbols = {
+        {"NIFTY", {{"NIFTY 50", "NSE"}, {"NIFTY50", "NSE"}}},
+        {"BANKNIFTY", {{"NIFTY BANK", "NSE"}}},
+        {"FINNIFTY", {{"NIFTY FIN SERVICE", "NSE"}}},
+        {"MIDCPNIFTY", {{"NIFTY MID SELECT", "NSE"}}},
+        {"NIFTYNXT50", {{"NIFTY NEXT 50", "NSE"}}},
+        {"SENSEX", {{"SENSEX", "BSE"}}},
+        {"BANKEX", {{"BANKEX", "BSE"}}}
+    };
+    
+    std::vector<std::pair<std::string, std::string>> candidates;
+    std::string configured = m_configManager->getStringValue("option_chain/spot_symbols/" + underlying, "");
+    if (!configured.empty()) {
+        candidates.emplace_back(configured, exchange);
+    }
+    auto known = indexSymbols.find(underlying);
+    if (known != indexSymbols.end()) {
+        candidates.insert(candidates.end(), known->second.begin(), known->second.end());
+    }
+    candidates.emplace_back(underlying, exchange);
+    
+    uint64_t spotToken = 0;
+    for (const auto& candidate : candidates) {
+        const InstrumentRef* instrument = universe->findBySymbol(candidate.first, candidate.second);
+        if (instrument) {
+            spotToken = instrument->instrumentToken;
+            m_logger->info("Resolved spot of {} to {}:{} (token {})", 
+                         underlying, candidate.second, candidate.first, spotToken);
+            break;
+        }
+    }
+    
+    if (spotToken == 0) {
+        m_logger->warn("No spot instrument found for {}:{} in universe version {}", 
+                     underlying, exchange, universe->getVersion());
+    }
+    
+    // Misses are cached too, so an unknown underlying costs one lookup per universe
+    std::lock_guard<std::mutex> lock(m_spotTokenMutex);
+    if (m_spotTokensVersion == universe->getVersion()) {
+        m_spotTokens[key] = spotToken;
+    }
+    return spotToken;
+}
+
+Future<double> MarketDataManager::getSpotPrice(const std::string& underlying, const std::string& exchange) {
+    m_logger->debug("Getting spot price for {}:{}", underlying, exchange);
+    
+    auto fallback = [this, underlying, exchange]() {
+        // If no spot instrument is found, look for futures for Indices
+        if (underlying == "NIFTY") {
+            // Use a hardcoded fallback for testing
+            double fallbackPrice = 24000.0; // Reasonable NIFTY price for testing
+            m_logger->warn("Using fallback price for {}: {}", underlying, fallbackPrice);
+            return fallbackPrice;
+        }
+        
+        m_logger->error("Failed to find spot price for {}:{}", underlying, exchange);
+        return 0.0;
+    };
+    
+    uint64_t spotToken = 0;
+    try {
+        spotToken = resolveSpotToken(underlying, exchange);
+        
+        if (spotToken != 0) {
+            // A recent quote batch or tick may already have carried the spot
+            auto store = getQuoteStore();
+            auto maxAge = std::chrono::milliseconds(
+                m_configManager->getIntValue("option_chain/spot_max_age_ms", 5000));
+            uint32_t ordinal = 0;
+            double spotPrice = 0.0;
+            std::chrono::system_clock::time_point updatedAt;
             
-            // If no spot instrument is found, look for futures for Indices
-            if (underlying == "NIFTY") {
-                // Use a hardcoded fallback for testing
-                double fallbackPrice = 24000.0; // Reasonable NIFTY price for testing
-                m_logger->warn("Using fallback price for {}: {}", underlying, fallbackPrice);
-                return fallbackPrice;
+            if (store->getUniverse()->findOrdinal(spotToken, ordinal) &&
+                store->readLastPrice(ordinal, spotPrice, updatedAt) && spotPrice > 0.0 &&
+                std::chrono::system_clock::now() - updatedAt <= maxAge) {
+                m_logger->debug("Using stored spot price for {}: {}", underlying, spotPrice);
+                return makeReadyFuture(spotPrice);
             }
-            
-            m_logger->error("Failed to find spot price for {}:{}", underlying, exchange);
-            return 0.0;
-        } catch (const std::exception& e) {
-            m_logger->error("Error getting spot price for {}:{}: {}", underlying, exchange, e.what());
-            return 0.0;
         }
+    } catch (const std::exception& e) {
+        m_logger->error("Error getting spot price for {}:{}: {}", underlying, exchange, e.what());
+        return makeReadyFuture(0.0);
+    }
+    
+    if (spotToken == 0) {
+        return makeReadyFuture(fallback());
+    }
+    
+    return getLTP(spotToken).then([this, underlying, fallback](double spotPrice) {
+        if (spotPrice > 0.0) {
+            m_logger->info("Fetched spot price for {}: {}", underlying, spotPrice);
+            return spotPrice;
+        }
+        return fallback();
     });
 }
 
@@ -1556,106 +1887,138 @@ std::pair<double, double> MarketDataManager::calculateStrikeRange(double spotPri
     return {minStrike, maxStrike};
 }
 
-std::future<std::vector<InstrumentModel>> MarketDataManager::getFilteredOptionChain(
+Future<std::vector<InstrumentModel>> MarketDataManager::getFilteredOptionChain(
     const std::string& underlying,
     const std::chrono::system_clock::time_point& expiry,
     const std::string& exchange) {
     
-    return std::async(std::launch::async, [this, underlying, expiry, exchange]() {
-        m_logger->info("Getting filtered option chain for {}:{} with expiry {}", 
-                     underlying, exchange, InstrumentModel::formatDate(expiry));
-        
-        // Get spot price to calculate strike range
-        double spotPrice = 0.0;
-        try {
-            auto spotPriceFuture = getSpotPrice(underlying, "NSE");
-            spotPrice = spotPriceFuture.get();
-        } catch (const std::exception& e) {
-            m_logger->warn("Failed to get spot price for filtering option chain: {}", e.what());
-        }
-        
-        // Calculate strike range
-        auto [minStrike, maxStrike] = calculateStrikeRange(spotPrice);
-        
-        // Get option chain with strike range
-        auto optionChainFuture = getOptionChain(underlying, expiry, exchange, minStrike, maxStrike);
-        auto optionChain = optionChainFuture.get();
+    m_logger->info("Getting filtered option chain for {}:{} with expiry {}", 
+                 underlying, exchange, InstrumentModel::formatDate(expiry));
+    
+    // Resolve the universe on the calling thread: the continuation may run on an API scheduler
+    // worker, which must not block on an /instruments download of its own
+    auto universe = getInstrumentUniverse();
+    
+    // The strike range is centred on the spot price
+    return getSpotPrice(underlying, "NSE").then([this, universe, underlying, expiry, exchange](double spotPrice) {
+        auto strikeRange = calculateStrikeRange(spotPrice);
         
+        auto optionChain = findOptionChain(*universe, underlying, expiry, exchange, 
+                                           strikeRange.first, strikeRange.second);
         m_logger->info("Filtered option chain contains {} options for {}:{} with expiry {}", 
                      optionChain.size(), underlying, exchange, 
                      InstrumentModel::formatDate(expiry));
-        
         return optionChain;
     });
 }
 
-std::future<std::vector<InstrumentModel>> MarketDataManager::getFilteredOptionChainWithQuotes(
+Future<std::vector<InstrumentModel>> MarketDataManager::getFilteredOptionChainWithQuotes(
     const std::string& underlying,
     const std::chrono::system_clock::time_point& expiry,
     const std::string& exchange) {
     
-    return std::async(std::launch::async, [this, underlying, expiry, exchange]() {
-        m_logger->info("Getting filtered option chain with quotes for {}:{} with expiry {}", 
-                     underlying, exchange, InstrumentModel::formatDate(expiry));
-        
-        // Get filtered option chain
-        auto filteredChainFuture = getFilteredOptionChain(underlying, expiry, exchange);
-        auto filteredChain = filteredChainFuture.get();
-        
-        if (filteredChain.empty()) {
-            m_logger->warn("No options found in filtered chain");
-            return std::vector<InstrumentModel>();
-        }
-        
-        // Extract instrument tokens
-        std::vector<uint64_t> instrumentTokens;
-        for (const auto& option : filteredChain) {
-            instrumentTokens.push_back(option.instrumentToken);
-        }
-        
-        // Get batch size from config
-        int batchSize = m_configManager->getIntValue("option_chain/pipeline/batch_size", 100);
-        
-        // Get quotes in batches
-        std::vector<InstrumentModel> resultChain;
-        for (size_t i = 0; i < instrumentTokens.size(); i += batchSize) {
-            size_t batchEnd = std::min(i + batchSize, instrumentTokens.size());
-            std::vector<uint64_t> batchTokens(instrumentTokens.begin() + i, 
-                                            instrumentTokens.begin() + batchEnd);
-            
-            m_logger->debug("Getting quotes for batch {}/{} (size: {})", 
-                          (i / batchSize) + 1, 
-                          (instrumentTokens.size() + batchSize - 1) / batchSize,
-                          batchTokens.size());
-            
-            auto quotesFuture = getQuotes(batchTokens);
-            auto quotes = quotesFuture.get();
-            
-            // Add to result chain
-            for (size_t j = i; j < batchEnd; ++j) {
-                uint64_t token = instrumentTokens[j];
-                if (quotes.find(token) != quotes.end()) {
-                    resultChain.push_back(quotes[token]);
-                }
-            }
-            
-            // Add a small delay to avoid rate limiting
-            if (i + batchSize < instrumentTokens.size()) {
-                std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    m_logger->info("Getting filtered option chain with quotes for {}:{} with expiry {}", 
+                 underlying, exchange, InstrumentModel::formatDate(expiry));
+    
+    return getFilteredOptionChain(underlying, expiry, exchange).then(
+        [this](std::vector<InstrumentModel> filteredChain) {
+            if (filteredChain.empty()) {
+                m_logger->warn("No options found in filtered chain");
             }
-        }
-        
-        m_logger->info("Got quotes for {}/{} options in the filtered chain", 
-                     resultChain.size(), filteredChain.size());
-        
-        // Re-sort by strike price
-        std::sort(resultChain.begin(), resultChain.end(), 
-                 [](const InstrumentModel& a, const InstrumentModel& b) {
-                     return a.strikePrice < b.strikePrice;
-                 });
-        
-        return resultChain;
-    });
+            return quoteOptionChain(std::move(filteredChain));
+        });
+}
+
+bool MarketDataManager::startTickFeed() {
+    std::lock_guard<std::mutex> lock(m_tickFeedMutex);
+    
+    if (std::atomic_load(&m_tickFeed)) {
+        return true;
+    }
+    
+    std::string host = m_configManager->getStringValue("ticker/host", "127.0.0.1");
+    int port = m_configManager->getIntValue("ticker/port", 9100);
+    int reconnectDelayMs = m_configManager->getIntValue("ticker/reconnect_delay_ms", 2000);
+    
+    if (port <= 0 || port > 65535) {
+        m_logger->error("Invalid ticker port: {}", port);
+        return false;
+    }
+    
+    // Ticks go into whichever store is current; a universe reload redirects them automatically
+    auto tickFeed = std::make_shared<TickFeed>(
+        m_logger,
+        [this]() { return std::atomic_load(&m_quoteStore); },
+        host,
+        static_cast<uint16_t>(port),
+        std::chrono::milliseconds(std::max(100, reconnectDelayMs)));
+    
+    tickFeed->setThreadCpus(m_ioCpus);
+    
+    if (auto journal = std::atomic_load(&m_journal)) {
+        tickFeed->setMessageObserver([journal](const uint8_t* data, size_t size) {
+            journal->append(JournalRecordKind::TICKS, {},
+                            std::string_view(reinterpret_cast<const char*>(data), size));
+        });
+    }
+    
+    tickFeed->start();
+    std::atomic_store(&m_tickFeed, tickFeed);
+    
+    return true;
+}
+
+void MarketDataManager::stopTickFeed() {
+    std::lock_guard<std::mutex> lock(m_tickFeedMutex);
+    
+    auto tickFeed = std::atomic_exchange(&m_tickFeed, std::shared_ptr<TickFeed>());
+    if (tickFeed) {
+        auto stats = tickFeed->getStats();
+        tickFeed->stop();
+        m_logger->info("Tick feed totals: {} messages, {} ticks, {} applied, {} unknown tokens, {} decode errors",
+                     stats.messages, stats.ticks, stats.applied, stats.unknownTokens, stats.decodeErrors);
+    }
+}
+
+std::shared_ptr<TickFeed> MarketDataManager::getTickFeed() const {
+    return std::atomic_load(&m_tickFeed);
+}
+
+bool MarketDataManager::subscribeTicks(const std::vector<uint64_t>& instrumentTokens, TickMode mode) {
+    auto tickFeed = getTickFeed();
+    if (!tickFeed) {
+        return false;
+    }
+    
+    tickFeed->subscribe(instrumentTokens, mode);
+    return true;
+}
+
+void MarketDataManager::setJournal(std::shared_ptr<MarketDataJournal> journal) {
+    std::atomic_store(&m_journal, std::move(journal));
+}
+
+void MarketDataManager::setIoCpus(std::vector<int> cpus) {
+    std::lock_guard<std::mutex> lock(m_tickFeedMutex);
+    m_ioCpus = std::move(cpus);
+}
+
+void MarketDataManager::setThreadPool(std::shared_ptr<ThreadPool> threadPool) {
+    std::atomic_store(&m_threadPool, std::move(threadPool));
+}
+
+void MarketDataManager::setReplayEngine(std::shared_ptr<ReplayEngine> replayEngine) {
+    std::atomic_store(&m_replayEngine, std::move(replayEngine));
+}
+
+bool MarketDataManager::startTickReplay() {
+    auto replayEngine = std::atomic_load(&m_replayEngine);
+    if (!replayEngine) {
+        return false;
+    }
+    
+    replayEngine->startTicks([this]() { return std::atomic_load(&m_quoteStore); });
+    return true;
 }
 
-}  // namespace BoxStrategy
\ No newline at end of file
+}  // namespace BoxStrategy
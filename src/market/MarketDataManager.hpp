@@ -8,19 +8,32 @@
 #include <string>
 #include <memory>
 #include <mutex>
+#include <atomic>
 #include <unordered_map>
+#include <map>
 #include <vector>
 #include <functional>
 #include <future>
+#include <condition_variable>
+#include <thread>
 #include <chrono>
 #include <queue>
 #include <fstream>
 #include <filesystem>
 #include "../utils/Logger.hpp"
 #include "../utils/HttpClient.hpp"
+#include "../utils/ApiScheduler.hpp"
+#include "../utils/Future.hpp"
 #include "../auth/AuthManager.hpp"
 #include "../models/InstrumentModel.hpp"
 #include "../config/ConfigManager.hpp"
+#include "../market/InstrumentSnapshot.hpp"
+#include "../market/InstrumentUniverse.hpp"
+#include "../market/InstrumentCsvParser.hpp"
+#include "../market/QuoteStore.hpp"
+#include "../market/TickFeed.hpp"
+#include "../market/MarketDataJournal.hpp"
+#include "../market/ReplayEngine.hpp"
 
 namespace BoxStrategy {
 
@@ -50,31 +63,63 @@ public:
     
     /**
      * @brief Get all instruments
-     * @return Future with vector of instruments
+     * @return Completed future with a copy of all instruments
+     * @note Prefer getInstrumentUniverse(), which shares the instruments without copying
      */
-    std::future<std::vector<InstrumentModel>> getAllInstruments();
+    Future<std::vector<InstrumentModel>> getAllInstruments();
+    
+    /**
+     * @brief Get the current instrument universe, loading it if missing or expired
+     * @return Shared, immutable universe (empty universe if no instruments could be loaded)
+     */
+    std::shared_ptr<const InstrumentUniverse> getInstrumentUniverse();
+    
+    /**
+     * @brief Get the quote store of the current instrument universe
+     * @return Quote store indexed by the universe's ordinals
+     */
+    std::shared_ptr<QuoteStore> getQuoteStore();
+    
+    /**
+     * @brief Called after a new instrument universe is published
+     * @param delta What changed against the previous universe
+     */
+    using UniverseListener = std::function<void(const InstrumentUniverseDelta& delta)>;
+    
+    /**
+     * @brief Register a listener for universe changes
+     * @param listener Listener, called on the publishing thread; it must not load instruments
+     * @return Listener ID for removeUniverseListener
+     */
+    size_t addUniverseListener(UniverseListener listener);
+    
+    /**
+     * @brief Unregister a universe listener
+     * @param listenerId ID returned by addUniverseListener
+     */
+    void removeUniverseListener(size_t listenerId);
     
     /**
      * @brief Get instruments by exchange
      * @param exchange Exchange name
-     * @return Future with vector of instruments
+     * @return Completed future with vector of instruments
      */
-    std::future<std::vector<InstrumentModel>> getInstrumentsByExchange(const std::string& exchange);
+    Future<std::vector<InstrumentModel>> getInstrumentsByExchange(const std::string& exchange);
     
     /**
      * @brief Get instrument by token
      * @param instrumentToken Instrument token
-     * @return Future with instrument
+     * @return Completed future with instrument
      */
-    std::future<InstrumentModel> getInstrumentByToken(uint64_t instrumentToken);
+    Future<InstrumentModel> getInstrumentByToken(uint64_t instrumentToken);
     
     /**
      * @brief Get instrument by trading symbol and exchange
      * @param tradingSymbol Trading symbol
      * @param exchange Exchange name
-     * @return Future with instrument
+     * @return Completed future with instrument
      */
-    std::future<InstrumentModel> getInstrumentBySymbol(const std::string& tradingSymbol, 
+    Future<InstrumentModel> getInstrumentBySymbol(const std::string& tradingSymbol, 
                                                      const std::string& exchange);
     
     /**
@@ -84,9 +129,9 @@ public:
      * @param exchange Exchange name (default "NFO")
      * @param minStrike Minimum strike price (optional)
      * @param maxStrike Maximum strike price (optional)
-     * @return Future with vector of option instruments
+     * @return Completed future with vector of option instruments
      */
-    std::future<std::vector<InstrumentModel>> getOptionChain(
+    Future<std::vector<InstrumentModel>> getOptionChain(
         const std::string& underlying,
         const std::chrono::system_clock::time_point& expiry,
         const std::string& exchange = "NFO",
@@ -102,7 +147,7 @@ public:
      * @param maxStrike Maximum strike price (optional)
      * @return Future with vector of option instruments with live quotes
      */
-    std::future<std::vector<InstrumentModel>> getOptionChainWithQuotes(
+    Future<std::vector<InstrumentModel>> getOptionChainWithQuotes(
         const std::string& underlying,
         const std::chrono::system_clock::time_point& expiry,
         const std::string& exchange = "NFO",
@@ -116,7 +161,7 @@ public:
      * @param exchange Exchange name (default "NFO")
      * @return Future with vector of filtered option instruments
      */
-    std::future<std::vector<InstrumentModel>> getFilteredOptionChain(
+    Future<std::vector<InstrumentModel>> getFilteredOptionChain(
         const std::string& underlying,
         const std::chrono::system_clock::time_point& expiry,
         const std::string& exchange = "NFO");
@@ -128,7 +173,7 @@ public:
      * @param exchange Exchange name (default "NFO")
      * @return Future with vector of filtered option instruments with quotes
      */
-    std::future<std::vector<InstrumentModel>> getFilteredOptionChainWithQuotes(
+    Future<std::vector<InstrumentModel>> getFilteredOptionChainWithQuotes(
         const std::string& underlying,
         const std::chrono::system_clock::time_point& expiry,
         const std::string& exchange = "NFO");
@@ -138,44 +183,52 @@ public:
      * @param instrumentToken Instrument token
      * @return Future with instrument model containing quote data
      */
-    std::future<InstrumentModel> getQuote(uint64_t instrumentToken);
+    Future<InstrumentModel> getQuote(uint64_t instrumentToken);
     
     /**
      * @brief Get quotes for multiple instruments
      * @param instrumentTokens Vector of instrument tokens
+     * @param flow Scheduler flow the requests belong to, e.g. the underlying being scanned
+     * @param store Quote store the responses are parsed into; null for the current one
      * @return Future with map of instrument token to instrument model
      */
-    std::future<std::unordered_map<uint64_t, InstrumentModel>> getQuotes(
-        const std::vector<uint64_t>& instrumentTokens);
+    Future<std::unordered_map<uint64_t, InstrumentModel>> getQuotes(
+        const std::vector<uint64_t>& instrumentTokens,
+        const std::string& flow = "",
+        std::shared_ptr<QuoteStore> store = nullptr);
     
     /**
      * @brief Get last traded price for an instrument
      * @param instrumentToken Instrument token
      * @return Future with last traded price
      */
-    std::future<double> getLTP(uint64_t instrumentToken);
+    Future<double> getLTP(uint64_t instrumentToken);
     
     /**
      * @brief Get last traded prices for multiple instruments
      * @param instrumentTokens Vector of instrument tokens
+     * @param flow Scheduler flow the requests belong to, e.g. the underlying being scanned
+     * @param store Quote store the responses are parsed into; null for the current one
      * @return Future with map of instrument token to last traded price
      */
-    std::future<std::unordered_map<uint64_t, double>> getLTPs(
-        const std::vector<uint64_t>& instrumentTokens);
+    Future<std::unordered_map<uint64_t, double>> getLTPs(
+        const std::vector<uint64_t>& instrumentTokens,
+        const std::string& flow = "",
+        std::shared_ptr<QuoteStore> store = nullptr);
     
     /**
      * @brief Get OHLC data for an instrument
      * @param instrumentToken Instrument token
      * @return Future with OHLC data
      */
-    std::future<std::tuple<double, double, double, double>> getOHLC(uint64_t instrumentToken);
+    Future<std::tuple<double, double, double, double>> getOHLC(uint64_t instrumentToken);
     
     /**
      * @brief Get OHLC data for multiple instruments
      * @param instrumentTokens Vector of instrument tokens
      * @return Future with map of instrument token to OHLC data
      */
-    std::future<std::unordered_map<uint64_t, std::tuple<double, double, double, double>>> getOHLCs(
+    Future<std::unordered_map<uint64_t, std::tuple<double, double, double, double>>> getOHLCs(
         const std::vector<uint64_t>& instrumentTokens);
     
     /**
@@ -183,13 +236,31 @@ public:
      * @param instrumentToken Instrument token
      * @return Future with instrument model containing market depth data
      */
-    std::future<InstrumentModel> getMarketDepth(uint64_t instrumentToken);
+    Future<InstrumentModel> getMarketDepth(uint64_t instrumentToken);
 
     /**
      * @brief Refresh the instruments cache by force
      * @return True if successful, false otherwise
      */
     bool refreshInstrumentsCache();
+    
+    /**
+     * @brief Start refreshing the instrument universe in the background
+     *
+     * The refresher downloads the next dump api/instruments_refresh_lead_seconds
+     * before the published universe expires and publishes it with a pointer
+     * swap. While it runs, getInstrumentUniverse() never downloads once a
+     * universe exists: an expired universe is returned as is and the
+     * refresher is woken instead.
+     *
+     * @return True if the refresher is running
+     */
+    bool startInstrumentRefresher();
+    
+    /**
+     * @brief Stop the background refresher, waiting for a running download
+     */
+    void stopInstrumentRefresher();
 
     /**
      * @brief Clear the instruments cache
@@ -198,42 +269,129 @@ public:
     
     /**
      * @brief Get the spot price for an underlying
+     *
+     * Uses the quote store when the spot instrument was written there within
+     * option_chain/spot_max_age_ms (scans carry the spot token in their
+     * quote batches); otherwise makes one /quote/ltp request.
+     *
      * @param underlying Underlying symbol (e.g., "NIFTY")
      * @param exchange Exchange name (default "NSE")
      * @return Future with spot price
      */
-    std::future<double> getSpotPrice(const std::string& underlying, const std::string& exchange = "NSE");
+    Future<double> getSpotPrice(const std::string& underlying, const std::string& exchange = "NSE");
+    
+    /**
+     * @brief Find the token of the index or equity an underlying's options are written on
+     *
+     * Known index names ("NIFTY" -> "NIFTY 50", ...) and
+     * option_chain/spot_symbols/<underlying> are tried before the underlying
+     * itself. The result is cached until the next universe version.
+     *
+     * @param underlying Underlying symbol (e.g., "NIFTY")
+     * @param exchange Exchange of the spot instrument (default "NSE")
+     * @return Instrument token, or 0 if the universe has no matching instrument
+     */
+    uint64_t resolveSpotToken(const std::string& underlying, const std::string& exchange = "NSE");
+    
+    /**
+     * @brief Start streaming ticks into the quote store
+     * @return True if the feed is running (it connects in the background)
+     */
+    bool startTickFeed();
+    
+    /**
+     * @brief Stop streaming ticks
+     */
+    void stopTickFeed();
+    
+    /**
+     * @brief Get the running tick feed
+     * @return Tick feed, or nullptr if not started
+     */
+    std::shared_ptr<TickFeed> getTickFeed() const;
+    
+    /**
+     * @brief Subscribe instruments on the tick feed
+     * @param instrumentTokens Instrument tokens
+     * @param mode Tick mode
+     * @return True if the tick feed is running
+     */
+    bool subscribeTicks(const std::vector<uint64_t>& instrumentTokens, TickMode mode = TickMode::FULL);
+    
+    /**
+     * @brief Record every successful API response and tick message in a journal
+     * @param journal Open journal, or nullptr to stop journaling
+     *
+     * Tick messages are recorded only for feeds started after this call.
+     */
+    void setJournal(std::shared_ptr<MarketDataJournal> journal);
+    
+    /**
+     * @brief Set the CPUs the tick feed thread is pinned to
+     * @param cpus Allowed CPUs, empty to leave it unpinned; applies to feeds started after this call
+     */
+    void setIoCpus(std::vector<int> cpus);
+    
+    /**
+     * @brief Share a thread pool for CPU-bound work such as parsing the instruments dump
+     * @param threadPool Pool to use, or nullptr to do that work on the calling thread
+     */
+    void setThreadPool(std::shared_ptr<ThreadPool> threadPool);
+    
+    /**
+     * @brief Serve API requests from a replay engine instead of the API
+     * @param replayEngine Loaded replay engine, or nullptr to go back to the API
+     *
+     * While replaying, requests need no access token, bypass the rate
+     * limiter and the instrument caches on disk are neither read nor written.
+     */
+    void setReplayEngine(std::shared_ptr<ReplayEngine> replayEngine);
+    
+    /**
+     * @brief Start playing the replay engine's ticks into the quote store
+     * @return False if no replay engine is set
+     */
+    bool startTickReplay();
+    
+    /**
+     * @brief Get how much of each endpoint's rate limit has been used
+     * @return Utilization per endpoint
+     */
+    std::vector<EndpointUtilization> getApiUtilization() const;
+    
+    /**
+     * @brief Log the rate limit utilization of every endpoint
+     */
+    void logApiUtilization() const;
 
 private:
+    struct QuoteFlight;
+    
     /**
      * @brief Parse instrument data from CSV
      * @param csvData CSV data
      * @return Vector of instruments
      */
-    std::vector<InstrumentModel> parseInstrumentsCSV(const std::string& csvData);
+    std::vector<InstrumentRef> parseInstrumentsCSV(const std::string& csvData);
     
     /**
-     * @brief Parse quote data from JSON
-     * @param quoteJson Quote JSON
-     * @return Instrument model with quote data
+     * @brief Log statistics of a CSV parse and take its instruments
+     * @param result Parse result
+     * @param elapsedMs Time the parse took
+     * @return Parsed instruments
      */
-    InstrumentModel parseQuoteJson(const std::string& instrumentTokenStr, 
-                                 const nlohmann::json& quoteJson);
+    std::vector<InstrumentRef> summarizeInstruments(CsvParseResult result, int64_t elapsedMs);
     
     /**
-     * @brief Parse LTP data from JSON
-     * @param ltpJson LTP JSON
-     * @return Last traded price
+     * @brief Download and parse the instruments dump, refreshing the CSV cache file
+     *
+     * In streaming mode the body is parsed and written to disk while it is
+     * still arriving; otherwise it is buffered, saved and then parsed.
+     *
+     * @param instruments Output for the parsed instruments
+     * @return True if the dump was downloaded
      */
-    double parseLTPJson(const std::string& instrumentTokenStr, const nlohmann::json& ltpJson);
-    
-    /**
-     * @brief Parse OHLC data from JSON
-     * @param ohlcJson OHLC JSON
-     * @return OHLC data
-     */
-    std::tuple<double, double, double, double> parseOHLCJson(
-        const std::string& instrumentTokenStr, const nlohmann::json& ohlcJson);
+    bool downloadInstruments(std::vector<InstrumentRef>& instruments);
     
     /**
      * @brief Rate-limited API request with proper authentication
@@ -241,20 +399,57 @@ private:
      * @param endpoint API endpoint
      * @param params Optional query parameters
      * @param body Optional request body
+     * @param priority Dispatch priority among queued requests for the endpoint
      * @return HTTP response
      */
     HttpResponse makeRateLimitedApiRequest(
         HttpMethod method,
         const std::string& endpoint,
         const std::unordered_map<std::string, std::string>& params = {},
-        const std::string& body = "");
+        const std::string& body = "",
+        RequestPriority priority = RequestPriority::NORMAL);
+    
+    /**
+     * @brief Queue an authenticated API request with the scheduler
+     * @param method HTTP method
+     * @param endpoint API endpoint
+     * @param params Query parameters
+     * @param body Request body
+     * @param priority Dispatch priority among queued requests for the endpoint
+     * @param deadline Latest dispatch time; later requests complete with status 408
+     * @param sink Optional sink that receives a successful response body as it arrives
+     * @param flow Scheduler flow sharing the endpoint's budget in turns with other flows
+     * @return Future with the HTTP response
+     */
+    Future<HttpResponse> submitApiRequest(
+        HttpMethod method,
+        const std::string& endpoint,
+        const std::unordered_map<std::string, std::string>& params,
+        const std::string& body,
+        RequestPriority priority,
+        ApiScheduler::Clock::time_point deadline = ApiScheduler::Clock::time_point::max(),
+        const HttpClient::BodySink& sink = nullptr,
+        const std::string& flow = "");
     
     /**
-     * @brief Check rate limits and wait if necessary
+     * @brief Perform an API request immediately, bypassing the scheduler
+     * @param method HTTP method
      * @param endpoint API endpoint
-     * @return True if request can proceed, false if rate limit is exceeded
+     * @param params Query parameters
+     * @param body Request body
+     * @param sink Optional sink that receives a successful response body as it arrives
+     * @param callback Receives the response on the HTTP I/O thread
+     *
+     * The request is multiplexed on the HTTP client's event loop; no thread
+     * waits for it.
      */
-    bool checkRateLimit(const std::string& endpoint);
+    void performApiRequest(
+        HttpMethod method,
+        const std::string& endpoint,
+        const std::unordered_map<std::string, std::string>& params,
+        const std::string& body,
+        const HttpClient::BodySink& sink,
+        HttpClient::Callback callback);
 
     /**
      * @brief Save instruments data to cache file
@@ -269,18 +464,182 @@ private:
      */
     std::string loadInstrumentsFromCache();
 
+    /**
+     * @brief Write the binary instruments snapshot
+     * @param instruments Parsed instruments
+     * @param downloadedAt When the dump the instruments came from was downloaded
+     * @return True if successful, false otherwise
+     */
+    bool saveInstrumentsSnapshot(const std::vector<InstrumentRef>& instruments,
+                                 std::chrono::system_clock::time_point downloadedAt);
+
+    /**
+     * @brief Load instruments from the memory-mapped binary snapshot if its dump is still fresh
+     * @param age Set to the age of the dump the snapshot was built from
+     * @return Instruments if successful, empty vector if missing, invalid or expired
+     */
+    std::vector<InstrumentRef> loadInstrumentsFromSnapshot(std::chrono::seconds& age);
+
     /**
      * @brief Check if instruments cache is valid
      * @return True if valid, false otherwise
      */
     bool isInstrumentsCacheValid();
 
+    /**
+     * @brief Check whether a cache file exists and is within the cache TTL
+     * @param cacheFilePath Path to the cache file
+     * @return True if fresh, false otherwise
+     */
+    bool isCacheFileFresh(const std::string& cacheFilePath);
+
+    /**
+     * @brief Get the age of a cache file
+     * @param cacheFilePath Path to the cache file
+     * @param age Output for the file age
+     * @return True if the file exists and its age could be read
+     */
+    bool getCacheFileAge(const std::string& cacheFilePath, std::chrono::seconds& age);
+
+    /**
+     * @brief Get the instruments cache TTL from config
+     * @return Cache TTL
+     */
+    std::chrono::minutes getInstrumentsCacheTTL();
+
+    /**
+     * @brief Load instruments from the snapshot, the CSV cache or the API, in that order
+     * @param validUntil Output for the time until which the loaded data is fresh
+     * @return Instruments if successful, empty vector otherwise
+     */
+    std::vector<InstrumentRef> loadInstruments(std::chrono::system_clock::time_point& validUntil);
+
+    /**
+     * @brief Body of the background refresher thread
+     */
+    void runInstrumentRefresher();
+
+    /**
+     * @brief Build and publish a new instrument universe
+     *
+     * With api/instruments_incremental_refresh the dump is diffed against the
+     * current universe: an unchanged dump only extends its validity, and a
+     * changed one builds the successor from the delta and carries the
+     * quotes of surviving instruments over to the new quote store.
+     * Listeners are told about the delta after publishing.
+     *
+     * @param instruments Instruments for the new universe
+     * @param validUntil Time until which the universe is fresh
+     * @return The published universe
+     */
+    std::shared_ptr<const InstrumentUniverse> publishInstrumentUniverse(
+        std::vector<InstrumentRef> instruments,
+        std::chrono::system_clock::time_point validUntil);
+
+    /**
+     * @brief Fetch quotes, sharing /quote requests with concurrent callers
+     * @param instrumentTokens Instrument tokens
+     * @param flow Scheduler flow of the batches this caller sends
+     * @param store Quote store the responses are parsed into
+     * @return Future with quotes by token; tokens the API did not return are missing
+     *
+     * Tokens already requested by another caller for the same store attach
+     * to that request.
+     * The remaining tokens form batches of up to api/quote_batch_size; a
+     * full batch is sent by whichever caller fills it. The last, partial
+     * batch stays open for api/quote_coalesce_window_ms so that concurrent
+     * callers can add their tokens to it, and the quote flusher sends it
+     * when the window ends. The calling thread never waits: the future
+     * completes on the thread that finishes the last request it depends on.
+     */
+    Future<std::unordered_map<uint64_t, InstrumentModel>> fetchQuotesCoalesced(
+        const std::vector<uint64_t>& instrumentTokens, const std::string& flow,
+        std::shared_ptr<QuoteStore> store);
+    
+    /**
+     * @brief Send a sealed batch and complete its waiters with the response
+     * @param flight Batch to send
+     */
+    void sendQuoteFlight(std::shared_ptr<QuoteFlight> flight);
+    
+    /**
+     * @brief Quote flusher loop; sends each partial batch when its coalescing window ends
+     */
+    void runQuoteFlusher();
+    
+    /**
+     * @brief Stop the quote flusher, sending the batch it holds
+     */
+    void stopQuoteFlusher();
+    
+    /**
+     * @brief Send one /quote request
+     * @param batch Instrument tokens (at most the API batch limit)
+     * @param flow Scheduler flow of the request
+     * @param store Quote store the response is parsed into
+     * @return Future with quotes by token
+     */
+    Future<std::unordered_map<uint64_t, InstrumentModel>> fetchQuoteBatch(
+        const std::vector<uint64_t>& batch, const std::string& flow,
+        std::shared_ptr<QuoteStore> store);
+    
+    /**
+     * @brief Replace the options of a chain with their quotes
+     * @param optionChain Options without quotes
+     * @return Future with the quoted options, sorted by strike; options without a quote are dropped
+     */
+    Future<std::vector<InstrumentModel>> quoteOptionChain(std::vector<InstrumentModel> optionChain);
+    
+    /**
+     * @brief Get the maximum number of tokens per /quote request
+     * @return Batch size
+     */
+    size_t getQuoteBatchSize() const;
+    
+    /**
+     * @brief Get the maximum number of tokens per /quote/ltp or /quote/ohlc request
+     * @return Batch size
+     */
+    size_t getLtpBatchSize() const;
+
+    /**
+     * @brief Combine reference data with the stored quote, if any
+     * @param store Quote store of the universe the instrument belongs to
+     * @param instrument Instrument reference data from the store's universe
+     * @return Instrument model
+     */
+    static InstrumentModel materialize(const QuoteStore& store, const InstrumentRef& instrument);
+
+    /**
+     * @brief Get binary instruments snapshot file path
+     * @return Full path to the snapshot file
+     */
+    std::string getInstrumentsSnapshotFilePath();
+
     /**
      * @brief Get cached instruments file path
      * @return Full path to cached instruments file
      */
     std::string getInstrumentsCacheFilePath();
     
+    /**
+     * @brief Collect the options of one underlying and expiry from a universe
+     * @param universe Universe to search; never loaded here
+     * @param underlying Underlying symbol (e.g., "NIFTY")
+     * @param expiry Expiry date; expiries within a day of it match
+     * @param exchange Exchange name
+     * @param minStrike Minimum strike price, or 0 for no bound
+     * @param maxStrike Maximum strike price, or 0 for no bound
+     * @return Options sorted by strike
+     */
+    std::vector<InstrumentModel> findOptionChain(
+        const InstrumentUniverse& universe,
+        const std::string& underlying,
+        const std::chrono::system_clock::time_point& expiry,
+        const std::string& exchange,
+        double minStrike,
+        double maxStrike);
+    
     /**
      * @brief Calculate strike range based on spot price and config
      * @param spotPrice Current spot price of the underlying
@@ -288,34 +647,50 @@ private:
      */
     std::pair<double, double> calculateStrikeRange(double spotPrice);
     
-    // Rate limiting parameters
-    struct RateLimitInfo {
-        int requestsPerMinute;
-        std::queue<std::chrono::system_clock::time_point> requestTimes;
-        std::shared_ptr<std::mutex> mtx;
-        
-        RateLimitInfo() : requestsPerMinute(0), mtx(std::make_shared<std::mutex>()) {}
-        
-        RateLimitInfo(int rpm) : 
-            requestsPerMinute(rpm), 
-            mtx(std::make_shared<std::mutex>()) {}
-    };
-    
-    std::unordered_map<std::string, RateLimitInfo> m_rateLimits;
-    bool m_instrumentsCached = false;
-    std::chrono::system_clock::time_point m_lastInstrumentsFetch;
-    std::chrono::minutes m_instrumentsCacheTTL = std::chrono::minutes(30);
-    std::mutex m_rateLimitMutex;
+    std::shared_ptr<ApiScheduler> m_apiScheduler;  ///< Paces API requests per endpoint
     
     std::shared_ptr<AuthManager> m_authManager;  ///< Authentication manager
     std::shared_ptr<HttpClient> m_httpClient;    ///< HTTP client
     std::shared_ptr<Logger> m_logger;            ///< Logger instance
     std::shared_ptr<ConfigManager> m_configManager;  ///< Config manager
     
-    std::unordered_map<uint64_t, InstrumentModel> m_instrumentCache;  ///< Cache of instruments by token
-    std::unordered_map<std::string, uint64_t> m_symbolToTokenMap;     ///< Map of symbol to token
+    std::shared_ptr<const InstrumentUniverse> m_universe;            ///< Published instrument universe (atomic access)
+    std::atomic<std::chrono::system_clock::time_point> m_universeValidUntil{
+        std::chrono::system_clock::time_point::min()};                ///< Expiry of the published universe
+    std::atomic<uint64_t> m_universeVersion{0};                       ///< Last published universe version
+    std::mutex m_universeLoadMutex;                                   ///< Serializes universe loads
+    
+    std::shared_ptr<QuoteStore> m_quoteStore;                         ///< Quotes of the published universe (atomic access)
+    
+    std::map<size_t, UniverseListener> m_universeListeners;           ///< Listeners by ID
+    size_t m_nextUniverseListenerId = 1;                              ///< Next listener ID
+    std::mutex m_universeListenerMutex;                               ///< Guards the listeners
+    
+    std::unordered_map<uint64_t, std::shared_ptr<QuoteFlight>> m_quoteFlights;  ///< Pending /quote request per token
+    std::shared_ptr<QuoteFlight> m_collectingQuoteFlight;                       ///< Batch still accepting tokens
+    std::mutex m_quoteFlightMutex;                                               ///< Guards the quote flights
+    std::condition_variable m_quoteFlightCondition;                              ///< Wakes the quote flusher
+    std::thread m_quoteFlusherThread;                                            ///< Sends partial batches, started on first use
+    bool m_quoteFlusherStop = false;                                             ///< Quote flusher should exit
+    
+    std::unordered_map<std::string, uint64_t> m_spotTokens;           ///< Spot token by underlying:exchange
+    uint64_t m_spotTokensVersion = 0;                                 ///< Universe version m_spotTokens belongs to
+    std::mutex m_spotTokenMutex;                                      ///< Guards the spot tokens
+    
+    std::thread m_refreshThread;                                      ///< Background instrument refresher
+    std::mutex m_refreshMutex;                                        ///< Guards the refresher state
+    std::condition_variable m_refreshCondition;                       ///< Wakes the refresher
+    bool m_refreshRequested = false;                                  ///< A reader found the universe expired
+    bool m_refreshStop = false;                                       ///< Refresher should exit
+    std::atomic<bool> m_refresherRunning{false};                      ///< Whether the refresher thread is running
+    
+    std::shared_ptr<TickFeed> m_tickFeed;                             ///< Streaming tick feed (atomic access)
+    std::mutex m_tickFeedMutex;                                       ///< Serializes starting and stopping the feed
+    std::vector<int> m_ioCpus;                                        ///< CPUs of the tick feed thread; guarded by m_tickFeedMutex
     
-    mutable std::mutex m_cacheMutex;  ///< Mutex for cache access
+    std::shared_ptr<MarketDataJournal> m_journal;                     ///< Journal of raw responses (atomic access)
+    std::shared_ptr<ThreadPool> m_threadPool;                         ///< Pool for CPU-bound work (atomic access)
+    std::shared_ptr<ReplayEngine> m_replayEngine;                     ///< Replay source replacing the API (atomic access)
 };
 
 }  // namespace BoxStrategy
\ No newline at end of file
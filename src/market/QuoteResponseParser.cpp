@@ -0,0 +1,318 @@
+/**
+ * @file QuoteResponseParser.cpp
+ * @brief Implementation of the QuoteResponseParser class
+ */
+
+#include "../market/QuoteResponseParser.hpp"
+#include "../external/json.hpp"
+#include <array>
+#include <charconv>
+
+using json = nlohmann::json;
+
+namespace BoxStrategy {
+
+namespace {
+
+/**
+ * @brief Integer view of a float for the integer fields; negative, NaN and out-of-range values become 0
+ */
+uint64_t toUnsigned(double value) {
+    // 2^64 is the first double an uint64_t cannot hold; the cast is undefined from there on
+    return value >= 0.0 && value < 18446744073709551616.0 ? static_cast<uint64_t>(value) : 0;
+}
+
+/**
+ * @brief SAX handler that tracks where in a quote response it is
+ */
+class QuoteSaxHandler {
+public:
+    QuoteSaxHandler(QuoteResponseKind kind, QuoteStore* store,
+                    const QuoteResponseParser::InstrumentCallback& onInstrument,
+                    QuoteParseResult& result)
+        : m_kind(kind), m_store(store), m_onInstrument(onInstrument), m_result(result) {}
+
+    bool null() { return true; }
+    bool boolean(bool) { return true; }
+    bool number_integer(json::number_integer_t value) { return number(static_cast<double>(value), static_cast<uint64_t>(value)); }
+    bool number_unsigned(json::number_unsigned_t value) { return number(static_cast<double>(value), value); }
+    bool number_float(json::number_float_t value, const json::string_t&) { return number(value, toUnsigned(value)); }
+    bool binary(json::binary_t&) { return true; }
+
+    bool string(json::string_t& value) {
+        if (m_skip == 0 && top() == Context::ROOT) {
+            if (m_field == Field::STATUS) {
+                m_statusSuccess = value == "success";
+            } else if (m_field == Field::MESSAGE) {
+                m_message = value;
+            }
+        }
+        return true;
+    }
+
+    bool start_object(std::size_t) {
+        if (m_skip > 0) {
+            m_skip++;
+            return true;
+        }
+
+        Context next = Context::SKIP;
+        switch (top()) {
+            case Context::NONE:
+                next = Context::ROOT;
+                break;
+            case Context::ROOT:
+                next = m_field == Field::DATA ? Context::DATA : Context::SKIP;
+                break;
+            case Context::DATA:
+                next = Context::INSTRUMENT;
+                m_quote = QuoteModel();
+                m_instrumentToken = 0;
+                break;
+            case Context::INSTRUMENT:
+                next = m_field == Field::OHLC ? Context::OHLC :
+                       m_field == Field::DEPTH ? Context::DEPTH : Context::SKIP;
+                break;
+            case Context::DEPTH_SIDE: {
+                DepthLadder& ladder = m_buySide ? m_quote.buyDepth : m_quote.sellDepth;
+                if (ladder.size() < DepthLadder::CAPACITY) {
+                    ladder.push_back({0.0, 0, 0});
+                    next = Context::DEPTH_LEVEL;
+                }
+                break;
+            }
+            default:
+                break;
+        }
+
+        return enter(next);
+    }
+
+    bool end_object() {
+        if (m_skip > 0) {
+            m_skip--;
+            return true;
+        }
+
+        if (top() == Context::INSTRUMENT) {
+            commit();
+        }
+
+        m_depth--;
+        m_field = Field::NONE;
+        return true;
+    }
+
+    bool start_array(std::size_t) {
+        if (m_skip > 0) {
+            m_skip++;
+            return true;
+        }
+
+        if (top() == Context::DEPTH && (m_field == Field::BUY || m_field == Field::SELL)) {
+            m_buySide = m_field == Field::BUY;
+            return enter(Context::DEPTH_SIDE);
+        }
+
+        return enter(Context::SKIP);
+    }
+
+    bool end_array() {
+        if (m_skip > 0) {
+            m_skip--;
+            return true;
+        }
+
+        m_depth--;
+        m_field = Field::NONE;
+        return true;
+    }
+
+    bool key(json::string_t& name) {
+        if (m_skip > 0) {
+            return true;
+        }
+
+        m_field = Field::NONE;
+        switch (top()) {
+            case Context::ROOT:
+                if (name == "status") m_field = Field::STATUS;
+                else if (name == "message") m_field = Field::MESSAGE;
+                else if (name == "data") m_field = Field::DATA;
+                break;
+            case Context::DATA:
+                // Responses are keyed by whatever was requested: a token or "EXCHANGE:SYMBOL"
+                m_keyToken = 0;
+                std::from_chars(name.data(), name.data() + name.size(), m_keyToken);
+                break;
+            case Context::INSTRUMENT:
+                if (name == "last_price") m_field = Field::LAST_PRICE;
+                else if (name == "instrument_token") m_field = Field::INSTRUMENT_TOKEN;
+                else if (name == "ohlc") m_field = Field::OHLC;
+                else if (name == "depth") m_field = Field::DEPTH;
+                else if (name == "average_price") m_field = Field::AVERAGE_PRICE;
+                else if (name == "volume") m_field = Field::VOLUME;
+                else if (name == "buy_quantity") m_field = Field::BUY_QUANTITY;
+                else if (name == "sell_quantity") m_field = Field::SELL_QUANTITY;
+                else if (name == "oi" || name == "open_interest") m_field = Field::OPEN_INTEREST;
+                break;
+            case Context::OHLC:
+                if (name == "open") m_field = Field::OPEN;
+                else if (name == "high") m_field = Field::HIGH;
+                else if (name == "low") m_field = Field::LOW;
+                else if (name == "close") m_field = Field::CLOSE;
+                break;
+            case Context::DEPTH:
+                if (name == "buy") m_field = Field::BUY;
+                else if (name == "sell") m_field = Field::SELL;
+                break;
+            case Context::DEPTH_LEVEL:
+                if (name == "price") m_field = Field::PRICE;
+                else if (name == "quantity") m_field = Field::QUANTITY;
+                else if (name == "orders") m_field = Field::ORDERS;
+                break;
+            default:
+                break;
+        }
+        return true;
+    }
+
+    bool parse_error(std::size_t position, const std::string&, const nlohmann::detail::exception& error) {
+        m_parseError = "Invalid JSON at byte " + std::to_string(position) + ": " + error.what();
+        return false;
+    }
+
+    /**
+     * @brief Fill in the result after the whole body was walked
+     */
+    void finish(bool parsed) {
+        if (!parsed) {
+            m_result.error = m_parseError.empty() ? "Invalid JSON" : m_parseError;
+        } else if (!m_statusSuccess) {
+            m_result.error = m_message.empty() ? "Response status is not success" : m_message;
+        } else {
+            m_result.success = true;
+        }
+    }
+
+private:
+    enum class Context : uint8_t { NONE, ROOT, DATA, INSTRUMENT, OHLC, DEPTH, DEPTH_SIDE, DEPTH_LEVEL, SKIP };
+
+    enum class Field : uint8_t {
+        NONE, STATUS, MESSAGE, DATA,
+        INSTRUMENT_TOKEN, LAST_PRICE, AVERAGE_PRICE, VOLUME, BUY_QUANTITY, SELL_QUANTITY, OPEN_INTEREST,
+        OHLC, OPEN, HIGH, LOW, CLOSE,
+        DEPTH, BUY, SELL, PRICE, QUANTITY, ORDERS
+    };
+
+    static constexpr size_t MAX_DEPTH = 8;
+
+    Context top() const { return m_depth == 0 ? Context::NONE : m_stack[m_depth - 1]; }
+
+    bool enter(Context context) {
+        // Anything the parser does not look into is skipped as a whole subtree
+        if (context == Context::SKIP || m_depth == MAX_DEPTH) {
+            m_skip = 1;
+        } else {
+            m_stack[m_depth++] = context;
+        }
+        m_field = Field::NONE;
+        return true;
+    }
+
+    bool number(double value, uint64_t unsignedValue) {
+        if (m_skip > 0) {
+            return true;
+        }
+
+        switch (m_field) {
+            case Field::INSTRUMENT_TOKEN: m_instrumentToken = unsignedValue; break;
+            case Field::LAST_PRICE: m_quote.lastPrice = value; break;
+            case Field::AVERAGE_PRICE: m_quote.averagePrice = value; break;
+            case Field::VOLUME: m_quote.volume = unsignedValue; break;
+            case Field::BUY_QUANTITY: m_quote.buyQuantity = unsignedValue; break;
+            case Field::SELL_QUANTITY: m_quote.sellQuantity = unsignedValue; break;
+            case Field::OPEN_INTEREST: m_quote.openInterest = value; break;
+            case Field::OPEN: m_quote.openPrice = value; break;
+            case Field::HIGH: m_quote.highPrice = value; break;
+            case Field::LOW: m_quote.lowPrice = value; break;
+            case Field::CLOSE: m_quote.closePrice = value; break;
+            case Field::PRICE: currentLevel().price = value; break;
+            case Field::QUANTITY: currentLevel().quantity = unsignedValue; break;
+            case Field::ORDERS: currentLevel().orders = static_cast<uint32_t>(unsignedValue); break;
+            default: break;
+        }
+        return true;
+    }
+
+    DepthItem& currentLevel() {
+        DepthLadder& ladder = m_buySide ? m_quote.buyDepth : m_quote.sellDepth;
+        return ladder[ladder.size() - 1];
+    }
+
+    void commit() {
+        uint64_t token = m_instrumentToken != 0 ? m_instrumentToken : m_keyToken;
+        m_result.instruments++;
+
+        uint32_t ordinal = QuoteResponseParser::NO_ORDINAL;
+        if (m_store && token != 0 && m_store->getUniverse()->findOrdinal(token, ordinal)) {
+            switch (m_kind) {
+                case QuoteResponseKind::QUOTE:
+                    m_store->update(ordinal, m_quote);
+                    break;
+                case QuoteResponseKind::LTP:
+                    m_store->updateLastPrice(ordinal, m_quote.lastPrice);
+                    break;
+                case QuoteResponseKind::OHLC:
+                    m_store->updateOHLC(ordinal, m_quote.openPrice, m_quote.highPrice,
+                                        m_quote.lowPrice, m_quote.closePrice);
+                    break;
+            }
+            m_result.stored++;
+        } else {
+            ordinal = QuoteResponseParser::NO_ORDINAL;
+        }
+
+        if (m_onInstrument && token != 0) {
+            m_onInstrument(token, ordinal, m_quote);
+        }
+    }
+
+    QuoteResponseKind m_kind;
+    QuoteStore* m_store;
+    const QuoteResponseParser::InstrumentCallback& m_onInstrument;
+    QuoteParseResult& m_result;
+
+    std::array<Context, MAX_DEPTH> m_stack{};
+    size_t m_depth = 0;
+    size_t m_skip = 0;
+    Field m_field = Field::NONE;
+
+    QuoteModel m_quote;
+    uint64_t m_instrumentToken = 0;
+    uint64_t m_keyToken = 0;
+    bool m_buySide = true;
+
+    bool m_statusSuccess = false;
+    std::string m_message;
+    std::string m_parseError;
+};
+
+}  // namespace
+
+QuoteParseResult QuoteResponseParser::parse(
+    std::string_view body,
+    QuoteResponseKind kind,
+    QuoteStore* store,
+    const InstrumentCallback& onInstrument) {
+
+    QuoteParseResult result;
+    QuoteSaxHandler handler(kind, store, onInstrument, result);
+
+    bool parsed = json::sax_parse(body.begin(), body.end(), &handler);
+    handler.finish(parsed);
+
+    return result;
+}
+
+}  // namespace BoxStrategy
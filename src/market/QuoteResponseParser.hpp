@@ -0,0 +1,76 @@
+/**
+ * @file QuoteResponseParser.hpp
+ * @brief Streaming parser for Kite /quote, /quote/ltp and /quote/ohlc responses
+ */
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <functional>
+#include <cstdint>
+#include <limits>
+#include "../models/InstrumentModel.hpp"
+#include "../market/QuoteStore.hpp"
+
+namespace BoxStrategy {
+
+/**
+ * @enum QuoteResponseKind
+ * @brief Endpoint a response body came from
+ */
+enum class QuoteResponseKind {
+    QUOTE,    ///< /quote: full quote with OHLC and depth
+    LTP,      ///< /quote/ltp: last price only
+    OHLC      ///< /quote/ohlc: last price and OHLC
+};
+
+/**
+ * @struct QuoteParseResult
+ * @brief Outcome of parsing one response body
+ */
+struct QuoteParseResult {
+    bool success = false;          ///< Whether the body parsed and its status was "success"
+    std::string error;             ///< API message or parse error when not successful
+    size_t instruments = 0;        ///< Instruments found in the body
+    size_t stored = 0;             ///< Instruments written into the store
+};
+
+/**
+ * @class QuoteResponseParser
+ * @brief Parses quote responses from a stream of JSON events into the quote store
+ *
+ * The body is walked with nlohmann's SAX interface, so no JSON tree is
+ * built. Fields of each instrument are collected into one reused
+ * QuoteModel and written into the instrument's store slot when its object
+ * closes. Only the fields the endpoint carries are written: last price for
+ * LTP, OHLC for OHLC, and the full quote for /quote.
+ */
+class QuoteResponseParser {
+public:
+    static constexpr uint32_t NO_ORDINAL = std::numeric_limits<uint32_t>::max();  ///< Token not in the store
+
+    /**
+     * @brief Called for every instrument after it is stored
+     * @param instrumentToken Instrument token
+     * @param ordinal Ordinal in the store, or NO_ORDINAL if the store does not know the token
+     * @param quote Parsed fields (only valid during the call)
+     */
+    using InstrumentCallback = std::function<void(uint64_t instrumentToken, uint32_t ordinal, const QuoteModel& quote)>;
+
+    /**
+     * @brief Parse a response body
+     * @param body Response body
+     * @param kind Endpoint the body came from
+     * @param store Store to write into (may be null)
+     * @param onInstrument Optional callback per instrument
+     * @return Parse result
+     */
+    static QuoteParseResult parse(
+        std::string_view body,
+        QuoteResponseKind kind,
+        QuoteStore* store,
+        const InstrumentCallback& onInstrument = nullptr);
+};
+
+}  // namespace BoxStrategy
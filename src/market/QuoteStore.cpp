@@ -0,0 +1,355 @@
+/**
+ * @file QuoteStore.cpp
+ * @brief Implementation of the QuoteStore class
+ */
+
+#include "../market/QuoteStore.hpp"
+#include <algorithm>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace BoxStrategy {
+
+namespace {
+
+constexpr size_t DEPTH = DepthLadder::CAPACITY;
+
+/**
+ * @brief Back off while another thread holds a slot
+ */
+inline void spinWait(unsigned& spins) {
+    if (++spins < 64) {
+#if defined(__x86_64__) || defined(__i386__)
+        _mm_pause();
+#endif
+    } else {
+        // The holder was probably descheduled
+        std::this_thread::yield();
+    }
+}
+
+}  // namespace
+
+QuoteStore::QuoteStore(std::shared_ptr<const InstrumentUniverse> universe)
+    : m_universe(std::move(universe)) {
+
+    m_size = m_universe ? m_universe->size() : 0;
+
+    m_sequence.reset(new std::atomic<uint32_t>[m_size]);
+    for (size_t i = 0; i < m_size; ++i) {
+        m_sequence[i].store(0, std::memory_order_relaxed);
+    }
+
+    m_lastPrice.reset(m_size, 0.0);
+    m_openPrice.reset(m_size, 0.0);
+    m_highPrice.reset(m_size, 0.0);
+    m_lowPrice.reset(m_size, 0.0);
+    m_closePrice.reset(m_size, 0.0);
+    m_averagePrice.reset(m_size, 0.0);
+    m_volume.reset(m_size, 0);
+    m_buyQuantity.reset(m_size, 0);
+    m_sellQuantity.reset(m_size, 0);
+    m_openInterest.reset(m_size, 0.0);
+    m_bestBid.reset(m_size, 0.0);
+    m_bestAsk.reset(m_size, 0.0);
+    m_buyPrice.reset(m_size * DEPTH, 0.0);
+    m_buyVolume.reset(m_size * DEPTH, 0);
+    m_buyOrders.reset(m_size * DEPTH, 0);
+    m_buyLevels.reset(m_size, 0);
+    m_sellPrice.reset(m_size * DEPTH, 0.0);
+    m_sellVolume.reset(m_size * DEPTH, 0);
+    m_sellOrders.reset(m_size * DEPTH, 0);
+    m_sellLevels.reset(m_size, 0);
+    m_quoted.reset(m_size, 0);
+    m_updatedAt.reset(m_size, 0);
+
+    // Until an instrument is quoted its last price is the one from the instruments dump
+    for (size_t i = 0; i < m_size; ++i) {
+        m_lastPrice.store(i, m_universe->at(static_cast<uint32_t>(i)).listedPrice);
+    }
+}
+
+int64_t QuoteStore::nowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+uint32_t QuoteStore::beginWrite(uint32_t ordinal) {
+    std::atomic<uint32_t>& sequence = m_sequence[ordinal];
+    uint32_t current = sequence.load(std::memory_order_relaxed);
+    unsigned spins = 0;
+
+    // An odd sequence means another writer holds the slot
+    while ((current & 1) != 0 ||
+           !sequence.compare_exchange_weak(current, current + 1, std::memory_order_acquire,
+                                           std::memory_order_relaxed)) {
+        spinWait(spins);
+        current = sequence.load(std::memory_order_relaxed);
+    }
+
+    // Keep the field stores below from becoming visible before the odd sequence
+    std::atomic_thread_fence(std::memory_order_release);
+    return current + 1;
+}
+
+void QuoteStore::endWrite(uint32_t ordinal, uint32_t sequence) {
+    m_sequence[ordinal].store(sequence + 1, std::memory_order_release);
+}
+
+uint32_t QuoteStore::beginRead(uint32_t ordinal) const {
+    unsigned spins = 0;
+    uint32_t sequence = m_sequence[ordinal].load(std::memory_order_acquire);
+
+    while ((sequence & 1) != 0) {
+        spinWait(spins);
+        sequence = m_sequence[ordinal].load(std::memory_order_acquire);
+    }
+
+    return sequence;
+}
+
+bool QuoteStore::validateRead(uint32_t ordinal, uint32_t sequence) const {
+    // Keep the field loads above from moving past the sequence check
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return m_sequence[ordinal].load(std::memory_order_relaxed) == sequence;
+}
+
+void QuoteStore::storeDepth(Column<double>& prices, Column<uint64_t>& quantities, Column<uint32_t>& orders,
+                            Column<uint8_t>& sizes, uint32_t ordinal, const DepthLadder& depth) {
+    size_t base = static_cast<size_t>(ordinal) * DEPTH;
+
+    for (size_t level = 0; level < depth.size(); ++level) {
+        prices.store(base + level, depth[level].price);
+        quantities.store(base + level, depth[level].quantity);
+        orders.store(base + level, depth[level].orders);
+    }
+    sizes.store(ordinal, static_cast<uint8_t>(depth.size()));
+}
+
+void QuoteStore::loadDepth(const Column<double>& prices, const Column<uint64_t>& quantities,
+                           const Column<uint32_t>& orders, const Column<uint8_t>& sizes,
+                           uint32_t ordinal, DepthLadder& depth) const {
+    size_t base = static_cast<size_t>(ordinal) * DEPTH;
+    size_t levels = std::min<size_t>(sizes.load(ordinal), DEPTH);
+
+    depth.clear();
+    for (size_t level = 0; level < levels; ++level) {
+        depth.push_back({prices.load(base + level), quantities.load(base + level), orders.load(base + level)});
+    }
+}
+
+void QuoteStore::update(uint32_t ordinal, const QuoteModel& quote) {
+    if (ordinal >= size()) {
+        return;
+    }
+
+    uint32_t sequence = beginWrite(ordinal);
+
+    m_lastPrice.store(ordinal, quote.lastPrice);
+    m_openPrice.store(ordinal, quote.openPrice);
+    m_highPrice.store(ordinal, quote.highPrice);
+    m_lowPrice.store(ordinal, quote.lowPrice);
+    m_closePrice.store(ordinal, quote.closePrice);
+    m_averagePrice.store(ordinal, quote.averagePrice);
+    m_volume.store(ordinal, quote.volume);
+    m_buyQuantity.store(ordinal, quote.buyQuantity);
+    m_sellQuantity.store(ordinal, quote.sellQuantity);
+    m_openInterest.store(ordinal, quote.openInterest);
+    storeDepth(m_buyPrice, m_buyVolume, m_buyOrders, m_buyLevels, ordinal, quote.buyDepth);
+    storeDepth(m_sellPrice, m_sellVolume, m_sellOrders, m_sellLevels, ordinal, quote.sellDepth);
+    m_bestBid.store(ordinal, quote.buyDepth.empty() ? 0.0 : quote.buyDepth.front().price);
+    m_bestAsk.store(ordinal, quote.sellDepth.empty() ? 0.0 : quote.sellDepth.front().price);
+    m_quoted.store(ordinal, 1);
+    m_updatedAt.store(ordinal, nowMs());
+
+    endWrite(ordinal, sequence);
+}
+
+void QuoteStore::updateQuote(uint32_t ordinal, const QuoteModel& quote) {
+    if (ordinal >= size()) {
+        return;
+    }
+
+    uint32_t sequence = beginWrite(ordinal);
+
+    m_lastPrice.store(ordinal, quote.lastPrice);
+    m_openPrice.store(ordinal, quote.openPrice);
+    m_highPrice.store(ordinal, quote.highPrice);
+    m_lowPrice.store(ordinal, quote.lowPrice);
+    m_closePrice.store(ordinal, quote.closePrice);
+    m_averagePrice.store(ordinal, quote.averagePrice);
+    m_volume.store(ordinal, quote.volume);
+    m_buyQuantity.store(ordinal, quote.buyQuantity);
+    m_sellQuantity.store(ordinal, quote.sellQuantity);
+    m_quoted.store(ordinal, 1);
+    m_updatedAt.store(ordinal, nowMs());
+
+    endWrite(ordinal, sequence);
+}
+
+void QuoteStore::updateLastPrice(uint32_t ordinal, double lastPrice) {
+    if (ordinal >= size()) {
+        return;
+    }
+
+    uint32_t sequence = beginWrite(ordinal);
+    m_lastPrice.store(ordinal, lastPrice);
+    m_updatedAt.store(ordinal, nowMs());
+    endWrite(ordinal, sequence);
+}
+
+void QuoteStore::updateOHLC(uint32_t ordinal, double open, double high, double low, double close) {
+    if (ordinal >= size()) {
+        return;
+    }
+
+    uint32_t sequence = beginWrite(ordinal);
+    m_openPrice.store(ordinal, open);
+    m_highPrice.store(ordinal, high);
+    m_lowPrice.store(ordinal, low);
+    m_closePrice.store(ordinal, close);
+    m_updatedAt.store(ordinal, nowMs());
+    endWrite(ordinal, sequence);
+}
+
+bool QuoteStore::read(uint32_t ordinal, QuoteModel& quote) const {
+    if (ordinal >= size()) {
+        return false;
+    }
+
+    // Read into a local copy so a failed attempt never leaves a torn quote behind
+    QuoteModel snapshot;
+    uint32_t sequence = 0;
+    bool quoted = false;
+
+    do {
+        sequence = beginRead(ordinal);
+        quoted = m_quoted.load(ordinal) != 0;
+
+        if (quoted) {
+            snapshot.lastPrice = m_lastPrice.load(ordinal);
+            snapshot.openPrice = m_openPrice.load(ordinal);
+            snapshot.highPrice = m_highPrice.load(ordinal);
+            snapshot.lowPrice = m_lowPrice.load(ordinal);
+            snapshot.closePrice = m_closePrice.load(ordinal);
+            snapshot.averagePrice = m_averagePrice.load(ordinal);
+            snapshot.volume = m_volume.load(ordinal);
+            snapshot.buyQuantity = m_buyQuantity.load(ordinal);
+            snapshot.sellQuantity = m_sellQuantity.load(ordinal);
+            snapshot.openInterest = m_openInterest.load(ordinal);
+            loadDepth(m_buyPrice, m_buyVolume, m_buyOrders, m_buyLevels, ordinal, snapshot.buyDepth);
+            loadDepth(m_sellPrice, m_sellVolume, m_sellOrders, m_sellLevels, ordinal, snapshot.sellDepth);
+        }
+    } while (!validateRead(ordinal, sequence));
+
+    if (!quoted) {
+        return false;
+    }
+
+    quote = snapshot;
+    return true;
+}
+
+bool QuoteStore::hasQuote(uint32_t ordinal) const {
+    if (ordinal >= size()) {
+        return false;
+    }
+
+    // The flag only ever goes from 0 to 1, so it needs no sequence check
+    return m_quoted.load(ordinal) != 0;
+}
+
+bool QuoteStore::hasFreshQuote(uint32_t ordinal, std::chrono::milliseconds maxAge) const {
+    if (!hasQuote(ordinal)) {
+        return false;
+    }
+
+    // A single word, so a racing write yields either the old or the new time
+    return nowMs() - m_updatedAt.load(ordinal) <= maxAge.count();
+}
+
+bool QuoteStore::readLastPrice(uint32_t ordinal, double& lastPrice,
+                               std::chrono::system_clock::time_point& updatedAt) const {
+    if (ordinal >= size()) {
+        return false;
+    }
+
+    double price = 0.0;
+    int64_t updatedMs = 0;
+    uint32_t sequence = 0;
+    do {
+        sequence = beginRead(ordinal);
+        price = m_lastPrice.load(ordinal);
+        updatedMs = m_updatedAt.load(ordinal);
+    } while (!validateRead(ordinal, sequence));
+
+    if (updatedMs == 0) {
+        return false;
+    }
+
+    lastPrice = price;
+    updatedAt = std::chrono::system_clock::time_point(std::chrono::milliseconds(updatedMs));
+    return true;
+}
+
+void QuoteStore::gatherPrices(const std::vector<uint32_t>& ordinals,
+                              std::vector<double>& lastPrices,
+                              std::vector<double>& bestBids,
+                              std::vector<double>& bestAsks) const {
+    lastPrices.resize(ordinals.size());
+    bestBids.resize(ordinals.size());
+    bestAsks.resize(ordinals.size());
+
+    for (size_t i = 0; i < ordinals.size(); ++i) {
+        uint32_t ordinal = ordinals[i];
+        if (ordinal >= size()) {
+            lastPrices[i] = bestBids[i] = bestAsks[i] = 0.0;
+            continue;
+        }
+
+        // Each instrument is consistent on its own; different instruments may come from different ticks
+        uint32_t sequence = 0;
+        do {
+            sequence = beginRead(ordinal);
+            bool quoted = m_quoted.load(ordinal) != 0;
+            lastPrices[i] = quoted ? m_lastPrice.load(ordinal) : 0.0;
+            bestBids[i] = quoted ? m_bestBid.load(ordinal) : 0.0;
+            bestAsks[i] = quoted ? m_bestAsk.load(ordinal) : 0.0;
+        } while (!validateRead(ordinal, sequence));
+    }
+}
+
+size_t QuoteStore::carryOver(const QuoteStore& previous, const std::vector<uint32_t>& ordinalMap) {
+    size_t copied = 0;
+    size_t count = std::min(previous.size(), ordinalMap.size());
+    QuoteModel quote;
+    double lastPrice = 0.0;
+    std::chrono::system_clock::time_point updatedAt;
+
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t ordinal = ordinalMap[i];
+        if (ordinal == InstrumentUniverse::NO_ORDINAL || ordinal >= m_size ||
+            !previous.readLastPrice(static_cast<uint32_t>(i), lastPrice, updatedAt)) {
+            continue;
+        }
+
+        if (previous.read(static_cast<uint32_t>(i), quote)) {
+            update(ordinal, quote);
+        } else {
+            updateLastPrice(ordinal, lastPrice);
+        }
+
+        // Keep the original write time so staleness checks still see the quote's real age;
+        // the store is not published yet, so no reader can race this store
+        m_updatedAt.store(ordinal, std::chrono::duration_cast<std::chrono::milliseconds>(
+            updatedAt.time_since_epoch()).count());
+        copied++;
+    }
+
+    return copied;
+}
+
+}  // namespace BoxStrategy
@@ -0,0 +1,235 @@
+/**
+ * @file QuoteStore.hpp
+ * @brief Structure-of-arrays store of live quotes, indexed by instrument ordinal
+ */
+
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include "../models/InstrumentModel.hpp"
+#include "../market/InstrumentUniverse.hpp"
+
+namespace BoxStrategy {
+
+/**
+ * @class QuoteStore
+ * @brief Latest quote of every instrument in one universe, one column per field
+ *
+ * Each quote field is a separate array indexed by the instrument's ordinal
+ * in the universe, so scans over many instruments (e.g. the best bid/ask
+ * of all legs of an option chain) read contiguous memory. Depth is stored
+ * as fixed five-level columns. The store is created for a specific
+ * universe and is replaced when a new universe is published.
+ *
+ * Every slot is guarded by its own sequence lock instead of a store-wide
+ * mutex. A writer makes the slot's sequence odd, updates the columns and
+ * makes it even again; concurrent writers of the same slot wait for each
+ * other. Readers never lock: they copy the fields and retry if the
+ * sequence was odd or changed meanwhile, so readers of different (or the
+ * same) instruments do not contend with each other.
+ */
+class QuoteStore {
+public:
+    /**
+     * @brief Constructor
+     * @param universe Universe whose ordinals index the columns
+     */
+    explicit QuoteStore(std::shared_ptr<const InstrumentUniverse> universe);
+
+    QuoteStore(const QuoteStore&) = delete;
+    QuoteStore& operator=(const QuoteStore&) = delete;
+
+    /**
+     * @brief Get the universe this store is indexed by
+     * @return Universe
+     */
+    const std::shared_ptr<const InstrumentUniverse>& getUniverse() const { return m_universe; }
+
+    /**
+     * @brief Get the number of slots
+     * @return Number of instruments in the universe
+     */
+    size_t size() const { return m_size; }
+
+    /**
+     * @brief Store a full quote
+     * @param ordinal Instrument ordinal
+     * @param quote Quote
+     */
+    void update(uint32_t ordinal, const QuoteModel& quote);
+
+    /**
+     * @brief Store a quote without open interest and depth
+     * @param ordinal Instrument ordinal
+     * @param quote Quote; its open interest and depth are ignored
+     */
+    void updateQuote(uint32_t ordinal, const QuoteModel& quote);
+
+    /**
+     * @brief Store a last traded price
+     * @param ordinal Instrument ordinal
+     * @param lastPrice Last traded price
+     */
+    void updateLastPrice(uint32_t ordinal, double lastPrice);
+
+    /**
+     * @brief Store OHLC prices
+     * @param ordinal Instrument ordinal
+     * @param open Open price
+     * @param high High price
+     * @param low Low price
+     * @param close Close price
+     */
+    void updateOHLC(uint32_t ordinal, double open, double high, double low, double close);
+
+    /**
+     * @brief Read the stored quote
+     * @param ordinal Instrument ordinal
+     * @param quote Output quote, untouched if the instrument was never quoted
+     * @return True if a quote has been stored for the instrument
+     */
+    bool read(uint32_t ordinal, QuoteModel& quote) const;
+
+    /**
+     * @brief Check if a quote has been stored
+     * @param ordinal Instrument ordinal
+     * @return True if quoted
+     */
+    bool hasQuote(uint32_t ordinal) const;
+
+    /**
+     * @brief Check if a quote has been stored and the slot was written recently
+     * @param ordinal Instrument ordinal
+     * @param maxAge Oldest last write that still counts as fresh
+     * @return True if quoted and written within maxAge
+     */
+    bool hasFreshQuote(uint32_t ordinal, std::chrono::milliseconds maxAge) const;
+
+    /**
+     * @brief Read the last price and when the slot was last written
+     * @param ordinal Instrument ordinal
+     * @param lastPrice Output last price
+     * @param updatedAt Output time of the last write of any kind (quote, LTP or OHLC)
+     * @return True if the slot has been written since the store was created
+     */
+    bool readLastPrice(uint32_t ordinal, double& lastPrice, std::chrono::system_clock::time_point& updatedAt) const;
+
+    /**
+     * @brief Copy the price columns of several instruments
+     * @param ordinals Instrument ordinals
+     * @param lastPrices Output last prices, one per ordinal
+     * @param bestBids Output best bids (0 if no depth), one per ordinal
+     * @param bestAsks Output best asks (0 if no depth), one per ordinal
+     */
+    void gatherPrices(const std::vector<uint32_t>& ordinals,
+                      std::vector<double>& lastPrices,
+                      std::vector<double>& bestBids,
+                      std::vector<double>& bestAsks) const;
+
+    /**
+     * @brief Copy the quotes of the store this one replaces
+     * @param previous Store of the previous universe
+     * @param ordinalMap New ordinal for every ordinal of the previous store (NO_ORDINAL to drop)
+     * @return Number of quotes copied
+     */
+    size_t carryOver(const QuoteStore& previous, const std::vector<uint32_t>& ordinalMap);
+
+private:
+    /**
+     * @class Column
+     * @brief Fixed-size array of relaxed atomics
+     *
+     * Fields are atomics so that a reader racing a writer is well defined;
+     * the sequence lock decides whether what was read is consistent.
+     */
+    template <typename T>
+    class Column {
+    public:
+        void reset(size_t size, T value) {
+            m_data.reset(new std::atomic<T>[size]);
+            for (size_t i = 0; i < size; ++i) {
+                m_data[i].store(value, std::memory_order_relaxed);
+            }
+        }
+
+        T load(size_t index) const { return m_data[index].load(std::memory_order_relaxed); }
+        void store(size_t index, T value) { m_data[index].store(value, std::memory_order_relaxed); }
+
+    private:
+        std::unique_ptr<std::atomic<T>[]> m_data;  ///< Values
+    };
+
+    /**
+     * @brief Get the current time for m_updatedAt
+     * @return Milliseconds since the epoch
+     */
+    static int64_t nowMs();
+
+    /**
+     * @brief Take the slot's sequence lock
+     * @return Sequence value to pass to endWrite
+     */
+    uint32_t beginWrite(uint32_t ordinal);
+
+    /**
+     * @brief Release the slot's sequence lock
+     */
+    void endWrite(uint32_t ordinal, uint32_t sequence);
+
+    /**
+     * @brief Wait until the slot is not being written
+     * @return Sequence value to validate the read against
+     */
+    uint32_t beginRead(uint32_t ordinal) const;
+
+    /**
+     * @brief Check that the slot did not change since beginRead
+     */
+    bool validateRead(uint32_t ordinal, uint32_t sequence) const;
+
+    /**
+     * @brief Write one side of the depth (caller holds the slot)
+     */
+    void storeDepth(Column<double>& prices, Column<uint64_t>& quantities, Column<uint32_t>& orders,
+                    Column<uint8_t>& sizes, uint32_t ordinal, const DepthLadder& depth);
+
+    /**
+     * @brief Read one side of the depth (inside a read section)
+     */
+    void loadDepth(const Column<double>& prices, const Column<uint64_t>& quantities, const Column<uint32_t>& orders,
+                   const Column<uint8_t>& sizes, uint32_t ordinal, DepthLadder& depth) const;
+
+    std::shared_ptr<const InstrumentUniverse> m_universe;  ///< Universe defining the ordinals
+    size_t m_size = 0;                                     ///< Number of slots
+
+    std::unique_ptr<std::atomic<uint32_t>[]> m_sequence;   ///< Per-slot sequence lock (odd while written)
+
+    Column<double> m_lastPrice;            ///< Last traded price
+    Column<double> m_openPrice;            ///< Opening price
+    Column<double> m_highPrice;            ///< High price
+    Column<double> m_lowPrice;             ///< Low price
+    Column<double> m_closePrice;           ///< Closing price
+    Column<double> m_averagePrice;         ///< Average price
+    Column<uint64_t> m_volume;             ///< Traded volume
+    Column<uint64_t> m_buyQuantity;        ///< Buy quantity
+    Column<uint64_t> m_sellQuantity;       ///< Sell quantity
+    Column<double> m_openInterest;         ///< Open interest
+    Column<double> m_bestBid;              ///< Best bid (top of buy depth)
+    Column<double> m_bestAsk;              ///< Best ask (top of sell depth)
+    Column<double> m_buyPrice;             ///< Buy depth prices, CAPACITY per slot
+    Column<uint64_t> m_buyVolume;          ///< Buy depth quantities, CAPACITY per slot
+    Column<uint32_t> m_buyOrders;          ///< Buy depth order counts, CAPACITY per slot
+    Column<uint8_t> m_buyLevels;           ///< Buy depth level count
+    Column<double> m_sellPrice;            ///< Sell depth prices, CAPACITY per slot
+    Column<uint64_t> m_sellVolume;         ///< Sell depth quantities, CAPACITY per slot
+    Column<uint32_t> m_sellOrders;         ///< Sell depth order counts, CAPACITY per slot
+    Column<uint8_t> m_sellLevels;          ///< Sell depth level count
+    Column<uint8_t> m_quoted;              ///< Whether a quote has been stored
+    Column<int64_t> m_updatedAt;           ///< Last write, milliseconds since the epoch (0 = never)
+};
+
+}  // namespace BoxStrategy
@@ -0,0 +1,264 @@
+/**
+ * @file ReplayEngine.cpp
+ * @brief Implementation of the ReplayEngine class
+ */
+
+#include "../market/ReplayEngine.hpp"
+#include <algorithm>
+
+namespace BoxStrategy {
+
+ReplayEngine::ReplayEngine(std::shared_ptr<Logger> logger, double speed)
+    : m_logger(std::move(logger)),
+      m_speed(std::max(0.0, speed)) {}
+
+ReplayEngine::~ReplayEngine() {
+    stop();
+}
+
+bool ReplayEngine::load(const std::string& path) {
+    JournalReader reader;
+    if (!reader.open(path)) {
+        m_logger->error("Failed to open journal {}: {}", path, reader.lastError());
+        return false;
+    }
+
+    std::vector<JournalRecord> records;
+    std::vector<JournalRecord> tickRecords;
+    JournalRecord record;
+    int64_t firstTimestampUs = 0;
+    int64_t lastTimestampUs = 0;
+
+    while (reader.next(record)) {
+        if (records.empty() && tickRecords.empty()) {
+            firstTimestampUs = record.timestampUs;
+        }
+        lastTimestampUs = record.timestampUs;
+
+        if (record.kind == JournalRecordKind::TICKS) {
+            tickRecords.push_back(std::move(record));
+        } else {
+            records.push_back(std::move(record));
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::lock_guard<std::mutex> tickLock(m_tickMutex);
+
+    m_records = std::move(records);
+    m_tickRecords = std::move(tickRecords);
+    m_nextTick = 0;
+    m_byKey.clear();
+    m_byEndpoint.clear();
+
+    for (size_t i = 0; i < m_records.size(); ++i) {
+        const std::string& key = m_records[i].key;
+        m_byKey[key].records.push_back(i);
+        m_byEndpoint[key.substr(0, key.find('?'))].push_back(EndpointRecord{i, keyInstruments(key)});
+    }
+
+    m_firstTimestampUs = firstTimestampUs;
+    m_positionUs = firstTimestampUs;
+    m_wallStart = std::chrono::steady_clock::now();
+
+    m_logger->info("Loaded journal {}: {} responses under {} keys, {} tick messages, {:.1f} s of market data",
+                   path, m_records.size(), m_byKey.size(), m_tickRecords.size(),
+                   (lastTimestampUs - firstTimestampUs) / 1e6);
+    return true;
+}
+
+HttpResponse ReplayEngine::respond(const std::string& endpoint,
+                                   const std::unordered_map<std::string, std::string>& params) {
+    std::string key = MarketDataJournal::requestKey(endpoint, params);
+    size_t index = std::string::npos;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto it = m_byKey.find(key);
+        if (it != m_byKey.end()) {
+            // Once a key's records are used up its last response keeps being served
+            KeyRecords& keyRecords = it->second;
+            index = keyRecords.records[std::min(keyRecords.next, keyRecords.records.size() - 1)];
+            if (keyRecords.next < keyRecords.records.size()) {
+                keyRecords.next++;
+            }
+            m_exact++;
+        } else {
+            index = findCoveringRecord(endpoint, keyInstruments(key));
+            if (index != std::string::npos) {
+                m_fallback++;
+            }
+        }
+
+        if (index != std::string::npos) {
+            m_positionUs = std::max(m_positionUs, m_records[index].timestampUs);
+        }
+    }
+
+    if (index == std::string::npos) {
+        m_misses++;
+        m_logger->warn("No journal record for {}", key);
+        return HttpResponse{404, "Not in journal", {}};
+    }
+
+    const JournalRecord& record = m_records[index];
+    if (!waitUntil(record.timestampUs)) {
+        return HttpResponse{503, "Replay stopped", {}};
+    }
+
+    playTicksUntil(record.timestampUs);
+    m_served++;
+
+    return HttpResponse{200, record.payload, {}};
+}
+
+void ReplayEngine::startTicks(TickFeed::StoreProvider storeProvider) {
+    {
+        std::lock_guard<std::mutex> lock(m_tickMutex);
+        m_storeProvider = std::move(storeProvider);
+    }
+
+    if (m_speed > 0.0 && !m_tickThread.joinable()) {
+        m_stopping = false;
+        m_tickThread = std::thread(&ReplayEngine::runTicks, this);
+    }
+}
+
+void ReplayEngine::stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_stopMutex);
+        m_stopping = true;
+    }
+    m_stopCondition.notify_all();
+
+    if (m_tickThread.joinable()) {
+        m_tickThread.join();
+    }
+}
+
+ReplayStats ReplayEngine::getStats() const {
+    ReplayStats stats;
+    stats.served = m_served.load();
+    stats.exact = m_exact.load();
+    stats.fallback = m_fallback.load();
+    stats.misses = m_misses.load();
+    stats.tickMessages = m_tickMessages.load();
+    stats.ticksApplied = m_ticksApplied.load();
+    return stats;
+}
+
+std::vector<std::string> ReplayEngine::keyInstruments(const std::string& key) {
+    std::vector<std::string> instruments;
+
+    size_t start = key.find("?i=");
+    if (start == std::string::npos) {
+        start = key.find("&i=");
+    }
+    if (start == std::string::npos) {
+        return instruments;
+    }
+
+    // requestKey has already sorted the values
+    start += 3;
+    size_t end = std::min(key.find('&', start), key.size());
+
+    while (start < end) {
+        size_t comma = std::min(key.find(',', start), end);
+        instruments.push_back(key.substr(start, comma - start));
+        start = comma + 1;
+    }
+
+    return instruments;
+}
+
+size_t ReplayEngine::findCoveringRecord(const std::string& endpoint,
+                                        const std::vector<std::string>& instruments) const {
+    auto it = m_byEndpoint.find(endpoint);
+    if (it == m_byEndpoint.end() || instruments.empty()) {
+        return std::string::npos;
+    }
+
+    // The latest covering record at or before the replay position, else the first after it
+    size_t before = std::string::npos;
+    for (const auto& candidate : it->second) {
+        if (!std::includes(candidate.instruments.begin(), candidate.instruments.end(),
+                           instruments.begin(), instruments.end())) {
+            continue;
+        }
+
+        if (m_records[candidate.record].timestampUs > m_positionUs) {
+            return before != std::string::npos ? before : candidate.record;
+        }
+        before = candidate.record;
+    }
+
+    return before;
+}
+
+bool ReplayEngine::waitUntil(int64_t timestampUs) {
+    if (m_speed <= 0.0) {
+        return !m_stopping.load();
+    }
+
+    auto offset = std::chrono::microseconds(
+        static_cast<int64_t>((timestampUs - m_firstTimestampUs) / m_speed));
+    auto target = m_wallStart + offset;
+
+    std::unique_lock<std::mutex> lock(m_stopMutex);
+    return !m_stopCondition.wait_until(lock, target, [this]() { return m_stopping.load(); });
+}
+
+void ReplayEngine::playTicksUntil(int64_t timestampUs) {
+    std::lock_guard<std::mutex> lock(m_tickMutex);
+
+    if (!m_storeProvider) {
+        return;
+    }
+
+    uint64_t applied = 0;
+    uint64_t unknown = 0;
+
+    while (m_nextTick < m_tickRecords.size() && m_tickRecords[m_nextTick].timestampUs <= timestampUs) {
+        const std::string& message = m_tickRecords[m_nextTick++].payload;
+        m_tickMessages++;
+
+        // Heartbeats and malformed messages were journaled as received
+        m_tickBuffer.clear();
+        if (message.size() < 2 ||
+            !TickCodec::decodeMessage(reinterpret_cast<const uint8_t*>(message.data()), message.size(),
+                                      m_tickBuffer)) {
+            continue;
+        }
+
+        auto store = m_storeProvider();
+        if (store) {
+            TickFeed::applyTicks(*store, m_tickBuffer, applied, unknown);
+        }
+    }
+
+    m_ticksApplied += applied;
+}
+
+void ReplayEngine::runTicks() {
+    m_logger->info("Replaying {} tick messages at {}x", m_tickRecords.size(), m_speed);
+
+    while (!m_stopping.load()) {
+        int64_t timestampUs = 0;
+        {
+            std::lock_guard<std::mutex> lock(m_tickMutex);
+            if (m_nextTick >= m_tickRecords.size()) {
+                break;
+            }
+            timestampUs = m_tickRecords[m_nextTick].timestampUs;
+        }
+
+        if (!waitUntil(timestampUs)) {
+            break;
+        }
+        playTicksUntil(timestampUs);
+    }
+
+    m_logger->info("Tick replay finished after {} messages", m_tickMessages.load());
+}
+
+}  // namespace BoxStrategy
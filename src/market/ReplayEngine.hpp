@@ -0,0 +1,189 @@
+/**
+ * @file ReplayEngine.hpp
+ * @brief Serves recorded market data from a journal in place of the live API and ticker
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
+#include <unordered_map>
+#include <chrono>
+#include "../utils/Logger.hpp"
+#include "../utils/HttpClient.hpp"
+#include "../market/MarketDataJournal.hpp"
+#include "../market/TickFeed.hpp"
+
+namespace BoxStrategy {
+
+/**
+ * @struct ReplayStats
+ * @brief Counters of a replay since the journal was loaded
+ */
+struct ReplayStats {
+    uint64_t served = 0;          ///< Requests answered from the journal
+    uint64_t exact = 0;           ///< Requests matched by their exact key
+    uint64_t fallback = 0;        ///< Requests answered by a record covering more instruments
+    uint64_t misses = 0;          ///< Requests with no matching record
+    uint64_t tickMessages = 0;    ///< Tick messages played
+    uint64_t ticksApplied = 0;    ///< Ticks written into the quote store
+};
+
+/**
+ * @class ReplayEngine
+ * @brief Answers API requests and plays tick messages from a market data journal
+ *
+ * The journal is loaded into memory and indexed by request key. Each request
+ * is answered with the next unused record recorded under its key, so a run
+ * that issues the same requests as the recorded one sees the same responses
+ * in the same order; once a key's records are used up its last one is
+ * repeated. A request whose key was never recorded (e.g. a quote batch split
+ * differently) is answered by the record of the same endpoint closest to the
+ * replay position whose instruments include all of the requested ones.
+ *
+ * Replay time starts at the first record. With a speed above zero, a
+ * response or tick is released when the wall clock reaches its recorded
+ * offset divided by the speed (1 is real time, 10 is ten times faster).
+ * With speed zero nothing waits and ticks are played in step with the
+ * responses: before a response is returned, every tick recorded before it
+ * is applied, which keeps as-fast-as-possible runs deterministic.
+ */
+class ReplayEngine {
+public:
+    /**
+     * @brief Constructor
+     * @param logger Logger instance
+     * @param speed Replay speed; 0 replays as fast as possible
+     */
+    ReplayEngine(std::shared_ptr<Logger> logger, double speed);
+
+    /**
+     * @brief Destructor, stops the tick thread
+     */
+    ~ReplayEngine();
+
+    ReplayEngine(const ReplayEngine&) = delete;
+    ReplayEngine& operator=(const ReplayEngine&) = delete;
+
+    /**
+     * @brief Load and index a journal, resetting the replay clock
+     * @param path Journal file path
+     * @return True if the journal could be read
+     */
+    bool load(const std::string& path);
+
+    /**
+     * @brief Answer an API request from the journal
+     * @param endpoint API endpoint
+     * @param params Query parameters
+     * @return The recorded response, or status 404 if nothing matches
+     */
+    HttpResponse respond(const std::string& endpoint,
+                         const std::unordered_map<std::string, std::string>& params);
+
+    /**
+     * @brief Start playing the recorded tick messages into a quote store
+     * @param storeProvider Returns the current quote store
+     *
+     * With speed zero ticks are played by respond(); otherwise a thread
+     * plays them on the replay clock.
+     */
+    void startTicks(TickFeed::StoreProvider storeProvider);
+
+    /**
+     * @brief Stop the tick thread
+     */
+    void stop();
+
+    /**
+     * @brief Get the replay speed
+     * @return Speed, 0 for as fast as possible
+     */
+    double getSpeed() const { return m_speed; }
+
+    /**
+     * @brief Get the replay counters
+     * @return Counters
+     */
+    ReplayStats getStats() const;
+
+private:
+    /**
+     * @brief Records of one request key
+     */
+    struct KeyRecords {
+        std::vector<size_t> records;                 ///< Indices into m_records, in time order
+        size_t next = 0;                             ///< Next record to serve
+    };
+
+    /**
+     * @brief Record of one endpoint with the instruments it covers
+     */
+    struct EndpointRecord {
+        size_t record = 0;                           ///< Index into m_records
+        std::vector<std::string> instruments;        ///< Sorted values of the "i" parameter
+    };
+
+    /**
+     * @brief Split the sorted "i" values out of a request key
+     */
+    static std::vector<std::string> keyInstruments(const std::string& key);
+
+    /**
+     * @brief Find the fallback record for a request that has no exact match
+     * @return Index into m_records, or npos
+     */
+    size_t findCoveringRecord(const std::string& endpoint, const std::vector<std::string>& instruments) const;
+
+    /**
+     * @brief Block until the replay clock reaches a recorded time
+     * @return False if stopped while waiting
+     */
+    bool waitUntil(int64_t timestampUs);
+
+    /**
+     * @brief Apply every tick message recorded up to a time
+     */
+    void playTicksUntil(int64_t timestampUs);
+
+    /**
+     * @brief Tick thread body for paced replays
+     */
+    void runTicks();
+
+    std::shared_ptr<Logger> m_logger;                                ///< Logger instance
+    double m_speed;                                                  ///< Replay speed, 0 for unpaced
+
+    std::vector<JournalRecord> m_records;                            ///< API response records
+    std::unordered_map<std::string, KeyRecords> m_byKey;             ///< Records by request key
+    std::unordered_map<std::string, std::vector<EndpointRecord>> m_byEndpoint; ///< Records by endpoint
+    int64_t m_firstTimestampUs = 0;                                  ///< Start of replay time
+    int64_t m_positionUs = 0;                                        ///< Latest record time served
+    std::chrono::steady_clock::time_point m_wallStart;               ///< Wall time replay started
+    mutable std::mutex m_mutex;                                      ///< Guards the request indexes
+
+    std::vector<JournalRecord> m_tickRecords;                        ///< Tick message records
+    size_t m_nextTick = 0;                                           ///< Next tick message to play
+    TickFeed::StoreProvider m_storeProvider;                         ///< Quote store ticks go into
+    std::vector<Tick> m_tickBuffer;                                  ///< Decoded ticks, reused
+    std::mutex m_tickMutex;                                          ///< Guards tick playback
+
+    std::thread m_tickThread;                                        ///< Paced tick player
+    std::atomic<bool> m_stopping{false};                             ///< Set to abandon waits
+    std::mutex m_stopMutex;                                          ///< Guards the paced waits
+    std::condition_variable m_stopCondition;                         ///< Wakes paced waits on stop
+
+    std::atomic<uint64_t> m_served{0};                               ///< Requests answered
+    std::atomic<uint64_t> m_exact{0};                                ///< Exact key matches
+    std::atomic<uint64_t> m_fallback{0};                             ///< Covering record matches
+    std::atomic<uint64_t> m_misses{0};                               ///< Unanswered requests
+    std::atomic<uint64_t> m_tickMessages{0};                         ///< Tick messages played
+    std::atomic<uint64_t> m_ticksApplied{0};                         ///< Ticks written into the store
+};
+
+}  // namespace BoxStrategy
@@ -0,0 +1,274 @@
+/**
+ * @file TickCodec.cpp
+ * @brief Implementation of the TickCodec class
+ */
+
+#include "../market/TickCodec.hpp"
+#include <cmath>
+
+namespace BoxStrategy {
+
+namespace {
+
+// Segments encoded in the low byte of an instrument token
+constexpr uint64_t SEGMENT_CDS = 3;
+constexpr uint64_t SEGMENT_BCD = 6;
+constexpr uint64_t SEGMENT_INDICES = 9;
+
+constexpr size_t DEPTH_OFFSET = 64;      ///< First depth entry in a full packet
+constexpr size_t DEPTH_ENTRY_SIZE = 12;  ///< Quantity, price, orders and padding
+
+uint16_t readUint16(const uint8_t* p) {
+    return static_cast<uint16_t>((p[0] << 8) | p[1]);
+}
+
+uint32_t readUint32(const uint8_t* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+}
+
+int32_t readInt32(const uint8_t* p) {
+    return static_cast<int32_t>(readUint32(p));
+}
+
+void writeUint16(std::vector<uint8_t>& out, uint16_t value) {
+    out.push_back(static_cast<uint8_t>(value >> 8));
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+void writeUint32(std::vector<uint8_t>& out, uint32_t value) {
+    out.push_back(static_cast<uint8_t>(value >> 24));
+    out.push_back(static_cast<uint8_t>(value >> 16));
+    out.push_back(static_cast<uint8_t>(value >> 8));
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+void writePrice(std::vector<uint8_t>& out, double price, double divisor) {
+    writeUint32(out, static_cast<uint32_t>(static_cast<int32_t>(std::llround(price * divisor))));
+}
+
+}  // namespace
+
+bool TickCodec::decodeMessage(const uint8_t* data, size_t size, std::vector<Tick>& ticks) {
+    if (size < 2) {
+        return false;
+    }
+
+    size_t packetCount = readUint16(data);
+    size_t pos = 2;
+
+    ticks.reserve(ticks.size() + packetCount);
+
+    for (size_t i = 0; i < packetCount; ++i) {
+        if (pos + 2 > size) {
+            return false;
+        }
+
+        size_t packetSize = readUint16(data + pos);
+        pos += 2;
+
+        if (pos + packetSize > size) {
+            return false;
+        }
+
+        Tick tick;
+        if (!decodePacket(data + pos, packetSize, tick)) {
+            return false;
+        }
+
+        ticks.push_back(tick);
+        pos += packetSize;
+    }
+
+    return true;
+}
+
+bool TickCodec::decodePacket(const uint8_t* data, size_t size, Tick& tick) {
+    if (size < LTP_PACKET_SIZE) {
+        return false;
+    }
+
+    tick.instrumentToken = readUint32(data);
+    const double divisor = priceDivisor(tick.instrumentToken);
+    auto price = [data, divisor](size_t offset) {
+        return readInt32(data + offset) / divisor;
+    };
+
+    QuoteModel& quote = tick.quote;
+    quote.lastPrice = price(4);
+
+    switch (size) {
+        case LTP_PACKET_SIZE:
+            tick.mode = TickMode::LTP;
+            tick.tradable = !isIndexToken(tick.instrumentToken);
+            return true;
+
+        case INDEX_QUOTE_PACKET_SIZE:
+        case INDEX_FULL_PACKET_SIZE:
+            tick.mode = size == INDEX_FULL_PACKET_SIZE ? TickMode::FULL : TickMode::QUOTE;
+            tick.tradable = false;
+            quote.highPrice = price(8);
+            quote.lowPrice = price(12);
+            quote.openPrice = price(16);
+            quote.closePrice = price(20);
+            // Bytes 24-27 hold the price change, which is derived from close and LTP
+            if (size == INDEX_FULL_PACKET_SIZE) {
+                tick.exchangeTimestamp = readInt32(data + 28);
+            }
+            return true;
+
+        case QUOTE_PACKET_SIZE:
+        case FULL_PACKET_SIZE:
+            break;
+
+        default:
+            return false;
+    }
+
+    tick.mode = size == FULL_PACKET_SIZE ? TickMode::FULL : TickMode::QUOTE;
+    tick.tradable = true;
+    tick.lastTradedQuantity = readUint32(data + 8);
+    quote.averagePrice = price(12);
+    quote.volume = readUint32(data + 16);
+    quote.buyQuantity = readUint32(data + 20);
+    quote.sellQuantity = readUint32(data + 24);
+    quote.openPrice = price(28);
+    quote.highPrice = price(32);
+    quote.lowPrice = price(36);
+    quote.closePrice = price(40);
+
+    if (size == FULL_PACKET_SIZE) {
+        tick.lastTradeTime = readInt32(data + 44);
+        quote.openInterest = readUint32(data + 48);
+        // Bytes 52-59 hold the day's OI high/low, which the quote model does not keep
+        tick.exchangeTimestamp = readInt32(data + 60);
+
+        quote.buyDepth.clear();
+        quote.sellDepth.clear();
+
+        for (size_t level = 0; level < 2 * DepthLadder::CAPACITY; ++level) {
+            const uint8_t* entry = data + DEPTH_OFFSET + level * DEPTH_ENTRY_SIZE;
+
+            DepthItem item;
+            item.quantity = readUint32(entry);
+            item.price = readInt32(entry + 4) / divisor;
+            item.orders = readUint16(entry + 8);
+
+            if (level < DepthLadder::CAPACITY) {
+                quote.buyDepth.push_back(item);
+            } else {
+                quote.sellDepth.push_back(item);
+            }
+        }
+    }
+
+    return true;
+}
+
+void TickCodec::encodePacket(const Tick& tick, std::vector<uint8_t>& out) {
+    const double divisor = priceDivisor(tick.instrumentToken);
+    const QuoteModel& quote = tick.quote;
+
+    writeUint32(out, static_cast<uint32_t>(tick.instrumentToken));
+    writePrice(out, quote.lastPrice, divisor);
+
+    if (tick.mode == TickMode::LTP) {
+        return;
+    }
+
+    if (isIndexToken(tick.instrumentToken)) {
+        writePrice(out, quote.highPrice, divisor);
+        writePrice(out, quote.lowPrice, divisor);
+        writePrice(out, quote.openPrice, divisor);
+        writePrice(out, quote.closePrice, divisor);
+        writePrice(out, quote.lastPrice - quote.closePrice, divisor);
+        if (tick.mode == TickMode::FULL) {
+            writeUint32(out, static_cast<uint32_t>(tick.exchangeTimestamp));
+        }
+        return;
+    }
+
+    writeUint32(out, tick.lastTradedQuantity);
+    writePrice(out, quote.averagePrice, divisor);
+    writeUint32(out, static_cast<uint32_t>(quote.volume));
+    writeUint32(out, static_cast<uint32_t>(quote.buyQuantity));
+    writeUint32(out, static_cast<uint32_t>(quote.sellQuantity));
+    writePrice(out, quote.openPrice, divisor);
+    writePrice(out, quote.highPrice, divisor);
+    writePrice(out, quote.lowPrice, divisor);
+    writePrice(out, quote.closePrice, divisor);
+
+    if (tick.mode != TickMode::FULL) {
+        return;
+    }
+
+    writeUint32(out, static_cast<uint32_t>(tick.lastTradeTime));
+    writeUint32(out, static_cast<uint32_t>(quote.openInterest));
+    writeUint32(out, static_cast<uint32_t>(quote.openInterest));  // OI day high
+    writeUint32(out, static_cast<uint32_t>(quote.openInterest));  // OI day low
+    writeUint32(out, static_cast<uint32_t>(tick.exchangeTimestamp));
+
+    auto writeSide = [&out, divisor](const DepthLadder& depth) {
+        for (size_t level = 0; level < DepthLadder::CAPACITY; ++level) {
+            DepthItem item = level < depth.size() ? depth[level] : DepthItem{0.0, 0, 0};
+            writeUint32(out, static_cast<uint32_t>(item.quantity));
+            writePrice(out, item.price, divisor);
+            writeUint16(out, static_cast<uint16_t>(item.orders));
+            writeUint16(out, 0);
+        }
+    };
+
+    writeSide(quote.buyDepth);
+    writeSide(quote.sellDepth);
+}
+
+void TickCodec::encodeMessage(const std::vector<Tick>& ticks, std::vector<uint8_t>& out) {
+    writeUint16(out, static_cast<uint16_t>(ticks.size()));
+
+    for (const auto& tick : ticks) {
+        // Reserve the length prefix and patch it once the packet is written
+        size_t lengthPos = out.size();
+        writeUint16(out, 0);
+        encodePacket(tick, out);
+
+        uint16_t packetSize = static_cast<uint16_t>(out.size() - lengthPos - 2);
+        out[lengthPos] = static_cast<uint8_t>(packetSize >> 8);
+        out[lengthPos + 1] = static_cast<uint8_t>(packetSize);
+    }
+}
+
+bool TickCodec::isIndexToken(uint64_t instrumentToken) {
+    return (instrumentToken & 0xFF) == SEGMENT_INDICES;
+}
+
+double TickCodec::priceDivisor(uint64_t instrumentToken) {
+    switch (instrumentToken & 0xFF) {
+        case SEGMENT_CDS: return 10000000.0;
+        case SEGMENT_BCD: return 10000.0;
+        default:          return 100.0;
+    }
+}
+
+const char* TickCodec::modeToString(TickMode mode) {
+    switch (mode) {
+        case TickMode::LTP:   return "ltp";
+        case TickMode::QUOTE: return "quote";
+        case TickMode::FULL:  return "full";
+        default:              return "ltp";
+    }
+}
+
+bool TickCodec::stringToMode(std::string_view name, TickMode& mode) {
+    if (name == "ltp") {
+        mode = TickMode::LTP;
+    } else if (name == "quote") {
+        mode = TickMode::QUOTE;
+    } else if (name == "full") {
+        mode = TickMode::FULL;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+}  // namespace BoxStrategy
@@ -0,0 +1,124 @@
+/**
+ * @file TickCodec.hpp
+ * @brief Encoder/decoder for Kite ticker binary packets
+ */
+
+#pragma once
+
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "../models/InstrumentModel.hpp"
+
+namespace BoxStrategy {
+
+/**
+ * @enum TickMode
+ * @brief Streaming modes, in increasing order of detail
+ */
+enum class TickMode {
+    LTP,      ///< Last traded price only
+    QUOTE,    ///< Prices, volume and OHLC without depth
+    FULL      ///< Everything including open interest and five-level depth
+};
+
+/**
+ * @struct Tick
+ * @brief One decoded tick packet
+ */
+struct Tick {
+    uint64_t instrumentToken = 0;        ///< Instrument token
+    TickMode mode = TickMode::LTP;       ///< Mode the packet was sent in
+    bool tradable = true;                ///< False for index packets
+    uint32_t lastTradedQuantity = 0;     ///< Quantity of the last trade
+    int64_t lastTradeTime = 0;           ///< Last trade time (epoch seconds, full mode)
+    int64_t exchangeTimestamp = 0;       ///< Exchange timestamp (epoch seconds, full mode)
+    QuoteModel quote;                    ///< Quote fields carried by the packet
+};
+
+/**
+ * @class TickCodec
+ * @brief Converts between Tick and the Kite ticker binary format
+ *
+ * A message starts with a big-endian 16-bit packet count; each packet is
+ * prefixed with its 16-bit length. All packet fields are big-endian 32-bit
+ * integers and prices are in paise (or the segment's smallest unit). The
+ * packet length identifies the mode:
+ * - 8 bytes:   LTP
+ * - 28 bytes:  index quote
+ * - 32 bytes:  index full
+ * - 44 bytes:  quote
+ * - 184 bytes: full, with five buy and five sell depth entries
+ */
+class TickCodec {
+public:
+    static constexpr size_t LTP_PACKET_SIZE = 8;           ///< LTP packet
+    static constexpr size_t INDEX_QUOTE_PACKET_SIZE = 28;  ///< Index quote packet
+    static constexpr size_t INDEX_FULL_PACKET_SIZE = 32;   ///< Index full packet
+    static constexpr size_t QUOTE_PACKET_SIZE = 44;        ///< Quote packet
+    static constexpr size_t FULL_PACKET_SIZE = 184;        ///< Full packet
+
+    /**
+     * @brief Decode a binary message into ticks
+     * @param data Message bytes
+     * @param size Message size
+     * @param ticks Output ticks, appended to
+     * @return False if the message is truncated or a packet has an unknown length
+     */
+    static bool decodeMessage(const uint8_t* data, size_t size, std::vector<Tick>& ticks);
+
+    /**
+     * @brief Decode a single packet
+     * @param data Packet bytes (without the length prefix)
+     * @param size Packet size
+     * @param tick Output tick
+     * @return False if the size is not a known packet size
+     */
+    static bool decodePacket(const uint8_t* data, size_t size, Tick& tick);
+
+    /**
+     * @brief Encode a single packet in the tick's mode, without the length prefix
+     * @param tick Tick to encode
+     * @param out Output buffer, appended to
+     */
+    static void encodePacket(const Tick& tick, std::vector<uint8_t>& out);
+
+    /**
+     * @brief Encode a message holding the given ticks
+     * @param ticks Ticks to encode
+     * @param out Output buffer, appended to
+     */
+    static void encodeMessage(const std::vector<Tick>& ticks, std::vector<uint8_t>& out);
+
+    /**
+     * @brief Check if a token belongs to the indices segment
+     * @param instrumentToken Instrument token
+     * @return True for index tokens
+     */
+    static bool isIndexToken(uint64_t instrumentToken);
+
+    /**
+     * @brief Get the divisor converting wire prices of a token to rupees
+     * @param instrumentToken Instrument token
+     * @return Price divisor
+     */
+    static double priceDivisor(uint64_t instrumentToken);
+
+    /**
+     * @brief Convert a mode to its ticker protocol name
+     * @param mode Tick mode
+     * @return "ltp", "quote" or "full"
+     */
+    static const char* modeToString(TickMode mode);
+
+    /**
+     * @brief Convert a ticker protocol name to a mode
+     * @param name Mode name
+     * @param mode Output mode
+     * @return False if the name is unknown
+     */
+    static bool stringToMode(std::string_view name, TickMode& mode);
+};
+
+}  // namespace BoxStrategy
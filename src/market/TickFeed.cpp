@@ -0,0 +1,278 @@
+/**
+ * @file TickFeed.cpp
+ * @brief Implementation of the TickFeed class
+ */
+
+#include "../market/TickFeed.hpp"
+#include "../external/json.hpp"
+#include "../utils/ThreadTopology.hpp"
+
+using json = nlohmann::json;
+
+namespace BoxStrategy {
+
+TickFeed::TickFeed(
+    std::shared_ptr<Logger> logger,
+    StoreProvider storeProvider,
+    const std::string& host,
+    uint16_t port,
+    std::chrono::milliseconds reconnectDelay
+) : m_logger(logger),
+    m_storeProvider(std::move(storeProvider)),
+    m_host(host),
+    m_port(port),
+    m_reconnectDelay(reconnectDelay) {
+}
+
+TickFeed::~TickFeed() {
+    stop();
+}
+
+void TickFeed::start() {
+    if (m_running.exchange(true)) {
+        return;
+    }
+
+    m_logger->info("Starting tick feed for {}:{}", m_host, m_port);
+    m_thread = std::thread(&TickFeed::run, this);
+}
+
+void TickFeed::stop() {
+    if (!m_running.exchange(false)) {
+        return;
+    }
+
+    {
+        // Wake the reconnect wait and unblock a pending receive
+        std::lock_guard<std::mutex> stopLock(m_stopMutex);
+        std::lock_guard<std::mutex> sendLock(m_sendMutex);
+        m_socket.shutdown();
+    }
+    m_stopCondition.notify_all();
+
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+
+    m_logger->info("Tick feed stopped");
+}
+
+void TickFeed::subscribe(const std::vector<uint64_t>& tokens, TickMode mode) {
+    std::vector<uint64_t> changed;
+    {
+        std::lock_guard<std::mutex> lock(m_subscriptionMutex);
+        changed.reserve(tokens.size());
+
+        for (uint64_t token : tokens) {
+            auto result = m_subscriptions.emplace(token, mode);
+            if (result.second || result.first->second != mode) {
+                result.first->second = mode;
+                changed.push_back(token);
+            }
+        }
+    }
+
+    if (changed.empty()) {
+        return;
+    }
+
+    m_logger->debug("Subscribing {} instruments in {} mode", changed.size(), TickCodec::modeToString(mode));
+
+    // Sent now if connected, otherwise on the next connect
+    std::lock_guard<std::mutex> lock(m_sendMutex);
+    if (m_connected.load() && !sendSubscribe(changed, mode)) {
+        m_logger->warn("Failed to send subscription for {} instruments", changed.size());
+    }
+}
+
+void TickFeed::unsubscribe(const std::vector<uint64_t>& tokens) {
+    std::vector<uint64_t> removed;
+    {
+        std::lock_guard<std::mutex> lock(m_subscriptionMutex);
+        removed.reserve(tokens.size());
+
+        for (uint64_t token : tokens) {
+            if (m_subscriptions.erase(token) > 0) {
+                removed.push_back(token);
+            }
+        }
+    }
+
+    if (removed.empty()) {
+        return;
+    }
+
+    m_logger->debug("Unsubscribing {} instruments", removed.size());
+
+    std::lock_guard<std::mutex> lock(m_sendMutex);
+    if (m_connected.load()) {
+        json message = {{"a", "unsubscribe"}, {"v", removed}};
+        m_socket.sendText(message.dump());
+    }
+}
+
+bool TickFeed::isSubscribed(uint64_t token, TickMode mode) const {
+    std::lock_guard<std::mutex> lock(m_subscriptionMutex);
+    auto it = m_subscriptions.find(token);
+    return it != m_subscriptions.end() && it->second >= mode;
+}
+
+size_t TickFeed::getSubscriptionCount() const {
+    std::lock_guard<std::mutex> lock(m_subscriptionMutex);
+    return m_subscriptions.size();
+}
+
+TickFeedStats TickFeed::getStats() const {
+    TickFeedStats stats;
+    stats.messages = m_messages.load();
+    stats.ticks = m_ticks.load();
+    stats.applied = m_applied.load();
+    stats.unknownTokens = m_unknownTokens.load();
+    stats.decodeErrors = m_decodeErrors.load();
+    stats.connects = m_connects.load();
+    return stats;
+}
+
+void TickFeed::run() {
+    if (!m_threadCpus.empty() && !ThreadTopology::pinCurrentThread(m_threadCpus)) {
+        m_logger->warn("Failed to pin the tick feed thread to CPUs {}", ThreadTopology::formatCpuList(m_threadCpus));
+    }
+
+    std::vector<uint8_t> payload;
+
+    while (m_running.load()) {
+        std::string error;
+        bool connected = false;
+        {
+            std::lock_guard<std::mutex> lock(m_sendMutex);
+            connected = m_running.load() && m_socket.connect(m_host, m_port, error);
+
+            if (connected) {
+                m_connected = true;
+                m_connects++;
+                m_logger->info("Tick feed connected to {}:{}", m_host, m_port);
+
+                if (!resubscribeAll()) {
+                    m_logger->warn("Failed to resend subscriptions");
+                }
+            }
+        }
+
+        if (connected) {
+            FramedSocket::FrameType type;
+            while (m_running.load() && m_socket.receiveFrame(type, payload)) {
+                if (type == FramedSocket::FrameType::BINARY) {
+                    applyMessage(payload);
+                } else {
+                    // Text frames carry errors and notices from the ticker
+                    m_logger->warn("Tick feed message: {}", std::string(payload.begin(), payload.end()));
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(m_sendMutex);
+            m_connected = false;
+            m_socket.close();
+
+            if (m_running.load()) {
+                m_logger->warn("Tick feed disconnected from {}:{}", m_host, m_port);
+            }
+        } else if (m_running.load()) {
+            m_logger->warn("Tick feed failed to connect to {}:{}: {}", m_host, m_port, error);
+        }
+
+        std::unique_lock<std::mutex> lock(m_stopMutex);
+        m_stopCondition.wait_for(lock, m_reconnectDelay, [this]() { return !m_running.load(); });
+    }
+}
+
+bool TickFeed::sendSubscribe(const std::vector<uint64_t>& tokens, TickMode mode) {
+    json subscribe = {{"a", "subscribe"}, {"v", tokens}};
+    json setMode = {{"a", "mode"}, {"v", json::array({TickCodec::modeToString(mode), tokens})}};
+
+    return m_socket.sendText(subscribe.dump()) && m_socket.sendText(setMode.dump());
+}
+
+bool TickFeed::resubscribeAll() {
+    std::vector<uint64_t> byMode[3];
+    {
+        std::lock_guard<std::mutex> lock(m_subscriptionMutex);
+        for (const auto& [token, mode] : m_subscriptions) {
+            byMode[static_cast<size_t>(mode)].push_back(token);
+        }
+    }
+
+    for (size_t i = 0; i < 3; ++i) {
+        if (!byMode[i].empty() && !sendSubscribe(byMode[i], static_cast<TickMode>(i))) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void TickFeed::applyMessage(const std::vector<uint8_t>& message) {
+    m_messages++;
+
+    if (m_messageObserver) {
+        m_messageObserver(message.data(), message.size());
+    }
+
+    // A one-byte message is the ticker's heartbeat
+    if (message.size() < 2) {
+        return;
+    }
+
+    m_tickBuffer.clear();
+    if (!TickCodec::decodeMessage(message.data(), message.size(), m_tickBuffer)) {
+        m_decodeErrors++;
+        m_logger->warn("Dropping malformed tick message of {} bytes", message.size());
+        return;
+    }
+
+    m_ticks += m_tickBuffer.size();
+
+    auto store = m_storeProvider();
+    if (!store) {
+        return;
+    }
+
+    uint64_t applied = 0;
+    uint64_t unknown = 0;
+    applyTicks(*store, m_tickBuffer, applied, unknown);
+
+    m_applied += applied;
+    m_unknownTokens += unknown;
+}
+
+void TickFeed::applyTicks(QuoteStore& store, const std::vector<Tick>& ticks,
+                          uint64_t& applied, uint64_t& unknown) {
+    const auto& universe = store.getUniverse();
+
+    for (const Tick& tick : ticks) {
+        uint32_t ordinal = 0;
+        if (!universe->findOrdinal(tick.instrumentToken, ordinal)) {
+            unknown++;
+            continue;
+        }
+
+        switch (tick.mode) {
+            case TickMode::LTP:
+                store.updateLastPrice(ordinal, tick.quote.lastPrice);
+                break;
+            case TickMode::QUOTE:
+                store.updateQuote(ordinal, tick.quote);
+                break;
+            case TickMode::FULL:
+                // Full index packets carry no depth, so only tradable packets replace it
+                if (tick.tradable) {
+                    store.update(ordinal, tick.quote);
+                } else {
+                    store.updateQuote(ordinal, tick.quote);
+                }
+                break;
+        }
+        applied++;
+    }
+}
+
+}  // namespace BoxStrategy
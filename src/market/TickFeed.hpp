@@ -0,0 +1,210 @@
+/**
+ * @file TickFeed.hpp
+ * @brief Streaming tick client writing into the quote store
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
+#include <functional>
+#include <unordered_map>
+#include <chrono>
+#include "../utils/Logger.hpp"
+#include "../utils/FramedSocket.hpp"
+#include "../market/TickCodec.hpp"
+#include "../market/QuoteStore.hpp"
+
+namespace BoxStrategy {
+
+/**
+ * @struct TickFeedStats
+ * @brief Counters of a tick feed since it was created
+ */
+struct TickFeedStats {
+    uint64_t messages = 0;        ///< Binary messages received
+    uint64_t ticks = 0;           ///< Packets decoded
+    uint64_t applied = 0;         ///< Ticks written into the quote store
+    uint64_t unknownTokens = 0;   ///< Ticks for tokens missing from the universe
+    uint64_t decodeErrors = 0;    ///< Malformed messages
+    uint64_t connects = 0;        ///< Successful connections
+};
+
+/**
+ * @class TickFeed
+ * @brief Subscribes to instruments on a ticker server and applies their ticks
+ *
+ * A reader thread keeps a connection to the ticker, decodes the binary
+ * tick messages and writes each tick into the current quote store. Control
+ * messages use the Kite ticker JSON protocol ({"a": "subscribe" | "unsubscribe"
+ * | "mode", "v": ...}). Subscriptions are remembered per token and replayed
+ * after every reconnect.
+ */
+class TickFeed {
+public:
+    /**
+     * @brief Supplies the quote store ticks are written into
+     */
+    using StoreProvider = std::function<std::shared_ptr<QuoteStore>()>;
+
+    /**
+     * @brief Receives every binary message before it is decoded
+     */
+    using MessageObserver = std::function<void(const uint8_t* data, size_t size)>;
+
+    /**
+     * @brief Constructor
+     * @param logger Logger instance
+     * @param storeProvider Returns the current quote store
+     * @param host Ticker host
+     * @param port Ticker port
+     * @param reconnectDelay Wait between connection attempts
+     */
+    TickFeed(
+        std::shared_ptr<Logger> logger,
+        StoreProvider storeProvider,
+        const std::string& host,
+        uint16_t port,
+        std::chrono::milliseconds reconnectDelay
+    );
+
+    /**
+     * @brief Destructor, stops the reader thread
+     */
+    ~TickFeed();
+
+    TickFeed(const TickFeed&) = delete;
+    TickFeed& operator=(const TickFeed&) = delete;
+
+    /**
+     * @brief Start the reader thread
+     */
+    void start();
+
+    /**
+     * @brief Stop the reader thread and disconnect
+     */
+    void stop();
+
+    /**
+     * @brief Check if the feed is connected to the ticker
+     * @return True if connected
+     */
+    bool isConnected() const { return m_connected.load(); }
+
+    /**
+     * @brief Subscribe to instruments in a mode
+     * @param tokens Instrument tokens
+     * @param mode Tick mode
+     *
+     * Tokens already subscribed in the same mode are not sent again.
+     */
+    void subscribe(const std::vector<uint64_t>& tokens, TickMode mode);
+
+    /**
+     * @brief Unsubscribe from instruments
+     * @param tokens Instrument tokens
+     */
+    void unsubscribe(const std::vector<uint64_t>& tokens);
+
+    /**
+     * @brief Check if a token is subscribed in at least the given mode
+     * @param token Instrument token
+     * @param mode Minimum mode
+     * @return True if subscribed
+     */
+    bool isSubscribed(uint64_t token, TickMode mode) const;
+
+    /**
+     * @brief Get the number of subscribed tokens
+     * @return Subscription count
+     */
+    size_t getSubscriptionCount() const;
+
+    /**
+     * @brief Get the feed counters
+     * @return Counters
+     */
+    TickFeedStats getStats() const;
+
+    /**
+     * @brief Set a callback that sees each binary message, e.g. to journal it
+     * @param observer Callback run on the reader thread; must be set before start()
+     */
+    void setMessageObserver(MessageObserver observer) { m_messageObserver = std::move(observer); }
+
+    /**
+     * @brief Pin the reader thread to some CPUs
+     * @param cpus Allowed CPUs, empty to leave the thread unpinned; must be set before start()
+     */
+    void setThreadCpus(std::vector<int> cpus) { m_threadCpus = std::move(cpus); }
+
+    /**
+     * @brief Write decoded ticks into a quote store
+     * @param store Quote store
+     * @param ticks Decoded ticks
+     * @param applied Incremented per tick written
+     * @param unknown Incremented per tick for a token missing from the store's universe
+     */
+    static void applyTicks(QuoteStore& store, const std::vector<Tick>& ticks,
+                           uint64_t& applied, uint64_t& unknown);
+
+private:
+    /**
+     * @brief Reader thread body: connect, resubscribe, read until disconnected
+     */
+    void run();
+
+    /**
+     * @brief Send the subscribe and mode messages for a set of tokens
+     * @return False if sending failed
+     */
+    bool sendSubscribe(const std::vector<uint64_t>& tokens, TickMode mode);
+
+    /**
+     * @brief Resend every remembered subscription after a connect
+     * @return False if sending failed
+     */
+    bool resubscribeAll();
+
+    /**
+     * @brief Decode a binary message and write its ticks into the quote store
+     */
+    void applyMessage(const std::vector<uint8_t>& message);
+
+    std::shared_ptr<Logger> m_logger;                      ///< Logger instance
+    StoreProvider m_storeProvider;                         ///< Current quote store
+    std::string m_host;                                    ///< Ticker host
+    uint16_t m_port;                                       ///< Ticker port
+    std::chrono::milliseconds m_reconnectDelay;            ///< Wait between connection attempts
+    MessageObserver m_messageObserver;                     ///< Sees every binary message
+    std::vector<int> m_threadCpus;                         ///< CPUs the reader thread is pinned to, if any
+
+    FramedSocket m_socket;                                 ///< Connection to the ticker
+    std::mutex m_sendMutex;                                ///< Serializes writes to the socket
+
+    std::unordered_map<uint64_t, TickMode> m_subscriptions; ///< Subscribed tokens and their modes
+    mutable std::mutex m_subscriptionMutex;                ///< Guards m_subscriptions
+
+    std::thread m_thread;                                  ///< Reader thread
+    std::atomic<bool> m_running{false};                    ///< Whether the reader should keep running
+    std::atomic<bool> m_connected{false};                  ///< Whether the socket is connected
+    std::mutex m_stopMutex;                                ///< Guards the stop wait
+    std::condition_variable m_stopCondition;               ///< Wakes the reconnect wait on stop
+
+    std::vector<Tick> m_tickBuffer;                        ///< Decoded ticks, reused by the reader
+
+    std::atomic<uint64_t> m_messages{0};                   ///< Binary messages received
+    std::atomic<uint64_t> m_ticks{0};                      ///< Packets decoded
+    std::atomic<uint64_t> m_applied{0};                    ///< Ticks written into the store
+    std::atomic<uint64_t> m_unknownTokens{0};              ///< Ticks for unknown tokens
+    std::atomic<uint64_t> m_decodeErrors{0};               ///< Malformed messages
+    std::atomic<uint64_t> m_connects{0};                   ///< Successful connections
+};
+
+}  // namespace BoxStrategy
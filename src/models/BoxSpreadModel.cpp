@@ -58,14 +58,20 @@ double BoxSpreadModel::calculateTheoreticalValue() const {
 }
 
 double BoxSpreadModel::calculateNetPremium() const {
+    return netPremiumFromPrices(longCallLower.lastPrice, shortCallHigher.lastPrice,
+                                longPutHigher.lastPrice, shortPutLower.lastPrice);
+}
+
+double BoxSpreadModel::netPremiumFromPrices(double longCallLower, double shortCallHigher,
+                                            double longPutHigher, double shortPutLower) {
     // Net premium is the sum of all the premiums paid and received
     // Long positions are paid (negative cash flow)
     // Short positions are received (positive cash flow)
     
-    double longCallPremium = -longCallLower.lastPrice;
-    double shortCallPremium = shortCallHigher.lastPrice;
-    double longPutPremium = -longPutHigher.lastPrice;
-    double shortPutPremium = shortPutLower.lastPrice;
+    double longCallPremium = -longCallLower;
+    double shortCallPremium = shortCallHigher;
+    double longPutPremium = -longPutHigher;
+    double shortPutPremium = shortPutLower;
     
     return longCallPremium + shortCallPremium + longPutPremium + shortPutPremium;
 }
@@ -84,6 +84,17 @@ struct BoxSpreadModel {
      */
     double calculateNetPremium() const;
     
+    /**
+     * @brief Calculate the net premium from the prices of the four legs
+     * @param longCallLower Price of the call at the lower strike
+     * @param shortCallHigher Price of the call at the higher strike
+     * @param longPutHigher Price of the put at the higher strike
+     * @param shortPutLower Price of the put at the lower strike
+     * @return Net premium of the box spread
+     */
+    static double netPremiumFromPrices(double longCallLower, double shortCallHigher,
+                                       double longPutHigher, double shortPutLower);
+    
     /**
      * @brief Calculate the profit/loss at expiry
      * @return Profit/loss at expiry
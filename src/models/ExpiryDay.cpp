@@ -0,0 +1,141 @@
+/**
+ * @file ExpiryDay.cpp
+ * @brief Implementation of the ExpiryDay class
+ */
+
+#include "../models/ExpiryDay.hpp"
+#include <array>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ctime>
+
+namespace BoxStrategy {
+
+namespace {
+
+/**
+ * @brief Cached conversions of one day
+ */
+struct DayEntry {
+    std::chrono::system_clock::time_point timePoint;  ///< Local midnight
+    std::string text;                                 ///< YYYY-MM-DD
+};
+
+/**
+ * @brief Days since 1970-01-01 of a proleptic Gregorian date
+ */
+int32_t daysFromCivil(int year, unsigned month, unsigned day) {
+    year -= month <= 2;
+    const int era = (year >= 0 ? year : year - 399) / 400;
+    const unsigned yearOfEra = static_cast<unsigned>(year - era * 400);
+    const unsigned dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    const unsigned dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + static_cast<int32_t>(dayOfEra) - 719468;
+}
+
+/**
+ * @brief Calendar date of a day count since 1970-01-01
+ */
+void civilFromDays(int32_t days, int& year, unsigned& month, unsigned& day) {
+    days += 719468;
+    const int era = (days >= 0 ? days : days - 146096) / 146097;
+    const unsigned dayOfEra = static_cast<unsigned>(days - era * 146097);
+    const unsigned yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    const unsigned dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    const unsigned mp = (5 * dayOfYear + 2) / 153;
+
+    day = dayOfYear - (153 * mp + 2) / 5 + 1;
+    month = mp < 10 ? mp + 3 : mp - 9;
+    year = static_cast<int>(yearOfEra) + era * 400 + (month <= 2);
+}
+
+std::unique_ptr<DayEntry> makeEntry(int32_t days) {
+    int year = 0;
+    unsigned month = 0;
+    unsigned day = 0;
+    civilFromDays(days, year, month, day);
+
+    // Local midnight, computed the same way as InstrumentModel::parseDate
+    std::tm tm = {};
+    tm.tm_year = year - 1900;
+    tm.tm_mon = static_cast<int>(month) - 1;
+    tm.tm_mday = static_cast<int>(day);
+
+    auto entry = std::make_unique<DayEntry>();
+    entry->timePoint = std::chrono::system_clock::from_time_t(std::mktime(&tm));
+    entry->text = fmt::format("{:04}-{:02}-{:02}", year, month, day);
+    return entry;
+}
+
+/**
+ * @brief Lazily filled cache of day conversions
+ *
+ * Days 0-65535 (1970-2149) use a lock-free slot table; anything else falls
+ * back to a mutex-protected map. Entries are never freed.
+ */
+class DayCache {
+public:
+    const DayEntry& get(int32_t days) {
+        if (days >= 0 && static_cast<size_t>(days) < m_slots.size()) {
+            auto& slot = m_slots[static_cast<size_t>(days)];
+
+            const DayEntry* entry = slot.load(std::memory_order_acquire);
+            if (entry) {
+                return *entry;
+            }
+
+            auto created = makeEntry(days);
+            const DayEntry* expected = nullptr;
+            if (slot.compare_exchange_strong(expected, created.get(), std::memory_order_acq_rel)) {
+                return *created.release();
+            }
+
+            // Another thread filled the slot first
+            return *expected;
+        }
+
+        std::lock_guard<std::mutex> lock(m_overflowMutex);
+        auto& entry = m_overflow[days];
+        if (!entry) {
+            entry = makeEntry(days);
+        }
+        return *entry;
+    }
+
+private:
+    std::array<std::atomic<const DayEntry*>, 65536> m_slots{};
+    std::map<int32_t, std::unique_ptr<DayEntry>> m_overflow;
+    std::mutex m_overflowMutex;
+};
+
+DayCache& dayCache() {
+    // Intentionally leaked so cached references stay valid during static destruction
+    static DayCache* instance = new DayCache();
+    return *instance;
+}
+
+}  // namespace
+
+ExpiryDay ExpiryDay::fromDate(int year, unsigned month, unsigned day) {
+    return ExpiryDay(daysFromCivil(year, month, day));
+}
+
+ExpiryDay ExpiryDay::fromTimePoint(const std::chrono::system_clock::time_point& tp) {
+    std::time_t time = std::chrono::system_clock::to_time_t(tp);
+    std::tm tm = {};
+    localtime_r(&time, &tm);
+
+    return fromDate(tm.tm_year + 1900, static_cast<unsigned>(tm.tm_mon + 1), static_cast<unsigned>(tm.tm_mday));
+}
+
+std::chrono::system_clock::time_point ExpiryDay::timePoint() const {
+    return dayCache().get(m_day).timePoint;
+}
+
+const std::string& ExpiryDay::toString() const {
+    return dayCache().get(m_day).text;
+}
+
+}  // namespace BoxStrategy
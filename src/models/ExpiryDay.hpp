@@ -0,0 +1,109 @@
+/**
+ * @file ExpiryDay.hpp
+ * @brief Compact calendar-day representation of an expiry date
+ */
+
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include <chrono>
+#include <functional>
+#include <fmt/format.h>
+
+namespace BoxStrategy {
+
+/**
+ * @class ExpiryDay
+ * @brief Expiry as a count of local calendar days since 1970-01-01
+ *
+ * Comparing two expiries is an integer compare. The matching time point
+ * (local midnight, as produced by InstrumentModel::parseDate) and the
+ * YYYY-MM-DD string are computed once per distinct day and cached for the
+ * life of the process. Day 0 means "no expiry".
+ */
+class ExpiryDay {
+public:
+    /**
+     * @brief Constructor, no expiry
+     */
+    constexpr ExpiryDay() : m_day(0) {}
+
+    /**
+     * @brief Constructor
+     * @param day Days since 1970-01-01
+     */
+    constexpr explicit ExpiryDay(int32_t day) : m_day(day) {}
+
+    /**
+     * @brief Create from a calendar date
+     * @param year Year (e.g. 2024)
+     * @param month Month, 1-12
+     * @param day Day of month, 1-31
+     * @return Expiry day
+     */
+    static ExpiryDay fromDate(int year, unsigned month, unsigned day);
+
+    /**
+     * @brief Create from a time point, using the local calendar date
+     * @param tp Time point
+     * @return Expiry day containing the time point
+     */
+    static ExpiryDay fromTimePoint(const std::chrono::system_clock::time_point& tp);
+
+    /**
+     * @brief Get the day count
+     * @return Days since 1970-01-01
+     */
+    constexpr int32_t day() const { return m_day; }
+
+    /**
+     * @brief Check if an expiry is set
+     * @return True unless this is the "no expiry" value
+     */
+    constexpr bool isSet() const { return m_day != 0; }
+
+    /**
+     * @brief Get local midnight of this day (cached)
+     * @return Time point
+     */
+    std::chrono::system_clock::time_point timePoint() const;
+
+    /**
+     * @brief Get the day formatted as YYYY-MM-DD (cached)
+     * @return Formatted date
+     */
+    const std::string& toString() const;
+
+    friend constexpr bool operator==(ExpiryDay a, ExpiryDay b) { return a.m_day == b.m_day; }
+    friend constexpr bool operator!=(ExpiryDay a, ExpiryDay b) { return a.m_day != b.m_day; }
+    friend constexpr bool operator<(ExpiryDay a, ExpiryDay b) { return a.m_day < b.m_day; }
+    friend constexpr bool operator<=(ExpiryDay a, ExpiryDay b) { return a.m_day <= b.m_day; }
+    friend constexpr bool operator>(ExpiryDay a, ExpiryDay b) { return a.m_day > b.m_day; }
+    friend constexpr bool operator>=(ExpiryDay a, ExpiryDay b) { return a.m_day >= b.m_day; }
+
+private:
+    int32_t m_day;  ///< Days since 1970-01-01
+};
+
+}  // namespace BoxStrategy
+
+namespace std {
+
+template<>
+struct hash<BoxStrategy::ExpiryDay> {
+    size_t operator()(BoxStrategy::ExpiryDay value) const noexcept {
+        return std::hash<int32_t>()(value.day());
+    }
+};
+
+}  // namespace std
+
+template<>
+struct fmt::formatter<BoxStrategy::ExpiryDay> : fmt::formatter<fmt::string_view> {
+    template<typename FormatContext>
+    auto format(const BoxStrategy::ExpiryDay& value, FormatContext& ctx) const {
+        const std::string& text = value.toString();
+        return fmt::formatter<fmt::string_view>::format(fmt::string_view(text.data(), text.size()), ctx);
+    }
+};
@@ -9,21 +9,9 @@
 
 namespace BoxStrategy {
 
-InstrumentModel::InstrumentModel()
-    : instrumentToken(0),
-      strikePrice(0.0),
-      optionType(OptionType::UNKNOWN),
-      type(InstrumentType::UNKNOWN),
-      lastPrice(0.0),
-      openPrice(0.0),
-      highPrice(0.0),
-      lowPrice(0.0),
-      closePrice(0.0),
-      averagePrice(0.0),
-      volume(0),
-      buyQuantity(0),
-      sellQuantity(0),
-      openInterest(0.0) {
+InstrumentModel::InstrumentModel(const InstrumentRef& ref)
+    : InstrumentRef(ref) {
+    lastPrice = ref.listedPrice;
 }
 
 std::string InstrumentModel::instrumentTypeToString(InstrumentType type) {
@@ -81,12 +69,8 @@ std::chrono::system_clock::time_point InstrumentModel::parseDate(const std::stri
 }
 
 std::string InstrumentModel::formatDate(const std::chrono::system_clock::time_point& tp) {
-    std::time_t time = std::chrono::system_clock::to_time_t(tp);
-    std::tm* tm = std::localtime(&time);
-    
-    std::ostringstream ss;
-    ss << std::put_time(tm, "%Y-%m-%d");
-    return ss.str();
+    // The formatted text is cached per calendar day
+    return ExpiryDay::fromTimePoint(tp).toString();
 }
 
 }  // namespace BoxStrategy
\ No newline at end of file
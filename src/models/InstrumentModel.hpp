@@ -9,6 +9,9 @@
 #include <cstdint>
 #include <chrono>
 #include <vector>
+#include <array>
+#include "../models/ExpiryDay.hpp"
+#include "../utils/InternedString.hpp"
 
 namespace BoxStrategy {
 
@@ -37,50 +40,119 @@ enum class OptionType {
 };
 
 /**
- * @struct InstrumentModel
- * @brief Model for a financial instrument
+ * @struct DepthItem
+ * @brief One price level of market depth
+ */
+struct DepthItem {
+    double price;                        ///< Price level
+    uint64_t quantity;                   ///< Quantity at this price level
+    uint32_t orders;                     ///< Number of orders at this price level
+};
+
+/**
+ * @class DepthLadder
+ * @brief Fixed-capacity, inline market depth for one side of the book
+ *
+ * Kite reports five levels per side, so the levels live inline instead of
+ * in a heap-allocated vector. Levels beyond the capacity are dropped.
  */
-struct InstrumentModel {
-    uint64_t instrumentToken;            ///< Unique identifier for the instrument
+class DepthLadder {
+public:
+    static constexpr size_t CAPACITY = 5;  ///< Maximum number of levels
+
+    /**
+     * @brief Append a level
+     * @param level Depth level
+     * @return False if the ladder is full
+     */
+    bool push_back(const DepthItem& level) {
+        if (m_size >= CAPACITY) {
+            return false;
+        }
+        m_levels[m_size++] = level;
+        return true;
+    }
+
+    void clear() { m_size = 0; }
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    const DepthItem& operator[](size_t index) const { return m_levels[index]; }
+    DepthItem& operator[](size_t index) { return m_levels[index]; }
+    const DepthItem& front() const { return m_levels[0]; }
+    const DepthItem* begin() const { return m_levels.data(); }
+    const DepthItem* end() const { return m_levels.data() + m_size; }
+
+private:
+    std::array<DepthItem, CAPACITY> m_levels{};  ///< Levels, best price first
+    uint8_t m_size = 0;                         ///< Number of valid levels
+};
+
+/**
+ * @struct InstrumentRef
+ * @brief Static reference data of an instrument, from the instruments dump
+ */
+struct InstrumentRef {
+    uint64_t instrumentToken = 0;        ///< Unique identifier for the instrument
     std::string tradingSymbol;           ///< Trading symbol of the instrument
-    std::string exchange;                ///< Exchange where the instrument is traded
+    InternedString exchange;             ///< Exchange where the instrument is traded
     std::string exchangeToken;           ///< Exchange token of the instrument
-    std::string name;                    ///< Name of the instrument
-    InstrumentType type;                 ///< Type of the instrument
-    std::string segment;                 ///< Segment of the instrument
+    InternedString name;                 ///< Name of the instrument
+    InstrumentType type = InstrumentType::UNKNOWN;  ///< Type of the instrument
+    InternedString segment;              ///< Segment of the instrument
     
     // Option-specific fields
-    std::string underlying;              ///< Underlying instrument for options
-    double strikePrice;                  ///< Strike price for options
-    OptionType optionType;               ///< Type of option (call/put)
-    std::chrono::system_clock::time_point expiry;  ///< Expiry date for options/futures
-    
-    // Market data
-    double lastPrice;                    ///< Last traded price
-    double openPrice;                    ///< Opening price
-    double highPrice;                    ///< High price
-    double lowPrice;                     ///< Low price
-    double closePrice;                   ///< Closing price
-    double averagePrice;                 ///< Average price
-    uint64_t volume;                     ///< Traded volume
-    uint64_t buyQuantity;                ///< Buy quantity
-    uint64_t sellQuantity;               ///< Sell quantity
-    double openInterest;                 ///< Open interest
+    InternedString underlying;           ///< Underlying instrument for options
+    double strikePrice = 0.0;            ///< Strike price for options
+    OptionType optionType = OptionType::UNKNOWN;    ///< Type of option (call/put)
+    ExpiryDay expiry;                    ///< Expiry date for options/futures
     
-    // Depth data
-    struct DepthItem {
-        double price;                    ///< Price level
-        uint64_t quantity;               ///< Quantity at this price level
-        uint32_t orders;                 ///< Number of orders at this price level
-    };
+    double listedPrice = 0.0;            ///< Last price as listed in the instruments dump
+};
+
+/**
+ * @struct QuoteModel
+ * @brief Live market data of an instrument
+ */
+struct QuoteModel {
+    using DepthItem = BoxStrategy::DepthItem;
     
-    std::vector<DepthItem> buyDepth;     ///< Market depth for buy side
-    std::vector<DepthItem> sellDepth;    ///< Market depth for sell side
+    double lastPrice = 0.0;              ///< Last traded price
+    double openPrice = 0.0;              ///< Opening price
+    double highPrice = 0.0;              ///< High price
+    double lowPrice = 0.0;               ///< Low price
+    double closePrice = 0.0;             ///< Closing price
+    double averagePrice = 0.0;           ///< Average price
+    uint64_t volume = 0;                 ///< Traded volume
+    uint64_t buyQuantity = 0;            ///< Buy quantity
+    uint64_t sellQuantity = 0;           ///< Sell quantity
+    double openInterest = 0.0;           ///< Open interest
     
+    DepthLadder buyDepth;                ///< Market depth for buy side
+    DepthLadder sellDepth;               ///< Market depth for sell side
+};
+
+/**
+ * @struct InstrumentModel
+ * @brief Model for a financial instrument: reference data plus its latest quote
+ */
+struct InstrumentModel : InstrumentRef, QuoteModel {
     /**
      * @brief Default constructor
      */
-    InstrumentModel();
+    InstrumentModel() = default;
+    
+    /**
+     * @brief Construct from reference data, using the listed price as last price
+     * @param ref Reference data
+     */
+    explicit InstrumentModel(const InstrumentRef& ref);
+    
+    /**
+     * @brief Construct from reference data and a quote
+     * @param ref Reference data
+     * @param quote Quote
+     */
+    InstrumentModel(const InstrumentRef& ref, const QuoteModel& quote) : InstrumentRef(ref), QuoteModel(quote) {}
     
     /**
      * @brief Convert instrument type to string
@@ -123,6 +195,13 @@ struct InstrumentModel {
      * @return Formatted date string in format YYYY-MM-DD
      */
     static std::string formatDate(const std::chrono::system_clock::time_point& tp);
+    
+    /**
+     * @brief Format an expiry day to date string
+     * @param day Expiry day
+     * @return Formatted date string in format YYYY-MM-DD
+     */
+    static const std::string& formatDate(ExpiryDay day) { return day.toString(); }
 };
 
 }  // namespace BoxStrategy
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include "../trading/OrderManager.hpp"
 #include <sstream>
 #include <algorithm>
+#include <thread>
 #include "../external/json.hpp"
 
 using json = nlohmann::json;
@@ -494,7 +495,7 @@ HttpResponse OrderManager::makeApiRequest(
         return HttpResponse{401, "Access token is not valid", {}};
     }
     
-    std::string url = "https://api.kite.trade" + endpoint;
+    std::string url = m_authManager->getApiBaseUrl() + endpoint;
     
     // Add query parameters to URL
     if (!params.empty()) {
@@ -0,0 +1,348 @@
+/**
+ * @file ApiScheduler.cpp
+ * @brief Implementation of the ApiScheduler class
+ */
+
+#include "../utils/ApiScheduler.hpp"
+#include <algorithm>
+
+namespace BoxStrategy {
+
+ApiScheduler::ApiScheduler(std::shared_ptr<Logger> logger, size_t numWorkers, double burst)
+    : m_logger(logger),
+      m_burst(std::max(1.0, burst)),
+      m_workers(std::max<size_t>(1, numWorkers), logger) {
+
+    setRateLimit(DEFAULT_ENDPOINT, 10.0);
+    m_dispatcher = std::thread(&ApiScheduler::run, this);
+}
+
+ApiScheduler::~ApiScheduler() {
+    stop();
+}
+
+void ApiScheduler::setRateLimit(const std::string& endpoint, double requestsPerMinute) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto now = Clock::now();
+    auto inserted = m_endpoints.try_emplace(endpoint);
+    Endpoint& bucket = inserted.first->second;
+
+    if (inserted.second) {
+        bucket.tokens = m_burst;
+        bucket.lastRefill = now;
+        bucket.created = now;
+        bucket.permitted = m_burst;
+    } else {
+        refill(bucket, now);
+    }
+
+    bucket.ratePerSecond = std::max(requestsPerMinute, 0.01) / 60.0;
+    bucket.configuredRatePerSecond = bucket.ratePerSecond;
+    bucket.lastAdjusted = now;
+    m_condition.notify_all();
+}
+
+double ApiScheduler::getRateLimit(const std::string& endpoint) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_endpoints.find(endpoint);
+    if (it == m_endpoints.end()) {
+        it = m_endpoints.find(DEFAULT_ENDPOINT);
+    }
+    return it->second.ratePerSecond * 60.0;
+}
+
+double ApiScheduler::reduceRateLimit(const std::string& endpoint, double factor, double minimum) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto now = Clock::now();
+    Endpoint& bucket = bucketFor(endpoint);
+    refill(bucket, now);
+
+    double requestsPerMinute = std::max(minimum, bucket.ratePerSecond * 60.0 * factor);
+    bucket.ratePerSecond = std::max(requestsPerMinute, 0.01) / 60.0;
+    bucket.lastAdjusted = now;
+    return requestsPerMinute;
+}
+
+void ApiScheduler::setRecoveryPeriod(std::chrono::seconds quietPeriod) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_recoveryPeriod = std::max(quietPeriod, std::chrono::seconds(1));
+}
+
+Future<HttpResponse> ApiScheduler::submit(
+    const std::string& endpoint,
+    Task task,
+    RequestPriority priority,
+    Clock::time_point deadline,
+    const std::string& flow) {
+
+    auto request = std::make_shared<Request>();
+    request->task = std::move(task);
+    request->priority = priority;
+    request->deadline = deadline;
+    request->submitted = Clock::now();
+
+    Future<HttpResponse> future = request->promise.getFuture();
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    if (m_stop) {
+        lock.unlock();
+        request->promise.setValue(HttpResponse{503, "API scheduler stopped", {}});
+        return future;
+    }
+
+    request->sequence = m_nextSequence++;
+
+    Endpoint& bucket = bucketFor(endpoint);
+    bucket.nextDeadline = std::min(bucket.nextDeadline, deadline);
+    auto& queue = bucket.flows[flow];
+    queue.push_back(std::move(request));
+    std::push_heap(queue.begin(), queue.end(), RequestOrder());
+    bucket.queued++;
+    m_condition.notify_all();
+
+    return future;
+}
+
+std::vector<EndpointUtilization> ApiScheduler::getUtilization() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto now = Clock::now();
+
+    std::vector<EndpointUtilization> result;
+    result.reserve(m_endpoints.size());
+
+    for (const auto& [name, bucket] : m_endpoints) {
+        // Include what has accrued since the last refill without modifying the bucket
+        double elapsed = std::chrono::duration<double>(now - bucket.lastRefill).count();
+        double permitted = bucket.permitted + elapsed * bucket.ratePerSecond;
+
+        EndpointUtilization utilization;
+        utilization.endpoint = name;
+        utilization.requestsPerMinute = bucket.ratePerSecond * 60.0;
+        utilization.dispatched = bucket.dispatched;
+        utilization.expired = bucket.expired;
+        utilization.queued = bucket.queued;
+        utilization.utilization = permitted > 0.0 ? std::min(1.0, bucket.dispatched / permitted) : 0.0;
+        utilization.averageWaitMs = bucket.dispatched > 0 ? bucket.totalWaitMs / bucket.dispatched : 0.0;
+        utilization.dispatchedByFlow = bucket.dispatchedByFlow;
+        result.push_back(utilization);
+    }
+
+    std::sort(result.begin(), result.end(),
+              [](const EndpointUtilization& a, const EndpointUtilization& b) { return a.endpoint < b.endpoint; });
+    return result;
+}
+
+void ApiScheduler::stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stop) {
+            return;
+        }
+        m_stop = true;
+    }
+    m_condition.notify_all();
+
+    if (m_dispatcher.joinable()) {
+        m_dispatcher.join();
+    }
+
+    std::vector<std::shared_ptr<Request>> abandoned;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto& [name, bucket] : m_endpoints) {
+            for (auto& [flow, queue] : bucket.flows) {
+                abandoned.insert(abandoned.end(), queue.begin(), queue.end());
+            }
+            bucket.flows.clear();
+            bucket.queued = 0;
+        }
+    }
+
+    for (auto& request : abandoned) {
+        request->promise.setValue(HttpResponse{503, "API scheduler stopped", {}});
+    }
+
+    // Requests on the wire call back into this scheduler (and their submitter) when they complete
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idleCondition.wait(lock, [this]() { return m_inFlight == 0; });
+}
+
+void ApiScheduler::start(std::shared_ptr<Request> request) {
+    m_workers.enqueue([this, request]() {
+        try {
+            request->task([this, request](HttpResponse response) {
+                complete(request, std::move(response));
+            });
+        } catch (...) {
+            request->promise.setException(std::current_exception());
+            finish();
+        }
+    });
+}
+
+void ApiScheduler::complete(std::shared_ptr<Request> request, HttpResponse response) {
+    // Responses arrive on the I/O thread; continuations run on a worker so they cannot stall other transfers
+    m_workers.enqueue([this, request, response = std::move(response)]() mutable {
+        request->promise.setValue(std::move(response));
+        finish();
+    });
+}
+
+void ApiScheduler::finish() {
+    // Notified under the lock so that stop() cannot return and destroy the condition before this does
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (--m_inFlight == 0) {
+        m_idleCondition.notify_all();
+    }
+}
+
+ApiScheduler::Endpoint& ApiScheduler::bucketFor(const std::string& endpoint) {
+    auto it = m_endpoints.find(endpoint);
+    if (it == m_endpoints.end()) {
+        it = m_endpoints.find(DEFAULT_ENDPOINT);
+    }
+    return it->second;
+}
+
+void ApiScheduler::refill(Endpoint& endpoint, Clock::time_point now) {
+    double elapsed = std::chrono::duration<double>(now - endpoint.lastRefill).count();
+    double accrued = elapsed * endpoint.ratePerSecond;
+
+    endpoint.permitted += accrued;
+    endpoint.tokens = std::min(m_burst, endpoint.tokens + accrued);
+    endpoint.lastRefill = now;
+}
+
+void ApiScheduler::recover(const std::string& name, Endpoint& endpoint, Clock::time_point now) {
+    if (endpoint.ratePerSecond >= endpoint.configuredRatePerSecond ||
+        now - endpoint.lastAdjusted < m_recoveryPeriod) {
+        return;
+    }
+
+    // Additive increase back to the configured limit, a tenth of it per quiet period
+    endpoint.ratePerSecond = std::min(endpoint.configuredRatePerSecond,
+                                      endpoint.ratePerSecond + endpoint.configuredRatePerSecond * 0.1);
+    endpoint.lastAdjusted = now;
+
+    m_logger->info("Rate limit for {} recovering to {:.1f} of {:.1f} requests per minute",
+                 name, endpoint.ratePerSecond * 60.0, endpoint.configuredRatePerSecond * 60.0);
+}
+
+std::shared_ptr<ApiScheduler::Request> ApiScheduler::takeNext(Endpoint& endpoint) {
+    // Only flows whose next request has the highest waiting priority are eligible
+    RequestPriority highest = RequestPriority::LOW;
+    for (const auto& [flow, queue] : endpoint.flows) {
+        highest = std::max(highest, queue.front()->priority);
+    }
+
+    // Start after the flow served last and wrap around
+    auto it = endpoint.flows.upper_bound(endpoint.lastFlow);
+    for (size_t i = 0; i < endpoint.flows.size(); ++i, ++it) {
+        if (it == endpoint.flows.end()) {
+            it = endpoint.flows.begin();
+        }
+        if (it->second.front()->priority == highest) {
+            break;
+        }
+    }
+
+    auto& queue = it->second;
+    std::pop_heap(queue.begin(), queue.end(), RequestOrder());
+    std::shared_ptr<Request> request = std::move(queue.back());
+    queue.pop_back();
+
+    if (!it->first.empty()) {
+        endpoint.dispatchedByFlow[it->first]++;
+    }
+    endpoint.lastFlow = it->first;
+    if (queue.empty()) {
+        endpoint.flows.erase(it);
+    }
+    endpoint.queued--;
+
+    return request;
+}
+
+void ApiScheduler::expire(const std::string& name, Endpoint& endpoint, Clock::time_point now) {
+    endpoint.nextDeadline = Clock::time_point::max();
+
+    for (auto flow = endpoint.flows.begin(); flow != endpoint.flows.end();) {
+        auto& queue = flow->second;
+        auto expired = std::partition(queue.begin(), queue.end(),
+                                      [now](const std::shared_ptr<Request>& request) { return request->deadline > now; });
+
+        for (auto it = expired; it != queue.end(); ++it) {
+            const auto& request = *it;
+            endpoint.expired++;
+            m_logger->warn("Dropping {} request: deadline passed after {} ms in queue", name,
+                         std::chrono::duration_cast<std::chrono::milliseconds>(now - request->submitted).count());
+            m_workers.enqueue([request]() {
+                request->promise.setValue(HttpResponse{408, "Request deadline passed before dispatch", {}});
+            });
+        }
+
+        endpoint.queued -= static_cast<size_t>(queue.end() - expired);
+        queue.erase(expired, queue.end());
+
+        if (queue.empty()) {
+            flow = endpoint.flows.erase(flow);
+            continue;
+        }
+
+        std::make_heap(queue.begin(), queue.end(), RequestOrder());
+        for (const auto& request : queue) {
+            endpoint.nextDeadline = std::min(endpoint.nextDeadline, request->deadline);
+        }
+        ++flow;
+    }
+}
+
+void ApiScheduler::run() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    while (!m_stop) {
+        auto now = Clock::now();
+        auto nextWake = Clock::time_point::max();
+
+        for (auto& [name, bucket] : m_endpoints) {
+            refill(bucket, now);
+            recover(name, bucket, now);
+
+            if (bucket.nextDeadline <= now) {
+                expire(name, bucket, now);
+            }
+
+            while (bucket.queued > 0 && bucket.tokens >= 1.0) {
+                std::shared_ptr<Request> request = takeNext(bucket);
+
+                bucket.tokens -= 1.0;
+                bucket.dispatched++;
+                bucket.totalWaitMs += std::chrono::duration<double, std::milli>(now - request->submitted).count();
+
+                m_inFlight++;
+                start(request);
+            }
+
+            if (bucket.queued == 0) {
+                bucket.nextDeadline = Clock::time_point::max();
+            } else {
+                // Wake when the next token accrues, or when a queued request expires
+                auto untilToken = std::chrono::duration<double>((1.0 - bucket.tokens) / bucket.ratePerSecond);
+                auto tokenTime = now + std::chrono::duration_cast<Clock::duration>(untilToken);
+                nextWake = std::min({nextWake, tokenTime, bucket.nextDeadline});
+            }
+        }
+
+        if (nextWake == Clock::time_point::max()) {
+            m_condition.wait(lock);
+        } else {
+            m_condition.wait_until(lock, nextWake);
+        }
+    }
+}
+
+}  // namespace BoxStrategy
@@ -0,0 +1,259 @@
+/**
+ * @file ApiScheduler.hpp
+ * @brief Rate-limited, prioritized dispatcher for API requests
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <future>
+#include <functional>
+#include <condition_variable>
+#include <unordered_map>
+#include <map>
+#include <chrono>
+#include "../utils/Logger.hpp"
+#include "../utils/HttpClient.hpp"
+#include "../utils/ThreadPool.hpp"
+#include "../utils/Future.hpp"
+
+namespace BoxStrategy {
+
+/**
+ * @enum RequestPriority
+ * @brief Order in which queued requests of one endpoint are dispatched
+ */
+enum class RequestPriority {
+    LOW = 0,      ///< Background work (e.g. instrument dumps)
+    NORMAL = 1,   ///< Regular requests
+    HIGH = 2      ///< Latency-sensitive requests (e.g. quotes for a running scan)
+};
+
+/**
+ * @struct EndpointUtilization
+ * @brief How much of an endpoint's request budget has been used
+ */
+struct EndpointUtilization {
+    std::string endpoint;              ///< Endpoint (rate limit key)
+    double requestsPerMinute = 0.0;    ///< Current rate limit
+    uint64_t dispatched = 0;           ///< Requests sent since the scheduler started
+    uint64_t expired = 0;              ///< Requests dropped because their deadline passed
+    size_t queued = 0;                 ///< Requests currently waiting
+    double utilization = 0.0;          ///< Dispatched requests / requests the budget allowed
+    double averageWaitMs = 0.0;        ///< Average time from submit to dispatch
+    std::map<std::string, uint64_t> dispatchedByFlow;  ///< Requests sent per named flow
+};
+
+/**
+ * @class ApiScheduler
+ * @brief Dispatches API requests at exactly the rate each endpoint permits
+ *
+ * Every endpoint has a token bucket refilled continuously at its rate
+ * limit. Requests are queued per endpoint by priority, then deadline, then
+ * submission order, and a single dispatcher thread hands one to the worker
+ * pool whenever the bucket holds a token. A worker only starts the request;
+ * the transfer runs on the HTTP client's event loop, so no thread waits on
+ * the network. Callers get a future instead of sleeping on the limit. A
+ * request still queued when its deadline passes is answered with status 408
+ * without being sent.
+ *
+ * Requests may name a flow, such as the underlying a scan is for. Each flow
+ * of an endpoint has its own queue, and among the flows whose next request
+ * has the highest waiting priority the dispatcher takes turns, so
+ * concurrent scans share the endpoint's budget evenly however many requests
+ * each has queued.
+ *
+ * Futures are completed on a worker, never on the I/O thread and never
+ * under the scheduler's lock, so their continuations may parse responses
+ * and submit further requests.
+ */
+class ApiScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+    using Completion = std::function<void(HttpResponse response)>;  ///< Receives the response, on any thread
+    using Task = std::function<void(Completion done)>;              ///< Starts a request and calls done once
+
+    static constexpr const char* DEFAULT_ENDPOINT = "default";  ///< Bucket for endpoints without their own limit
+
+    /**
+     * @brief Constructor
+     * @param logger Logger instance
+     * @param numWorkers Number of threads starting dispatched requests and completing their futures
+     * @param burst Requests an idle endpoint may send back to back (bucket capacity)
+     */
+    ApiScheduler(std::shared_ptr<Logger> logger, size_t numWorkers, double burst = 1.0);
+
+    /**
+     * @brief Destructor, answers queued requests with status 503 and waits for those in flight
+     */
+    ~ApiScheduler();
+
+    ApiScheduler(const ApiScheduler&) = delete;
+    ApiScheduler& operator=(const ApiScheduler&) = delete;
+
+    /**
+     * @brief Set the rate limit of an endpoint
+     * @param endpoint Endpoint, or DEFAULT_ENDPOINT
+     * @param requestsPerMinute Permitted requests per minute
+     */
+    void setRateLimit(const std::string& endpoint, double requestsPerMinute);
+
+    /**
+     * @brief Get the rate limit applied to an endpoint
+     * @param endpoint Endpoint
+     * @return Permitted requests per minute
+     */
+    double getRateLimit(const std::string& endpoint) const;
+
+    /**
+     * @brief Scale down the rate limit applied to an endpoint, e.g. after a 429
+     * @param endpoint Endpoint; falls back to the default bucket
+     * @param factor Multiplier applied to the current limit
+     * @param minimum Lowest requests per minute to go down to
+     * @return New requests per minute
+     *
+     * The limit climbs back to the one set with setRateLimit in steps of
+     * a tenth of it, one per recovery period without a further reduction.
+     */
+    double reduceRateLimit(const std::string& endpoint, double factor, double minimum);
+
+    /**
+     * @brief Set how long a reduced limit must go without another reduction before each recovery step
+     * @param quietPeriod Recovery period
+     */
+    void setRecoveryPeriod(std::chrono::seconds quietPeriod);
+
+    /**
+     * @brief Queue a request
+     * @param endpoint Endpoint whose budget the request uses
+     * @param task Starts the request once dispatched
+     * @param priority Request priority
+     * @param deadline Latest time the request may be dispatched
+     * @param flow Flow the request belongs to; flows take turns at the endpoint's budget
+     * @return Future with the response
+     */
+    Future<HttpResponse> submit(
+        const std::string& endpoint,
+        Task task,
+        RequestPriority priority = RequestPriority::NORMAL,
+        Clock::time_point deadline = Clock::time_point::max(),
+        const std::string& flow = "");
+
+    /**
+     * @brief Get the budget utilization of every endpoint
+     * @return One entry per endpoint
+     */
+    std::vector<EndpointUtilization> getUtilization() const;
+
+    /**
+     * @brief Stop dispatching; queued requests are answered with status 503
+     *
+     * Returns once every request already started has completed.
+     */
+    void stop();
+
+private:
+    struct Request {
+        Task task;                                 ///< Starts the request
+        RequestPriority priority;                  ///< Request priority
+        Clock::time_point deadline;                ///< Latest dispatch time
+        Clock::time_point submitted;               ///< Submission time
+        uint64_t sequence;                         ///< Submission order
+        Promise<HttpResponse> promise;             ///< Receives the response
+    };
+
+    struct RequestOrder {
+        bool operator()(const std::shared_ptr<Request>& a, const std::shared_ptr<Request>& b) const {
+            // priority_queue puts the "largest" element on top
+            if (a->priority != b->priority) return a->priority < b->priority;
+            if (a->deadline != b->deadline) return a->deadline > b->deadline;
+            return a->sequence > b->sequence;
+        }
+    };
+
+    struct Endpoint {
+        double ratePerSecond = 0.0;                ///< Refill rate
+        double configuredRatePerSecond = 0.0;      ///< Rate set with setRateLimit, recovered to after a reduction
+        Clock::time_point lastAdjusted;            ///< Last change of the refill rate
+        double tokens = 0.0;                       ///< Available dispatches
+        Clock::time_point lastRefill;              ///< Last refill time
+        Clock::time_point created;                 ///< Creation time, for utilization
+        double permitted = 0.0;                    ///< Dispatches the budget allowed since creation
+        uint64_t dispatched = 0;                   ///< Requests sent
+        uint64_t expired = 0;                      ///< Requests dropped at their deadline
+        double totalWaitMs = 0.0;                  ///< Sum of queueing delays
+        Clock::time_point nextDeadline = Clock::time_point::max();  ///< Earliest deadline in the queues
+        std::map<std::string, std::vector<std::shared_ptr<Request>>> flows;  ///< Heaps ordered by RequestOrder, by flow
+        std::string lastFlow;                      ///< Flow dispatched from last
+        size_t queued = 0;                         ///< Requests in all flows
+        std::map<std::string, uint64_t> dispatchedByFlow;  ///< Requests sent per named flow
+    };
+
+    /**
+     * @brief Dispatcher thread body
+     */
+    void run();
+
+    /**
+     * @brief Find the bucket of an endpoint, falling back to the default one
+     */
+    Endpoint& bucketFor(const std::string& endpoint);
+
+    /**
+     * @brief Add the tokens accrued since the last refill
+     */
+    void refill(Endpoint& endpoint, Clock::time_point now);
+
+    /**
+     * @brief Step a reduced refill rate back towards the configured one after a quiet period
+     */
+    void recover(const std::string& name, Endpoint& endpoint, Clock::time_point now);
+
+    /**
+     * @brief Take the next request to dispatch, rotating among the flows
+     */
+    std::shared_ptr<Request> takeNext(Endpoint& endpoint);
+
+    /**
+     * @brief Answer every queued request whose deadline has passed with status 408
+     */
+    void expire(const std::string& name, Endpoint& endpoint, Clock::time_point now);
+
+    /**
+     * @brief Start a dispatched request on a worker
+     */
+    void start(std::shared_ptr<Request> request);
+
+    /**
+     * @brief Complete a started request's future on a worker
+     */
+    void complete(std::shared_ptr<Request> request, HttpResponse response);
+
+    /**
+     * @brief Count a started request as finished
+     */
+    void finish();
+
+    std::shared_ptr<Logger> m_logger;                          ///< Logger instance
+    double m_burst;                                            ///< Bucket capacity
+    Clock::duration m_recoveryPeriod = std::chrono::seconds(60);  ///< Quiet time before each recovery step
+    ThreadPool m_workers;                                      ///< Executes dispatched requests
+
+    std::unordered_map<std::string, Endpoint> m_endpoints;     ///< Buckets and queues by endpoint
+    mutable std::mutex m_mutex;                                ///< Guards m_endpoints
+    std::condition_variable m_condition;                       ///< Wakes the dispatcher
+    uint64_t m_nextSequence = 0;                               ///< Next submission number
+    size_t m_inFlight = 0;                                     ///< Requests started but not yet completed
+    std::condition_variable m_idleCondition;                   ///< Signalled when m_inFlight drops to zero
+
+    std::thread m_dispatcher;                                  ///< Dispatcher thread
+    bool m_stop = false;                                       ///< Whether the dispatcher should exit
+};
+
+}  // namespace BoxStrategy
@@ -0,0 +1,342 @@
+/**
+ * @file FramedSocket.cpp
+ * @brief Implementation of the FramedSocket class
+ */
+
+#include "../utils/FramedSocket.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace BoxStrategy {
+
+namespace {
+
+constexpr size_t READ_CHUNK_SIZE = 64 * 1024;  ///< Bytes requested per recv
+
+bool resolve(const std::string& host, uint16_t port, bool passive, addrinfo*& result, std::string& error) {
+    addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = passive ? AI_PASSIVE : 0;
+
+    std::string service = std::to_string(port);
+    int rc = ::getaddrinfo(host.empty() ? nullptr : host.c_str(), service.c_str(), &hints, &result);
+    if (rc != 0) {
+        error = ::gai_strerror(rc);
+        return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+FramedSocket::FramedSocket(int fd)
+    : m_fd(fd) {
+}
+
+FramedSocket::~FramedSocket() {
+    close();
+}
+
+FramedSocket::FramedSocket(FramedSocket&& other) noexcept
+    : m_fd(other.m_fd),
+      m_readBuffer(std::move(other.m_readBuffer)),
+      m_readPos(other.m_readPos) {
+    other.m_fd = -1;
+    other.m_readPos = 0;
+}
+
+FramedSocket& FramedSocket::operator=(FramedSocket&& other) noexcept {
+    if (this != &other) {
+        close();
+        m_fd = other.m_fd;
+        m_readBuffer = std::move(other.m_readBuffer);
+        m_readPos = other.m_readPos;
+        other.m_fd = -1;
+        other.m_readPos = 0;
+    }
+    return *this;
+}
+
+bool FramedSocket::connect(const std::string& host, uint16_t port, std::string& error) {
+    close();
+
+    addrinfo* addresses = nullptr;
+    if (!resolve(host, port, false, addresses, error)) {
+        return false;
+    }
+
+    for (addrinfo* address = addresses; address; address = address->ai_next) {
+        int fd = ::socket(address->ai_family, address->ai_socktype | SOCK_CLOEXEC, address->ai_protocol);
+        if (fd < 0) {
+            error = std::strerror(errno);
+            continue;
+        }
+
+        if (::connect(fd, address->ai_addr, address->ai_addrlen) == 0) {
+            // Ticks are small and latency sensitive
+            int one = 1;
+            ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            m_fd = fd;
+            break;
+        }
+
+        error = std::strerror(errno);
+        ::close(fd);
+    }
+
+    ::freeaddrinfo(addresses);
+    return m_fd >= 0;
+}
+
+bool FramedSocket::listen(const std::string& host, uint16_t port, std::string& error) {
+    close();
+
+    addrinfo* addresses = nullptr;
+    if (!resolve(host, port, true, addresses, error)) {
+        return false;
+    }
+
+    for (addrinfo* address = addresses; address; address = address->ai_next) {
+        int fd = ::socket(address->ai_family, address->ai_socktype | SOCK_CLOEXEC, address->ai_protocol);
+        if (fd < 0) {
+            error = std::strerror(errno);
+            continue;
+        }
+
+        int one = 1;
+        ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+        if (::bind(fd, address->ai_addr, address->ai_addrlen) == 0 && ::listen(fd, SOMAXCONN) == 0) {
+            m_fd = fd;
+            break;
+        }
+
+        error = std::strerror(errno);
+        ::close(fd);
+    }
+
+    ::freeaddrinfo(addresses);
+    return m_fd >= 0;
+}
+
+FramedSocket FramedSocket::accept() {
+    int fd = -1;
+    do {
+        fd = ::accept4(m_fd, nullptr, nullptr, SOCK_CLOEXEC);
+    } while (fd < 0 && errno == EINTR);
+
+    if (fd >= 0) {
+        int one = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+
+    return FramedSocket(fd);
+}
+
+uint16_t FramedSocket::localPort() const {
+    sockaddr_storage address = {};
+    socklen_t length = sizeof(address);
+    if (m_fd < 0 || ::getsockname(m_fd, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+        return 0;
+    }
+
+    if (address.ss_family == AF_INET) {
+        return ntohs(reinterpret_cast<sockaddr_in*>(&address)->sin_port);
+    }
+    if (address.ss_family == AF_INET6) {
+        return ntohs(reinterpret_cast<sockaddr_in6*>(&address)->sin6_port);
+    }
+    return 0;
+}
+
+bool FramedSocket::sendFrame(FrameType type, const void* data, size_t size) {
+    if (m_fd < 0 || size > MAX_FRAME_SIZE) {
+        return false;
+    }
+
+    uint8_t header[HEADER_SIZE] = {
+        static_cast<uint8_t>(size >> 24), static_cast<uint8_t>(size >> 16),
+        static_cast<uint8_t>(size >> 8), static_cast<uint8_t>(size),
+        static_cast<uint8_t>(type)
+    };
+
+    // Header and payload leave in one system call
+    iovec parts[2];
+    parts[0].iov_base = header;
+    parts[0].iov_len = HEADER_SIZE;
+    parts[1].iov_base = const_cast<void*>(data);
+    parts[1].iov_len = size;
+
+    msghdr message = {};
+    message.msg_iov = parts;
+    message.msg_iovlen = 2;
+
+    size_t remaining = HEADER_SIZE + size;
+    while (remaining > 0) {
+        ssize_t sent = ::sendmsg(m_fd, &message, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+
+        remaining -= static_cast<size_t>(sent);
+
+        // Skip the parts that went out completely
+        size_t consumed = static_cast<size_t>(sent);
+        while (message.msg_iovlen > 0 && consumed >= message.msg_iov[0].iov_len) {
+            consumed -= message.msg_iov[0].iov_len;
+            message.msg_iov++;
+            message.msg_iovlen--;
+        }
+        if (message.msg_iovlen > 0) {
+            message.msg_iov[0].iov_base = static_cast<uint8_t*>(message.msg_iov[0].iov_base) + consumed;
+            message.msg_iov[0].iov_len -= consumed;
+        }
+    }
+
+    return true;
+}
+
+bool FramedSocket::receiveFrame(FrameType& type, std::vector<uint8_t>& payload) {
+    uint8_t header[HEADER_SIZE];
+    if (!readExact(header, HEADER_SIZE)) {
+        return false;
+    }
+
+    size_t size = (static_cast<size_t>(header[0]) << 24) | (static_cast<size_t>(header[1]) << 16) |
+                  (static_cast<size_t>(header[2]) << 8) | static_cast<size_t>(header[3]);
+    if (size > MAX_FRAME_SIZE ||
+        (header[4] != static_cast<uint8_t>(FrameType::TEXT) && header[4] != static_cast<uint8_t>(FrameType::BINARY))) {
+        return false;
+    }
+
+    type = static_cast<FrameType>(header[4]);
+    payload.resize(size);
+    return size == 0 || readExact(payload.data(), size);
+}
+
+bool FramedSocket::sendRaw(const void* data, size_t size) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+
+    while (size > 0) {
+        if (m_fd < 0) {
+            return false;
+        }
+
+        ssize_t sent = ::send(m_fd, bytes, size, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+
+        bytes += sent;
+        size -= static_cast<size_t>(sent);
+    }
+
+    return true;
+}
+
+bool FramedSocket::receiveLine(std::string& line, size_t maxSize) {
+    line.clear();
+
+    while (true) {
+        // Take what is buffered up to the newline
+        const uint8_t* begin = m_readBuffer.data() + m_readPos;
+        const uint8_t* end = m_readBuffer.data() + m_readBuffer.size();
+        const uint8_t* newline = std::find(begin, end, static_cast<uint8_t>('\n'));
+
+        line.append(reinterpret_cast<const char*>(begin), static_cast<size_t>(newline - begin));
+        m_readPos += static_cast<size_t>(newline - begin);
+
+        if (newline != end) {
+            m_readPos++;
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+            return true;
+        }
+
+        if (line.size() > maxSize) {
+            return false;
+        }
+
+        // Buffer drained without a newline; readExact refills it with one byte consumed
+        uint8_t byte = 0;
+        if (!readExact(&byte, 1)) {
+            return false;
+        }
+        if (byte == '\n') {
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+            return true;
+        }
+        line.push_back(static_cast<char>(byte));
+    }
+}
+
+bool FramedSocket::readExact(uint8_t* data, size_t size) {
+    while (size > 0) {
+        size_t buffered = m_readBuffer.size() - m_readPos;
+
+        if (buffered > 0) {
+            size_t take = std::min(buffered, size);
+            std::memcpy(data, m_readBuffer.data() + m_readPos, take);
+            m_readPos += take;
+            data += take;
+            size -= take;
+            continue;
+        }
+
+        if (m_fd < 0) {
+            return false;
+        }
+
+        // Refill the buffer
+        m_readBuffer.resize(READ_CHUNK_SIZE);
+        m_readPos = 0;
+
+        ssize_t received = ::recv(m_fd, m_readBuffer.data(), m_readBuffer.size(), 0);
+        if (received < 0 && errno == EINTR) {
+            m_readBuffer.clear();
+            continue;
+        }
+        if (received <= 0) {
+            m_readBuffer.clear();
+            return false;
+        }
+
+        m_readBuffer.resize(static_cast<size_t>(received));
+    }
+
+    return true;
+}
+
+void FramedSocket::shutdown() {
+    if (m_fd >= 0) {
+        ::shutdown(m_fd, SHUT_RDWR);
+    }
+}
+
+void FramedSocket::close() {
+    if (m_fd >= 0) {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+    m_readBuffer.clear();
+    m_readPos = 0;
+}
+
+}  // namespace BoxStrategy
@@ -0,0 +1,160 @@
+/**
+ * @file FramedSocket.hpp
+ * @brief Blocking TCP socket exchanging length-prefixed frames
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace BoxStrategy {
+
+/**
+ * @class FramedSocket
+ * @brief TCP connection carrying text and binary frames
+ *
+ * Each frame is a big-endian 32-bit payload length, a one-byte frame type
+ * and the payload. Reads go through an internal buffer so a burst of small
+ * frames costs one system call. The socket is move-only and closed on
+ * destruction.
+ */
+class FramedSocket {
+public:
+    /**
+     * @enum FrameType
+     * @brief Kind of payload carried by a frame
+     */
+    enum class FrameType : uint8_t {
+        TEXT = 1,    ///< UTF-8 text (JSON control messages)
+        BINARY = 2   ///< Binary data (tick messages)
+    };
+
+    static constexpr size_t HEADER_SIZE = 5;                  ///< Length and type
+    static constexpr size_t MAX_FRAME_SIZE = 16 * 1024 * 1024; ///< Largest accepted payload
+
+    FramedSocket() = default;
+
+    /**
+     * @brief Take ownership of a connected socket
+     * @param fd Socket descriptor
+     */
+    explicit FramedSocket(int fd);
+
+    ~FramedSocket();
+
+    FramedSocket(FramedSocket&& other) noexcept;
+    FramedSocket& operator=(FramedSocket&& other) noexcept;
+    FramedSocket(const FramedSocket&) = delete;
+    FramedSocket& operator=(const FramedSocket&) = delete;
+
+    /**
+     * @brief Connect to a server
+     * @param host Host name or address
+     * @param port TCP port
+     * @param error Output error description on failure
+     * @return True if connected
+     */
+    bool connect(const std::string& host, uint16_t port, std::string& error);
+
+    /**
+     * @brief Bind and listen for connections
+     * @param host Address to bind
+     * @param port TCP port (0 = any free port)
+     * @param error Output error description on failure
+     * @return True if listening
+     */
+    bool listen(const std::string& host, uint16_t port, std::string& error);
+
+    /**
+     * @brief Wait for a connection on a listening socket
+     * @return Connected socket, not open on failure
+     */
+    FramedSocket accept();
+
+    /**
+     * @brief Get the local port of a bound socket
+     * @return Port, 0 if not bound
+     */
+    uint16_t localPort() const;
+
+    /**
+     * @brief Send one frame
+     * @param type Frame type
+     * @param data Payload
+     * @param size Payload size
+     * @return False if the connection failed
+     */
+    bool sendFrame(FrameType type, const void* data, size_t size);
+
+    /**
+     * @brief Send one text frame
+     * @param text Payload
+     * @return False if the connection failed
+     */
+    bool sendText(const std::string& text) {
+        return sendFrame(FrameType::TEXT, text.data(), text.size());
+    }
+
+    /**
+     * @brief Block until a frame arrives
+     * @param type Output frame type
+     * @param payload Output payload
+     * @return False on disconnect or a malformed frame
+     */
+    bool receiveFrame(FrameType& type, std::vector<uint8_t>& payload);
+
+    /**
+     * @brief Send bytes without framing, for line-based protocols such as HTTP
+     * @param data Bytes to send
+     * @param size Number of bytes
+     * @return False if the connection failed
+     */
+    bool sendRaw(const void* data, size_t size);
+
+    /**
+     * @brief Block until exactly size unframed bytes have arrived
+     * @param data Output buffer
+     * @param size Number of bytes
+     * @return False on disconnect
+     */
+    bool receiveRaw(uint8_t* data, size_t size) { return readExact(data, size); }
+
+    /**
+     * @brief Block until a line ending in "\n" arrives
+     * @param line Output line without the "\r\n" or "\n"
+     * @param maxSize Longest accepted line
+     * @return False on disconnect or an over-long line
+     */
+    bool receiveLine(std::string& line, size_t maxSize);
+
+    /**
+     * @brief Shut the connection down, unblocking a pending receive
+     */
+    void shutdown();
+
+    /**
+     * @brief Close the socket
+     */
+    void close();
+
+    /**
+     * @brief Check if the socket is open
+     * @return True if open
+     */
+    bool isOpen() const { return m_fd >= 0; }
+
+private:
+    /**
+     * @brief Read exactly size bytes through the read buffer
+     */
+    bool readExact(uint8_t* data, size_t size);
+
+    int m_fd = -1;                        ///< Socket descriptor
+    std::vector<uint8_t> m_readBuffer;    ///< Bytes received but not consumed
+    size_t m_readPos = 0;                 ///< First unconsumed byte in the buffer
+};
+
+}  // namespace BoxStrategy
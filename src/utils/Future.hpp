@@ -0,0 +1,379 @@
+/**
+ * @file Future.hpp
+ * @brief Future and promise with continuations
+ */
+
+#pragma once
+
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <optional>
+#include <exception>
+#include <chrono>
+#include <vector>
+#include <type_traits>
+#include "../utils/ThreadPool.hpp"
+
+namespace BoxStrategy {
+
+template<class T> class Future;
+template<class T> class Promise;
+
+namespace detail {
+
+/**
+ * @brief State shared by a promise and its future
+ */
+template<class T>
+struct FutureState {
+    static_assert(!std::is_void<T>::value, "Future<void> is not supported; use a value such as bool");
+
+    std::mutex mutex;                        ///< Guards the fields below
+    std::condition_variable ready;           ///< Signalled once done
+    bool done = false;                       ///< Whether a value or an error is set
+    std::optional<T> value;                  ///< Value, once done without error
+    std::exception_ptr error;                ///< Error, once done with one
+    std::function<void()> continuation;      ///< Runs once done, on the completing thread
+
+    /**
+     * @brief Run a callback once done: right away if already done, otherwise on the completing thread
+     */
+    void subscribe(std::function<void()> callback) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!done) {
+                continuation = std::move(callback);
+                return;
+            }
+        }
+        callback();
+    }
+};
+
+template<class T>
+struct Unwrap {
+    using Type = T;
+    static constexpr bool isFuture = false;
+};
+
+template<class T>
+struct Unwrap<Future<T>> {
+    using Type = T;
+    static constexpr bool isFuture = true;
+};
+
+}  // namespace detail
+
+/**
+ * @class Promise
+ * @brief Producer side of a Future
+ *
+ * Setting the value runs the future's continuation, if one is attached, on
+ * the calling thread. A promise destroyed without a value breaks its
+ * future with std::future_errc::broken_promise.
+ */
+template<class T>
+class Promise {
+public:
+    Promise() : m_state(std::make_shared<detail::FutureState<T>>()) {}
+
+    ~Promise() {
+        if (!m_state) {
+            return;
+        }
+
+        bool done;
+        {
+            std::lock_guard<std::mutex> lock(m_state->mutex);
+            done = m_state->done;
+        }
+        if (!done) {
+            setException(std::make_exception_ptr(std::future_error(std::future_errc::broken_promise)));
+        }
+    }
+
+    Promise(Promise&&) noexcept = default;
+    Promise& operator=(Promise&&) noexcept = default;
+    Promise(const Promise&) = delete;
+    Promise& operator=(const Promise&) = delete;
+
+    /**
+     * @brief Get the future; call at most once
+     */
+    Future<T> getFuture() {
+        return Future<T>(m_state);
+    }
+
+    /**
+     * @brief Complete the future with a value
+     */
+    void setValue(T value) {
+        finish([&](detail::FutureState<T>& state) { state.value.emplace(std::move(value)); });
+    }
+
+    /**
+     * @brief Complete the future with an error
+     */
+    void setException(std::exception_ptr error) {
+        finish([&](detail::FutureState<T>& state) { state.error = error; });
+    }
+
+private:
+    template<class Fill>
+    void finish(Fill fill) {
+        std::function<void()> continuation;
+        {
+            std::lock_guard<std::mutex> lock(m_state->mutex);
+            if (m_state->done) {
+                throw std::future_error(std::future_errc::promise_already_satisfied);
+            }
+            fill(*m_state);
+            m_state->done = true;
+            continuation = std::move(m_state->continuation);
+        }
+        m_state->ready.notify_all();
+
+        if (continuation) {
+            continuation();
+        }
+    }
+
+    std::shared_ptr<detail::FutureState<T>> m_state;  ///< Shared with the future
+};
+
+/**
+ * @class Future
+ * @brief Move-only future whose result can be chained with then()
+ *
+ * get(), wait() and wait_for() behave like std::future's. then() consumes
+ * the future and returns one for the continuation's result, so dependent
+ * steps compose without a thread blocking between them. A continuation
+ * runs on the thread that completes the future (for API requests, an
+ * ApiScheduler worker), or on a ThreadPool when one is given; if the
+ * future is already complete it runs right away on the caller. A
+ * continuation may return a Future, which is flattened. Errors skip
+ * continuations and surface from get().
+ */
+template<class T>
+class Future {
+public:
+    using State = detail::FutureState<T>;
+
+    Future() = default;
+    Future(Future&&) noexcept = default;
+    Future& operator=(Future&&) noexcept = default;
+    Future(const Future&) = delete;
+    Future& operator=(const Future&) = delete;
+
+    /**
+     * @brief Whether the future refers to a result not yet taken
+     */
+    bool valid() const {
+        return m_state != nullptr;
+    }
+
+    /**
+     * @brief Whether the result is available
+     */
+    bool isReady() const {
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        return m_state->done;
+    }
+
+    /**
+     * @brief Block until the result is available
+     */
+    void wait() const {
+        std::unique_lock<std::mutex> lock(m_state->mutex);
+        m_state->ready.wait(lock, [this]() { return m_state->done; });
+    }
+
+    /**
+     * @brief Block until the result is available or the timeout passes
+     */
+    template<class Rep, class Period>
+    std::future_status wait_for(const std::chrono::duration<Rep, Period>& timeout) const {
+        std::unique_lock<std::mutex> lock(m_state->mutex);
+        return m_state->ready.wait_for(lock, timeout, [this]() { return m_state->done; }) ?
+            std::future_status::ready : std::future_status::timeout;
+    }
+
+    /**
+     * @brief Wait for and take the result, rethrowing its error
+     */
+    T get() {
+        if (!m_state) {
+            throw std::future_error(std::future_errc::no_state);
+        }
+
+        std::shared_ptr<State> state = std::move(m_state);
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->ready.wait(lock, [&state]() { return state->done; });
+
+        if (state->error) {
+            std::rethrow_exception(state->error);
+        }
+        return std::move(*state->value);
+    }
+
+    /**
+     * @brief Chain a continuation run on the completing thread
+     * @param f Called with the value; may return a value or a Future
+     * @return Future with the continuation's result
+     */
+    template<class F>
+    auto then(F f) {
+        return chain(nullptr, std::move(f));
+    }
+
+    /**
+     * @brief Chain a continuation run on a thread pool
+     * @param pool Pool the continuation is enqueued on
+     * @param f Called with the value; may return a value or a Future
+     * @return Future with the continuation's result
+     */
+    template<class F>
+    auto then(ThreadPool& pool, F f) {
+        return chain(&pool, std::move(f));
+    }
+
+private:
+    template<class U> friend class Future;
+    template<class U> friend class Promise;
+    template<class U> friend Future<std::vector<U>> whenAll(std::vector<Future<U>> futures);
+
+    explicit Future(std::shared_ptr<State> state) : m_state(std::move(state)) {}
+
+    template<class F>
+    auto chain(ThreadPool* pool, F f) {
+        using Result = std::invoke_result_t<F, T>;
+        using Next = typename detail::Unwrap<Result>::Type;
+
+        if (!m_state) {
+            throw std::future_error(std::future_errc::no_state);
+        }
+
+        auto promise = std::make_shared<Promise<Next>>();
+        Future<Next> next = promise->getFuture();
+        std::shared_ptr<State> state = std::move(m_state);
+
+        auto run = [state, promise, f]() mutable {
+            if (state->error) {
+                promise->setException(state->error);
+                return;
+            }
+
+            try {
+                if constexpr (detail::Unwrap<Result>::isFuture) {
+                    f(std::move(*state->value)).forwardTo(promise);
+                } else {
+                    promise->setValue(f(std::move(*state->value)));
+                }
+            } catch (...) {
+                promise->setException(std::current_exception());
+            }
+        };
+
+        if (pool) {
+            state->subscribe([pool, run]() mutable {
+                try {
+                    pool->enqueue(run);
+                } catch (const std::exception&) {
+                    // The pool is stopping; finish on this thread rather than drop the result
+                    run();
+                }
+            });
+        } else {
+            state->subscribe(std::move(run));
+        }
+
+        return next;
+    }
+
+    void forwardTo(const std::shared_ptr<Promise<T>>& promise) {
+        std::shared_ptr<State> state = std::move(m_state);
+        state->subscribe([state, promise]() {
+            if (state->error) {
+                promise->setException(state->error);
+            } else {
+                promise->setValue(std::move(*state->value));
+            }
+        });
+    }
+
+    std::shared_ptr<State> m_state;  ///< Shared with the promise
+};
+
+/**
+ * @brief Make a future that is already complete
+ */
+template<class T>
+Future<std::decay_t<T>> makeReadyFuture(T&& value) {
+    Promise<std::decay_t<T>> promise;
+    promise.setValue(std::forward<T>(value));
+    return promise.getFuture();
+}
+
+/**
+ * @brief Combine futures into one for all of their values, in order
+ *
+ * Completes when the last future does, with the first error if any failed.
+ */
+template<class T>
+Future<std::vector<T>> whenAll(std::vector<Future<T>> futures) {
+    struct Gather {
+        std::mutex mutex;
+        std::vector<std::optional<T>> values;
+        size_t remaining = 0;
+        std::exception_ptr error;
+        Promise<std::vector<T>> promise;
+    };
+
+    if (futures.empty()) {
+        return makeReadyFuture(std::vector<T>());
+    }
+
+    auto gather = std::make_shared<Gather>();
+    gather->values.resize(futures.size());
+    gather->remaining = futures.size();
+    Future<std::vector<T>> all = gather->promise.getFuture();
+
+    for (size_t i = 0; i < futures.size(); ++i) {
+        std::shared_ptr<detail::FutureState<T>> state = std::move(futures[i].m_state);
+        state->subscribe([gather, state, i]() {
+            {
+                std::lock_guard<std::mutex> lock(gather->mutex);
+                if (state->error) {
+                    if (!gather->error) {
+                        gather->error = state->error;
+                    }
+                } else {
+                    gather->values[i] = std::move(state->value);
+                }
+
+                if (--gather->remaining > 0) {
+                    return;
+                }
+            }
+
+            if (gather->error) {
+                gather->promise.setException(gather->error);
+                return;
+            }
+
+            std::vector<T> values;
+            values.reserve(gather->values.size());
+            for (auto& value : gather->values) {
+                values.push_back(std::move(*value));
+            }
+            gather->promise.setValue(std::move(values));
+        });
+    }
+
+    return all;
+}
+
+}  // namespace BoxStrategy
@@ -4,13 +4,48 @@
  */
 
 #include "../utils/HttpClient.hpp"
+#include "../utils/ThreadTopology.hpp"
 #include <curl/curl.h>
 #include <thread>
+#include <chrono>
+#include <cerrno>
+#include <cstring>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
 
 namespace BoxStrategy {
 
-HttpClient::HttpClient(std::shared_ptr<Logger> logger)
-    : m_logger(logger), m_connectionTimeout(10000), m_requestTimeout(30000), m_initialized(false) {
+namespace {
+
+/**
+ * @brief Where streamCallback delivers a response body
+ */
+struct StreamTarget {
+    CURL* curl;                          ///< Transfer handle, for the status code
+    const HttpClient::BodySink* sink;    ///< Receives a 2xx body
+    std::string* body;                   ///< Buffers any other body
+};
+
+}  // namespace
+
+/**
+ * @brief One request from submission to completion
+ */
+struct HttpClient::Transfer {
+    CURL* curl = nullptr;                  ///< Easy handle from the pool
+    curl_slist* headerList = nullptr;      ///< Request headers, freed when the transfer is done
+    std::string body;                      ///< Request body, which curl reads in place
+    HttpResponse response{0, {}, {}, {}};  ///< Filled in as the transfer runs
+    BodySink sink;                         ///< Receives a streamed 2xx body
+    StreamTarget stream{};                 ///< streamCallback's view of the sink and body
+    Callback callback;                     ///< Receives the response, if set
+    std::promise<HttpResponse> promise;    ///< Receives the response otherwise
+};
+
+HttpClient::HttpClient(std::shared_ptr<Logger> logger, std::vector<int> ioCpus)
+    : m_logger(logger), m_connectionTimeout(10000), m_requestTimeout(30000), m_initialized(false),
+      m_ioCpus(std::move(ioCpus)) {
     init();
 }
 
@@ -22,6 +57,43 @@ void HttpClient::init() {
     std::lock_guard<std::mutex> lock(m_mutex);
     if (!m_initialized) {
         curl_global_init(CURL_GLOBAL_ALL);
+        
+        // Every handle resolves, resumes TLS sessions and reuses connections from the same caches
+        m_share = curl_share_init();
+        if (m_share) {
+            curl_share_setopt(m_share, CURLSHOPT_LOCKFUNC, HttpClient::lockShared);
+            curl_share_setopt(m_share, CURLSHOPT_UNLOCKFUNC, HttpClient::unlockShared);
+            curl_share_setopt(m_share, CURLSHOPT_USERDATA, this);
+            curl_share_setopt(m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+            curl_share_setopt(m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+            curl_share_setopt(m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+        } else {
+            m_logger->warn("Failed to create CURL share handle; connections are cached per handle");
+        }
+        
+        // The multi handle reports the sockets it needs watched; the loop watches them with epoll
+        m_multi = curl_multi_init();
+        m_epollFd = epoll_create1(EPOLL_CLOEXEC);
+        m_wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        
+        epoll_event wake{};
+        wake.events = EPOLLIN;
+        wake.data.fd = m_wakeFd;
+        
+        if (m_multi && m_epollFd >= 0 && m_wakeFd >= 0 &&
+            epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_wakeFd, &wake) == 0) {
+            curl_multi_setopt(m_multi, CURLMOPT_SOCKETFUNCTION, HttpClient::socketCallback);
+            curl_multi_setopt(m_multi, CURLMOPT_SOCKETDATA, this);
+            curl_multi_setopt(m_multi, CURLMOPT_TIMERFUNCTION, HttpClient::timerCallback);
+            curl_multi_setopt(m_multi, CURLMOPT_TIMERDATA, this);
+            
+            m_ioThread = std::thread(&HttpClient::runLoop, this);
+            m_ioThreadId = m_ioThread.get_id();
+        } else {
+            m_logger->error("Failed to set up the HTTP event loop ({}); requests run on the calling thread",
+                          std::strerror(errno));
+        }
+        
         m_initialized = true;
         m_logger->info("HttpClient initialized");
     }
@@ -30,6 +102,56 @@ void HttpClient::init() {
 void HttpClient::cleanup() {
     std::lock_guard<std::mutex> lock(m_mutex);
     if (m_initialized) {
+        {
+            std::lock_guard<std::mutex> submitLock(m_submitMutex);
+            m_stopping = true;
+        }
+        
+        if (m_ioThread.joinable()) {
+            uint64_t one = 1;
+            ssize_t written = ::write(m_wakeFd, &one, sizeof(one));
+            (void)written;
+            m_ioThread.join();
+        }
+        
+        // Whatever did not finish fails
+        for (auto& [curl, transfer] : m_active) {
+            curl_multi_remove_handle(m_multi, curl);
+            complete(std::move(transfer), CURLE_ABORTED_BY_CALLBACK);
+        }
+        m_active.clear();
+        
+        for (auto& transfer : m_submitted) {
+            complete(std::move(transfer), CURLE_ABORTED_BY_CALLBACK);
+        }
+        m_submitted.clear();
+        
+        if (m_multi) {
+            curl_multi_cleanup(m_multi);
+            m_multi = nullptr;
+        }
+        if (m_epollFd >= 0) {
+            ::close(m_epollFd);
+            m_epollFd = -1;
+        }
+        if (m_wakeFd >= 0) {
+            ::close(m_wakeFd);
+            m_wakeFd = -1;
+        }
+        
+        {
+            std::lock_guard<std::mutex> poolLock(m_poolMutex);
+            for (CURL* curl : m_idleHandles) {
+                curl_easy_cleanup(curl);
+            }
+            m_idleHandles.clear();
+        }
+        
+        if (m_share) {
+            curl_share_cleanup(m_share);
+            m_share = nullptr;
+        }
+        
         curl_global_cleanup();
         m_initialized = false;
         m_logger->info("HttpClient cleaned up");
@@ -40,38 +162,338 @@ HttpResponse HttpClient::request(HttpMethod method, const std::string& url,
                                const std::unordered_map<std::string, std::string>& headers,
                                const std::string& body) {
     m_logger->debug("Making {} request to {}", methodToString(method), url);
+    return requestAndWait(method, url, headers, body, nullptr);
+}
+
+HttpResponse HttpClient::request(HttpMethod method, const std::string& url,
+                               const std::unordered_map<std::string, std::string>& headers,
+                               const std::string& body,
+                               const BodySink& sink) {
+    m_logger->debug("Making streamed {} request to {}", methodToString(method), url);
+    return requestAndWait(method, url, headers, body, &sink);
+}
+
+std::future<HttpResponse> HttpClient::requestAsync(HttpMethod method, const std::string& url,
+                                                const std::unordered_map<std::string, std::string>& headers,
+                                                const std::string& body) {
+    auto transfer = prepare(method, url, headers, body, nullptr);
+    if (!transfer) {
+        std::promise<HttpResponse> failed;
+        failed.set_value(HttpResponse{0, {}, {}, {}});
+        return failed.get_future();
+    }
+    
+    std::future<HttpResponse> future = transfer->promise.get_future();
+    submit(std::move(transfer));
+    return future;
+}
+
+void HttpClient::requestAsync(HttpMethod method, const std::string& url,
+                            const std::unordered_map<std::string, std::string>& headers,
+                            const std::string& body,
+                            Callback callback) {
+    auto transfer = prepare(method, url, headers, body, nullptr);
+    if (!transfer) {
+        callback(HttpResponse{0, {}, {}, {}});
+        return;
+    }
     
-    HttpResponse response;
-    response.statusCode = 0;
+    transfer->callback = std::move(callback);
+    submit(std::move(transfer));
+}
+
+void HttpClient::requestAsync(HttpMethod method, const std::string& url,
+                            const std::unordered_map<std::string, std::string>& headers,
+                            const std::string& body,
+                            const BodySink& sink,
+                            Callback callback) {
+    auto transfer = prepare(method, url, headers, body, &sink);
+    if (!transfer) {
+        callback(HttpResponse{0, {}, {}, {}});
+        return;
+    }
+    
+    transfer->callback = std::move(callback);
+    submit(std::move(transfer));
+}
+
+std::unique_ptr<HttpClient::Transfer> HttpClient::prepare(
+    HttpMethod method, const std::string& url,
+    const std::unordered_map<std::string, std::string>& headers,
+    const std::string& body, const BodySink* sink) {
     
-    CURL* curl = curl_easy_init();
+    CURL* curl = acquireHandle();
     if (!curl) {
         m_logger->error("Failed to initialize CURL");
-        return response;
+        return nullptr;
+    }
+    
+    auto transfer = std::make_unique<Transfer>();
+    transfer->curl = curl;
+    transfer->body = body;
+    transfer->headerList = setCurlOptions(curl, method, url, headers, transfer->body,
+                                          transfer->response.headers, transfer->response.body);
+    
+    if (sink) {
+        transfer->sink = *sink;
+        transfer->stream = StreamTarget{curl, &transfer->sink, &transfer->response.body};
+        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, HttpClient::streamCallback);
+        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &transfer->stream);
+    }
+    
+    return transfer;
+}
+
+void HttpClient::submit(std::unique_ptr<Transfer> transfer) {
+    m_inFlight++;
+    
+    if (m_ioThreadId == std::thread::id()) {
+        CURLcode result = curl_easy_perform(transfer->curl);
+        complete(std::move(transfer), result);
+        return;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(m_submitMutex);
+        if (!m_stopping.load()) {
+            m_submitted.push_back(std::move(transfer));
+        }
     }
     
-    setCurlOptions(curl, method, url, headers, body, response.headers, response.body);
+    if (transfer) {
+        complete(std::move(transfer), CURLE_ABORTED_BY_CALLBACK);
+        return;
+    }
+    
+    // The loop picks up its own submissions before it next waits
+    if (std::this_thread::get_id() != m_ioThreadId) {
+        uint64_t one = 1;
+        ssize_t written = ::write(m_wakeFd, &one, sizeof(one));
+        (void)written;
+    }
+}
+
+HttpResponse HttpClient::requestAndWait(HttpMethod method, const std::string& url,
+                                      const std::unordered_map<std::string, std::string>& headers,
+                                      const std::string& body, const BodySink* sink) {
+    auto transfer = prepare(method, url, headers, body, sink);
+    if (!transfer) {
+        return HttpResponse{0, {}, {}, {}};
+    }
     
-    CURLcode res = curl_easy_perform(curl);
-    if (res != CURLE_OK) {
-        m_logger->error("CURL request failed: {} - {}", static_cast<int>(res), curl_easy_strerror(res));
+    std::future<HttpResponse> future = transfer->promise.get_future();
+    if (std::this_thread::get_id() == m_ioThreadId) {
+        m_inFlight++;
+        CURLcode result = curl_easy_perform(transfer->curl);
+        complete(std::move(transfer), result);
     } else {
-        long statusCode;
-        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &statusCode);
-        response.statusCode = static_cast<int>(statusCode);
-        m_logger->debug("Request completed with status code {}", response.statusCode);
+        submit(std::move(transfer));
+    }
+    return future.get();
+}
+
+void HttpClient::complete(std::unique_ptr<Transfer> transfer, CURLcode result) {
+    recordResult(transfer->curl, result, transfer->response);
+    
+    curl_slist_free_all(transfer->headerList);
+    releaseHandle(transfer->curl);
+    m_inFlight--;
+    
+    if (!transfer->callback) {
+        transfer->promise.set_value(std::move(transfer->response));
+        return;
     }
     
-    curl_easy_cleanup(curl);
-    return response;
+    try {
+        transfer->callback(std::move(transfer->response));
+    } catch (const std::exception& e) {
+        m_logger->error("Exception in HTTP callback: {}", e.what());
+    } catch (...) {
+        m_logger->error("Unknown exception in HTTP callback");
+    }
 }
 
-std::future<HttpResponse> HttpClient::requestAsync(HttpMethod method, const std::string& url,
-                                                const std::unordered_map<std::string, std::string>& headers,
-                                                const std::string& body) {
-    return std::async(std::launch::async, [this, method, url, headers, body]() {
-        return request(method, url, headers, body);
-    });
+void HttpClient::runLoop() {
+    if (!m_ioCpus.empty() && !ThreadTopology::pinCurrentThread(m_ioCpus)) {
+        m_logger->warn("Failed to pin the HTTP I/O thread to CPUs {}", ThreadTopology::formatCpuList(m_ioCpus));
+    }
+    
+    epoll_event events[64];
+    
+    while (!m_stopping.load()) {
+        addSubmitted();
+        
+        // Sleep until a socket is ready, a transfer is submitted or curl's timer is due
+        int timeoutMs = -1;
+        if (m_timerArmed) {
+            auto remaining = std::chrono::duration_cast<std::chrono::microseconds>(
+                m_timerDeadline - std::chrono::steady_clock::now()).count();
+            timeoutMs = static_cast<int>(std::max<int64_t>(0, (remaining + 999) / 1000));
+        }
+        
+        int count = epoll_wait(m_epollFd, events, 64, timeoutMs);
+        if (count < 0) {
+            if (errno != EINTR) {
+                m_logger->error("HTTP event loop wait failed: {}", std::strerror(errno));
+            }
+            continue;
+        }
+        
+        int running = 0;
+        for (int i = 0; i < count; ++i) {
+            int fd = events[i].data.fd;
+            
+            if (fd == m_wakeFd) {
+                uint64_t wakeups;
+                ssize_t drained = ::read(m_wakeFd, &wakeups, sizeof(wakeups));
+                (void)drained;
+                continue;
+            }
+            
+            int flags = 0;
+            if (events[i].events & EPOLLIN) flags |= CURL_CSELECT_IN;
+            if (events[i].events & EPOLLOUT) flags |= CURL_CSELECT_OUT;
+            if (events[i].events & (EPOLLERR | EPOLLHUP)) flags |= CURL_CSELECT_ERR;
+            
+            curl_multi_socket_action(m_multi, fd, flags, &running);
+        }
+        
+        if (m_timerArmed && std::chrono::steady_clock::now() >= m_timerDeadline) {
+            m_timerArmed = false;
+            curl_multi_socket_action(m_multi, CURL_SOCKET_TIMEOUT, 0, &running);
+        }
+        
+        collectFinished();
+    }
+}
+
+void HttpClient::addSubmitted() {
+    std::vector<std::unique_ptr<Transfer>> submitted;
+    {
+        std::lock_guard<std::mutex> lock(m_submitMutex);
+        submitted.swap(m_submitted);
+    }
+    
+    for (auto& transfer : submitted) {
+        CURL* curl = transfer->curl;
+        
+        CURLMcode code = curl_multi_add_handle(m_multi, curl);
+        if (code != CURLM_OK) {
+            m_logger->error("Failed to start HTTP transfer: {}", curl_multi_strerror(code));
+            complete(std::move(transfer), CURLE_FAILED_INIT);
+            continue;
+        }
+        
+        m_active.emplace(curl, std::move(transfer));
+    }
+}
+
+void HttpClient::collectFinished() {
+    int pending = 0;
+    while (CURLMsg* message = curl_multi_info_read(m_multi, &pending)) {
+        if (message->msg != CURLMSG_DONE) {
+            continue;
+        }
+        
+        CURL* curl = message->easy_handle;
+        CURLcode result = message->data.result;
+        curl_multi_remove_handle(m_multi, curl);
+        
+        auto it = m_active.find(curl);
+        if (it == m_active.end()) {
+            continue;
+        }
+        
+        std::unique_ptr<Transfer> transfer = std::move(it->second);
+        m_active.erase(it);
+        complete(std::move(transfer), result);
+    }
+}
+
+int HttpClient::socketCallback(CURL*, curl_socket_t socket, int what, void* userp, void* socketp) {
+    auto* client = static_cast<HttpClient*>(userp);
+    
+    if (what == CURL_POLL_REMOVE) {
+        epoll_ctl(client->m_epollFd, EPOLL_CTL_DEL, socket, nullptr);
+        return 0;
+    }
+    
+    epoll_event event{};
+    event.data.fd = socket;
+    event.events = ((what & CURL_POLL_IN) ? EPOLLIN : 0u) | ((what & CURL_POLL_OUT) ? EPOLLOUT : 0u);
+    
+    // A socket curl has seen before carries a non-null socketp
+    int operation = socketp ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+    if (epoll_ctl(client->m_epollFd, operation, socket, &event) != 0) {
+        int retry = errno == EEXIST ? EPOLL_CTL_MOD : errno == ENOENT ? EPOLL_CTL_ADD : -1;
+        if (retry < 0 || epoll_ctl(client->m_epollFd, retry, socket, &event) != 0) {
+            client->m_logger->error("Failed to watch HTTP socket {}: {}", socket, std::strerror(errno));
+        }
+    }
+    
+    if (!socketp) {
+        curl_multi_assign(client->m_multi, socket, client);
+    }
+    return 0;
+}
+
+int HttpClient::timerCallback(CURLM*, long timeoutMs, void* userp) {
+    auto* client = static_cast<HttpClient*>(userp);
+    
+    // Only ever called on the I/O thread, from inside curl_multi_add_handle or socket_action
+    client->m_timerArmed = timeoutMs >= 0;
+    if (client->m_timerArmed) {
+        client->m_timerDeadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    }
+    return 0;
+}
+
+size_t HttpClient::prewarm(const std::string& url, size_t connections) {
+    auto start = std::chrono::steady_clock::now();
+    
+    // Concurrent requests cannot share a connection, so each one opens its own
+    std::vector<std::future<HttpResponse>> futures;
+    for (size_t i = 0; i < connections; ++i) {
+        futures.push_back(requestAsync(HttpMethod::GET, url));
+    }
+    
+    size_t warmed = 0;
+    for (auto& future : futures) {
+        if (future.get().statusCode != 0) {
+            warmed++;
+        }
+    }
+    
+    auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    m_logger->info("Opened {} of {} connections to {} in {} ms", warmed, connections, url, elapsedMs);
+    return warmed;
+}
+
+void HttpClient::setMaxIdleConnections(size_t maxIdle) {
+    m_maxIdleHandles = std::max<size_t>(1, maxIdle);
+}
+
+HttpClientStats HttpClient::getStats() const {
+    HttpClientStats stats;
+    stats.requests = m_requests.load();
+    stats.reused = m_reused.load();
+    stats.failed = m_failed.load();
+    stats.inFlight = m_inFlight.load();
+    
+    uint64_t fresh = stats.requests - stats.reused;
+    if (fresh > 0) {
+        stats.averageConnectMs = m_connectUs.load() / 1000.0 / fresh;
+        stats.averageTlsMs = m_tlsUs.load() / 1000.0 / fresh;
+    }
+    if (stats.requests > 0) {
+        stats.averageFirstByteMs = m_firstByteUs.load() / 1000.0 / stats.requests;
+        stats.averageTotalMs = m_totalUs.load() / 1000.0 / stats.requests;
+    }
+    
+    std::lock_guard<std::mutex> lock(m_poolMutex);
+    stats.idleHandles = m_idleHandles.size();
+    return stats;
 }
 
 void HttpClient::setConnectionTimeout(long timeoutMs) {
@@ -82,11 +504,85 @@ void HttpClient::setRequestTimeout(long timeoutMs) {
     m_requestTimeout = timeoutMs;
 }
 
-void HttpClient::setCurlOptions(CURL* curl, HttpMethod method, const std::string& url,
-                              const std::unordered_map<std::string, std::string>& headers,
-                              const std::string& body,
-                              std::unordered_map<std::string, std::string>& responseHeaders,
-                              std::string& responseBody) {
+CURL* HttpClient::acquireHandle() {
+    {
+        std::lock_guard<std::mutex> lock(m_poolMutex);
+        if (!m_idleHandles.empty()) {
+            CURL* curl = m_idleHandles.back();
+            m_idleHandles.pop_back();
+            return curl;
+        }
+    }
+    
+    return curl_easy_init();
+}
+
+void HttpClient::releaseHandle(CURL* curl) {
+    // Clears the options of this request; the connection stays cached for the next one
+    curl_easy_reset(curl);
+    
+    {
+        std::lock_guard<std::mutex> lock(m_poolMutex);
+        if (m_idleHandles.size() < m_maxIdleHandles) {
+            m_idleHandles.push_back(curl);
+            return;
+        }
+    }
+    
+    curl_easy_cleanup(curl);
+}
+
+void HttpClient::recordResult(CURL* curl, CURLcode result, HttpResponse& response) {
+    if (result != CURLE_OK) {
+        m_failed++;
+        m_logger->error("CURL request failed: {} - {}", static_cast<int>(result), curl_easy_strerror(result));
+        return;
+    }
+    
+    long statusCode;
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &statusCode);
+    response.statusCode = static_cast<int>(statusCode);
+    
+    curl_off_t dnsUs = 0, connectUs = 0, tlsUs = 0, firstByteUs = 0, totalUs = 0;
+    long newConnections = 0;
+    curl_easy_getinfo(curl, CURLINFO_NAMELOOKUP_TIME_T, &dnsUs);
+    curl_easy_getinfo(curl, CURLINFO_CONNECT_TIME_T, &connectUs);
+    curl_easy_getinfo(curl, CURLINFO_APPCONNECT_TIME_T, &tlsUs);
+    curl_easy_getinfo(curl, CURLINFO_STARTTRANSFER_TIME_T, &firstByteUs);
+    curl_easy_getinfo(curl, CURLINFO_TOTAL_TIME_T, &totalUs);
+    curl_easy_getinfo(curl, CURLINFO_NUM_CONNECTS, &newConnections);
+    
+    HttpTiming& timing = response.timing;
+    timing.dnsMs = dnsUs / 1000.0;
+    timing.connectMs = connectUs / 1000.0;
+    timing.tlsMs = tlsUs / 1000.0;
+    timing.firstByteMs = firstByteUs / 1000.0;
+    timing.totalMs = totalUs / 1000.0;
+    timing.reused = newConnections == 0;
+    
+    m_requests++;
+    if (timing.reused) {
+        m_reused++;
+    } else {
+        m_connectUs += static_cast<uint64_t>(connectUs);
+        m_tlsUs += static_cast<uint64_t>(tlsUs > connectUs ? tlsUs - connectUs : 0);
+    }
+    m_firstByteUs += static_cast<uint64_t>(firstByteUs);
+    m_totalUs += static_cast<uint64_t>(totalUs);
+    
+    m_logger->debug("Request completed with status code {} in {:.1f} ms ({}, first byte at {:.1f} ms)",
+                  response.statusCode, timing.totalMs,
+                  timing.reused ? "reused connection" :
+                      fmt::format("dns {:.1f} ms, connect {:.1f} ms, tls {:.1f} ms",
+                                  timing.dnsMs, timing.connectMs, timing.tlsMs),
+                  timing.firstByteMs);
+}
+
+curl_slist* HttpClient::setCurlOptions(CURL* curl, HttpMethod method, const std::string& url,
+                                     const std::unordered_map<std::string, std::string>& headers,
+                                     const std::string& body,
+                                     std::unordered_map<std::string, std::string>& responseHeaders,
+                                     std::string& responseBody) {
     // Set URL
     curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
     
@@ -94,6 +590,17 @@ void HttpClient::setCurlOptions(CURL* curl, HttpMethod method, const std::string
     curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT_MS, m_connectionTimeout);
     curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, m_requestTimeout);
     
+    // Shared caches, and connections that stay open between requests
+    if (m_share) {
+        curl_easy_setopt(curl, CURLOPT_SHARE, m_share);
+    }
+    curl_easy_setopt(curl, CURLOPT_MAXCONNECTS, static_cast<long>(m_maxIdleHandles.load()));
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(curl, CURLOPT_TCP_NODELAY, 1L);
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPIDLE, 30L);
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPINTVL, 15L);
+    
     // Set up response callbacks
     curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, HttpClient::writeCallback);
     curl_easy_setopt(curl, CURLOPT_WRITEDATA, &responseBody);
@@ -142,6 +649,16 @@ void HttpClient::setCurlOptions(CURL* curl, HttpMethod method, const std::string
     #ifdef DEBUG
     curl_easy_setopt(curl, CURLOPT_VERBOSE, 1L);
     #endif
+    
+    return headerList;
+}
+
+void HttpClient::lockShared(CURL*, curl_lock_data data, curl_lock_access, void* userp) {
+    static_cast<HttpClient*>(userp)->m_shareLocks[data].lock();
+}
+
+void HttpClient::unlockShared(CURL*, curl_lock_data data, void* userp) {
+    static_cast<HttpClient*>(userp)->m_shareLocks[data].unlock();
 }
 
 std::string HttpClient::methodToString(HttpMethod method) {
@@ -161,6 +678,22 @@ size_t HttpClient::writeCallback(void* data, size_t size, size_t nmemb, void* us
     return realSize;
 }
 
+size_t HttpClient::streamCallback(void* data, size_t size, size_t nmemb, void* userp) {
+    size_t realSize = size * nmemb;
+    StreamTarget* target = static_cast<StreamTarget*>(userp);
+    
+    // The status line has been received by the time the body arrives
+    long statusCode = 0;
+    curl_easy_getinfo(target->curl, CURLINFO_RESPONSE_CODE, &statusCode);
+    
+    if (statusCode >= 200 && statusCode < 300) {
+        return (*target->sink)(static_cast<const char*>(data), realSize) ? realSize : 0;
+    }
+    
+    target->body->append(static_cast<char*>(data), realSize);
+    return realSize;
+}
+
 size_t HttpClient::headerCallback(void* data, size_t size, size_t nmemb, void* userp) {
     size_t realSize = size * nmemb;
     std::string header(static_cast<char*>(data), realSize);
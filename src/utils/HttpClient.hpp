@@ -9,6 +9,12 @@
 #include <unordered_map>
 #include <memory>
 #include <future>
+#include <functional>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <chrono>
 #include <curl/curl.h>
 #include "../utils/Logger.hpp"
 
@@ -25,6 +31,19 @@ enum class HttpMethod {
     DELETE
 };
 
+/**
+ * @struct HttpTiming
+ * @brief Where the time of one request went, each phase measured from the start
+ */
+struct HttpTiming {
+    double dnsMs = 0.0;          ///< Name resolution done
+    double connectMs = 0.0;      ///< TCP connection established
+    double tlsMs = 0.0;          ///< TLS handshake done (0 for plain HTTP)
+    double firstByteMs = 0.0;    ///< First response byte received
+    double totalMs = 0.0;        ///< Transfer complete
+    bool reused = false;         ///< Sent on a kept-alive connection, so no connect or handshake
+};
+
 /**
  * @struct HttpResponse
  * @brief HTTP response data
@@ -33,19 +52,62 @@ struct HttpResponse {
     int statusCode;                              ///< HTTP status code
     std::string body;                            ///< Response body
     std::unordered_map<std::string, std::string> headers;  ///< Response headers
+    HttpTiming timing = {};                      ///< Timing breakdown of the transfer
+};
+
+/**
+ * @struct HttpClientStats
+ * @brief Connection reuse and average phase times of all requests so far
+ */
+struct HttpClientStats {
+    uint64_t requests = 0;           ///< Completed transfers
+    uint64_t reused = 0;             ///< Transfers sent on a kept-alive connection
+    uint64_t failed = 0;             ///< Transfers that failed below HTTP
+    double averageConnectMs = 0.0;   ///< DNS plus TCP connect, over new connections
+    double averageTlsMs = 0.0;       ///< TLS handshake, over new connections
+    double averageFirstByteMs = 0.0; ///< Time to first byte, over all transfers
+    double averageTotalMs = 0.0;     ///< Total time, over all transfers
+    size_t idleHandles = 0;          ///< Handles waiting in the pool
+    size_t inFlight = 0;             ///< Transfers submitted and not yet complete
 };
 
 /**
  * @class HttpClient
  * @brief Thread-safe HTTP client for making API requests
+ *
+ * All transfers run on one I/O thread driving a curl multi handle from
+ * epoll, so any number of requests can be in flight without a thread
+ * each. Asynchronous requests complete a future or call a callback on the
+ * I/O thread; the synchronous request() submits one and waits for it.
+ *
+ * Requests check an easy handle out of a pool and return it afterwards, so
+ * their connections stay open for the next request to the same host. All
+ * handles share one DNS cache, TLS session cache and connection cache
+ * through a share handle, so any idle connection to a host can serve any
+ * request. prewarm opens connections ahead of the first real request.
  */
 class HttpClient {
 public:
+    /**
+     * @brief Receives a successful response body chunk by chunk as it arrives
+     * @return False to abort the transfer
+     */
+    using BodySink = std::function<bool(const char* data, size_t size)>;
+
+    /**
+     * @brief Receives the response of an asynchronous request, on the I/O thread
+     *
+     * Callbacks hold up every other transfer while they run, so they should
+     * hand real work to another thread.
+     */
+    using Callback = std::function<void(HttpResponse response)>;
+
     /**
      * @brief Constructor
      * @param logger Logger instance
+     * @param ioCpus CPUs the I/O loop thread is pinned to; empty leaves it unpinned
      */
-    explicit HttpClient(std::shared_ptr<Logger> logger);
+    explicit HttpClient(std::shared_ptr<Logger> logger, std::vector<int> ioCpus = {});
     
     /**
      * @brief Destructor
@@ -64,18 +126,88 @@ public:
                         const std::unordered_map<std::string, std::string>& headers = {},
                         const std::string& body = "");
     
+    /**
+     * @brief Perform a synchronous HTTP request, streaming a 2xx body to a sink
+     *
+     * The body of a 2xx response is handed to the sink as it arrives and is
+     * not kept in the returned response; other responses are buffered as usual.
+     *
+     * @param method HTTP method
+     * @param url URL to request
+     * @param headers HTTP headers
+     * @param body Request body
+     * @param sink Receives the response body
+     * @return HTTP response (status code 0 if the transfer failed or the sink aborted it)
+     */
+    HttpResponse request(HttpMethod method, const std::string& url,
+                        const std::unordered_map<std::string, std::string>& headers,
+                        const std::string& body,
+                        const BodySink& sink);
+    
     /**
      * @brief Perform an asynchronous HTTP request
      * @param method HTTP method
      * @param url URL to request
      * @param headers HTTP headers
      * @param body Request body
-     * @return Future HTTP response
+     * @return Future HTTP response, completed by the I/O thread
      */
     std::future<HttpResponse> requestAsync(HttpMethod method, const std::string& url,
                                           const std::unordered_map<std::string, std::string>& headers = {},
                                           const std::string& body = "");
     
+    /**
+     * @brief Perform an asynchronous HTTP request, calling back with the response
+     * @param method HTTP method
+     * @param url URL to request
+     * @param headers HTTP headers
+     * @param body Request body
+     * @param callback Receives the response on the I/O thread
+     */
+    void requestAsync(HttpMethod method, const std::string& url,
+                      const std::unordered_map<std::string, std::string>& headers,
+                      const std::string& body,
+                      Callback callback);
+    
+    /**
+     * @brief Perform an asynchronous HTTP request, streaming a 2xx body to a sink
+     * @param method HTTP method
+     * @param url URL to request
+     * @param headers HTTP headers
+     * @param body Request body
+     * @param sink Receives the response body on the I/O thread
+     * @param callback Receives the response on the I/O thread
+     */
+    void requestAsync(HttpMethod method, const std::string& url,
+                      const std::unordered_map<std::string, std::string>& headers,
+                      const std::string& body,
+                      const BodySink& sink,
+                      Callback callback);
+    
+    /**
+     * @brief Open connections to a host ahead of time
+     *
+     * Sends concurrent GET requests to the URL, so that each leaves a
+     * kept-alive connection with a completed TLS handshake in the cache.
+     *
+     * @param url URL on the host, e.g. the API base URL
+     * @param connections Number of connections to open
+     * @return Number of requests that got an HTTP response
+     */
+    size_t prewarm(const std::string& url, size_t connections);
+    
+    /**
+     * @brief Set the number of idle handles and cached connections kept
+     * @param maxIdle Handles kept in the pool; the connection cache holds as many connections
+     */
+    void setMaxIdleConnections(size_t maxIdle);
+    
+    /**
+     * @brief Get connection reuse and timing statistics
+     * @return Statistics of all requests so far
+     */
+    HttpClientStats getStats() const;
+    
     /**
      * @brief Set connection timeout
      * @param timeoutMs Timeout in milliseconds
@@ -99,6 +231,82 @@ private:
      */
     void cleanup();
     
+    struct Transfer;
+    
+    /**
+     * @brief Create a transfer with its handle and options set
+     * @return Transfer, or nullptr if no handle could be created
+     */
+    std::unique_ptr<Transfer> prepare(HttpMethod method, const std::string& url,
+                                      const std::unordered_map<std::string, std::string>& headers,
+                                      const std::string& body, const BodySink* sink);
+    
+    /**
+     * @brief Hand a transfer to the I/O thread
+     */
+    void submit(std::unique_ptr<Transfer> transfer);
+    
+    /**
+     * @brief Send a request and wait for its response
+     *
+     * Called from the I/O thread itself (a callback making a synchronous
+     * request) the transfer is performed right away, as waiting for the loop
+     * would deadlock it.
+     */
+    HttpResponse requestAndWait(HttpMethod method, const std::string& url,
+                                const std::unordered_map<std::string, std::string>& headers,
+                                const std::string& body, const BodySink* sink);
+    
+    /**
+     * @brief Deliver a finished transfer's response and return its handle to the pool
+     */
+    void complete(std::unique_ptr<Transfer> transfer, CURLcode result);
+    
+    /**
+     * @brief I/O thread body: waits on epoll and drives the multi handle
+     */
+    void runLoop();
+    
+    /**
+     * @brief Add submitted transfers to the multi handle
+     */
+    void addSubmitted();
+    
+    /**
+     * @brief Complete every transfer the multi handle reports as done
+     */
+    void collectFinished();
+    
+    /**
+     * @brief Multi handle socket callback: registers sockets with epoll
+     */
+    static int socketCallback(CURL* curl, curl_socket_t socket, int what, void* userp, void* socketp);
+    
+    /**
+     * @brief Multi handle timer callback: sets when the loop must call back into curl
+     */
+    static int timerCallback(CURLM* multi, long timeoutMs, void* userp);
+    
+    /**
+     * @brief Take an idle handle from the pool, or create one
+     * @return CURL handle, nullptr if none could be created
+     */
+    CURL* acquireHandle();
+    
+    /**
+     * @brief Return a handle to the pool; its connection stays in the shared cache
+     * @param curl CURL handle
+     */
+    void releaseHandle(CURL* curl);
+    
+    /**
+     * @brief Fill in status and timing of a finished transfer and update the statistics
+     * @param curl CURL handle of the transfer
+     * @param result Transfer result
+     * @param response Response to fill in
+     */
+    void recordResult(CURL* curl, CURLcode result, HttpResponse& response);
+    
     /**
      * @brief Set common curl options
      * @param curl CURL handle
@@ -108,12 +316,23 @@ private:
      * @param body Request body
      * @param responseHeaders Response headers
      * @param responseBody Response body
+     * @return Request header list, which must outlive the transfer and then be freed
      */
-    void setCurlOptions(CURL* curl, HttpMethod method, const std::string& url,
-                        const std::unordered_map<std::string, std::string>& headers,
-                        const std::string& body,
-                        std::unordered_map<std::string, std::string>& responseHeaders,
-                        std::string& responseBody);
+    curl_slist* setCurlOptions(CURL* curl, HttpMethod method, const std::string& url,
+                               const std::unordered_map<std::string, std::string>& headers,
+                               const std::string& body,
+                               std::unordered_map<std::string, std::string>& responseHeaders,
+                               std::string& responseBody);
+    
+    /**
+     * @brief Share handle lock callback
+     */
+    static void lockShared(CURL* curl, curl_lock_data data, curl_lock_access access, void* userp);
+    
+    /**
+     * @brief Share handle unlock callback
+     */
+    static void unlockShared(CURL* curl, curl_lock_data data, void* userp);
     
     /**
      * @brief Convert HTTP method to string
@@ -132,6 +351,16 @@ private:
      */
     static size_t writeCallback(void* data, size_t size, size_t nmemb, void* userp);
     
+    /**
+     * @brief CURL write callback for streamed requests
+     * @param data Data received
+     * @param size Size of each data element
+     * @param nmemb Number of data elements
+     * @param userp Stream target
+     * @return Number of bytes handled, 0 to abort
+     */
+    static size_t streamCallback(void* data, size_t size, size_t nmemb, void* userp);
+    
     /**
      * @brief CURL header callback
      * @param data Header data received
@@ -147,6 +376,38 @@ private:
     long m_requestTimeout;             ///< Request timeout in milliseconds
     bool m_initialized;                ///< Whether libcurl is initialized
     std::mutex m_mutex;                ///< Mutex for thread safety
+    
+    CURLSH* m_share = nullptr;                         ///< DNS, TLS session and connection caches
+    std::mutex m_shareLocks[CURL_LOCK_DATA_LAST];      ///< One lock per shared cache
+    
+    std::vector<CURL*> m_idleHandles;                  ///< Handles ready for the next request
+    std::atomic<size_t> m_maxIdleHandles{32};          ///< Pool size
+    mutable std::mutex m_poolMutex;                    ///< Guards m_idleHandles
+    
+    std::atomic<uint64_t> m_requests{0};               ///< Completed transfers
+    std::atomic<uint64_t> m_reused{0};                 ///< Transfers on kept-alive connections
+    std::atomic<uint64_t> m_failed{0};                 ///< Failed transfers
+    std::atomic<uint64_t> m_connectUs{0};              ///< Sum of connect times of new connections
+    std::atomic<uint64_t> m_tlsUs{0};                  ///< Sum of TLS handshake times of new connections
+    std::atomic<uint64_t> m_firstByteUs{0};            ///< Sum of times to first byte
+    std::atomic<uint64_t> m_totalUs{0};                ///< Sum of total times
+    
+    CURLM* m_multi = nullptr;                          ///< Drives all transfers
+    int m_epollFd = -1;                                ///< Sockets of the transfers, and m_wakeFd
+    int m_wakeFd = -1;                                 ///< eventfd that wakes the loop for new transfers
+    std::thread m_ioThread;                            ///< Runs the loop
+    std::vector<int> m_ioCpus;                         ///< CPUs the loop thread is pinned to, if any
+    std::thread::id m_ioThreadId;                      ///< Loop thread, or none if the loop failed to start
+    std::atomic<bool> m_stopping{false};               ///< Whether the loop should exit
+    
+    std::vector<std::unique_ptr<Transfer>> m_submitted;    ///< Transfers waiting to be added
+    std::mutex m_submitMutex;                          ///< Guards m_submitted
+    std::atomic<size_t> m_inFlight{0};                 ///< Submitted transfers not yet complete
+    
+    // Used by the I/O thread only
+    std::unordered_map<CURL*, std::unique_ptr<Transfer>> m_active;  ///< Transfers in the multi handle
+    std::chrono::steady_clock::time_point m_timerDeadline; ///< When curl wants its timeout action
+    bool m_timerArmed = false;                         ///< Whether m_timerDeadline is set
 };
 
 }  // namespace BoxStrategy
\ No newline at end of file
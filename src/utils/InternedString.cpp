@@ -0,0 +1,85 @@
+/**
+ * @file InternedString.cpp
+ * @brief Implementation of the InternedString class
+ */
+
+#include "../utils/InternedString.hpp"
+#include <deque>
+#include <unordered_map>
+#include <shared_mutex>
+#include <mutex>
+
+namespace BoxStrategy {
+
+namespace {
+
+/**
+ * @brief Process-wide intern table
+ *
+ * Entries live in a deque so their addresses never change; the map is
+ * keyed by views into the stored strings.
+ */
+class InternTable {
+public:
+    InternTable() {
+        m_entries.push_back(InternedString::Entry{std::string(), 0});
+        m_index.emplace(std::string_view(m_entries.back().value), &m_entries.back());
+    }
+
+    const InternedString::Entry* empty() const { return &m_entries.front(); }
+
+    const InternedString::Entry* intern(std::string_view value) {
+        {
+            std::shared_lock<std::shared_mutex> lock(m_mutex);
+            auto it = m_index.find(value);
+            if (it != m_index.end()) {
+                return it->second;
+            }
+        }
+
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+
+        // Another thread may have interned it between the two locks
+        auto it = m_index.find(value);
+        if (it != m_index.end()) {
+            return it->second;
+        }
+
+        m_entries.push_back(InternedString::Entry{std::string(value), static_cast<uint32_t>(m_entries.size())});
+        const InternedString::Entry* entry = &m_entries.back();
+        m_index.emplace(std::string_view(entry->value), entry);
+        return entry;
+    }
+
+    size_t size() const {
+        std::shared_lock<std::shared_mutex> lock(m_mutex);
+        return m_entries.size();
+    }
+
+private:
+    std::deque<InternedString::Entry> m_entries;
+    std::unordered_map<std::string_view, const InternedString::Entry*> m_index;
+    mutable std::shared_mutex m_mutex;
+};
+
+InternTable& table() {
+    // Intentionally leaked so handles stay valid during static destruction
+    static InternTable* instance = new InternTable();
+    return *instance;
+}
+
+}  // namespace
+
+InternedString::InternedString()
+    : m_entry(table().empty()) {
+}
+
+InternedString::InternedString(std::string_view value)
+    : m_entry(value.empty() ? table().empty() : table().intern(value)) {
+}
+
+size_t InternedString::tableSize() {
+    return table().size();
+}
+
+}  // namespace BoxStrategy
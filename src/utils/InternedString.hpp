@@ -0,0 +1,141 @@
+/**
+ * @file InternedString.hpp
+ * @brief Process-wide interned strings for low-cardinality fields
+ */
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <fmt/format.h>
+
+namespace BoxStrategy {
+
+/**
+ * @class InternedString
+ * @brief Handle to a string stored once in a process-wide table
+ *
+ * Equal strings share one table entry, so an InternedString is a single
+ * pointer and equality between two of them is a pointer compare. Entries
+ * are never freed, which keeps handles valid for the life of the process;
+ * use it for fields with few distinct values (exchange, segment,
+ * underlying, name), not for per-instrument values like trading symbols.
+ */
+class InternedString {
+public:
+    /**
+     * @brief Constructor, the empty string
+     */
+    InternedString();
+
+    /**
+     * @brief Constructor, interns the given value
+     * @param value String value
+     */
+    InternedString(std::string_view value);
+
+    /**
+     * @brief Constructor, interns the given value
+     * @param value String value
+     */
+    InternedString(const std::string& value) : InternedString(std::string_view(value)) {}
+
+    /**
+     * @brief Constructor, interns the given value
+     * @param value Null-terminated string value
+     */
+    InternedString(const char* value) : InternedString(std::string_view(value)) {}
+
+    /**
+     * @brief Get the string value
+     * @return Interned string
+     */
+    const std::string& str() const { return m_entry->value; }
+
+    /**
+     * @brief Implicit conversion for APIs taking const std::string&
+     */
+    operator const std::string&() const { return m_entry->value; }
+
+    /**
+     * @brief Get the dense ID of the string, unique per distinct value
+     * @return ID (0 is the empty string)
+     */
+    uint32_t id() const { return m_entry->id; }
+
+    /**
+     * @brief Check if the string is empty
+     * @return True if empty
+     */
+    bool empty() const { return m_entry->value.empty(); }
+
+    /**
+     * @brief Get the length of the string
+     * @return Length in bytes
+     */
+    size_t size() const { return m_entry->value.size(); }
+
+    /**
+     * @brief Get the number of distinct interned strings
+     * @return Table size
+     */
+    static size_t tableSize();
+
+    friend bool operator==(const InternedString& a, const InternedString& b) { return a.m_entry == b.m_entry; }
+    friend bool operator!=(const InternedString& a, const InternedString& b) { return a.m_entry != b.m_entry; }
+    friend bool operator==(const InternedString& a, std::string_view b) { return a.str() == b; }
+    friend bool operator!=(const InternedString& a, std::string_view b) { return a.str() != b; }
+    friend bool operator==(std::string_view a, const InternedString& b) { return a == b.str(); }
+    friend bool operator!=(std::string_view a, const InternedString& b) { return a != b.str(); }
+    friend bool operator==(const InternedString& a, const std::string& b) { return a.str() == b; }
+    friend bool operator!=(const InternedString& a, const std::string& b) { return a.str() != b; }
+    friend bool operator==(const std::string& a, const InternedString& b) { return a == b.str(); }
+    friend bool operator!=(const std::string& a, const InternedString& b) { return a != b.str(); }
+    friend bool operator==(const InternedString& a, const char* b) { return a.str() == b; }
+    friend bool operator!=(const InternedString& a, const char* b) { return a.str() != b; }
+    friend bool operator==(const char* a, const InternedString& b) { return a == b.str(); }
+    friend bool operator!=(const char* a, const InternedString& b) { return a != b.str(); }
+
+    friend std::string operator+(const std::string& a, const InternedString& b) { return a + b.str(); }
+    friend std::string operator+(const InternedString& a, const std::string& b) { return a.str() + b; }
+    friend std::string operator+(const InternedString& a, const char* b) { return a.str() + b; }
+
+    friend std::ostream& operator<<(std::ostream& os, const InternedString& value) { return os << value.str(); }
+
+    /**
+     * @struct Entry
+     * @brief One slot of the intern table
+     */
+    struct Entry {
+        std::string value;   ///< String value
+        uint32_t id;         ///< Dense ID
+    };
+
+private:
+    const Entry* m_entry;    ///< Table entry, never null
+};
+
+}  // namespace BoxStrategy
+
+namespace std {
+
+template<>
+struct hash<BoxStrategy::InternedString> {
+    size_t operator()(const BoxStrategy::InternedString& value) const noexcept {
+        return std::hash<uint32_t>()(value.id());
+    }
+};
+
+}  // namespace std
+
+template<>
+struct fmt::formatter<BoxStrategy::InternedString> : fmt::formatter<fmt::string_view> {
+    template<typename FormatContext>
+    auto format(const BoxStrategy::InternedString& value, FormatContext& ctx) const {
+        return fmt::formatter<fmt::string_view>::format(
+            fmt::string_view(value.str().data(), value.size()), ctx);
+    }
+};
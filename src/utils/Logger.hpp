@@ -11,6 +11,7 @@
 #include <memory>
 #include <chrono>
 #include <sstream>
+#include <iomanip>
 #include <iostream>
 #include <fmt/format.h>
 
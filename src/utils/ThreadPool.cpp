@@ -4,179 +4,377 @@
  */
 
 #include "../utils/ThreadPool.hpp"
+#include "../utils/WorkStealingDeque.hpp"
 
 namespace BoxStrategy {
 
-ThreadPool::ThreadPool(size_t numThreads, std::shared_ptr<Logger> logger)
-    : m_stop(false), m_activeTaskCount(0), m_logger(logger) {
+/**
+ * @brief Per-worker state; lives in a slot that is never freed while the pool runs
+ */
+struct ThreadPool::Worker {
+    Worker(ThreadPool* owner, size_t slot, int numaNode) : pool(owner), index(slot), node(numaNode) {}
+
+    ThreadPool* pool;                   ///< Pool the worker belongs to
+    size_t index;                       ///< Slot index
+    int node;                           ///< NUMA node of the worker's placement
+    WorkStealingDeque<Task> deque;      ///< Tasks enqueued by this worker
+    std::thread thread;                 ///< Worker thread, joinable until reaped
+    std::atomic<bool> retiring{false};  ///< Set by resize to make the worker exit
+    size_t nextVictim = 0;              ///< Rotates the first worker to steal from
+};
+
+thread_local ThreadPool::Worker* ThreadPool::s_currentWorker = nullptr;
+
+ThreadPool::ThreadPool(size_t numThreads, std::shared_ptr<Logger> logger,
+                       std::vector<WorkerPlacement> placements)
+    : m_workers(MAX_WORKERS), m_placements(std::move(placements)),
+      m_stop(false), m_activeTaskCount(0), m_logger(logger) {
+    for (const auto& placement : m_placements) {
+        m_multiNode = m_multiNode || placement.node != m_placements.front().node;
+    }
+    
+    if (numThreads > MAX_WORKERS) {
+        m_logger->warn("Thread pool limited to {} threads, {} requested", MAX_WORKERS, numThreads);
+        numThreads = MAX_WORKERS;
+    }
     m_logger->info("Initializing thread pool with {} threads", numThreads);
     
     // Create worker threads
+    std::lock_guard<std::mutex> workersLock(m_workersMutex);
     for (size_t i = 0; i < numThreads; ++i) {
-        m_workers.emplace_back([this, i] {
-            m_logger->debug("Worker thread {} started", i);
-            this->workerThread();
-            m_logger->debug("Worker thread {} stopped", i);
-        });
+        startWorker(i);
     }
+    m_numThreads = numThreads;
 }
 
 ThreadPool::~ThreadPool() {
     m_logger->info("Shutting down thread pool");
     
     {
-        std::lock_guard<std::mutex> lock(m_queueMutex);
+        std::lock_guard<std::mutex> lock(m_injectMutex);
         m_stop = true;
     }
     
     // Wake up all worker threads
-    m_condition.notify_all();
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_sleepCondition.notify_all();
+    }
     
-    // Join all worker threads
-    for (std::thread& worker : m_workers) {
-        worker.join();
+    // Join all worker threads, including retired ones not yet reaped
+    size_t slots = m_workerSlots.load(std::memory_order_acquire);
+    for (size_t i = 0; i < slots; ++i) {
+        if (m_workers[i]->thread.joinable()) {
+            m_workers[i]->thread.join();
+        }
+    }
+    
+    // A worker retiring during shutdown may have handed tasks over after the
+    // others exited; run them here rather than break their futures
+    for (size_t i = 0; i < slots; ++i) {
+        while (Task* task = m_workers[i]->deque.pop()) {
+            runTask(task);
+        }
+    }
+    while (!m_injected.empty()) {
+        Task* task = m_injected.front();
+        m_injected.pop_front();
+        runTask(task);
     }
     
     m_logger->info("Thread pool shutdown complete");
 }
 
 void ThreadPool::resize(size_t numThreads) {
+    // Concurrent scans may resize at the same time
+    std::lock_guard<std::mutex> workersLock(m_workersMutex);
+    
+    if (numThreads > MAX_WORKERS) {
+        m_logger->warn("Thread pool limited to {} threads, {} requested", MAX_WORKERS, numThreads);
+        numThreads = MAX_WORKERS;
+    }
+    
     // Handle case where size doesn't need to change
-    if (numThreads == m_workers.size()) {
+    if (numThreads == m_numThreads) {
         return;
     }
     
     // Log the resize operation
-    m_logger->info("Resizing thread pool from {} to {} threads", m_workers.size(), numThreads);
+    m_logger->info("Resizing thread pool from {} to {} threads", m_numThreads, numThreads);
     
     // Handle case where we need to increase the number of threads
-    if (numThreads > m_workers.size()) {
-        size_t oldSize = m_workers.size();
+    if (numThreads > m_numThreads) {
+        size_t oldSize = m_numThreads;
         for (size_t i = oldSize; i < numThreads; ++i) {
-            m_workers.emplace_back([this, i] {
-                m_logger->debug("Worker thread {} started (resized pool)", i);
-                this->workerThread();
-                m_logger->debug("Worker thread {} stopped", i);
-            });
+            startWorker(i);
         }
+        m_numThreads = numThreads;
         m_logger->info("Added {} new worker threads", numThreads - oldSize);
         return;
     }
     
-    // Handle case where we need to decrease the number of threads
-    if (numThreads < m_workers.size()) {
-        // Create a temporary vector to hold threads to be removed
-        size_t numToRemove = m_workers.size() - numThreads;
-        std::vector<std::thread> threadsToRemove;
-        
-        // Move threads that we want to remove to the temporary vector
-        {
-            std::lock_guard<std::mutex> lock(m_queueMutex);
-            
-            // Set a flag to indicate which threads should exit
-            m_threadsToStop = numToRemove;
-            
-            // Wake up all worker threads so they can check if they should exit
-            m_condition.notify_all();
+    // Scale down by retiring the highest slots. A retiring worker finishes its
+    // current task, hands its queued tasks to the injection queue and exits;
+    // its thread is reaped when the slot is reused or the pool is destroyed,
+    // so resizing never waits on a running task.
+    for (size_t i = numThreads; i < m_numThreads; ++i) {
+        m_workers[i]->retiring.store(true);
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_sleepCondition.notify_all();
+    }
+    
+    m_logger->info("Scaling down thread pool by {} threads", m_numThreads - numThreads);
+    m_numThreads = numThreads;
+}
+
+void ThreadPool::startWorker(size_t index) {
+    if (!m_workers[index]) {
+        // Slots are created in order; publish the slot before thieves may scan it
+        int node = index < m_placements.size() ? m_placements[index].node : 0;
+        m_workers[index] = std::make_unique<Worker>(this, index, node);
+        m_workerSlots.store(index + 1, std::memory_order_release);
+    }
+    
+    Worker& worker = *m_workers[index];
+    if (worker.thread.joinable()) {
+        if (worker.thread.get_id() == std::this_thread::get_id()) {
+            // Resized back up from a task on this very worker: keep it running
+            worker.retiring.store(false);
+            return;
         }
+        worker.thread.join();
+    }
+    
+    worker.retiring.store(false);
+    worker.thread = std::thread([this, &worker] {
+        if (worker.index < m_placements.size() && !m_placements[worker.index].cpus.empty() &&
+            !ThreadTopology::pinCurrentThread(m_placements[worker.index].cpus)) {
+            m_logger->warn("Failed to pin worker thread {} to CPUs {}", worker.index,
+                         ThreadTopology::formatCpuList(m_placements[worker.index].cpus));
+        }
+        m_logger->debug("Worker thread {} started", worker.index);
+        this->workerThread(worker);
+        m_logger->debug("Worker thread {} stopped", worker.index);
+    });
+}
+
+void ThreadPool::submit(Task* task) {
+    Worker* worker = s_currentWorker;
+    
+    m_pendingTaskCount.fetch_add(1);
+    if (worker && worker->pool == this) {
+        // Local submission: lock-free push onto this worker's own deque. The
+        // worker drains it before exiting, so this is safe while stopping.
+        worker->deque.push(task);
+    } else {
+        std::unique_lock<std::mutex> lock(m_injectMutex);
         
-        // Wait a bit for threads to exit naturally when they check m_threadsToStop
-        // This is a non-blocking approach that allows threads to complete their current tasks
-        m_logger->info("Scaling down thread pool by {} threads", numToRemove);
-        
-        // Wait for thread count to decrease
-        auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(3);
-        bool timedOut = false;
+        // Don't allow enqueueing after stopping the pool
+        if (m_stop) {
+            lock.unlock();
+            m_pendingTaskCount.fetch_sub(1);
+            delete task;
+            throw std::runtime_error("Cannot enqueue task on stopped ThreadPool");
+        }
         
-        while (m_threadsToStop > 0) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
-            
-            // Check for timeout to avoid hanging indefinitely
-            if (std::chrono::steady_clock::now() > timeout) {
-                m_logger->warn("Timeout while waiting for threads to stop naturally");
-                timedOut = true;
-                break;
-            }
+        m_injected.push_back(task);
+        m_injectedCount.fetch_add(1);
+    }
+    
+    wakeWorker();
+}
+
+void ThreadPool::wakeWorker() {
+    // Pairs with the fence a worker issues after announcing it will park:
+    // either it sees the new task, or we see it parked and wake it
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_sleepers.load(std::memory_order_relaxed) > 0) {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_sleepCondition.notify_one();
+    }
+}
+
+void ThreadPool::workerThread(Worker& worker) {
+    s_currentWorker = &worker;
+    
+    while (!worker.retiring.load()) {
+        if (Task* task = findTask(worker)) {
+            runTask(task);
+            continue;
         }
         
-        // If we still have threads to remove, we need to force them to stop
-        if (timedOut) {
-            m_logger->warn("Some threads didn't stop naturally, cleaning up remaining threads");
+        // Exit on shutdown only once nothing is left to run
+        if (m_stop && !hasQueuedTasks()) {
+            break;
         }
         
-        // Remove any stopped threads from our worker vector
-        {
-            std::lock_guard<std::mutex> lock(m_queueMutex);
-            
-            // Erase any threads that have completed (detached)
-            m_workers.erase(
-                std::remove_if(m_workers.begin(), m_workers.end(), 
-                               [](const std::thread& t) { return !t.joinable(); }),
-                m_workers.end());
-            
-            // Reset the counter for next resize operation
-            m_threadsToStop = 0;
-            
-            m_logger->info("Thread pool resized to {} threads", m_workers.size());
+        // Park until a submission or a stop/resize signal
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_sleepers.fetch_add(1);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!m_stop && !worker.retiring.load() && !hasQueuedTasks()) {
+            m_sleepCondition.wait(lock);
         }
+        m_sleepers.fetch_sub(1);
+    }
+    
+    // Hand whatever this worker still holds to the injection queue
+    size_t handedOver = 0;
+    while (Task* task = worker.deque.pop()) {
+        std::lock_guard<std::mutex> lock(m_injectMutex);
+        m_injected.push_back(task);
+        m_injectedCount.fetch_add(1);
+        ++handedOver;
     }
+    if (handedOver > 0) {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_sleepCondition.notify_all();
+    }
+    
+    s_currentWorker = nullptr;
 }
 
-void ThreadPool::workerThread() {
-    while (true) {
-        std::function<void()> task;
-        bool shouldExit = false;
-        
-        {
-            std::unique_lock<std::mutex> lock(m_queueMutex);
-            
-            // Wait for a task, stop signal, or thread reduction signal
-            m_condition.wait(lock, [this] {
-                return m_stop || !m_tasks.empty() || m_threadsToStop > 0;
-            });
-            
-            // Check if we should stop due to thread pool shutdown
-            if (m_stop && m_tasks.empty()) {
-                return;
+ThreadPool::Task* ThreadPool::findTask(Worker& worker) {
+    // Own deque first, newest task first while its data is still in cache
+    if (Task* task = worker.deque.pop()) {
+        return task;
+    }
+    
+    // Then work submitted from outside the pool
+    if (m_injectedCount.load(std::memory_order_relaxed) > 0) {
+        std::lock_guard<std::mutex> lock(m_injectMutex);
+        if (!m_injected.empty()) {
+            Task* task = m_injected.front();
+            m_injected.pop_front();
+            m_injectedCount.fetch_sub(1);
+            return task;
+        }
+    }
+    
+    // Then the oldest task of another worker, starting at a rotating victim;
+    // across NUMA nodes, workers on the thief's own node go first
+    size_t slots = m_workerSlots.load(std::memory_order_acquire);
+    for (int pass = m_multiNode ? 0 : 1; pass < 2; ++pass) {
+        for (size_t i = 0; i < slots; ++i) {
+            size_t victim = (worker.nextVictim + i) % slots;
+            if (victim == worker.index || (pass == 0 && m_workers[victim]->node != worker.node)) {
+                continue;
             }
-            
-            // Check if we should stop due to thread pool resizing
-            if (m_threadsToStop > 0) {
-                // Decrement the counter before exiting
-                m_threadsToStop--;
-                shouldExit = true;
-            } else if (!m_tasks.empty()) {
-                // Get the next task
-                task = std::move(m_tasks.front());
-                m_tasks.pop();
+            if (Task* task = m_workers[victim]->deque.steal()) {
+                worker.nextVictim = victim;
+                return task;
             }
         }
-        
-        // Check if this thread should exit due to resizing
-        if (shouldExit) {
+    }
+    worker.nextVictim = (worker.nextVictim + 1) % slots;
+    
+    return nullptr;
+}
+
+bool ThreadPool::hasQueuedTasks() const {
+    if (m_injectedCount.load(std::memory_order_relaxed) > 0) {
+        return true;
+    }
+    
+    size_t slots = m_workerSlots.load(std::memory_order_acquire);
+    for (size_t i = 0; i < slots; ++i) {
+        if (!m_workers[i]->deque.empty()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::runTask(Task* task) {
+    m_activeTaskCount++;
+    try {
+        (*task)();
+    } catch (const std::exception& e) {
+        m_logger->error("Exception in worker thread: {}", e.what());
+    } catch (...) {
+        m_logger->error("Unknown exception in worker thread");
+    }
+    delete task;
+    m_activeTaskCount--;
+    
+    if (m_pendingTaskCount.fetch_sub(1) == 1) {
+        std::lock_guard<std::mutex> lock(m_completionMutex);
+        m_completionCondition.notify_all();
+    }
+}
+
+void ThreadPool::ChunkLoop::work() {
+    while (true) {
+        size_t chunk = next.fetch_add(1);
+        if (chunk >= chunks) {
             return;
         }
         
-        // Execute the task if we have one
-        if (task) {
+        if (failed.load() || (cancel && cancel->load())) {
+            skipped.store(true);
+        } else {
             try {
-                task();
-            } catch (const std::exception& e) {
-                m_logger->error("Exception in worker thread: {}", e.what());
+                run(body, chunk);
             } catch (...) {
-                m_logger->error("Unknown exception in worker thread");
+                if (!failed.exchange(true)) {
+                    error = std::current_exception();
+                }
             }
         }
+        
+        if (done.fetch_add(1) + 1 == chunks) {
+            std::lock_guard<std::mutex> lock(mutex);
+            finished.notify_all();
+        }
+    }
+}
+
+bool ThreadPool::runChunkLoop(const std::shared_ptr<ChunkLoop>& loop) {
+    // Helpers posted from a worker land on its own deque and are stolen by idle workers
+    size_t helpers = std::min(getNumThreads(), loop->chunks - 1);
+    for (size_t i = 0; i < helpers; ++i) {
+        try {
+            submit(new Task([loop]() { loop->work(); }));
+        } catch (const std::runtime_error&) {
+            // The pool is stopping; the caller runs the chunks itself
+            break;
+        }
+    }
+    
+    loop->work();
+    
+    {
+        std::unique_lock<std::mutex> lock(loop->mutex);
+        loop->finished.wait(lock, [&loop] { return loop->done.load() == loop->chunks; });
     }
+    
+    if (loop->error) {
+        std::rethrow_exception(loop->error);
+    }
+    return !loop->skipped.load();
+}
+
+size_t ThreadPool::chunkGrain(size_t count, size_t grain) const {
+    if (grain > 0) {
+        return grain;
+    }
+    
+    // About four chunks per worker evens out uneven chunks without much claiming
+    size_t chunks = std::max<size_t>(1, getNumThreads() * 4);
+    return std::max<size_t>(1, (count + chunks - 1) / chunks);
 }
 
 size_t ThreadPool::getNumThreads() const {
-    return m_workers.size();
+    std::lock_guard<std::mutex> lock(m_workersMutex);
+    return m_numThreads;
 }
 
 size_t ThreadPool::getQueueSize() const {
-    std::unique_lock<std::mutex> lock(m_queueMutex);
-    return m_tasks.size();
+    size_t pending = m_pendingTaskCount.load();
+    size_t active = m_activeTaskCount.load();
+    return pending > active ? pending - active : 0;
 }
 
 size_t ThreadPool::getActiveTaskCount() const {
@@ -184,10 +382,10 @@ size_t ThreadPool::getActiveTaskCount() const {
 }
 
 void ThreadPool::waitForCompletion() {
-    std::unique_lock<std::mutex> lock(m_queueMutex);
+    std::unique_lock<std::mutex> lock(m_completionMutex);
     m_completionCondition.wait(lock, [this] {
-        return m_activeTaskCount == 0 && m_tasks.empty();
+        return m_pendingTaskCount.load() == 0;
     });
 }
 
-}  // namespace BoxStrategy
\ No newline at end of file
+}  // namespace BoxStrategy
@@ -6,7 +6,7 @@
 #pragma once
 
 #include <vector>
-#include <queue>
+#include <deque>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
@@ -14,15 +14,36 @@
 #include <future>
 #include <memory>
 #include <atomic>
+#include <exception>
+#include <new>
+#include <optional>
 #include <type_traits>
-#include <algorithm>  // For std::remove_if
+#include <algorithm>
 #include "../utils/Logger.hpp"
+#include "../utils/ThreadTopology.hpp"
 
 namespace BoxStrategy {
 
 /**
  * @class ThreadPool
- * @brief Thread pool for parallel task execution
+ * @brief Work-stealing thread pool for parallel task execution
+ *
+ * Each worker owns a Chase-Lev deque. A task enqueued from inside a worker
+ * goes onto that worker's deque without taking any lock, and the worker
+ * runs its own tasks newest first. Tasks enqueued from other threads go
+ * onto a shared injection queue. An idle worker drains its deque, then the
+ * injection queue, then steals the oldest task from another worker, and
+ * only parks once all of them are empty. Tasks keep small callables inline
+ * so a submission costs one allocation besides the future's state.
+ *
+ * Workers can be given a fixed placement (see ThreadTopology): each pins
+ * itself to its CPUs when it starts, and when workers span several NUMA
+ * nodes a thief tries victims on its own node before the others.
+ *
+ * parallelFor, parallelTransform and parallelReduce split an index range
+ * into chunks that the calling thread and helper tasks claim one at a
+ * time. The caller works through chunks too, so a loop completes even when
+ * every worker is busy or the caller is itself a worker.
  */
 class ThreadPool {
 public:
@@ -30,8 +51,10 @@ public:
      * @brief Constructor
      * @param numThreads Number of worker threads
      * @param logger Logger instance
+     * @param placements CPUs of each worker; workers without one are unpinned
      */
-    ThreadPool(size_t numThreads, std::shared_ptr<Logger> logger);
+    ThreadPool(size_t numThreads, std::shared_ptr<Logger> logger,
+               std::vector<WorkerPlacement> placements = {});
     
     /**
      * @brief Destructor
@@ -47,6 +70,55 @@ public:
     auto enqueue(F&& f, Args&&... args) 
         -> std::future<typename std::result_of<F(Args...)>::type>;
     
+    /**
+     * @brief Run a body over an index range in parallel chunks
+     * @param begin First index
+     * @param end One past the last index
+     * @param body Called as body(from, to) for each chunk [from, to)
+     * @param grain Indices per chunk; 0 picks about four chunks per worker
+     * @param cancel Once set, chunks not yet started are skipped
+     * @return false if any chunk was skipped
+     *
+     * Blocks until every chunk has run or been skipped. The first exception
+     * thrown by the body cancels the remaining chunks and is rethrown here.
+     */
+    template<class F>
+    bool parallelFor(size_t begin, size_t end, F&& body, size_t grain = 0,
+                     const std::atomic<bool>* cancel = nullptr);
+    
+    /**
+     * @brief Map every index of a range in parallel
+     * @param begin First index
+     * @param end One past the last index
+     * @param f Called as f(i) for each index
+     * @param grain Indices per chunk; 0 picks about four chunks per worker
+     * @param cancel Once set, chunks not yet started are skipped
+     * @return Results in index order, without those of skipped chunks
+     */
+    template<class F>
+    auto parallelTransform(size_t begin, size_t end, F&& f, size_t grain = 0,
+                           const std::atomic<bool>* cancel = nullptr)
+        -> std::vector<std::invoke_result_t<F&, size_t>>;
+    
+    /**
+     * @brief Reduce an index range in parallel
+     * @param begin First index
+     * @param end One past the last index
+     * @param identity Initial value of the result and of every chunk's accumulator
+     * @param body Called as body(from, to, accumulator) for each chunk [from, to)
+     * @param combine Called as combine(result, chunkAccumulator), returning the new result
+     * @param grain Indices per chunk; 0 picks about four chunks per worker
+     * @param cancel Once set, chunks not yet started are skipped
+     * @return Chunk accumulators combined in index order
+     *
+     * Each chunk accumulates into its own buffer, and the buffers are
+     * combined on the calling thread once all chunks are done, so the body
+     * never needs a lock to publish its results.
+     */
+    template<class T, class F, class Combine>
+    T parallelReduce(size_t begin, size_t end, T identity, F&& body, Combine&& combine,
+                     size_t grain = 0, const std::atomic<bool>* cancel = nullptr);
+    
     /**
      * @brief Resize the thread pool
      * @param numThreads New number of worker threads
@@ -98,22 +170,150 @@ public:
     }
 
 private:
+    /**
+     * @brief Move-only callable, stored inline when small enough
+     */
+    class Task {
+    public:
+        template<class F>
+        explicit Task(F&& f) {
+            using Callable = std::decay_t<F>;
+            if constexpr (sizeof(Callable) <= INLINE_SIZE &&
+                          alignof(Callable) <= alignof(std::max_align_t)) {
+                m_callable = new (m_storage) Callable(std::forward<F>(f));
+                m_destroy = [](void* callable) { static_cast<Callable*>(callable)->~Callable(); };
+            } else {
+                m_callable = new Callable(std::forward<F>(f));
+                m_destroy = [](void* callable) { delete static_cast<Callable*>(callable); };
+            }
+            m_invoke = [](void* callable) { (*static_cast<Callable*>(callable))(); };
+        }
+
+        ~Task() {
+            m_destroy(m_callable);
+        }
+
+        Task(const Task&) = delete;
+        Task& operator=(const Task&) = delete;
+
+        void operator()() {
+            m_invoke(m_callable);
+        }
+
+    private:
+        static constexpr size_t INLINE_SIZE = 48;
+
+        alignas(std::max_align_t) unsigned char m_storage[INLINE_SIZE];  ///< Inline callable storage
+        void* m_callable;                                                ///< Callable, inline or on the heap
+        void (*m_invoke)(void*);                                         ///< Calls the callable
+        void (*m_destroy)(void*);                                        ///< Destroys the callable
+    };
+
+    struct Worker;
+
+    /**
+     * @brief Chunks of one parallel loop, claimed in order by the caller and helper tasks
+     *
+     * Helper tasks may start after the loop has finished; they only touch
+     * the body once they claim a chunk, so they outliving the caller's frame
+     * is harmless.
+     */
+    struct ChunkLoop {
+        size_t chunks = 0;                        ///< Number of chunks
+        void* body = nullptr;                     ///< Chunk runner on the caller's frame
+        void (*run)(void*, size_t) = nullptr;     ///< Runs one chunk through body
+        const std::atomic<bool>* cancel = nullptr;///< Caller's cancellation flag, if any
+        std::atomic<size_t> next{0};              ///< Next chunk to claim
+        std::atomic<size_t> done{0};              ///< Chunks run or skipped
+        std::atomic<bool> skipped{false};         ///< Whether any chunk was skipped
+        std::atomic<bool> failed{false};          ///< Whether a chunk threw
+        std::exception_ptr error;                 ///< First exception thrown by a chunk
+        std::mutex mutex;                         ///< Guards the wait for the last chunk
+        std::condition_variable finished;         ///< Signalled when done reaches chunks
+
+        /**
+         * @brief Claim and run chunks until none are left
+         */
+        void work();
+    };
+
+    /**
+     * @brief Run chunks [0, chunks) through runChunk on the caller and the pool
+     */
+    template<class Chunk>
+    bool runChunks(size_t chunks, Chunk& runChunk, const std::atomic<bool>* cancel);
+
+    /**
+     * @brief Post helper tasks for a loop, work on it, and wait for its last chunk
+     */
+    bool runChunkLoop(const std::shared_ptr<ChunkLoop>& loop);
+
+    /**
+     * @brief Indices per chunk for a range, given the requested grain
+     */
+    size_t chunkGrain(size_t count, size_t grain) const;
+
+    /**
+     * @brief Queue a task: on the calling worker's deque, or the injection queue
+     */
+    void submit(Task* task);
+
+    /**
+     * @brief Start the thread of a worker slot, creating the slot if needed
+     */
+    void startWorker(size_t index);
+
     /**
      * @brief Worker thread function
      */
-    void workerThread();
-    
-    std::vector<std::thread> m_workers;           ///< Worker threads
-    std::queue<std::function<void()>> m_tasks;    ///< Task queue
-    
-    mutable std::mutex m_queueMutex;              ///< Mutex for task queue
-    std::condition_variable m_condition;          ///< Condition variable for task queue
+    void workerThread(Worker& worker);
+
+    /**
+     * @brief Find a task for a worker: own deque, injection queue, then steal
+     */
+    Task* findTask(Worker& worker);
+
+    /**
+     * @brief Whether any deque or the injection queue holds a task
+     */
+    bool hasQueuedTasks() const;
+
+    /**
+     * @brief Run a task and update the counters
+     */
+    void runTask(Task* task);
+
+    /**
+     * @brief Wake one parked worker if any are parked
+     */
+    void wakeWorker();
+
+    static constexpr size_t MAX_WORKERS = 256;    ///< Worker slots reserved up front
+
+    static thread_local Worker* s_currentWorker;  ///< Worker run by the calling thread, if any
+
+    std::vector<std::unique_ptr<Worker>> m_workers; ///< Worker slots; never reallocated
+    std::atomic<size_t> m_workerSlots{0};         ///< Slots created so far, scanned by thieves
+    std::vector<WorkerPlacement> m_placements;    ///< Placement of each worker slot
+    bool m_multiNode = false;                     ///< Whether placed workers span several NUMA nodes
+    size_t m_numThreads = 0;                      ///< Running workers, always slots [0, m_numThreads)
+    mutable std::mutex m_workersMutex;            ///< Serializes resizes
+
+    std::deque<Task*> m_injected;                 ///< Tasks enqueued from outside the workers
+    mutable std::mutex m_injectMutex;             ///< Guards m_injected
+    std::atomic<size_t> m_injectedCount{0};       ///< Size of m_injected, readable without the lock
+
+    std::mutex m_sleepMutex;                      ///< Guards parking
+    std::condition_variable m_sleepCondition;     ///< Parked workers wait here
+    std::atomic<size_t> m_sleepers{0};            ///< Number of parked workers
+
+    std::mutex m_completionMutex;                 ///< Guards completion waits
     std::condition_variable m_completionCondition;///< Condition variable for completion
-    
+
     std::atomic<bool> m_stop;                     ///< Whether to stop the thread pool
-    std::atomic<size_t> m_activeTaskCount;        ///< Number of active tasks
-    std::atomic<size_t> m_threadsToStop{0};       ///< Counter for threads that should exit during resizing
-    
+    std::atomic<size_t> m_activeTaskCount;        ///< Number of running tasks
+    std::atomic<size_t> m_pendingTaskCount{0};    ///< Number of queued or running tasks
+
     std::shared_ptr<Logger> m_logger;             ///< Logger instance
 };
 
@@ -122,30 +322,93 @@ auto ThreadPool::enqueue(F&& f, Args&&... args)
     -> std::future<typename std::result_of<F(Args...)>::type> {
     using return_type = typename std::result_of<F(Args...)>::type;
     
-    auto task = std::make_shared<std::packaged_task<return_type()>>(
+    // The packaged task is two pointers, so it fits in the task's inline storage
+    std::packaged_task<return_type()> task(
         std::bind(std::forward<F>(f), std::forward<Args>(args)...)
     );
     
-    std::future<return_type> res = task->get_future();
-    {
-        std::unique_lock<std::mutex> lock(m_queueMutex);
-        
-        // Don't allow enqueueing after stopping the pool
-        if (m_stop) {
-            throw std::runtime_error("Cannot enqueue task on stopped ThreadPool");
-        }
-        
-        m_tasks.emplace([task, this]() {
-            m_activeTaskCount++;
-            (*task)();
-            m_activeTaskCount--;
-            if (m_activeTaskCount == 0 && m_tasks.empty()) {
-                m_completionCondition.notify_all();
+    std::future<return_type> res = task.get_future();
+    submit(new Task(std::move(task)));
+    return res;
+}
+
+template<class F>
+bool ThreadPool::parallelFor(size_t begin, size_t end, F&& body, size_t grain,
+                             const std::atomic<bool>* cancel) {
+    if (begin >= end) {
+        return true;
+    }
+    
+    size_t count = end - begin;
+    grain = chunkGrain(count, grain);
+    auto runChunk = [&](size_t chunk) {
+        size_t from = begin + chunk * grain;
+        body(from, std::min(from + grain, end));
+    };
+    return runChunks((count + grain - 1) / grain, runChunk, cancel);
+}
+
+template<class F>
+auto ThreadPool::parallelTransform(size_t begin, size_t end, F&& f, size_t grain,
+                                   const std::atomic<bool>* cancel)
+    -> std::vector<std::invoke_result_t<F&, size_t>> {
+    using Result = std::invoke_result_t<F&, size_t>;
+    
+    return parallelReduce(begin, end, std::vector<Result>(),
+        [&f](size_t from, size_t to, std::vector<Result>& results) {
+            results.reserve(to - from);
+            for (size_t i = from; i < to; ++i) {
+                results.push_back(f(i));
             }
-        });
+        },
+        [](std::vector<Result> all, std::vector<Result> chunk) {
+            if (all.empty()) {
+                return chunk;
+            }
+            all.insert(all.end(), std::make_move_iterator(chunk.begin()), std::make_move_iterator(chunk.end()));
+            return all;
+        },
+        grain, cancel);
+}
+
+template<class T, class F, class Combine>
+T ThreadPool::parallelReduce(size_t begin, size_t end, T identity, F&& body, Combine&& combine,
+                             size_t grain, const std::atomic<bool>* cancel) {
+    if (begin >= end) {
+        return identity;
     }
-    m_condition.notify_one();
-    return res;
+    
+    size_t count = end - begin;
+    grain = chunkGrain(count, grain);
+    size_t chunks = (count + grain - 1) / grain;
+    
+    // One accumulator per chunk, each written only by the thread running that chunk
+    std::vector<std::optional<T>> partials(chunks);
+    auto runChunk = [&](size_t chunk) {
+        size_t from = begin + chunk * grain;
+        T partial = identity;
+        body(from, std::min(from + grain, end), partial);
+        partials[chunk].emplace(std::move(partial));
+    };
+    runChunks(chunks, runChunk, cancel);
+    
+    T result = std::move(identity);
+    for (auto& partial : partials) {
+        if (partial) {
+            result = combine(std::move(result), std::move(*partial));
+        }
+    }
+    return result;
+}
+
+template<class Chunk>
+bool ThreadPool::runChunks(size_t chunks, Chunk& runChunk, const std::atomic<bool>* cancel) {
+    auto loop = std::make_shared<ChunkLoop>();
+    loop->chunks = chunks;
+    loop->body = &runChunk;
+    loop->run = [](void* body, size_t chunk) { (*static_cast<Chunk*>(body))(chunk); };
+    loop->cancel = cancel;
+    return runChunkLoop(loop);
 }
 
 }  // namespace BoxStrategy
\ No newline at end of file
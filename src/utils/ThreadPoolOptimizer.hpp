@@ -7,11 +7,90 @@
 #include <memory>
 #include <vector>
 #include <functional>
+#include <iterator>
+#include <string>
 #include "ThreadPool.hpp"
 #include "../utils/Logger.hpp"
 
 namespace BoxStrategy {
 
+/**
+ * @class ProgressTracker
+ * @brief Reports the progress of a parallel loop from the threads doing the work
+ *
+ * Whichever thread advances the count past the next report time logs the
+ * report, so tracking progress needs no monitoring thread of its own.
+ */
+class ProgressTracker {
+public:
+    /**
+     * @brief Constructor
+     * @param logger Logger instance
+     * @param totalItems Total number of items to process
+     * @param reportIntervalSec Interval in seconds between progress reports
+     * @param label Label for the progress report
+     */
+    ProgressTracker(std::shared_ptr<Logger> logger, size_t totalItems,
+                    double reportIntervalSec = 5.0, const std::string& label = "Progress")
+        : m_logger(logger), m_totalItems(totalItems), m_label(label),
+          m_startTime(std::chrono::steady_clock::now()),
+          m_interval(std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+              std::chrono::duration<double>(reportIntervalSec))),
+          m_nextReport((m_startTime + m_interval).time_since_epoch().count()) {}
+    
+    /**
+     * @brief Record processed items, logging a report if one is due
+     * @param count Number of items just processed
+     */
+    void advance(size_t count = 1) {
+        size_t completed = m_completed.fetch_add(count) + count;
+        
+        auto now = std::chrono::steady_clock::now();
+        auto due = m_nextReport.load(std::memory_order_relaxed);
+        if (now.time_since_epoch().count() < due ||
+            !m_nextReport.compare_exchange_strong(due, (now + m_interval).time_since_epoch().count())) {
+            return;
+        }
+        
+        double elapsed = std::chrono::duration<double>(now - m_startTime).count();
+        double percentComplete = m_totalItems > 0 ? (double)completed / m_totalItems * 100.0 : 100.0;
+        double itemsPerSecond = (double)completed / std::max(1.0, elapsed);
+        double estimatedSecondsRemaining = (m_totalItems - std::min(completed, m_totalItems)) /
+                                           std::max(0.1, itemsPerSecond);
+        
+        m_logger->info("{}: {:.1f}% ({}/{}) - {:.1f} items/sec - Est. remaining: {:.0f} sec", 
+                     m_label, percentComplete, completed, m_totalItems, 
+                     itemsPerSecond, estimatedSecondsRemaining);
+    }
+    
+    /**
+     * @brief Get the number of processed items
+     */
+    size_t completed() const {
+        return m_completed.load();
+    }
+    
+    /**
+     * @brief Log the final report
+     */
+    void finish() {
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_startTime).count();
+        size_t completed = m_completed.load();
+        
+        m_logger->info("{} completed: {} items in {:.1f} seconds ({:.1f} items/sec)",
+                     m_label, completed, elapsed, (double)completed / std::max(1.0, elapsed));
+    }
+    
+private:
+    std::shared_ptr<Logger> m_logger;                     ///< Logger instance
+    size_t m_totalItems;                                  ///< Total number of items
+    std::string m_label;                                  ///< Label for the progress report
+    std::chrono::steady_clock::time_point m_startTime;    ///< When tracking started
+    std::chrono::steady_clock::duration m_interval;       ///< Interval between reports
+    std::atomic<size_t> m_completed{0};                   ///< Processed items
+    std::atomic<std::chrono::steady_clock::rep> m_nextReport; ///< Clock count of the next report
+};
+
 /**
  * @class ThreadPoolOptimizer
  * @brief Optimizes thread pool usage for different workloads
@@ -56,80 +135,6 @@ public:
         return batchSize;
     }
     
-    /**
-     * @brief Monitor and report progress on batch processing
-     * @param totalItems Total number of items to process
-     * @param processedItemsCounter Atomic counter for processed items
-     * @param reportIntervalSec Interval in seconds between progress reports
-     * @param label Label for the progress report
-     * @return Function that can be called to stop monitoring
-     */
-    std::function<void()> monitorProgress(
-        size_t totalItems,
-        std::atomic<size_t>& processedItemsCounter,
-        double reportIntervalSec = 5.0,
-        const std::string& label = "Progress"
-    ) {
-        // Create a monitoring thread that periodically reports progress
-        std::atomic<bool> keepRunning(true);
-        
-        std::thread monitorThread([this, totalItems, &processedItemsCounter, 
-                                 reportIntervalSec, label, &keepRunning]() {
-            auto startTime = std::chrono::high_resolution_clock::now();
-            auto lastReportTime = startTime;
-            
-            while (keepRunning.load() && processedItemsCounter.load() < totalItems) {
-                // Sleep for a short interval to reduce CPU usage
-                std::this_thread::sleep_for(std::chrono::milliseconds(200));
-                
-                auto now = std::chrono::high_resolution_clock::now();
-                auto timeSinceLastReport = std::chrono::duration_cast<std::chrono::duration<double>>(
-                    now - lastReportTime).count();
-                
-                // Check if it's time to report progress
-                if (timeSinceLastReport >= reportIntervalSec) {
-                    auto totalElapsed = std::chrono::duration_cast<std::chrono::duration<double>>(
-                        now - startTime).count();
-                    
-                    size_t completed = processedItemsCounter.load();
-                    
-                    if (completed > 0 && totalItems > 0) {
-                        double percentComplete = (double)completed / totalItems * 100.0;
-                        double itemsPerSecond = (double)completed / std::max(1.0, totalElapsed);
-                        double estimatedSecondsRemaining = (totalItems - completed) / 
-                                                         std::max(0.1, itemsPerSecond);
-                        
-                        m_logger->info("{}: {:.1f}% ({}/{}) - {:.1f} items/sec - Est. remaining: {:.0f} sec", 
-                                     label, percentComplete, completed, totalItems, 
-                                     itemsPerSecond, estimatedSecondsRemaining);
-                    }
-                    
-                    lastReportTime = now;
-                }
-            }
-            
-            // Final report
-            if (processedItemsCounter.load() >= totalItems) {
-                auto endTime = std::chrono::high_resolution_clock::now();
-                auto totalElapsed = std::chrono::duration_cast<std::chrono::duration<double>>(
-                    endTime - startTime).count();
-                
-                double itemsPerSecond = (double)totalItems / std::max(1.0, totalElapsed);
-                
-                m_logger->info("{} completed: {} items in {:.1f} seconds ({:.1f} items/sec)",
-                             label, totalItems, totalElapsed, itemsPerSecond);
-            }
-        });
-        
-        // Detach the thread so it runs independently
-        monitorThread.detach();
-        
-        // Return a function to stop the monitoring
-        return [&keepRunning]() {
-            keepRunning.store(false);
-        };
-    }
-    
     /**
      * @brief Create a batched workload processor
      * 
@@ -162,56 +167,30 @@ public:
         size_t batchSize = calculateOptimalBatchSize(workItems.size(), minBatchSize, maxBatchSize);
         m_logger->info("Processing {} items in batches of up to {} items", workItems.size(), batchSize);
         
-        // Set up progress tracking
-        std::atomic<size_t> processedItems(0);
-        auto stopProgress = monitorProgress(workItems.size(), processedItems, 5.0, progressLabel);
-        
-        // Create a queue of work batches
-        std::vector<std::vector<T>> batches;
-        for (size_t i = 0; i < workItems.size(); i += batchSize) {
-            size_t batchEnd = std::min(i + batchSize, workItems.size());
-            batches.emplace_back(workItems.begin() + i, workItems.begin() + batchEnd);
-        }
-        
-        // Process each batch
-        std::mutex resultsMutex;
-        std::vector<result_type> results;
-        results.reserve(workItems.size());
-        
-        std::vector<std::future<void>> futures;
-        
-        for (const auto& batch : batches) {
-            futures.push_back(m_threadPool->enqueue([this, &batch, &processItemFunc, &batchProcessingFunc,
-                                                    &processedItems, &resultsMutex, &results]() {
+        // Each batch fills its own result buffer; the buffers are joined in order
+        ProgressTracker progress(m_logger, workItems.size(), 5.0, progressLabel);
+        auto results = m_threadPool->parallelReduce(0, workItems.size(), std::vector<result_type>(),
+            [&](size_t from, size_t to, std::vector<result_type>& batchResults) {
                 // If a batch processing function was provided, call it first
                 if (batchProcessingFunc) {
-                    batchProcessingFunc(batch);
+                    batchProcessingFunc(std::vector<T>(workItems.begin() + from, workItems.begin() + to));
                 }
                 
                 // Process each item in the batch
-                std::vector<result_type> batchResults;
-                batchResults.reserve(batch.size());
-                
-                for (const auto& item : batch) {
-                    batchResults.push_back(processItemFunc(item));
-                    processedItems++;
-                }
-                
-                // Add batch results to the global results
-                {
-                    std::lock_guard<std::mutex> lock(resultsMutex);
-                    results.insert(results.end(), batchResults.begin(), batchResults.end());
+                batchResults.reserve(to - from);
+                for (size_t i = from; i < to; ++i) {
+                    batchResults.push_back(processItemFunc(workItems[i]));
                 }
-            }));
-        }
-        
-        // Wait for all batches to complete
-        for (auto& future : futures) {
-            future.get();
-        }
-        
-        // Stop progress reporting
-        stopProgress();
+                progress.advance(to - from);
+            },
+            [](std::vector<result_type> all, std::vector<result_type> batchResults) {
+                all.insert(all.end(), std::make_move_iterator(batchResults.begin()),
+                           std::make_move_iterator(batchResults.end()));
+                return all;
+            },
+            batchSize);
+        
+        progress.finish();
         
         return results;
     }
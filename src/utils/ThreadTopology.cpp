@@ -0,0 +1,249 @@
+/**
+ * @file ThreadTopology.cpp
+ * @brief Implementation of the ThreadTopology class
+ */
+
+#include "../utils/ThreadTopology.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <thread>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace BoxStrategy {
+
+namespace {
+
+std::vector<int> intersectCpus(const std::vector<int>& a, const std::vector<int>& b) {
+    std::vector<int> result;
+    std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(result));
+    return result;
+}
+
+std::vector<int> subtractCpus(const std::vector<int>& a, const std::vector<int>& b) {
+    std::vector<int> result;
+    std::set_difference(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(result));
+    return result;
+}
+
+}  // namespace
+
+TopologyOptions TopologyOptions::fromConfig(ConfigManager& configManager) {
+    TopologyOptions options;
+    options.numThreads = static_cast<size_t>(std::max(1, configManager.getIntValue("system/num_threads", 4)));
+    options.pinWorkers = configManager.getBoolValue("system/pin_threads", false);
+    options.analysisCpus = configManager.getStringValue("system/analysis_cpus", "");
+    options.isolateIo = configManager.getBoolValue("system/isolate_io_threads", false);
+    options.ioCpus = configManager.getStringValue("system/io_cpus", "");
+    options.numaAware = configManager.getBoolValue("system/numa_aware", true);
+    options.numScanThreads = static_cast<size_t>(std::max(0, configManager.getIntValue("system/scan_threads", 0)));
+    return options;
+}
+
+ThreadTopology::ThreadTopology(const TopologyOptions& options, std::shared_ptr<Logger> logger)
+    : m_logger(logger) {
+    std::vector<int> allowed = getAllowedCpus();
+
+    std::vector<int> analysisCpus = allowed;
+    if (!options.analysisCpus.empty()) {
+        analysisCpus = intersectCpus(parseCpuList(options.analysisCpus), allowed);
+        if (analysisCpus.empty()) {
+            m_logger->warn("Analysis CPUs '{}' name no usable CPU; using all allowed CPUs", options.analysisCpus);
+            analysisCpus = allowed;
+        }
+    }
+
+    if (options.isolateIo) {
+        if (!options.ioCpus.empty()) {
+            m_ioCpus = intersectCpus(parseCpuList(options.ioCpus), allowed);
+            if (m_ioCpus.empty()) {
+                m_logger->warn("I/O CPUs '{}' name no usable CPU; using the first allowed CPU", options.ioCpus);
+            }
+        }
+        if (m_ioCpus.empty() && !allowed.empty()) {
+            m_ioCpus.push_back(allowed.front());
+        }
+
+        std::vector<int> remaining = subtractCpus(analysisCpus, m_ioCpus);
+        if (remaining.empty()) {
+            m_logger->warn("No CPU left for analysis workers after reserving {} for I/O; not isolating I/O",
+                         formatCpuList(m_ioCpus));
+            m_ioCpus.clear();
+        } else {
+            analysisCpus = remaining;
+        }
+    }
+
+    // Order the analysis CPUs node by node so consecutive workers share a node
+    int maxCpu = allowed.empty() ? 0 : allowed.back();
+    std::vector<int> cpuNodes = readCpuNodes(maxCpu);
+    auto nodeOf = [&cpuNodes](int cpu) { return cpuNodes[cpu]; };
+    if (options.numaAware) {
+        std::stable_sort(analysisCpus.begin(), analysisCpus.end(),
+                         [&nodeOf](int a, int b) { return nodeOf(a) < nodeOf(b); });
+    }
+
+    std::set<int> workerNodes;
+    for (size_t i = 0; i < options.numThreads; ++i) {
+        WorkerPlacement placement;
+        if (options.pinWorkers && !analysisCpus.empty()) {
+            int cpu = analysisCpus[i % analysisCpus.size()];
+            placement.cpus.push_back(cpu);
+            placement.node = options.numaAware ? nodeOf(cpu) : 0;
+        } else if (!m_ioCpus.empty()) {
+            // Not pinned individually, but still kept off the I/O CPUs
+            placement.cpus = analysisCpus;
+            std::sort(placement.cpus.begin(), placement.cpus.end());
+        }
+        workerNodes.insert(placement.node);
+        m_workerPlacements.push_back(std::move(placement));
+    }
+
+    std::vector<int> sortedAnalysisCpus = analysisCpus;
+    std::sort(sortedAnalysisCpus.begin(), sortedAnalysisCpus.end());
+    m_logger->info("Thread topology: {} analysis workers {} CPUs {} on {} NUMA node(s); I/O threads on {}",
+                 options.numThreads, options.pinWorkers ? "pinned to" : "over",
+                 formatCpuList(sortedAnalysisCpus), workerNodes.size(),
+                 m_ioCpus.empty() ? std::string("any CPU") : "CPUs " + formatCpuList(m_ioCpus));
+}
+
+const std::vector<WorkerPlacement>& ThreadTopology::getWorkerPlacements() const {
+    return m_workerPlacements;
+}
+
+const std::vector<int>& ThreadTopology::getIoCpus() const {
+    return m_ioCpus;
+}
+
+bool ThreadTopology::pinCurrentThread(const std::vector<int>& cpus) {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) {
+        if (cpu >= 0 && cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &set);
+        }
+    }
+    if (CPU_COUNT(&set) == 0) {
+        return false;
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)cpus;
+    return false;
+#endif
+}
+
+std::vector<int> ThreadTopology::parseCpuList(const std::string& list) {
+    std::vector<int> cpus;
+    std::stringstream stream(list);
+    std::string item;
+
+    while (std::getline(stream, item, ',')) {
+        item.erase(std::remove_if(item.begin(), item.end(), ::isspace), item.end());
+        if (item.empty()) {
+            continue;
+        }
+
+        try {
+            size_t dash = item.find('-');
+            int first = std::stoi(item.substr(0, dash));
+            int last = dash == std::string::npos ? first : std::stoi(item.substr(dash + 1));
+            if (first < 0 || last < first) {
+                return {};
+            }
+            for (int cpu = first; cpu <= last; ++cpu) {
+                cpus.push_back(cpu);
+            }
+        } catch (const std::exception&) {
+            return {};
+        }
+    }
+
+    std::sort(cpus.begin(), cpus.end());
+    cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+    return cpus;
+}
+
+std::string ThreadTopology::formatCpuList(const std::vector<int>& cpus) {
+    std::string list;
+    for (size_t i = 0; i < cpus.size();) {
+        size_t j = i;
+        while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1) {
+            ++j;
+        }
+
+        if (!list.empty()) {
+            list += ",";
+        }
+        list += std::to_string(cpus[i]);
+        if (j > i) {
+            list += "-" + std::to_string(cpus[j]);
+        }
+        i = j + 1;
+    }
+    return list;
+}
+
+std::vector<int> ThreadTopology::getAllowedCpus() {
+    std::vector<int> cpus;
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set)) {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+#endif
+    if (cpus.empty()) {
+        unsigned int hwThreads = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned int cpu = 0; cpu < hwThreads; ++cpu) {
+            cpus.push_back(static_cast<int>(cpu));
+        }
+    }
+    return cpus;
+}
+
+std::vector<int> ThreadTopology::readCpuNodes(int maxCpu) {
+    std::vector<int> nodes(static_cast<size_t>(maxCpu) + 1, 0);
+
+    // Each /sys/devices/system/node/nodeN/cpulist lists the CPUs of node N
+    std::error_code error;
+    std::filesystem::directory_iterator it("/sys/devices/system/node", error);
+    if (error) {
+        return nodes;
+    }
+
+    for (const auto& entry : it) {
+        std::string name = entry.path().filename().string();
+        if (name.rfind("node", 0) != 0 || name.size() == 4 ||
+            !std::all_of(name.begin() + 4, name.end(), ::isdigit)) {
+            continue;
+        }
+
+        std::ifstream file(entry.path() / "cpulist");
+        std::string list;
+        if (!std::getline(file, list)) {
+            continue;
+        }
+
+        int node = std::stoi(name.substr(4));
+        for (int cpu : parseCpuList(list)) {
+            if (cpu <= maxCpu) {
+                nodes[cpu] = node;
+            }
+        }
+    }
+    return nodes;
+}
+
+}  // namespace BoxStrategy
@@ -0,0 +1,118 @@
+/**
+ * @file ThreadTopology.hpp
+ * @brief CPU placement of analysis workers and I/O threads
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include "../utils/Logger.hpp"
+#include "../config/ConfigManager.hpp"
+
+namespace BoxStrategy {
+
+/**
+ * @struct WorkerPlacement
+ * @brief CPUs a pool worker may run on
+ */
+struct WorkerPlacement {
+    std::vector<int> cpus;  ///< Allowed CPUs; empty leaves the worker unpinned
+    int node = 0;           ///< NUMA node of those CPUs
+};
+
+/**
+ * @struct TopologyOptions
+ * @brief How to lay out worker and I/O threads over the CPUs
+ */
+struct TopologyOptions {
+    size_t numThreads = 4;         ///< Analysis workers
+    bool pinWorkers = false;       ///< Pin each analysis worker to one CPU
+    std::string analysisCpus;      ///< CPU list for analysis workers, e.g. "2-7"; empty for all
+    bool isolateIo = false;        ///< Keep I/O threads and analysis workers on disjoint CPUs
+    std::string ioCpus;            ///< CPU list for I/O threads; empty picks the first allowed CPU
+    bool numaAware = true;         ///< Fill NUMA nodes one at a time
+    size_t numScanThreads = 0;     ///< Unpinned scan threads; 0 for one per concurrent expiry scan
+
+    /**
+     * @brief Read the layout from the system section of the config
+     * @param configManager Config manager
+     * @return Options from system/num_threads, pin_threads, analysis_cpus, isolate_io_threads, io_cpus,
+     *         numa_aware and scan_threads
+     */
+    static TopologyOptions fromConfig(ConfigManager& configManager);
+};
+
+/**
+ * @class ThreadTopology
+ * @brief Fixed CPU layout of the process, worked out once at startup
+ *
+ * Analysis workers get one placement each for the lifetime of their pool,
+ * so a worker keeps its caches warm across scans. With NUMA awareness the
+ * analysis CPUs are ordered node by node, so neighbouring workers share a
+ * node and the pool spans as few nodes as it needs. With I/O isolation the
+ * I/O CPUs are taken out of the analysis set and handed to the threads
+ * that wait on sockets (the HTTP I/O loop and the tick feed), which pin
+ * themselves when they start. Other threads keep the process mask. NUMA
+ * nodes are read from sysfs; affinity is only applied on Linux.
+ */
+class ThreadTopology {
+public:
+    /**
+     * @brief Constructor; detects the allowed CPUs and NUMA nodes
+     * @param options Requested layout
+     * @param logger Logger instance
+     */
+    ThreadTopology(const TopologyOptions& options, std::shared_ptr<Logger> logger);
+
+    /**
+     * @brief Get the placement of each analysis worker
+     * @return One placement per worker
+     */
+    const std::vector<WorkerPlacement>& getWorkerPlacements() const;
+
+    /**
+     * @brief Get the CPUs reserved for I/O threads
+     * @return CPU list; empty unless I/O is isolated
+     */
+    const std::vector<int>& getIoCpus() const;
+
+    /**
+     * @brief Restrict the calling thread to some CPUs
+     * @param cpus Allowed CPUs
+     * @return true on success
+     */
+    static bool pinCurrentThread(const std::vector<int>& cpus);
+
+    /**
+     * @brief Parse a CPU list such as "0-3,8,10-11"
+     * @param list CPU list
+     * @return CPUs in ascending order, without duplicates; empty if malformed
+     */
+    static std::vector<int> parseCpuList(const std::string& list);
+
+    /**
+     * @brief Format CPUs as a CPU list
+     * @param cpus CPUs in ascending order
+     * @return CPU list such as "0-3,8"
+     */
+    static std::string formatCpuList(const std::vector<int>& cpus);
+
+private:
+    /**
+     * @brief Get the CPUs the process may run on
+     */
+    static std::vector<int> getAllowedCpus();
+
+    /**
+     * @brief Map each CPU to its NUMA node; CPUs without one map to node 0
+     */
+    static std::vector<int> readCpuNodes(int maxCpu);
+
+    std::vector<WorkerPlacement> m_workerPlacements;  ///< Placement of each analysis worker
+    std::vector<int> m_ioCpus;                        ///< CPUs reserved for I/O threads
+    std::shared_ptr<Logger> m_logger;                 ///< Logger instance
+};
+
+}  // namespace BoxStrategy
@@ -0,0 +1,167 @@
+/**
+ * @file WorkStealingDeque.hpp
+ * @brief Lock-free Chase-Lev work-stealing deque
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace BoxStrategy {
+
+/**
+ * @class WorkStealingDeque
+ * @brief Chase-Lev deque of pointers with one owner and any number of thieves
+ *
+ * The owning thread pushes and pops at the bottom; other threads steal
+ * from the top. Neither side takes a lock: the owner only contends with
+ * thieves, through one compare-and-swap, when a single element is left.
+ * The ring grows when full; outgrown rings are kept until the deque is
+ * destroyed because a thief may still be reading one.
+ *
+ * Follows Lê, Pop, Cohen and Zappa Nardelli, "Correct and Efficient
+ * Work-Stealing for Weak Memory Models" (PPoPP 2013).
+ */
+template<class T>
+class WorkStealingDeque {
+public:
+    /**
+     * @brief Constructor
+     * @param capacity Initial capacity, rounded up to a power of two
+     */
+    explicit WorkStealingDeque(size_t capacity = 256) {
+        size_t rounded = 1;
+        while (rounded < capacity) {
+            rounded <<= 1;
+        }
+        m_rings.push_back(std::make_unique<Ring>(rounded));
+        m_ring.store(m_rings.back().get(), std::memory_order_relaxed);
+    }
+
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+    /**
+     * @brief Push an element at the bottom; owner thread only
+     */
+    void push(T* item) {
+        int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+        int64_t top = m_top.load(std::memory_order_acquire);
+        Ring* ring = m_ring.load(std::memory_order_relaxed);
+
+        if (bottom - top > static_cast<int64_t>(ring->capacity) - 1) {
+            ring = grow(ring, top, bottom);
+        }
+
+        ring->put(bottom, item);
+        std::atomic_thread_fence(std::memory_order_release);
+        m_bottom.store(bottom + 1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Pop the most recently pushed element; owner thread only
+     * @return Element, or nullptr if the deque is empty
+     */
+    T* pop() {
+        int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+        Ring* ring = m_ring.load(std::memory_order_relaxed);
+        m_bottom.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t top = m_top.load(std::memory_order_relaxed);
+
+        if (top > bottom) {
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        T* item = ring->get(bottom);
+        if (top == bottom) {
+            // Last element: race thieves for it
+            if (!m_top.compare_exchange_strong(top, top + 1,
+                                               std::memory_order_seq_cst,
+                                               std::memory_order_relaxed)) {
+                item = nullptr;
+            }
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        }
+        return item;
+    }
+
+    /**
+     * @brief Steal the oldest element; any thread
+     * @return Element, or nullptr if the deque is empty or the steal lost a race
+     */
+    T* steal() {
+        int64_t top = m_top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t bottom = m_bottom.load(std::memory_order_acquire);
+
+        if (top >= bottom) {
+            return nullptr;
+        }
+
+        Ring* ring = m_ring.load(std::memory_order_acquire);
+        T* item = ring->get(top);
+        if (!m_top.compare_exchange_strong(top, top + 1,
+                                           std::memory_order_seq_cst,
+                                           std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        return item;
+    }
+
+    /**
+     * @brief Approximate number of elements
+     */
+    size_t size() const {
+        int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+        int64_t top = m_top.load(std::memory_order_relaxed);
+        return bottom > top ? static_cast<size_t>(bottom - top) : 0;
+    }
+
+    /**
+     * @brief Whether the deque looks empty
+     */
+    bool empty() const {
+        return size() == 0;
+    }
+
+private:
+    struct Ring {
+        explicit Ring(size_t size)
+            : capacity(size), mask(size - 1), slots(new std::atomic<T*>[size]) {}
+
+        T* get(int64_t index) const {
+            return slots[index & mask].load(std::memory_order_relaxed);
+        }
+
+        void put(int64_t index, T* item) {
+            slots[index & mask].store(item, std::memory_order_relaxed);
+        }
+
+        size_t capacity;                          ///< Number of slots, a power of two
+        int64_t mask;                             ///< capacity - 1
+        std::unique_ptr<std::atomic<T*>[]> slots; ///< Ring storage
+    };
+
+    Ring* grow(Ring* ring, int64_t top, int64_t bottom) {
+        auto bigger = std::make_unique<Ring>(ring->capacity * 2);
+        for (int64_t i = top; i < bottom; ++i) {
+            bigger->put(i, ring->get(i));
+        }
+        Ring* next = bigger.get();
+        m_rings.push_back(std::move(bigger));
+        m_ring.store(next, std::memory_order_release);
+        return next;
+    }
+
+    alignas(64) std::atomic<int64_t> m_top{0};     ///< Steal end, advanced by thieves and the last pop
+    alignas(64) std::atomic<int64_t> m_bottom{0};  ///< Owner end
+    std::atomic<Ring*> m_ring{nullptr};            ///< Current ring
+    std::vector<std::unique_ptr<Ring>> m_rings;    ///< Current and outgrown rings; owner only
+};
+
+}  // namespace BoxStrategy
@@ -0,0 +1,876 @@
+/**
+ * @file MockKiteServer.cpp
+ * @brief Implementation of the MockKiteServer class
+ */
+
+#include "MockKiteServer.hpp"
+#include "../external/json.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <ctime>
+#include <iterator>
+#include <sstream>
+#include <fmt/format.h>
+
+using json = nlohmann::json;
+
+namespace BoxStrategy {
+
+namespace {
+
+constexpr size_t MAX_LINE_SIZE = 64 * 1024;          ///< Longest request or header line
+constexpr size_t MAX_BODY_SIZE = 1024 * 1024;        ///< Largest accepted request body
+constexpr double TICK_SIZE = 0.05;                   ///< Price step of options
+constexpr double VOLATILITY = 0.15;                  ///< Implied volatility of the synthetic chains
+constexpr uint64_t SEGMENT_NFO_OPT = 2;              ///< Low byte of NFO option tokens
+constexpr uint64_t SEGMENT_INDICES = 9;              ///< Low byte of index tokens
+
+const char* MONTHS[] = {"JAN", "FEB", "MAR", "APR", "MAY", "JUN",
+                        "JUL", "AUG", "SEP", "OCT", "NOV", "DEC"};
+
+/**
+ * @brief Tokens of the indices the live dump lists, so spot lookups match production
+ */
+uint64_t knownIndexToken(const std::string& symbol) {
+    if (symbol == "NIFTY 50") return 256265;
+    if (symbol == "NIFTY BANK") return 260105;
+    if (symbol == "NIFTY FIN SERVICE") return 257801;
+    if (symbol == "NIFTY MID SELECT") return 288009;
+    return 0;
+}
+
+double roundToTick(double price) {
+    return std::max(TICK_SIZE, std::round(price / TICK_SIZE) * TICK_SIZE);
+}
+
+double normalCdf(double x) {
+    return 0.5 * std::erfc(-x / std::sqrt(2.0));
+}
+
+std::string urlDecode(const std::string& text) {
+    std::string decoded;
+    decoded.reserve(text.size());
+
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (text[i] == '+') {
+            decoded.push_back(' ');
+        } else if (text[i] == '%' && i + 2 < text.size() &&
+                   std::isxdigit(static_cast<unsigned char>(text[i + 1])) &&
+                   std::isxdigit(static_cast<unsigned char>(text[i + 2]))) {
+            decoded.push_back(static_cast<char>(std::stoi(text.substr(i + 1, 2), nullptr, 16)));
+            i += 2;
+        } else {
+            decoded.push_back(text[i]);
+        }
+    }
+
+    return decoded;
+}
+
+std::vector<std::pair<std::string, std::string>> parseForm(const std::string& text) {
+    std::vector<std::pair<std::string, std::string>> fields;
+    size_t start = 0;
+
+    while (start < text.size()) {
+        size_t end = std::min(text.find('&', start), text.size());
+        std::string field = text.substr(start, end - start);
+        size_t equals = field.find('=');
+
+        if (!field.empty()) {
+            fields.emplace_back(urlDecode(field.substr(0, equals)),
+                                equals == std::string::npos ? "" : urlDecode(field.substr(equals + 1)));
+        }
+        start = end + 1;
+    }
+
+    return fields;
+}
+
+std::string formatTimestamp(std::time_t time) {
+    std::tm local = {};
+    localtime_r(&time, &local);
+    char buffer[32];
+    std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &local);
+    return buffer;
+}
+
+const char* reasonPhrase(int status) {
+    switch (status) {
+        case 200: return "OK";
+        case 400: return "Bad Request";
+        case 403: return "Forbidden";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 429: return "Too Many Requests";
+        default: return "Error";
+    }
+}
+
+}  // namespace
+
+/**
+ * @brief State of one connected client
+ */
+struct MockKiteServer::Session {
+    FramedSocket socket;                                  ///< Client connection
+    std::atomic<bool> open{true};                         ///< Whether the client is connected
+    std::mt19937_64 random;                               ///< Latency and price random source
+    std::thread thread;                                   ///< Serves the connection
+};
+
+/**
+ * @brief A synthetic instrument
+ */
+struct MockKiteServer::Instrument {
+    uint64_t token = 0;                                   ///< Instrument token
+    std::string tradingSymbol;                            ///< Trading symbol
+    std::string exchange;                                 ///< Exchange
+    size_t underlying = 0;                                ///< Index into the underlyings
+    bool isIndex = false;                                 ///< Index rather than option
+    bool isCall = false;                                  ///< Call option
+    double strike = 0.0;                                  ///< Strike price
+    double years = 0.0;                                   ///< Time to expiry in years
+};
+
+/**
+ * @brief A placed order
+ */
+struct MockKiteServer::Order {
+    json fields;                                          ///< Order as returned by the API
+};
+
+bool LatencyDistribution::parse(const std::string& text, LatencyDistribution& distribution) {
+    std::vector<std::string> parts;
+    std::stringstream stream(text);
+    std::string part;
+    while (std::getline(stream, part, ':')) {
+        parts.push_back(part);
+    }
+
+    try {
+        if (parts.size() == 2 && parts[0] == "fixed") {
+            distribution = {Kind::FIXED, std::stod(parts[1]), 0.0};
+        } else if (parts.size() == 3 && parts[0] == "uniform") {
+            distribution = {Kind::UNIFORM, std::stod(parts[1]), std::stod(parts[2])};
+        } else if (parts.size() == 3 && parts[0] == "lognormal") {
+            distribution = {Kind::LOGNORMAL, std::stod(parts[1]), std::stod(parts[2])};
+        } else {
+            return false;
+        }
+    } catch (const std::exception&) {
+        return false;
+    }
+
+    return distribution.a >= 0.0 && distribution.b >= 0.0;
+}
+
+int64_t LatencyDistribution::sampleUs(std::mt19937_64& random) const {
+    double milliseconds = a;
+
+    switch (kind) {
+        case Kind::FIXED:
+            break;
+        case Kind::UNIFORM:
+            milliseconds = std::uniform_real_distribution<double>(a, std::max(a, b))(random);
+            break;
+        case Kind::LOGNORMAL:
+            milliseconds = a > 0.0 ? std::lognormal_distribution<double>(std::log(a), b)(random) : 0.0;
+            break;
+    }
+
+    return static_cast<int64_t>(milliseconds * 1000.0);
+}
+
+std::string LatencyDistribution::toString() const {
+    switch (kind) {
+        case Kind::FIXED: return fmt::format("fixed:{}", a);
+        case Kind::UNIFORM: return fmt::format("uniform:{}:{}", a, b);
+        case Kind::LOGNORMAL: return fmt::format("lognormal:{}:{}", a, b);
+    }
+    return "";
+}
+
+MockKiteServer::MockKiteServer(const MockKiteOptions& options)
+    : m_options(options),
+      m_latencyRandom(options.seed) {
+}
+
+MockKiteServer::~MockKiteServer() {
+    stop();
+}
+
+bool MockKiteServer::start(std::string& error) {
+    if (m_options.underlyings.empty() || m_options.strikesPerExpiry <= 0 || m_options.expiries <= 0) {
+        error = "at least one underlying, strike and expiry is required";
+        return false;
+    }
+
+    buildInstruments();
+
+    if (!m_listener.listen(m_options.host, m_options.port, error)) {
+        return false;
+    }
+
+    m_running = true;
+    m_acceptThread = std::thread(&MockKiteServer::acceptLoop, this);
+    return true;
+}
+
+void MockKiteServer::stop() {
+    if (!m_running.exchange(false)) {
+        return;
+    }
+
+    m_listener.shutdown();
+    if (m_acceptThread.joinable()) {
+        m_acceptThread.join();
+    }
+
+    std::lock_guard<std::mutex> lock(m_sessionsMutex);
+    for (auto& session : m_sessions) {
+        session->open = false;
+        session->socket.shutdown();
+        session->thread.join();
+    }
+    m_sessions.clear();
+
+    m_listener.close();
+}
+
+std::string MockKiteServer::baseUrl() const {
+    return fmt::format("http://{}:{}", m_options.host, port());
+}
+
+size_t MockKiteServer::instrumentCount() const {
+    return m_instruments.size();
+}
+
+std::vector<MockEndpointStats> MockKiteServer::getStats() const {
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+
+    std::vector<MockEndpointStats> stats;
+    for (const auto& entry : m_stats) {
+        stats.push_back(entry.second);
+    }
+    return stats;
+}
+
+void MockKiteServer::resetStats() {
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    m_stats.clear();
+    m_connections = 0;
+}
+
+void MockKiteServer::buildInstruments() {
+    m_instruments.clear();
+    m_byToken.clear();
+    m_bySymbol.clear();
+
+    // Weekly expiries fall on Thursdays, starting with today's if it is one
+    std::time_t now = std::time(nullptr);
+    std::tm today = {};
+    localtime_r(&now, &today);
+    int daysToThursday = (4 - today.tm_wday + 7) % 7;
+
+    std::string csv = "instrument_token,exchange_token,tradingsymbol,name,last_price,expiry,strike,"
+                      "tick_size,lot_size,instrument_type,segment,exchange\n";
+    uint64_t nextOptionId = 100000;
+
+    for (size_t u = 0; u < m_options.underlyings.size(); ++u) {
+        const MockUnderlying& underlying = m_options.underlyings[u];
+
+        Instrument index;
+        index.token = knownIndexToken(underlying.spotSymbol);
+        if (index.token == 0) {
+            index.token = (static_cast<uint64_t>(1000 + u) << 8) | SEGMENT_INDICES;
+        }
+        index.tradingSymbol = underlying.spotSymbol;
+        index.exchange = "NSE";
+        index.underlying = u;
+        index.isIndex = true;
+        m_instruments.push_back(index);
+
+        csv += fmt::format("{},{},{},{},0,,0,0,0,EQ,INDICES,NSE\n",
+                           index.token, index.token >> 8, index.tradingSymbol, index.tradingSymbol);
+
+        double center = std::round(underlying.spot / underlying.strikeStep) * underlying.strikeStep;
+        double lowest = center - underlying.strikeStep * (m_options.strikesPerExpiry / 2);
+
+        for (int e = 0; e < m_options.expiries; ++e) {
+            int days = daysToThursday + 7 * e;
+            std::tm expiry = today;
+            expiry.tm_mday += days;
+            expiry.tm_hour = 12;
+            std::mktime(&expiry);
+
+            std::string expiryDate = fmt::format("{:04}-{:02}-{:02}",
+                                                 expiry.tm_year + 1900, expiry.tm_mon + 1, expiry.tm_mday);
+            std::string symbolPrefix = fmt::format("{}{:02}{}{:02}", underlying.name,
+                                                   expiry.tm_year % 100, MONTHS[expiry.tm_mon], expiry.tm_mday);
+
+            for (int s = 0; s < m_options.strikesPerExpiry; ++s) {
+                double strike = lowest + underlying.strikeStep * s;
+
+                for (bool call : {true, false}) {
+                    Instrument option;
+                    option.token = (nextOptionId++ << 8) | SEGMENT_NFO_OPT;
+                    option.tradingSymbol = fmt::format("{}{}{}", symbolPrefix, strike, call ? "CE" : "PE");
+                    option.exchange = "NFO";
+                    option.underlying = u;
+                    option.isCall = call;
+                    option.strike = strike;
+                    // Expiring options keep a few hours of time value
+                    option.years = std::max(0.25, static_cast<double>(days)) / 365.0;
+                    m_instruments.push_back(option);
+
+                    csv += fmt::format("{},{},{},\"{}\",0,{},{},{},{},{},NFO-OPT,NFO\n",
+                                       option.token, option.token >> 8, option.tradingSymbol, underlying.name,
+                                       expiryDate, strike, TICK_SIZE, underlying.lotSize, call ? "CE" : "PE");
+                }
+            }
+        }
+    }
+
+    for (size_t i = 0; i < m_instruments.size(); ++i) {
+        m_byToken[m_instruments[i].token] = i;
+        m_bySymbol[m_instruments[i].exchange + ":" + m_instruments[i].tradingSymbol] = i;
+    }
+
+    m_instrumentsCsv = std::move(csv);
+}
+
+void MockKiteServer::acceptLoop() {
+    while (m_running.load()) {
+        FramedSocket socket = m_listener.accept();
+        if (!socket.isOpen()) {
+            continue;
+        }
+
+        auto session = std::make_shared<Session>();
+        session->socket = std::move(socket);
+        session->random.seed(m_options.seed + m_connections.fetch_add(1) + 1);
+
+        std::lock_guard<std::mutex> lock(m_sessionsMutex);
+
+        // Reap clients that have gone away
+        for (auto it = m_sessions.begin(); it != m_sessions.end();) {
+            if (!(*it)->open.load()) {
+                (*it)->thread.join();
+                it = m_sessions.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        if (!m_running.load()) {
+            session->socket.close();
+            break;
+        }
+
+        session->thread = std::thread(&MockKiteServer::serve, this, session);
+        m_sessions.push_back(session);
+    }
+}
+
+void MockKiteServer::serve(const std::shared_ptr<Session>& session) {
+    Request request;
+
+    while (m_running.load() && readRequest(*session, request)) {
+        auto received = std::chrono::steady_clock::now();
+        std::string group = endpointGroup(request.path);
+
+        Response response;
+        if (!admit(group)) {
+            response = error(429, "NetworkException", "Too many requests");
+        } else {
+            response = dispatch(request);
+        }
+
+        // The service time counts from arrival, so it includes building the response
+        std::this_thread::sleep_until(received + std::chrono::microseconds(sampleLatencyUs(group)));
+
+        {
+            std::lock_guard<std::mutex> lock(m_statsMutex);
+            MockEndpointStats& stats = m_stats[group];
+            if (response.status >= 400 && response.status != 429) {
+                stats.errors++;
+            }
+            stats.bytesSent += response.body.size();
+        }
+
+        auto connection = request.headers.find("connection");
+        bool keepAlive = connection == request.headers.end() || connection->second != "close";
+
+        if (!writeResponse(*session, response, keepAlive) || !keepAlive) {
+            break;
+        }
+    }
+
+    session->socket.shutdown();
+    session->open = false;
+}
+
+bool MockKiteServer::readRequest(Session& session, Request& request) {
+    request = Request();
+
+    std::string line;
+    if (!session.socket.receiveLine(line, MAX_LINE_SIZE)) {
+        return false;
+    }
+
+    // Request line: METHOD TARGET VERSION
+    size_t methodEnd = line.find(' ');
+    size_t targetEnd = line.find(' ', methodEnd + 1);
+    if (methodEnd == std::string::npos || targetEnd == std::string::npos) {
+        return false;
+    }
+
+    request.method = line.substr(0, methodEnd);
+    std::string target = line.substr(methodEnd + 1, targetEnd - methodEnd - 1);
+    size_t queryStart = target.find('?');
+    request.path = target.substr(0, queryStart);
+    if (queryStart != std::string::npos) {
+        request.query = parseForm(target.substr(queryStart + 1));
+    }
+
+    while (true) {
+        if (!session.socket.receiveLine(line, MAX_LINE_SIZE)) {
+            return false;
+        }
+        if (line.empty()) {
+            break;
+        }
+
+        size_t colon = line.find(':');
+        if (colon == std::string::npos) {
+            continue;
+        }
+
+        std::string name = line.substr(0, colon);
+        std::transform(name.begin(), name.end(), name.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+        size_t valueStart = line.find_first_not_of(' ', colon + 1);
+        request.headers[name] = valueStart == std::string::npos ? "" : line.substr(valueStart);
+    }
+
+    auto expect = request.headers.find("expect");
+    if (expect != request.headers.end() && expect->second == "100-continue") {
+        static const char CONTINUE[] = "HTTP/1.1 100 Continue\r\n\r\n";
+        session.socket.sendRaw(CONTINUE, sizeof(CONTINUE) - 1);
+    }
+
+    auto length = request.headers.find("content-length");
+    if (length != request.headers.end()) {
+        // A malformed length gets a 400 and closes the connection; the body cannot be framed
+        const std::string& value = length->second;
+        size_t size = 0;
+        auto parsed = std::from_chars(value.data(), value.data() + value.size(), size);
+        if (parsed.ec != std::errc() || parsed.ptr != value.data() + value.size()) {
+            writeResponse(session, error(400, "InputException", "Invalid Content-Length"), false);
+            return false;
+        }
+        if (size > MAX_BODY_SIZE) {
+            return false;
+        }
+
+        request.body.resize(size);
+        if (size > 0 && !session.socket.receiveRaw(reinterpret_cast<uint8_t*>(&request.body[0]), size)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool MockKiteServer::writeResponse(Session& session, const Response& response, bool keepAlive) {
+    std::string head = fmt::format("HTTP/1.1 {} {}\r\nContent-Type: {}\r\nContent-Length: {}\r\n{}\r\n",
+                                   response.status, reasonPhrase(response.status), response.contentType,
+                                   response.body.size(), keepAlive ? "" : "Connection: close\r\n");
+
+    return session.socket.sendRaw(head.data(), head.size()) &&
+           session.socket.sendRaw(response.body.data(), response.body.size());
+}
+
+MockKiteServer::Response MockKiteServer::dispatch(const Request& request) {
+    if (request.path == "/session/token") {
+        return handleSession(request);
+    }
+
+    // Everything else needs "Authorization: token api_key:access_token"
+    auto authorization = request.headers.find("authorization");
+    if (authorization == request.headers.end() || authorization->second.rfind("token ", 0) != 0 ||
+        authorization->second.find(':') == std::string::npos) {
+        return error(403, "TokenException", "Incorrect `api_key` or `access_token`.");
+    }
+
+    if (request.path == "/instruments") {
+        if (request.method != "GET") {
+            return error(405, "InputException", "Method not allowed");
+        }
+
+        Response response;
+        response.contentType = "text/csv";
+        response.body = m_instrumentsCsv;
+        return response;
+    }
+
+    if (request.path == "/quote" || request.path == "/quote/ltp" || request.path == "/quote/ohlc") {
+        return handleQuote(request, request.path);
+    }
+
+    if (request.path == "/orders" || request.path.rfind("/orders/", 0) == 0 || request.path == "/trades") {
+        return handleOrders(request);
+    }
+
+    return error(404, "GeneralException", "Route not found");
+}
+
+MockKiteServer::Response MockKiteServer::handleQuote(const Request& request, const std::string& endpoint) {
+    std::vector<std::pair<const std::string*, const Instrument*>> requested;
+    for (const auto& param : request.query) {
+        if (param.first == "i") {
+            requested.emplace_back(&param.second, findInstrument(param.second));
+        }
+    }
+
+    if (requested.empty()) {
+        return error(400, "InputException", "No instruments given");
+    }
+
+    // One random walk step per response keeps put-call parity intact within it
+    std::mt19937_64 random(m_options.seed ^ (m_quoteSequence.fetch_add(1) * 0x9E3779B97F4A7C15ULL));
+    std::string timestamp = formatTimestamp(std::time(nullptr));
+
+    fmt::memory_buffer out;
+    fmt::format_to(std::back_inserter(out), "{{\"status\":\"success\",\"data\":{{");
+    bool first = true;
+
+    for (const auto& [key, instrument] : requested) {
+        if (!instrument) {
+            continue;
+        }
+
+        const MockUnderlying& underlying = m_options.underlyings[instrument->underlying];
+        double price = quotePrice(*instrument, random);
+        double open = roundToTick(price * 0.98);
+        double high = roundToTick(price * 1.03);
+        double low = roundToTick(price * 0.96);
+        double close = roundToTick(price * 1.01);
+
+        fmt::format_to(std::back_inserter(out), "{}\"{}\":{{\"instrument_token\":{},\"last_price\":{}",
+                       first ? "" : ",", *key, instrument->token, price);
+        first = false;
+
+        if (endpoint == "/quote/ltp") {
+            fmt::format_to(std::back_inserter(out), "}}");
+            continue;
+        }
+
+        fmt::format_to(std::back_inserter(out),
+                       ",\"ohlc\":{{\"open\":{},\"high\":{},\"low\":{},\"close\":{}}}", open, high, low, close);
+
+        if (endpoint == "/quote/ohlc") {
+            fmt::format_to(std::back_inserter(out), "}}");
+            continue;
+        }
+
+        if (instrument->isIndex) {
+            fmt::format_to(std::back_inserter(out), ",\"timestamp\":\"{}\",\"net_change\":0}}", timestamp);
+            continue;
+        }
+
+        std::uniform_int_distribution<int> lots(1, 40);
+        std::uniform_int_distribution<int> orders(1, 12);
+        int lotSize = underlying.lotSize;
+
+        fmt::format_to(std::back_inserter(out),
+                       ",\"timestamp\":\"{}\",\"last_trade_time\":\"{}\",\"last_quantity\":{},"
+                       "\"volume\":{},\"average_price\":{},\"buy_quantity\":{},\"sell_quantity\":{},"
+                       "\"oi\":{},\"net_change\":0,\"depth\":{{\"buy\":[",
+                       timestamp, timestamp, lotSize, lots(random) * lotSize * 1000,
+                       roundToTick(price * 0.995), lots(random) * lotSize * 50, lots(random) * lotSize * 50,
+                       lots(random) * lotSize * 500);
+
+        for (int level = 0; level < 5; ++level) {
+            fmt::format_to(std::back_inserter(out), "{}{{\"price\":{},\"quantity\":{},\"orders\":{}}}",
+                           level ? "," : "", std::max(TICK_SIZE, roundToTick(price - TICK_SIZE * (level + 1))),
+                           lots(random) * lotSize, orders(random));
+        }
+        fmt::format_to(std::back_inserter(out), "],\"sell\":[");
+        for (int level = 0; level < 5; ++level) {
+            fmt::format_to(std::back_inserter(out), "{}{{\"price\":{},\"quantity\":{},\"orders\":{}}}",
+                           level ? "," : "", roundToTick(price + TICK_SIZE * (level + 1)),
+                           lots(random) * lotSize, orders(random));
+        }
+        fmt::format_to(std::back_inserter(out), "]}}}}");
+    }
+
+    fmt::format_to(std::back_inserter(out), "}}}}");
+
+    Response response;
+    response.body = fmt::to_string(out);
+    return response;
+}
+
+MockKiteServer::Response MockKiteServer::handleOrders(const Request& request) {
+    // Paths: /orders, /orders/{id}, /orders/{variety}, /orders/{variety}/{id}, /trades
+    std::vector<std::string> segments;
+    std::stringstream stream(request.path);
+    std::string segment;
+    while (std::getline(stream, segment, '/')) {
+        if (!segment.empty()) {
+            segments.push_back(segment);
+        }
+    }
+
+    auto success = [](json data) {
+        Response response;
+        response.body = json{{"status", "success"}, {"data", std::move(data)}}.dump();
+        return response;
+    };
+
+    std::lock_guard<std::mutex> lock(m_ordersMutex);
+
+    if (segments[0] == "trades") {
+        json trades = json::array();
+        for (const auto& entry : m_orders) {
+            const json& order = entry.second.fields;
+            if (order["status"] == "COMPLETE") {
+                json trade = order;
+                trade["trade_id"] = "T" + order["order_id"].get<std::string>();
+                trades.push_back(std::move(trade));
+            }
+        }
+        return success(std::move(trades));
+    }
+
+    if (request.method == "GET") {
+        if (segments.size() == 1) {
+            json orders = json::array();
+            for (const auto& entry : m_orders) {
+                orders.push_back(entry.second.fields);
+            }
+            return success(std::move(orders));
+        }
+
+        auto it = m_orders.find(segments[1]);
+        if (segments.size() != 2 || it == m_orders.end()) {
+            return error(400, "InputException", "Invalid order_id");
+        }
+        return success(json::array({it->second.fields}));
+    }
+
+    std::string timestamp = formatTimestamp(std::time(nullptr));
+
+    if (request.method == "POST" && segments.size() == 2) {
+        json order;
+        for (const auto& [name, value] : parseForm(request.body)) {
+            order[name] = value;
+        }
+
+        for (const char* required : {"tradingsymbol", "exchange", "transaction_type", "order_type", "quantity"}) {
+            if (!order.contains(required)) {
+                return error(400, "InputException", fmt::format("Missing {}", required));
+            }
+        }
+
+        const Instrument* instrument = findInstrument(order["exchange"].get<std::string>() + ":" +
+                                                      order["tradingsymbol"].get<std::string>());
+        if (!instrument) {
+            return error(400, "InputException", "Invalid `tradingsymbol`.");
+        }
+
+        std::string orderId = std::to_string(m_nextOrderId++);
+        uint64_t quantity = std::stoull(order["quantity"].get<std::string>());
+        double price = order.contains("price") ? std::stod(order["price"].get<std::string>()) : 0.0;
+        double triggerPrice = order.contains("trigger_price") ?
+            std::stod(order["trigger_price"].get<std::string>()) : 0.0;
+
+        // Market orders fill at a fresh quote
+        std::mt19937_64 random(m_options.seed ^ m_nextOrderId);
+        double fillPrice = price > 0.0 ? price : quotePrice(*instrument, random);
+        bool filled = m_options.fillOrders;
+
+        order["order_id"] = orderId;
+        order["exchange_order_id"] = "1" + orderId;
+        order["variety"] = segments[1];
+        order["instrument_token"] = instrument->token;
+        order["quantity"] = quantity;
+        order["price"] = price;
+        order["trigger_price"] = triggerPrice;
+        order["status"] = filled ? "COMPLETE" : "OPEN";
+        order["filled_quantity"] = filled ? quantity : 0;
+        order["pending_quantity"] = filled ? 0 : quantity;
+        order["cancelled_quantity"] = 0;
+        order["average_price"] = filled ? fillPrice : 0.0;
+        order["order_timestamp"] = timestamp;
+        order["exchange_update_timestamp"] = timestamp;
+
+        m_orders[orderId].fields = std::move(order);
+        return success(json{{"order_id", orderId}});
+    }
+
+    if ((request.method == "PUT" || request.method == "DELETE") && segments.size() == 3) {
+        auto it = m_orders.find(segments[2]);
+        if (it == m_orders.end()) {
+            return error(400, "InputException", "Invalid order_id");
+        }
+
+        json& order = it->second.fields;
+        if (order["status"] != "OPEN") {
+            return error(400, "InputException",
+                         fmt::format("Order cannot be {}ed as it is {}",
+                                     request.method == "PUT" ? "modifi" : "cancell",
+                                     order["status"].get<std::string>()));
+        }
+
+        if (request.method == "DELETE") {
+            order["status"] = "CANCELLED";
+            order["cancelled_quantity"] = order["pending_quantity"];
+            order["pending_quantity"] = 0;
+        } else {
+            for (const auto& [name, value] : parseForm(request.body)) {
+                if (name == "quantity") {
+                    order["quantity"] = std::stoull(value);
+                    order["pending_quantity"] = std::stoull(value);
+                } else if (name == "price" || name == "trigger_price") {
+                    order[name] = std::stod(value);
+                } else if (name == "order_type" || name == "validity") {
+                    order[name] = value;
+                }
+            }
+        }
+
+        order["exchange_update_timestamp"] = timestamp;
+        return success(json{{"order_id", segments[2]}});
+    }
+
+    return error(405, "InputException", "Method not allowed");
+}
+
+MockKiteServer::Response MockKiteServer::handleSession(const Request& request) {
+    Response response;
+
+    if (request.method == "DELETE") {
+        response.body = R"({"status":"success","data":true})";
+        return response;
+    }
+
+    if (request.method != "POST") {
+        return error(405, "InputException", "Method not allowed");
+    }
+
+    json fields;
+    for (const auto& [name, value] : parseForm(request.body)) {
+        fields[name] = value;
+    }
+
+    for (const char* required : {"api_key", "request_token", "checksum"}) {
+        if (!fields.contains(required)) {
+            return error(400, "InputException", fmt::format("Missing {}", required));
+        }
+    }
+
+    json data = {
+        {"user_id", "MOCK01"},
+        {"user_name", "Mock User"},
+        {"api_key", fields["api_key"]},
+        {"access_token", "mock_" + fields["request_token"].get<std::string>()},
+        {"public_token", "mock_public"},
+        {"login_time", formatTimestamp(std::time(nullptr))}
+    };
+
+    response.body = json{{"status", "success"}, {"data", data}}.dump();
+    return response;
+}
+
+std::string MockKiteServer::endpointGroup(const std::string& path) {
+    if (path.rfind("/orders", 0) == 0) {
+        return "/orders";
+    }
+    return path;
+}
+
+bool MockKiteServer::admit(const std::string& group) {
+    auto now = std::chrono::steady_clock::now();
+
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    m_stats[group].endpoint = group;
+    m_stats[group].requests++;
+
+    auto limit = m_options.rateLimits.find(group);
+    double perSecond = limit != m_options.rateLimits.end() ? limit->second : m_options.defaultRateLimit;
+    if (perSecond <= 0.0) {
+        return true;
+    }
+
+    // Sliding one second window, like the exchange-side limiter
+    auto& window = m_windows[group];
+    while (!window.empty() && now - window.front() >= std::chrono::seconds(1)) {
+        window.pop_front();
+    }
+
+    if (static_cast<double>(window.size()) >= perSecond) {
+        m_stats[group].rateLimited++;
+        return false;
+    }
+
+    window.push_back(now);
+    return true;
+}
+
+int64_t MockKiteServer::sampleLatencyUs(const std::string& group) {
+    auto it = m_options.endpointLatency.find(group);
+    const LatencyDistribution& distribution = it != m_options.endpointLatency.end() ? it->second : m_options.latency;
+
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+    return distribution.sampleUs(m_latencyRandom);
+}
+
+double MockKiteServer::quotePrice(const Instrument& instrument, std::mt19937_64& random) const {
+    const MockUnderlying& underlying = m_options.underlyings[instrument.underlying];
+
+    // The index drifts a few basis points between responses
+    std::normal_distribution<double> drift(0.0, 0.0005);
+    double spot = underlying.spot * (1.0 + drift(random));
+
+    if (instrument.isIndex) {
+        return std::round(spot * 100.0) / 100.0;
+    }
+
+    // Black-Scholes at zero rates, so a fairly priced box is worth exactly its strike width
+    double volatility = VOLATILITY * std::sqrt(instrument.years);
+    double d1 = (std::log(spot / instrument.strike) + 0.5 * volatility * volatility) / volatility;
+    double d2 = d1 - volatility;
+    double price = instrument.isCall ?
+        spot * normalCdf(d1) - instrument.strike * normalCdf(d2) :
+        instrument.strike * normalCdf(-d2) - spot * normalCdf(-d1);
+
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    if (uniform(random) < m_options.mispricedFraction) {
+        price *= uniform(random) < 0.5 ? 0.9 : 1.1;
+    }
+
+    return roundToTick(price);
+}
+
+const MockKiteServer::Instrument* MockKiteServer::findInstrument(const std::string& key) const {
+    if (!key.empty() && std::all_of(key.begin(), key.end(), [](unsigned char c) { return std::isdigit(c); })) {
+        auto it = m_byToken.find(std::stoull(key));
+        return it != m_byToken.end() ? &m_instruments[it->second] : nullptr;
+    }
+
+    auto it = m_bySymbol.find(key);
+    return it != m_bySymbol.end() ? &m_instruments[it->second] : nullptr;
+}
+
+MockKiteServer::Response MockKiteServer::error(int status, const std::string& type, const std::string& message) {
+    Response response;
+    response.status = status;
+    response.body = json{{"status", "error"}, {"message", message}, {"error_type", type}}.dump();
+    return response;
+}
+
+}  // namespace BoxStrategy
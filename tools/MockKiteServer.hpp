@@ -0,0 +1,267 @@
+/**
+ * @file MockKiteServer.hpp
+ * @brief Local stand-in for the Kite REST API, for load and latency testing
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <list>
+#include <deque>
+#include <random>
+#include <chrono>
+#include <cstdint>
+#include "../src/utils/FramedSocket.hpp"
+
+namespace BoxStrategy {
+
+/**
+ * @struct LatencyDistribution
+ * @brief Service time added to each response
+ */
+struct LatencyDistribution {
+    /**
+     * @brief Shape of the distribution
+     */
+    enum class Kind {
+        FIXED,       ///< Always a milliseconds
+        UNIFORM,     ///< Between a and b milliseconds
+        LOGNORMAL    ///< Median a milliseconds, log standard deviation b
+    };
+
+    Kind kind = Kind::FIXED;    ///< Shape
+    double a = 0.0;             ///< First parameter
+    double b = 0.0;             ///< Second parameter
+
+    /**
+     * @brief Parse "fixed:MS", "uniform:MIN:MAX" or "lognormal:MEDIAN:SIGMA"
+     * @param text Specification
+     * @param distribution Output distribution
+     * @return False if the specification is malformed
+     */
+    static bool parse(const std::string& text, LatencyDistribution& distribution);
+
+    /**
+     * @brief Draw a service time
+     * @param random Random source
+     * @return Service time in microseconds
+     */
+    int64_t sampleUs(std::mt19937_64& random) const;
+
+    /**
+     * @brief Describe the distribution
+     * @return Specification in the format accepted by parse
+     */
+    std::string toString() const;
+};
+
+/**
+ * @struct MockUnderlying
+ * @brief An index with a synthetic option chain
+ */
+struct MockUnderlying {
+    std::string name;           ///< Underlying name, e.g. "NIFTY"
+    std::string spotSymbol;     ///< Trading symbol of the index on NSE, e.g. "NIFTY 50"
+    double spot = 0.0;          ///< Index level
+    double strikeStep = 0.0;    ///< Distance between strikes
+    int lotSize = 1;            ///< Lot size of the options
+};
+
+/**
+ * @struct MockKiteOptions
+ * @brief Settings of the mock API server
+ */
+struct MockKiteOptions {
+    std::string host = "127.0.0.1";                         ///< Address to bind
+    uint16_t port = 8090;                                   ///< Port to listen on (0 = any free port)
+
+    std::vector<MockUnderlying> underlyings = {
+        {"NIFTY", "NIFTY 50", 22000.0, 50.0, 25},
+        {"BANKNIFTY", "NIFTY BANK", 48000.0, 100.0, 15}
+    };                                                      ///< Indices with option chains
+    int strikesPerExpiry = 100;                             ///< Strikes listed per expiry (calls and puts each)
+    int expiries = 4;                                       ///< Weekly expiries listed per underlying
+    double mispricedFraction = 0.02;                        ///< Share of quotes skewed enough to open a box spread
+
+    LatencyDistribution latency;                            ///< Default service time
+    std::map<std::string, LatencyDistribution> endpointLatency; ///< Service time by endpoint group
+
+    std::map<std::string, double> rateLimits = {
+        {"/quote", 1.0}, {"/quote/ltp", 1.0}, {"/quote/ohlc", 1.0}, {"/orders", 10.0}
+    };                                                      ///< Requests per second by endpoint group
+    double defaultRateLimit = 10.0;                         ///< Requests per second of other groups (0 = unlimited)
+
+    bool fillOrders = true;                                 ///< Complete orders as soon as they are placed
+    uint64_t seed = 42;                                     ///< Random seed for prices and latency
+};
+
+/**
+ * @struct MockEndpointStats
+ * @brief Counters of one endpoint group
+ */
+struct MockEndpointStats {
+    std::string endpoint;       ///< Endpoint group, e.g. "/quote" or "/orders"
+    uint64_t requests = 0;      ///< Requests received
+    uint64_t rateLimited = 0;   ///< Requests answered with 429
+    uint64_t errors = 0;        ///< Requests answered with another 4xx
+    uint64_t bytesSent = 0;     ///< Response body bytes
+};
+
+/**
+ * @class MockKiteServer
+ * @brief Serves the Kite REST endpoints the application uses from synthetic data
+ *
+ * Implements GET /instruments, GET /quote, /quote/ltp and /quote/ohlc,
+ * the /orders endpoints (place, modify, cancel, status, list), GET /trades
+ * and POST/DELETE /session/token over HTTP/1.1 with keep-alive. Each
+ * connection is served by its own thread. A request is first checked
+ * against its endpoint group's rate limit (a one second sliding window,
+ * exceeded requests get 429 like the live API), then delayed by a service
+ * time drawn from the group's latency distribution.
+ *
+ * The instrument dump lists every configured index on NSE and, per
+ * underlying, a call and a put for each strike of each weekly expiry.
+ * Quotes are priced from intrinsic value plus a time value that decays
+ * with expiry, with a small random walk and five-level depth; a
+ * configurable share of them is skewed to create box spread opportunities.
+ */
+class MockKiteServer {
+public:
+    /**
+     * @brief Constructor
+     * @param options Server settings
+     */
+    explicit MockKiteServer(const MockKiteOptions& options);
+
+    /**
+     * @brief Destructor, stops the server
+     */
+    ~MockKiteServer();
+
+    MockKiteServer(const MockKiteServer&) = delete;
+    MockKiteServer& operator=(const MockKiteServer&) = delete;
+
+    /**
+     * @brief Build the synthetic instruments, listen and start accepting clients
+     * @param error Output error description on failure
+     * @return True if listening
+     */
+    bool start(std::string& error);
+
+    /**
+     * @brief Disconnect all clients and stop listening
+     */
+    void stop();
+
+    /**
+     * @brief Get the port the server listens on
+     * @return Port
+     */
+    uint16_t port() const { return m_listener.localPort(); }
+
+    /**
+     * @brief Get the base URL clients should use
+     * @return URL such as "http://127.0.0.1:8090"
+     */
+    std::string baseUrl() const;
+
+    /**
+     * @brief Get the number of synthetic instruments
+     * @return Instrument count
+     */
+    size_t instrumentCount() const;
+
+    /**
+     * @brief Get the counters of every endpoint group seen so far
+     * @return Counters sorted by endpoint group
+     */
+    std::vector<MockEndpointStats> getStats() const;
+
+    /**
+     * @brief Get the number of connections accepted
+     * @return Connection count
+     */
+    uint64_t connectionsAccepted() const { return m_connections.load(); }
+
+    /**
+     * @brief Reset all counters
+     */
+    void resetStats();
+
+private:
+    struct Session;
+    struct Instrument;
+    struct Order;
+
+    /**
+     * @brief A parsed HTTP request
+     */
+    struct Request {
+        std::string method;                                       ///< HTTP method
+        std::string path;                                         ///< Path without the query
+        std::vector<std::pair<std::string, std::string>> query;  ///< Query parameters in order
+        std::unordered_map<std::string, std::string> headers;    ///< Headers with lowercase names
+        std::string body;                                         ///< Request body
+    };
+
+    /**
+     * @brief A response to send
+     */
+    struct Response {
+        int status = 200;                                         ///< HTTP status
+        std::string contentType = "application/json";            ///< Content type
+        std::string body;                                         ///< Body
+    };
+
+    void buildInstruments();
+    void acceptLoop();
+    void serve(const std::shared_ptr<Session>& session);
+    bool readRequest(Session& session, Request& request);
+    bool writeResponse(Session& session, const Response& response, bool keepAlive);
+
+    Response dispatch(const Request& request);
+    Response handleQuote(const Request& request, const std::string& endpoint);
+    Response handleOrders(const Request& request);
+    Response handleSession(const Request& request);
+
+    static std::string endpointGroup(const std::string& path);
+    bool admit(const std::string& group);
+    int64_t sampleLatencyUs(const std::string& group);
+    double quotePrice(const Instrument& instrument, std::mt19937_64& random) const;
+    const Instrument* findInstrument(const std::string& key) const;
+    static Response error(int status, const std::string& type, const std::string& message);
+
+    MockKiteOptions m_options;                                ///< Server settings
+    FramedSocket m_listener;                                  ///< Listening socket
+    std::thread m_acceptThread;                               ///< Accepts clients
+    std::atomic<bool> m_running{false};                       ///< Whether the server is running
+
+    std::list<std::shared_ptr<Session>> m_sessions;           ///< Connected clients
+    std::mutex m_sessionsMutex;                               ///< Guards m_sessions
+
+    std::vector<Instrument> m_instruments;                    ///< Synthetic instruments
+    std::unordered_map<uint64_t, size_t> m_byToken;           ///< Instrument index by token
+    std::unordered_map<std::string, size_t> m_bySymbol;       ///< Instrument index by "EXCHANGE:SYMBOL"
+    std::string m_instrumentsCsv;                             ///< The instrument dump
+
+    std::map<std::string, Order> m_orders;                    ///< Orders by ID
+    uint64_t m_nextOrderId = 240101000000001ULL;              ///< Next order ID
+    std::mutex m_ordersMutex;                                 ///< Guards the orders
+
+    std::map<std::string, std::deque<std::chrono::steady_clock::time_point>> m_windows; ///< Recent requests by group
+    std::map<std::string, MockEndpointStats> m_stats;         ///< Counters by group
+    std::mt19937_64 m_latencyRandom;                          ///< Latency random source
+    mutable std::mutex m_statsMutex;                          ///< Guards windows, counters and latency random
+
+    std::atomic<uint64_t> m_connections{0};                   ///< Connections accepted
+    std::atomic<uint64_t> m_quoteSequence{0};                 ///< Seeds each quote response's random walk
+};
+
+}  // namespace BoxStrategy
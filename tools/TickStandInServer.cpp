@@ -0,0 +1,350 @@
+/**
+ * @file TickStandInServer.cpp
+ * @brief Implementation of the TickStandInServer class
+ */
+
+#include "TickStandInServer.hpp"
+#include "../src/market/TickCodec.hpp"
+#include "../external/json.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <random>
+#include <unordered_map>
+
+using json = nlohmann::json;
+
+namespace BoxStrategy {
+
+namespace {
+
+constexpr double TICK_SIZE = 0.05;  ///< Price step of the synthetic depth ladders
+
+/**
+ * @brief Read a recording made with the record option
+ */
+bool loadRecording(const std::string& path, std::vector<std::vector<uint8_t>>& messages, std::string& error) {
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        error = "cannot open " + path;
+        return false;
+    }
+
+    uint8_t header[4];
+    while (std::fread(header, 1, sizeof(header), file) == sizeof(header)) {
+        size_t size = (static_cast<size_t>(header[0]) << 24) | (static_cast<size_t>(header[1]) << 16) |
+                      (static_cast<size_t>(header[2]) << 8) | static_cast<size_t>(header[3]);
+
+        std::vector<uint8_t> message(size);
+        if (std::fread(message.data(), 1, size, file) != size) {
+            break;
+        }
+        messages.push_back(std::move(message));
+    }
+
+    std::fclose(file);
+
+    if (messages.empty()) {
+        error = "no messages in " + path;
+        return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+/**
+ * @brief State of one connected client
+ */
+struct TickStandInServer::Session {
+    FramedSocket socket;                                  ///< Client connection
+    std::mutex mutex;                                     ///< Guards subscriptions
+    std::mutex sendMutex;                                 ///< Serializes writes to the socket
+    std::unordered_map<uint64_t, TickMode> subscriptions; ///< Subscribed tokens and modes
+    std::atomic<bool> open{true};                         ///< Whether the client is connected
+    std::thread reader;                                   ///< Handles control messages
+    std::thread writer;                                   ///< Streams ticks
+};
+
+TickStandInServer::TickStandInServer(const TickServerOptions& options)
+    : m_options(options) {
+}
+
+TickStandInServer::~TickStandInServer() {
+    stop();
+}
+
+bool TickStandInServer::start(std::string& error) {
+    if (!m_options.replayFile.empty() && !loadRecording(m_options.replayFile, m_replay, error)) {
+        return false;
+    }
+
+    if (!m_options.recordFile.empty()) {
+        m_recordFile = std::fopen(m_options.recordFile.c_str(), "ab");
+        if (!m_recordFile) {
+            error = "cannot open " + m_options.recordFile;
+            return false;
+        }
+    }
+
+    if (!m_listener.listen(m_options.host, m_options.port, error)) {
+        return false;
+    }
+
+    m_running = true;
+    m_acceptThread = std::thread(&TickStandInServer::acceptLoop, this);
+    return true;
+}
+
+void TickStandInServer::stop() {
+    if (!m_running.exchange(false)) {
+        return;
+    }
+
+    m_listener.shutdown();
+    if (m_acceptThread.joinable()) {
+        m_acceptThread.join();
+    }
+
+    std::lock_guard<std::mutex> lock(m_sessionsMutex);
+    for (auto& session : m_sessions) {
+        session->open = false;
+        session->socket.shutdown();
+        session->reader.join();
+        session->writer.join();
+    }
+    m_sessions.clear();
+
+    m_listener.close();
+
+    if (m_recordFile) {
+        std::fclose(m_recordFile);
+        m_recordFile = nullptr;
+    }
+}
+
+void TickStandInServer::acceptLoop() {
+    while (m_running.load()) {
+        FramedSocket socket = m_listener.accept();
+        if (!socket.isOpen()) {
+            continue;
+        }
+
+        auto session = std::make_shared<Session>();
+        session->socket = std::move(socket);
+
+        std::lock_guard<std::mutex> lock(m_sessionsMutex);
+
+        // Reap clients that have gone away
+        for (auto it = m_sessions.begin(); it != m_sessions.end();) {
+            if (!(*it)->open.load()) {
+                (*it)->reader.join();
+                (*it)->writer.join();
+                it = m_sessions.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        if (!m_running.load()) {
+            break;
+        }
+
+        session->reader = std::thread(&TickStandInServer::readControl, this, session);
+        session->writer = std::thread(&TickStandInServer::streamTicks, this, session);
+        m_sessions.push_back(session);
+    }
+}
+
+void TickStandInServer::readControl(const std::shared_ptr<Session>& session) {
+    FramedSocket::FrameType type;
+    std::vector<uint8_t> payload;
+
+    while (session->open.load() && session->socket.receiveFrame(type, payload)) {
+        if (type != FramedSocket::FrameType::TEXT) {
+            continue;
+        }
+
+        json message = json::parse(payload.begin(), payload.end(), nullptr, false);
+        if (message.is_discarded() || !message.contains("a") || !message.contains("v")) {
+            std::lock_guard<std::mutex> lock(session->sendMutex);
+            session->socket.sendText(R"({"type":"error","data":"malformed control message"})");
+            continue;
+        }
+
+        try {
+            applyControl(*session, message["a"].get<std::string>(), message["v"]);
+        } catch (const std::exception& e) {
+            std::lock_guard<std::mutex> lock(session->sendMutex);
+            session->socket.sendText(json({{"type", "error"}, {"data", e.what()}}).dump());
+        }
+    }
+
+    session->open = false;
+}
+
+void TickStandInServer::applyControl(Session& session, const std::string& action, const json& value) {
+    std::lock_guard<std::mutex> lock(session.mutex);
+
+    if (action == "subscribe" && value.is_array()) {
+        // New subscriptions start in quote mode, like the real ticker
+        for (const auto& token : value) {
+            session.subscriptions.emplace(token.get<uint64_t>(), TickMode::QUOTE);
+        }
+    } else if (action == "unsubscribe" && value.is_array()) {
+        for (const auto& token : value) {
+            session.subscriptions.erase(token.get<uint64_t>());
+        }
+    } else if (action == "mode" && value.is_array() && value.size() == 2) {
+        TickMode mode;
+        if (!TickCodec::stringToMode(value[0].get<std::string>(), mode)) {
+            return;
+        }
+        for (const auto& token : value[1]) {
+            auto it = session.subscriptions.find(token.get<uint64_t>());
+            if (it != session.subscriptions.end()) {
+                it->second = mode;
+            }
+        }
+    }
+}
+
+void TickStandInServer::streamTicks(const std::shared_ptr<Session>& session) {
+    using Clock = std::chrono::steady_clock;
+
+    const auto interval = m_options.messagesPerSecond > 0.0
+        ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / m_options.messagesPerSecond))
+        : Clock::duration::zero();
+
+    std::mt19937_64 random(std::random_device{}());
+    std::normal_distribution<double> step(0.0, 0.5);
+    std::unordered_map<uint64_t, Tick> state;
+
+    std::vector<Tick> ticks;
+    std::vector<Tick> recorded;
+    std::vector<uint8_t> message;
+    size_t replayCursor = 0;
+    auto nextSend = Clock::now();
+
+    while (m_running.load() && session->open.load()) {
+        ticks.clear();
+
+        {
+            std::lock_guard<std::mutex> lock(session->mutex);
+
+            if (!m_replay.empty()) {
+                // Play the recording in a loop, keeping only subscribed tokens
+                const auto& source = m_replay[replayCursor];
+                replayCursor = (replayCursor + 1) % m_replay.size();
+
+                recorded.clear();
+                TickCodec::decodeMessage(source.data(), source.size(), recorded);
+
+                for (Tick& tick : recorded) {
+                    auto it = session->subscriptions.find(tick.instrumentToken);
+                    if (it != session->subscriptions.end() && it->second <= tick.mode) {
+                        tick.mode = it->second;
+                        ticks.push_back(tick);
+                    }
+                }
+            } else {
+                int64_t now = static_cast<int64_t>(std::time(nullptr));
+
+                for (const auto& [token, mode] : session->subscriptions) {
+                    auto inserted = state.emplace(token, Tick());
+                    Tick& tick = inserted.first->second;
+                    QuoteModel& quote = tick.quote;
+
+                    if (inserted.second) {
+                        tick.instrumentToken = token;
+                        quote.closePrice = 50.0 + static_cast<double>(token % 500);
+                        quote.lastPrice = quote.openPrice = quote.highPrice = quote.lowPrice = quote.closePrice;
+                    }
+
+                    // Random walk on the tick grid, never below one tick
+                    double price = std::round((quote.lastPrice + step(random)) / TICK_SIZE) * TICK_SIZE;
+                    quote.lastPrice = std::max(TICK_SIZE, price);
+                    quote.highPrice = std::max(quote.highPrice, quote.lastPrice);
+                    quote.lowPrice = std::min(quote.lowPrice, quote.lastPrice);
+                    quote.averagePrice = (quote.highPrice + quote.lowPrice) / 2.0;
+                    tick.lastTradedQuantity = 50;
+                    quote.volume += tick.lastTradedQuantity;
+                    quote.openInterest = 100000.0 + static_cast<double>(token % 1000) * 75.0;
+                    tick.lastTradeTime = now;
+                    tick.exchangeTimestamp = now;
+
+                    quote.buyDepth.clear();
+                    quote.sellDepth.clear();
+                    quote.buyQuantity = 0;
+                    quote.sellQuantity = 0;
+                    for (size_t level = 0; level < DepthLadder::CAPACITY; ++level) {
+                        uint64_t quantity = 75 * (level + 1);
+                        quote.buyDepth.push_back({std::max(TICK_SIZE, quote.lastPrice - TICK_SIZE * (level + 1)),
+                                                  quantity, static_cast<uint32_t>(level + 1)});
+                        quote.sellDepth.push_back({quote.lastPrice + TICK_SIZE * (level + 1),
+                                                   quantity, static_cast<uint32_t>(level + 1)});
+                        quote.buyQuantity += quantity;
+                        quote.sellQuantity += quantity;
+                    }
+
+                    tick.mode = mode;
+                    ticks.push_back(tick);
+                }
+            }
+        }
+
+        message.clear();
+        if (ticks.empty()) {
+            // Heartbeat
+            message.push_back(0);
+        } else {
+            TickCodec::encodeMessage(ticks, message);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(session->sendMutex);
+            if (!session->socket.sendFrame(FramedSocket::FrameType::BINARY, message.data(), message.size())) {
+                break;
+            }
+        }
+
+        if (!ticks.empty()) {
+            m_messagesSent++;
+            m_ticksSent += ticks.size();
+            record(message);
+        }
+
+        if (interval > Clock::duration::zero()) {
+            nextSend += interval;
+            auto now = Clock::now();
+            if (nextSend < now) {
+                // Running late; do not try to catch up with a burst
+                nextSend = now;
+            }
+            std::this_thread::sleep_until(nextSend);
+        } else if (ticks.empty()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+
+    session->open = false;
+    session->socket.shutdown();
+}
+
+void TickStandInServer::record(const std::vector<uint8_t>& message) {
+    if (!m_recordFile) {
+        return;
+    }
+
+    uint8_t header[4] = {
+        static_cast<uint8_t>(message.size() >> 24), static_cast<uint8_t>(message.size() >> 16),
+        static_cast<uint8_t>(message.size() >> 8), static_cast<uint8_t>(message.size())
+    };
+
+    std::lock_guard<std::mutex> lock(m_recordMutex);
+    std::fwrite(header, 1, sizeof(header), m_recordFile);
+    std::fwrite(message.data(), 1, message.size(), m_recordFile);
+}
+
+}  // namespace BoxStrategy
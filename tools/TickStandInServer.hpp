@@ -0,0 +1,115 @@
+/**
+ * @file TickStandInServer.hpp
+ * @brief Local stand-in for the ticker service, for testing and benchmarks
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <list>
+#include <cstdint>
+#include <cstdio>
+#include "../src/utils/FramedSocket.hpp"
+#include "../external/json.hpp"
+
+namespace BoxStrategy {
+
+/**
+ * @struct TickServerOptions
+ * @brief Settings of the stand-in ticker
+ */
+struct TickServerOptions {
+    std::string host = "127.0.0.1";   ///< Address to bind
+    uint16_t port = 9100;             ///< Port to listen on (0 = any free port)
+    double messagesPerSecond = 1.0;   ///< Tick messages per client per second (0 = as fast as possible)
+    std::string replayFile;           ///< Recorded messages to play back instead of synthetic ticks
+    std::string recordFile;           ///< File to append every sent message to
+};
+
+/**
+ * @class TickStandInServer
+ * @brief Speaks the ticker protocol against TickFeed without the live service
+ *
+ * Clients subscribe with the same JSON control messages as the real ticker.
+ * Each client gets one message per interval holding a packet for every
+ * subscribed token in its mode. Prices are a random walk per token, or come
+ * from a recording: a file of messages, each prefixed with its big-endian
+ * 32-bit length, filtered down to the client's subscriptions.
+ */
+class TickStandInServer {
+public:
+    /**
+     * @brief Constructor
+     * @param options Server settings
+     */
+    explicit TickStandInServer(const TickServerOptions& options);
+
+    /**
+     * @brief Destructor, stops the server
+     */
+    ~TickStandInServer();
+
+    TickStandInServer(const TickStandInServer&) = delete;
+    TickStandInServer& operator=(const TickStandInServer&) = delete;
+
+    /**
+     * @brief Listen and start accepting clients
+     * @param error Output error description on failure
+     * @return True if listening
+     */
+    bool start(std::string& error);
+
+    /**
+     * @brief Disconnect all clients and stop listening
+     */
+    void stop();
+
+    /**
+     * @brief Get the port the server listens on
+     * @return Port
+     */
+    uint16_t port() const { return m_listener.localPort(); }
+
+    /**
+     * @brief Get the number of tick messages sent to all clients
+     * @return Message count
+     */
+    uint64_t messagesSent() const { return m_messagesSent.load(); }
+
+    /**
+     * @brief Get the number of tick packets sent to all clients
+     * @return Packet count
+     */
+    uint64_t ticksSent() const { return m_ticksSent.load(); }
+
+private:
+    struct Session;
+
+    void acceptLoop();
+    void readControl(const std::shared_ptr<Session>& session);
+    void applyControl(Session& session, const std::string& action, const nlohmann::json& value);
+    void streamTicks(const std::shared_ptr<Session>& session);
+    void record(const std::vector<uint8_t>& message);
+
+    TickServerOptions m_options;                     ///< Server settings
+    FramedSocket m_listener;                         ///< Listening socket
+    std::thread m_acceptThread;                      ///< Accepts clients
+    std::atomic<bool> m_running{false};              ///< Whether the server is running
+
+    std::list<std::shared_ptr<Session>> m_sessions;  ///< Connected clients
+    std::mutex m_sessionsMutex;                      ///< Guards m_sessions
+
+    std::vector<std::vector<uint8_t>> m_replay;      ///< Recorded messages to play back
+    FILE* m_recordFile = nullptr;                    ///< Recording output
+    std::mutex m_recordMutex;                        ///< Serializes recording
+
+    std::atomic<uint64_t> m_messagesSent{0};         ///< Tick messages sent
+    std::atomic<uint64_t> m_ticksSent{0};            ///< Tick packets sent
+};
+
+}  // namespace BoxStrategy
@@ -0,0 +1,135 @@
+/**
+ * @file mock_kite_server.cpp
+ * @brief Mock Kite REST API server for running the application without the live API
+ *
+ * Usage: mock_kite_server [--host ADDR] [--port N] [--strikes N] [--expiries N]
+ *                         [--latency SPEC] [--endpoint-latency GROUP=SPEC]
+ *                         [--rate-limit GROUP=PER_SEC] [--mispriced FRACTION]
+ *                         [--no-fill] [--seed N]
+ *
+ * Latency specs are fixed:MS, uniform:MIN:MAX or lognormal:MEDIAN:SIGMA.
+ * Endpoint groups are paths such as /quote or /instruments, with all order
+ * endpoints grouped as /orders; a rate limit of 0 removes the limit.
+ *
+ * Point the application at it with api/base_url = "http://ADDR:N"; any
+ * request token completes the login.
+ */
+
+#include <iostream>
+#include <string>
+#include <thread>
+#include <chrono>
+#include <csignal>
+#include <atomic>
+#include <fmt/format.h>
+#include "MockKiteServer.hpp"
+
+using namespace BoxStrategy;
+
+namespace {
+
+std::atomic<bool> g_running{true};
+
+void signalHandler(int) {
+    g_running = false;
+}
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program
+              << " [--host ADDR] [--port N] [--strikes N] [--expiries N] [--latency SPEC]\n"
+                 "       [--endpoint-latency GROUP=SPEC] [--rate-limit GROUP=PER_SEC] [--mispriced FRACTION]\n"
+                 "       [--no-fill] [--seed N]\n"
+                 "Latency SPEC: fixed:MS | uniform:MIN:MAX | lognormal:MEDIAN:SIGMA\n";
+}
+
+/**
+ * @brief Split a GROUP=VALUE argument
+ */
+bool splitAssignment(const std::string& text, std::string& name, std::string& value) {
+    size_t equals = text.find('=');
+    if (equals == std::string::npos || equals == 0) {
+        return false;
+    }
+
+    name = text.substr(0, equals);
+    value = text.substr(equals + 1);
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    MockKiteOptions options;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            std::string name;
+            std::string value;
+
+            if (arg == "--host" && hasValue) {
+                options.host = argv[++i];
+            } else if (arg == "--port" && hasValue) {
+                options.port = static_cast<uint16_t>(std::stoi(argv[++i]));
+            } else if (arg == "--strikes" && hasValue) {
+                options.strikesPerExpiry = std::stoi(argv[++i]);
+            } else if (arg == "--expiries" && hasValue) {
+                options.expiries = std::stoi(argv[++i]);
+            } else if (arg == "--latency" && hasValue) {
+                if (!LatencyDistribution::parse(argv[++i], options.latency)) {
+                    printUsage(argv[0]);
+                    return 1;
+                }
+            } else if (arg == "--endpoint-latency" && hasValue && splitAssignment(argv[++i], name, value)) {
+                if (!LatencyDistribution::parse(value, options.endpointLatency[name])) {
+                    printUsage(argv[0]);
+                    return 1;
+                }
+            } else if (arg == "--rate-limit" && hasValue && splitAssignment(argv[++i], name, value)) {
+                options.rateLimits[name] = std::stod(value);
+            } else if (arg == "--mispriced" && hasValue) {
+                options.mispricedFraction = std::stod(argv[++i]);
+            } else if (arg == "--no-fill") {
+                options.fillOrders = false;
+            } else if (arg == "--seed" && hasValue) {
+                options.seed = std::stoull(argv[++i]);
+            } else {
+                printUsage(argv[0]);
+                return 1;
+            }
+        }
+    } catch (const std::exception&) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    std::signal(SIGINT, signalHandler);
+    std::signal(SIGTERM, signalHandler);
+
+    MockKiteServer server(options);
+
+    std::string error;
+    if (!server.start(error)) {
+        std::cerr << "Failed to start mock API server: " << error << std::endl;
+        return 1;
+    }
+
+    std::cout << fmt::format("Mock Kite API listening on {} with {} instruments, latency {}\n",
+                             server.baseUrl(), server.instrumentCount(), options.latency.toString())
+              << std::flush;
+
+    while (g_running.load()) {
+        std::this_thread::sleep_for(std::chrono::seconds(10));
+
+        for (const auto& stats : server.getStats()) {
+            std::cout << fmt::format("{}: {} requests, {} rate limited, {} errors, {:.1f} MB\n",
+                                     stats.endpoint, stats.requests, stats.rateLimited, stats.errors,
+                                     stats.bytesSent / (1024.0 * 1024.0));
+        }
+        std::cout << std::flush;
+    }
+
+    server.stop();
+    return 0;
+}
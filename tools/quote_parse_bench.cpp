@@ -0,0 +1,210 @@
+/**
+ * @file quote_parse_bench.cpp
+ * @brief Parse throughput of /quote responses: JSON tree versus streaming parser
+ *
+ * Usage: quote_parse_bench [--instruments N] [--iterations I]
+ *
+ * Builds a /quote response body for N instruments with five-level depth
+ * and parses it I times into a quote store, once the way the market data
+ * manager used to (a full JSON tree, a copy of "data" and field lookups
+ * into an InstrumentModel) and once with QuoteResponseParser. Reports MB/s
+ * for both and checks that they leave identical quotes in the store.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <fmt/format.h>
+#include "../external/json.hpp"
+#include "../src/market/QuoteResponseParser.hpp"
+#include "../src/market/QuoteStore.hpp"
+#include "../src/market/InstrumentUniverse.hpp"
+
+using namespace BoxStrategy;
+using json = nlohmann::json;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+std::shared_ptr<const InstrumentUniverse> makeUniverse(size_t count) {
+    std::vector<InstrumentRef> instruments(count);
+    for (size_t i = 0; i < count; ++i) {
+        instruments[i].instrumentToken = (static_cast<uint64_t>(i + 1) << 8) | 2;
+        instruments[i].tradingSymbol = fmt::format("SYM{}", i);
+        instruments[i].exchange = "NFO";
+    }
+    return std::make_shared<const InstrumentUniverse>(std::move(instruments), 1);
+}
+
+std::string makeBody(const InstrumentUniverse& universe) {
+    std::string body = R"({"status":"success","data":{)";
+
+    for (uint32_t ordinal = 0; ordinal < universe.size(); ++ordinal) {
+        uint64_t token = universe.at(ordinal).instrumentToken;
+        double price = 100.0 + ordinal * 0.05;
+
+        std::string depth[2];
+        for (int side = 0; side < 2; ++side) {
+            for (int level = 0; level < 5; ++level) {
+                double levelPrice = side == 0 ? price - 0.05 * (level + 1) : price + 0.05 * (level + 1);
+                depth[side] += fmt::format(R"({}{{"price":{:.2f},"quantity":{},"orders":{}}})",
+                                           level == 0 ? "" : ",", levelPrice, 50 * (level + 1), level + 1);
+            }
+        }
+
+        body += fmt::format(
+            R"({}"{}":{{"instrument_token":{},"timestamp":"2024-01-25 10:15:30","last_trade_time":"2024-01-25 10:15:29",)"
+            R"("last_price":{:.2f},"last_quantity":50,"buy_quantity":{},"sell_quantity":{},"volume":{},)"
+            R"("average_price":{:.2f},"oi":{},"oi_day_high":0,"oi_day_low":0,"net_change":0,)"
+            R"("lower_circuit_limit":0.05,"upper_circuit_limit":{:.2f},)"
+            R"("ohlc":{{"open":{:.2f},"high":{:.2f},"low":{:.2f},"close":{:.2f}}},)"
+            R"("depth":{{"buy":[{}],"sell":[{}]}}}})",
+            ordinal == 0 ? "" : ",", token, token, price, 1000 + ordinal, 1200 + ordinal, 50000 + ordinal,
+            price - 0.5, 250000 + ordinal, price * 2, price - 2, price + 3, price - 4, price - 1,
+            depth[0], depth[1]);
+    }
+
+    body += "}}";
+    return body;
+}
+
+QuoteModel parseTreeQuote(const json& quoteJson) {
+    QuoteModel quote;
+
+    if (quoteJson.contains("last_price")) quote.lastPrice = quoteJson["last_price"].get<double>();
+    if (quoteJson.contains("ohlc")) {
+        const auto& ohlc = quoteJson["ohlc"];
+        if (ohlc.contains("open")) quote.openPrice = ohlc["open"].get<double>();
+        if (ohlc.contains("high")) quote.highPrice = ohlc["high"].get<double>();
+        if (ohlc.contains("low")) quote.lowPrice = ohlc["low"].get<double>();
+        if (ohlc.contains("close")) quote.closePrice = ohlc["close"].get<double>();
+    }
+    if (quoteJson.contains("average_price")) quote.averagePrice = quoteJson["average_price"].get<double>();
+    if (quoteJson.contains("volume")) quote.volume = quoteJson["volume"].get<uint64_t>();
+    if (quoteJson.contains("buy_quantity")) quote.buyQuantity = quoteJson["buy_quantity"].get<uint64_t>();
+    if (quoteJson.contains("sell_quantity")) quote.sellQuantity = quoteJson["sell_quantity"].get<uint64_t>();
+    if (quoteJson.contains("oi")) quote.openInterest = quoteJson["oi"].get<double>();
+    if (quoteJson.contains("depth")) {
+        const auto& depth = quoteJson["depth"];
+        for (const char* side : {"buy", "sell"}) {
+            if (!depth.contains(side)) continue;
+            DepthLadder& ladder = side[0] == 'b' ? quote.buyDepth : quote.sellDepth;
+            for (const auto& level : depth[side]) {
+                DepthItem item;
+                if (level.contains("price")) item.price = level["price"].get<double>();
+                if (level.contains("quantity")) item.quantity = level["quantity"].get<uint64_t>();
+                if (level.contains("orders")) item.orders = level["orders"].get<uint32_t>();
+                ladder.push_back(item);
+            }
+        }
+    }
+    return quote;
+}
+
+/**
+ * @brief The previous path: JSON tree, a copy of "data", lookups per requested token
+ */
+size_t parseWithTree(const std::string& body, const std::vector<uint64_t>& tokens, QuoteStore& store) {
+    json responseJson = json::parse(body);
+    size_t stored = 0;
+
+    if (responseJson["status"] == "success") {
+        json data = responseJson["data"];
+        for (uint64_t token : tokens) {
+            auto tokenStr = std::to_string(token);
+            if (data.find(tokenStr) != data.end()) {
+                uint32_t ordinal = 0;
+                if (store.getUniverse()->findOrdinal(token, ordinal)) {
+                    store.update(ordinal, parseTreeQuote(data[tokenStr]));
+                    stored++;
+                }
+            }
+        }
+    }
+    return stored;
+}
+
+bool sameQuote(const QuoteModel& a, const QuoteModel& b) {
+    bool same = a.lastPrice == b.lastPrice && a.openPrice == b.openPrice && a.highPrice == b.highPrice &&
+                a.lowPrice == b.lowPrice && a.closePrice == b.closePrice && a.averagePrice == b.averagePrice &&
+                a.volume == b.volume && a.buyQuantity == b.buyQuantity && a.sellQuantity == b.sellQuantity &&
+                a.openInterest == b.openInterest && a.buyDepth.size() == b.buyDepth.size() &&
+                a.sellDepth.size() == b.sellDepth.size();
+
+    for (size_t i = 0; same && i < a.buyDepth.size(); ++i) {
+        same = a.buyDepth[i].price == b.buyDepth[i].price && a.buyDepth[i].quantity == b.buyDepth[i].quantity &&
+               a.buyDepth[i].orders == b.buyDepth[i].orders;
+    }
+    for (size_t i = 0; same && i < a.sellDepth.size(); ++i) {
+        same = a.sellDepth[i].price == b.sellDepth[i].price && a.sellDepth[i].quantity == b.sellDepth[i].quantity &&
+               a.sellDepth[i].orders == b.sellDepth[i].orders;
+    }
+    return same;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    size_t instrumentCount = 500;
+    size_t iterations = 200;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--instruments" && i + 1 < argc) {
+            instrumentCount = std::max(1, std::stoi(argv[++i]));
+        } else if (arg == "--iterations" && i + 1 < argc) {
+            iterations = std::max(1, std::stoi(argv[++i]));
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--instruments N] [--iterations I]\n";
+            return 1;
+        }
+    }
+
+    auto universe = makeUniverse(instrumentCount);
+    std::string body = makeBody(*universe);
+
+    std::vector<uint64_t> tokens;
+    for (const auto& instrument : universe->getInstruments()) {
+        tokens.push_back(instrument.instrumentToken);
+    }
+
+    QuoteStore treeStore(universe);
+    QuoteStore streamStore(universe);
+    double megabytes = static_cast<double>(body.size()) * iterations / (1024.0 * 1024.0);
+
+    auto start = Clock::now();
+    size_t treeStored = 0;
+    for (size_t i = 0; i < iterations; ++i) {
+        treeStored = parseWithTree(body, tokens, treeStore);
+    }
+    double treeSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    start = Clock::now();
+    QuoteParseResult result;
+    for (size_t i = 0; i < iterations; ++i) {
+        result = QuoteResponseParser::parse(body, QuoteResponseKind::QUOTE, &streamStore);
+    }
+    double streamSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    size_t mismatches = 0;
+    for (uint32_t ordinal = 0; ordinal < universe->size(); ++ordinal) {
+        QuoteModel fromTree;
+        QuoteModel fromStream;
+        if (!treeStore.read(ordinal, fromTree) || !streamStore.read(ordinal, fromStream) ||
+            !sameQuote(fromTree, fromStream)) {
+            mismatches++;
+        }
+    }
+
+    std::cout << fmt::format("Body: {} instruments, {:.1f} KB\n", instrumentCount, body.size() / 1024.0);
+    std::cout << fmt::format("JSON tree:   {:>8.1f} MB/s ({:.1f} us per body, {} stored)\n",
+                             megabytes / treeSeconds, treeSeconds * 1e6 / iterations, treeStored);
+    std::cout << fmt::format("Streaming:   {:>8.1f} MB/s ({:.1f} us per body, {} stored)\n",
+                             megabytes / streamSeconds, streamSeconds * 1e6 / iterations, result.stored);
+    std::cout << fmt::format("Speedup:     {:.2f}x, {} mismatching quotes\n", treeSeconds / streamSeconds, mismatches);
+
+    return result.success && mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,148 @@
+/**
+ * @file quote_store_bench.cpp
+ * @brief Reader scalability and consistency check of the quote store
+ *
+ * Usage: quote_store_bench [--instruments N] [--max-readers R] [--seconds S]
+ *
+ * One writer keeps rewriting random slots with full quotes whose fields all
+ * carry the same value, while 1, 2, 4 ... R readers read random slots. Each
+ * round reports the read throughput and the number of torn reads (quotes
+ * whose fields disagree), which must be zero.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fmt/format.h>
+#include "../src/market/QuoteStore.hpp"
+#include "../src/market/InstrumentUniverse.hpp"
+
+using namespace BoxStrategy;
+
+namespace {
+
+std::shared_ptr<const InstrumentUniverse> makeUniverse(size_t count) {
+    std::vector<InstrumentRef> instruments(count);
+    for (size_t i = 0; i < count; ++i) {
+        instruments[i].instrumentToken = (static_cast<uint64_t>(i + 1) << 8) | 2;
+        instruments[i].tradingSymbol = fmt::format("SYM{}", i);
+        instruments[i].exchange = "NFO";
+    }
+    return std::make_shared<const InstrumentUniverse>(std::move(instruments), 1);
+}
+
+QuoteModel makeQuote(double value) {
+    QuoteModel quote;
+    quote.lastPrice = quote.openPrice = quote.highPrice = quote.lowPrice = quote.closePrice = value;
+    quote.averagePrice = quote.openInterest = value;
+    quote.volume = quote.buyQuantity = quote.sellQuantity = static_cast<uint64_t>(value);
+    for (size_t level = 0; level < DepthLadder::CAPACITY; ++level) {
+        quote.buyDepth.push_back({value, static_cast<uint64_t>(value), static_cast<uint32_t>(value)});
+        quote.sellDepth.push_back({value, static_cast<uint64_t>(value), static_cast<uint32_t>(value)});
+    }
+    return quote;
+}
+
+bool isConsistent(const QuoteModel& quote) {
+    double value = quote.lastPrice;
+    bool consistent = quote.openPrice == value && quote.highPrice == value && quote.lowPrice == value &&
+                      quote.closePrice == value && quote.averagePrice == value && quote.openInterest == value &&
+                      quote.volume == static_cast<uint64_t>(value) &&
+                      quote.buyDepth.size() == DepthLadder::CAPACITY &&
+                      quote.sellDepth.size() == DepthLadder::CAPACITY;
+
+    for (size_t level = 0; consistent && level < DepthLadder::CAPACITY; ++level) {
+        consistent = quote.buyDepth[level].price == value && quote.sellDepth[level].price == value &&
+                     quote.buyDepth[level].quantity == static_cast<uint64_t>(value);
+    }
+    return consistent;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    size_t instrumentCount = 20000;
+    size_t maxReaders = std::max(1u, std::thread::hardware_concurrency());
+    double seconds = 2.0;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--instruments" && i + 1 < argc) {
+            instrumentCount = std::max(1, std::stoi(argv[++i]));
+        } else if (arg == "--max-readers" && i + 1 < argc) {
+            maxReaders = std::max(1, std::stoi(argv[++i]));
+        } else if (arg == "--seconds" && i + 1 < argc) {
+            seconds = std::max(0.1, std::stod(argv[++i]));
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--instruments N] [--max-readers R] [--seconds S]\n";
+            return 1;
+        }
+    }
+
+    QuoteStore store(makeUniverse(instrumentCount));
+    for (uint32_t ordinal = 0; ordinal < store.size(); ++ordinal) {
+        store.update(ordinal, makeQuote(1.0));
+    }
+
+    bool allConsistent = true;
+
+    for (size_t readers = 1; readers <= maxReaders; readers *= 2) {
+        std::atomic<bool> running{true};
+        std::atomic<uint64_t> reads{0};
+        std::atomic<uint64_t> torn{0};
+        std::atomic<uint64_t> writes{0};
+
+        std::thread writer([&]() {
+            std::mt19937 random(1);
+            std::uniform_int_distribution<uint32_t> pick(0, static_cast<uint32_t>(store.size() - 1));
+            double value = 2.0;
+            uint64_t count = 0;
+
+            while (running.load(std::memory_order_relaxed)) {
+                store.update(pick(random), makeQuote(value));
+                value = value >= 1e6 ? 2.0 : value + 1.0;
+                count++;
+            }
+            writes = count;
+        });
+
+        std::vector<std::thread> threads;
+        for (size_t r = 0; r < readers; ++r) {
+            threads.emplace_back([&, r]() {
+                std::mt19937 random(static_cast<uint32_t>(r + 100));
+                std::uniform_int_distribution<uint32_t> pick(0, static_cast<uint32_t>(store.size() - 1));
+                QuoteModel quote;
+                uint64_t count = 0;
+                uint64_t bad = 0;
+
+                while (running.load(std::memory_order_relaxed)) {
+                    store.read(pick(random), quote);
+                    bad += isConsistent(quote) ? 0 : 1;
+                    count++;
+                }
+                reads += count;
+                torn += bad;
+            });
+        }
+
+        std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+        running = false;
+        writer.join();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        std::cout << fmt::format("{:>3} readers: {:>12.0f} reads/sec ({:>10.0f} per reader), "
+                                 "{:>10.0f} writes/sec, {} torn reads\n",
+                                 readers, reads / seconds, reads / seconds / readers,
+                                 writes / seconds, torn.load());
+        allConsistent = allConsistent && torn.load() == 0;
+    }
+
+    return allConsistent ? 0 : 1;
+}
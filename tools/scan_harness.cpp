@@ -0,0 +1,548 @@
+/**
+ * @file scan_harness.cpp
+ * @brief End-to-end load and latency harness running scan cycles against the mock API
+ *
+ * Usage: scan_harness [--cycles N] [--underlyings A,B] [--strikes N] [--expiries N]
+ *                     [--latency SPEC] [--endpoint-latency GROUP=SPEC]
+ *                     [--rate-limit GROUP=PER_SEC] [--orders] [--url URL]
+ *                     [--config FILE] [--set KEY=VALUE] [--http-requests N]
+ *                     [--concurrency N] [--async] [--verbose]
+ *
+ * Starts an in-process MockKiteServer (or uses the server at --url), logs
+ * in through /session/token and wires the application's components to it
+ * exactly as main does. It then times the instrument load and N scan cycles
+ * over every underlying: find profitable spreads, filter by liquidity and,
+ * with --orders, place the best box spread as live orders on the mock.
+ * --http-requests additionally fires raw /quote requests through HttpClient
+ * from --concurrency threads, bypassing the scheduler, to measure the client
+ * on its own (lift the mock's /quote limit with --rate-limit /quote=0). With
+ * --async one thread keeps --concurrency requests in flight through the
+ * callback API instead.
+ *
+ * Settings come from --config (copied, never written) or the harness
+ * defaults, then --set overrides such as --set api/rate_limits/quote=120.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <filesystem>
+#include <unistd.h>
+#include <fmt/format.h>
+#include "MockKiteServer.hpp"
+#include "../src/utils/Logger.hpp"
+#include "../src/utils/HttpClient.hpp"
+#include "../src/utils/ThreadPool.hpp"
+#include "../src/utils/ThreadTopology.hpp"
+#include "../src/config/ConfigManager.hpp"
+#include "../src/auth/AuthManager.hpp"
+#include "../src/market/MarketDataManager.hpp"
+#include "../src/market/ExpiryManager.hpp"
+#include "../src/analysis/CombinationAnalyzer.hpp"
+#include "../src/analysis/MarketDepthAnalyzer.hpp"
+#include "../src/risk/RiskCalculator.hpp"
+#include "../src/risk/FeeCalculator.hpp"
+#include "../src/trading/OrderManager.hpp"
+
+using namespace BoxStrategy;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct HarnessOptions {
+    int cycles = 5;
+    std::vector<std::string> underlyings = {"NIFTY"};
+    bool placeOrders = false;
+    std::string url;
+    std::string configFile;
+    std::vector<std::pair<std::string, std::string>> overrides;
+    size_t httpRequests = 0;
+    size_t concurrency = 8;
+    bool asyncRequests = false;
+    bool verbose = false;
+    MockKiteOptions mock;
+};
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program
+              << " [--cycles N] [--underlyings A,B] [--strikes N] [--expiries N] [--latency SPEC]\n"
+                 "       [--endpoint-latency GROUP=SPEC] [--rate-limit GROUP=PER_SEC] [--orders] [--url URL]\n"
+                 "       [--config FILE] [--set KEY=VALUE] [--http-requests N] [--concurrency N] [--async]\n"
+                 "       [--verbose]\n"
+                 "Latency SPEC: fixed:MS | uniform:MIN:MAX | lognormal:MEDIAN:SIGMA\n";
+}
+
+bool splitAssignment(const std::string& text, std::string& name, std::string& value) {
+    size_t equals = text.find('=');
+    if (equals == std::string::npos || equals == 0) {
+        return false;
+    }
+
+    name = text.substr(0, equals);
+    value = text.substr(equals + 1);
+    return true;
+}
+
+std::vector<std::string> splitList(const std::string& text) {
+    std::vector<std::string> items;
+    size_t start = 0;
+    while (start <= text.size()) {
+        size_t end = std::min(text.find(',', start), text.size());
+        if (end > start) {
+            items.push_back(text.substr(start, end - start));
+        }
+        start = end + 1;
+    }
+    return items;
+}
+
+/**
+ * @brief Nearest-rank percentile of sorted samples
+ */
+double percentile(const std::vector<double>& sorted, double fraction) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+
+    size_t rank = static_cast<size_t>(std::ceil(fraction * static_cast<double>(sorted.size())));
+    return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+}
+
+std::string describeConnections(const HttpClientStats& stats) {
+    return fmt::format("{} requests, {} on kept-alive connections, {} new ({:.2f} ms connect, {:.2f} ms TLS), "
+                       "{:.2f} ms average to first byte",
+                       stats.requests, stats.reused, stats.requests - stats.reused, stats.averageConnectMs,
+                       stats.averageTlsMs, stats.averageFirstByteMs);
+}
+
+std::string describeLatencies(std::vector<double> samples) {
+    std::sort(samples.begin(), samples.end());
+    return fmt::format("p50 {:.1f} ms, p90 {:.1f} ms, p99 {:.1f} ms, p99.9 {:.1f} ms, max {:.1f} ms",
+                       percentile(samples, 0.5), percentile(samples, 0.9), percentile(samples, 0.99),
+                       percentile(samples, 0.999), samples.empty() ? 0.0 : samples.back());
+}
+
+double millisecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+/**
+ * @brief Apply a --set override, guessing the value's type
+ */
+void applyOverride(ConfigManager& config, const std::string& key, const std::string& value) {
+    if (value == "true" || value == "false") {
+        config.setBoolValue(key, value == "true");
+        return;
+    }
+
+    try {
+        size_t used = 0;
+        int integer = std::stoi(value, &used);
+        if (used == value.size()) {
+            config.setIntValue(key, integer);
+            return;
+        }
+
+        double number = std::stod(value, &used);
+        if (used == value.size()) {
+            config.setDoubleValue(key, number);
+            return;
+        }
+    } catch (const std::exception&) {
+    }
+
+    config.setStringValue(key, value);
+}
+
+/**
+ * @brief Settings that make a scan as fast as the API allows
+ */
+void applyDefaults(ConfigManager& config, const HarnessOptions& options,
+                   const std::string& baseUrl, const std::filesystem::path& workDir) {
+    config.setStringValue("api/base_url", baseUrl);
+    config.setStringValue("api/key", "harness_key");
+    config.setStringValue("api/secret", "harness_secret");
+    config.setStringValue("api/instruments_cache_file", (workDir / "instruments.csv").string());
+    config.setBoolValue("api/instruments_background_refresh", false);
+
+    // The client paces itself at the mock's limits, so no request should see a 429
+    auto limitPerMinute = [&](const std::string& group) {
+        auto it = options.mock.rateLimits.find(group);
+        double perSecond = it != options.mock.rateLimits.end() ? it->second : options.mock.defaultRateLimit;
+        return perSecond > 0.0 ? static_cast<int>(perSecond * 60.0) : 60000;
+    };
+    config.setIntValue("api/rate_limits/quote", limitPerMinute("/quote"));
+    config.setIntValue("api/rate_limits/ltp", limitPerMinute("/quote/ltp"));
+    config.setIntValue("api/rate_limits/ohlc", limitPerMinute("/quote/ohlc"));
+    config.setIntValue("api/rate_limits/instruments", limitPerMinute("/instruments"));
+    config.setIntValue("api/rate_limits/default", limitPerMinute("/orders"));
+
+    config.setStringValue("strategy/exchange", "NFO");
+    config.setIntValue("strategy/quantity", 1);
+    config.setBoolValue("strategy/paper_trading", !options.placeOrders);
+    config.setIntValue("expiry/max_count", options.mock.expiries);
+    config.setIntValue("expiry/max_days", 7 * options.mock.expiries + 7);
+}
+
+/**
+ * @brief Keep up to --concurrency raw /quote requests in flight from one thread
+ *
+ * Each completion callback records its request and sends the next one.
+ */
+void sendAsyncRequests(const HarnessOptions& options, const std::string& baseUrl, HttpClient& httpClient,
+                       const std::unordered_map<std::string, std::string>& headers,
+                       const std::vector<uint64_t>& tokens,
+                       std::vector<double>& latencies, std::map<int, size_t>& statuses) {
+    std::mutex mutex;
+    std::condition_variable done;
+    std::atomic<size_t> next{0};
+    size_t completed = 0;
+
+    std::function<void()> sendNext = [&]() {
+        size_t i = next++;
+        if (i >= options.httpRequests) {
+            return;
+        }
+
+        std::string url = baseUrl + "/quote?i=" + std::to_string(tokens[i % tokens.size()]);
+        auto sent = Clock::now();
+        httpClient.requestAsync(HttpMethod::GET, url, headers, "", [&, sent](HttpResponse response) {
+            double latency = millisecondsSince(sent);
+            sendNext();
+
+            // Nothing here may be touched once the last completion is counted
+            std::lock_guard<std::mutex> lock(mutex);
+            latencies.push_back(latency);
+            statuses[response.statusCode]++;
+            if (++completed == options.httpRequests) {
+                done.notify_all();
+            }
+        });
+    };
+
+    for (size_t w = 0; w < options.concurrency; ++w) {
+        sendNext();
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [&]() { return completed == options.httpRequests; });
+}
+
+/**
+ * @brief Fire raw /quote requests from several threads and report client-side latency
+ */
+void runHttpLoad(const HarnessOptions& options, const std::string& baseUrl,
+                 const std::shared_ptr<Logger>& logger, const std::vector<uint64_t>& tokens) {
+    auto httpClient = std::make_shared<HttpClient>(logger);
+    std::unordered_map<std::string, std::string> headers = {
+        {"X-Kite-Version", "3"},
+        {"Authorization", "token harness_key:harness"}
+    };
+
+    std::atomic<size_t> next{0};
+    std::vector<std::vector<double>> latencies(options.concurrency);
+    std::vector<std::map<int, size_t>> statuses(options.concurrency);
+    std::vector<std::thread> workers;
+
+    auto start = Clock::now();
+    if (options.asyncRequests) {
+        sendAsyncRequests(options, baseUrl, *httpClient, headers, tokens, latencies[0], statuses[0]);
+    }
+    for (size_t w = 0; w < options.concurrency && !options.asyncRequests; ++w) {
+        workers.emplace_back([&, w]() {
+            for (size_t i = next++; i < options.httpRequests; i = next++) {
+                std::string url = baseUrl + "/quote?i=" + std::to_string(tokens[i % tokens.size()]);
+
+                auto sent = Clock::now();
+                HttpResponse response = httpClient->request(HttpMethod::GET, url, headers);
+                latencies[w].push_back(millisecondsSince(sent));
+                statuses[w][response.statusCode]++;
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    double seconds = millisecondsSince(start) / 1000.0;
+
+    std::vector<double> all;
+    std::map<int, size_t> statusCounts;
+    for (size_t w = 0; w < options.concurrency; ++w) {
+        all.insert(all.end(), latencies[w].begin(), latencies[w].end());
+        for (const auto& [status, count] : statuses[w]) {
+            statusCounts[status] += count;
+        }
+    }
+
+    std::cout << fmt::format("HTTP: {} requests, {} {} in {:.2f} s, {:.0f} requests/sec\n",
+                             all.size(), options.concurrency,
+                             options.asyncRequests ? "in flight from one thread" : "threads",
+                             seconds, all.size() / seconds);
+    std::cout << "HTTP latency: " << describeLatencies(all) << "\n";
+    std::cout << "HTTP connections: " << describeConnections(httpClient->getStats()) << "\n";
+    for (const auto& [status, count] : statusCounts) {
+        std::cout << fmt::format("HTTP status {}: {}\n", status, count);
+    }
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    HarnessOptions options;
+    options.mock.port = 0;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            std::string name;
+            std::string value;
+
+            if (arg == "--cycles" && hasValue) {
+                options.cycles = std::max(1, std::stoi(argv[++i]));
+            } else if (arg == "--underlyings" && hasValue) {
+                options.underlyings = splitList(argv[++i]);
+            } else if (arg == "--strikes" && hasValue) {
+                options.mock.strikesPerExpiry = std::stoi(argv[++i]);
+            } else if (arg == "--expiries" && hasValue) {
+                options.mock.expiries = std::stoi(argv[++i]);
+            } else if (arg == "--latency" && hasValue) {
+                if (!LatencyDistribution::parse(argv[++i], options.mock.latency)) {
+                    printUsage(argv[0]);
+                    return 1;
+                }
+            } else if (arg == "--endpoint-latency" && hasValue && splitAssignment(argv[++i], name, value)) {
+                if (!LatencyDistribution::parse(value, options.mock.endpointLatency[name])) {
+                    printUsage(argv[0]);
+                    return 1;
+                }
+            } else if (arg == "--rate-limit" && hasValue && splitAssignment(argv[++i], name, value)) {
+                options.mock.rateLimits[name] = std::stod(value);
+            } else if (arg == "--orders") {
+                options.placeOrders = true;
+            } else if (arg == "--url" && hasValue) {
+                options.url = argv[++i];
+            } else if (arg == "--config" && hasValue) {
+                options.configFile = argv[++i];
+            } else if (arg == "--set" && hasValue && splitAssignment(argv[++i], name, value)) {
+                options.overrides.emplace_back(name, value);
+            } else if (arg == "--http-requests" && hasValue) {
+                options.httpRequests = std::stoul(argv[++i]);
+            } else if (arg == "--concurrency" && hasValue) {
+                options.concurrency = std::max(1, std::stoi(argv[++i]));
+            } else if (arg == "--async") {
+                options.asyncRequests = true;
+            } else if (arg == "--verbose") {
+                options.verbose = true;
+            } else {
+                printUsage(argv[0]);
+                return 1;
+            }
+        }
+    } catch (const std::exception&) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    // Start the mock unless an external server was given
+    std::unique_ptr<MockKiteServer> server;
+    std::string baseUrl = options.url;
+
+    if (baseUrl.empty()) {
+        server = std::make_unique<MockKiteServer>(options.mock);
+
+        std::string error;
+        if (!server->start(error)) {
+            std::cerr << "Failed to start mock API server: " << error << std::endl;
+            return 1;
+        }
+
+        baseUrl = server->baseUrl();
+        std::cout << fmt::format("Mock API at {}: {} instruments, latency {}\n",
+                                 baseUrl, server->instrumentCount(), options.mock.latency.toString());
+    }
+
+    // Caches and the saved login go to a scratch directory, never to the working tree
+    std::filesystem::path workDir = std::filesystem::temp_directory_path() /
+                                    fmt::format("scan_harness_{}", ::getpid());
+    std::filesystem::create_directories(workDir);
+    std::filesystem::path configPath = workDir / "config.json";
+
+    auto logger = std::make_shared<Logger>((workDir / "scan_harness.log").string(), options.verbose,
+                                           options.verbose ? LogLevel::INFO : LogLevel::WARN);
+
+    if (!options.configFile.empty()) {
+        std::filesystem::copy_file(options.configFile, configPath);
+    }
+
+    auto configManager = std::make_shared<ConfigManager>(configPath.string(), logger);
+    if (!options.configFile.empty() && !configManager->loadConfig()) {
+        std::cerr << "Failed to load " << options.configFile << std::endl;
+        return 1;
+    }
+
+    applyDefaults(*configManager, options, baseUrl, workDir);
+    for (const auto& [key, value] : options.overrides) {
+        applyOverride(*configManager, key, value);
+    }
+
+    // The topology comes first so that the HTTP I/O loop starts on the I/O CPUs
+    TopologyOptions topologyOptions = TopologyOptions::fromConfig(*configManager);
+    ThreadTopology topology(topologyOptions, logger);
+
+    auto httpClient = std::make_shared<HttpClient>(logger, topology.getIoCpus());
+    httpClient->setMaxIdleConnections(configManager->getIntValue("api/connection_pool_size", 32));
+    auto authManager = std::make_shared<AuthManager>(configManager, httpClient, logger);
+
+    auto loginStart = Clock::now();
+    if (!authManager->generateAccessToken("harness")) {
+        std::cerr << "Login against " << baseUrl << " failed, see " << (workDir / "scan_harness.log") << std::endl;
+        return 1;
+    }
+    std::cout << fmt::format("Login: {:.1f} ms\n", millisecondsSince(loginStart));
+
+    int prewarmConnections = configManager->getIntValue("api/prewarm_connections", 4);
+    if (prewarmConnections > 0) {
+        httpClient->prewarm(baseUrl + "/", prewarmConnections);
+    }
+
+    auto threadPool = std::make_shared<ThreadPool>(topologyOptions.numThreads, logger, topology.getWorkerPlacements());
+    size_t scanThreads = topologyOptions.numScanThreads;
+    if (scanThreads == 0) {
+        bool parallelExpiries = configManager->getBoolValue("expiry/process_in_parallel", false);
+        scanThreads = options.underlyings.size() * (parallelExpiries ?
+            static_cast<size_t>(std::max(1, configManager->getIntValue("expiry/max_count", 3))) : 1);
+    }
+    auto scanThreadPool = std::make_shared<ThreadPool>(scanThreads, logger);
+    auto marketDataManager = std::make_shared<MarketDataManager>(authManager, httpClient, logger, configManager);
+    marketDataManager->setThreadPool(threadPool);
+    marketDataManager->setIoCpus(topology.getIoCpus());
+    auto expiryManager = std::make_shared<ExpiryManager>(configManager, marketDataManager, logger);
+    auto feeCalculator = std::make_shared<FeeCalculator>(configManager, logger);
+    auto riskCalculator = std::make_shared<RiskCalculator>(configManager, logger);
+    auto marketDepthAnalyzer = std::make_shared<MarketDepthAnalyzer>(configManager, marketDataManager, logger);
+    auto combinationAnalyzer = std::make_shared<CombinationAnalyzer>(
+        configManager, marketDataManager, expiryManager, feeCalculator, riskCalculator, threadPool, logger);
+    combinationAnalyzer->setScanThreadPool(scanThreadPool);
+    auto orderManager = std::make_shared<OrderManager>(configManager, authManager, httpClient, logger);
+
+    auto loadStart = Clock::now();
+    auto universe = marketDataManager->getInstrumentUniverse();
+    std::cout << fmt::format("Instrument load: {} instruments in {:.1f} ms\n",
+                             universe->size(), millisecondsSince(loadStart));
+
+    if (universe->size() == 0) {
+        std::cerr << "No instruments loaded, see " << (workDir / "scan_harness.log") << std::endl;
+        return 1;
+    }
+
+    // Scan cycles
+    uint64_t quantity = static_cast<uint64_t>(configManager->getIntValue("strategy/quantity", 1));
+    std::vector<double> scanLatencies;
+    std::vector<double> orderLatencies;
+    size_t spreadsFound = 0;
+    size_t liquidSpreads = 0;
+    size_t ordersPlaced = 0;
+
+    auto cyclesStart = Clock::now();
+    for (int cycle = 0; cycle < options.cycles; ++cycle) {
+        auto cycleStart = Clock::now();
+
+        // Underlyings are scanned concurrently on the scan pool, as in the application
+        struct ScanResult {
+            std::vector<BoxSpreadModel> spreads;
+            size_t found = 0;
+            double latencyMs = 0.0;
+        };
+        std::vector<std::future<ScanResult>> scans;
+        for (const auto& underlying : options.underlyings) {
+            scans.push_back(scanThreadPool->enqueue([&, underlying]() {
+                auto scanStart = Clock::now();
+                ScanResult result;
+                result.spreads = combinationAnalyzer->findProfitableSpreads(underlying, "NFO");
+                result.found = result.spreads.size();
+                result.spreads = marketDepthAnalyzer->filterByLiquidity(result.spreads, quantity);
+                result.latencyMs = millisecondsSince(scanStart);
+                return result;
+            }));
+        }
+
+        for (auto& scan : scans) {
+            ScanResult result = scan.get();
+            auto& spreads = result.spreads;
+            spreadsFound += result.found;
+            liquidSpreads += spreads.size();
+            scanLatencies.push_back(result.latencyMs);
+
+            if (options.placeOrders && !spreads.empty()) {
+                auto orderStart = Clock::now();
+                if (orderManager->placeBoxSpreadOrder(spreads[0], quantity)) {
+                    ordersPlaced++;
+                }
+                orderLatencies.push_back(millisecondsSince(orderStart));
+            }
+        }
+
+        std::cout << fmt::format("Cycle {}: {:.1f} ms\n", cycle + 1, millisecondsSince(cycleStart));
+    }
+    double cycleSeconds = millisecondsSince(cyclesStart) / 1000.0;
+
+    std::cout << fmt::format("Scans: {} in {:.2f} s, {:.2f} scans/sec; {} spreads found, {} liquid\n",
+                             scanLatencies.size(), cycleSeconds, scanLatencies.size() / cycleSeconds,
+                             spreadsFound, liquidSpreads);
+    std::cout << "Scan latency: " << describeLatencies(scanLatencies) << "\n";
+
+    if (options.placeOrders) {
+        std::cout << fmt::format("Orders: {} box spreads placed\n", ordersPlaced);
+        std::cout << "Box spread placement latency: " << describeLatencies(orderLatencies) << "\n";
+    }
+
+    for (const auto& endpoint : marketDataManager->getApiUtilization()) {
+        if (endpoint.dispatched == 0) {
+            continue;
+        }
+        std::cout << fmt::format("Client {}: {} requests, limit {:.0f}/min, {:.0f}% of budget, "
+                                 "{:.1f} ms average scheduler wait, {} expired\n",
+                                 endpoint.endpoint, endpoint.dispatched, endpoint.requestsPerMinute,
+                                 endpoint.utilization * 100.0, endpoint.averageWaitMs, endpoint.expired);
+        for (const auto& [flow, dispatched] : endpoint.dispatchedByFlow) {
+            std::cout << fmt::format("Client {} for {}: {} requests\n", endpoint.endpoint, flow, dispatched);
+        }
+    }
+
+    std::cout << "Client connections: " << describeConnections(httpClient->getStats()) << "\n";
+
+    if (options.httpRequests > 0) {
+        std::vector<uint64_t> tokens;
+        for (const auto& instrument : universe->getInstruments()) {
+            tokens.push_back(instrument.instrumentToken);
+        }
+        runHttpLoad(options, baseUrl, logger, tokens);
+    }
+
+    if (server) {
+        for (const auto& stats : server->getStats()) {
+            std::cout << fmt::format("Server {}: {} requests, {} rate limited, {} errors, {:.1f} MB\n",
+                                     stats.endpoint, stats.requests, stats.rateLimited, stats.errors,
+                                     stats.bytesSent / (1024.0 * 1024.0));
+        }
+        std::cout << fmt::format("Server connections: {}\n", server->connectionsAccepted());
+        server->stop();
+    }
+
+    std::error_code ignored;
+    std::filesystem::remove_all(workDir, ignored);
+    return 0;
+}
@@ -0,0 +1,158 @@
+/**
+ * @file tick_bench.cpp
+ * @brief Throughput benchmark of tick decoding and the tick feed
+ *
+ * Usage: tick_bench [--instruments N] [--seconds S]
+ *
+ * Measures the codec on its own, then streams full-mode ticks for N
+ * synthetic options from an in-process stand-in server through a TickFeed
+ * into a quote store for S seconds.
+ */
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <chrono>
+#include <fmt/format.h>
+#include "TickStandInServer.hpp"
+#include "../src/market/TickCodec.hpp"
+#include "../src/market/TickFeed.hpp"
+#include "../src/market/QuoteStore.hpp"
+#include "../src/market/InstrumentUniverse.hpp"
+#include "../src/utils/Logger.hpp"
+
+using namespace BoxStrategy;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr uint64_t SEGMENT_NFO_OPT = 2;  ///< Low byte of NFO option tokens
+
+std::shared_ptr<const InstrumentUniverse> makeUniverse(size_t count) {
+    std::vector<InstrumentRef> instruments(count);
+
+    for (size_t i = 0; i < count; ++i) {
+        InstrumentRef& instrument = instruments[i];
+        double strike = 20000.0 + 50.0 * static_cast<double>(i / 2);
+        bool call = i % 2 == 0;
+
+        instrument.instrumentToken = (static_cast<uint64_t>(i + 1) << 8) | SEGMENT_NFO_OPT;
+        instrument.tradingSymbol = fmt::format("NIFTY{}{}", strike, call ? "CE" : "PE");
+        instrument.exchange = "NFO";
+        instrument.name = "NIFTY";
+        instrument.underlying = "NIFTY";
+        instrument.segment = "NFO-OPT";
+        instrument.type = InstrumentType::OPTION;
+        instrument.optionType = call ? OptionType::CALL : OptionType::PUT;
+        instrument.strikePrice = strike;
+        instrument.expiry = ExpiryDay::fromDate(2030, 1, 31);
+    }
+
+    return std::make_shared<const InstrumentUniverse>(std::move(instruments), 1);
+}
+
+void benchmarkCodec(const InstrumentUniverse& universe) {
+    std::vector<Tick> ticks;
+    for (const auto& instrument : universe.getInstruments()) {
+        Tick tick;
+        tick.instrumentToken = instrument.instrumentToken;
+        tick.mode = TickMode::FULL;
+        tick.quote.lastPrice = 101.25;
+        for (size_t level = 0; level < DepthLadder::CAPACITY; ++level) {
+            tick.quote.buyDepth.push_back({101.0 - 0.05 * level, 75, 3});
+            tick.quote.sellDepth.push_back({101.5 + 0.05 * level, 75, 3});
+        }
+        ticks.push_back(tick);
+    }
+
+    std::vector<uint8_t> message;
+    TickCodec::encodeMessage(ticks, message);
+
+    const size_t iterations = std::max<size_t>(1, 2000000 / ticks.size());
+    std::vector<Tick> decoded;
+    decoded.reserve(ticks.size());
+
+    auto start = Clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        decoded.clear();
+        TickCodec::decodeMessage(message.data(), message.size(), decoded);
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    double packets = static_cast<double>(iterations * ticks.size());
+    std::cout << fmt::format("Codec: {} full packets per message, {:.1f} ns/packet, {:.0f} MB/s\n",
+                             ticks.size(), seconds * 1e9 / packets,
+                             static_cast<double>(iterations * message.size()) / seconds / 1e6);
+}
+
+bool benchmarkFeed(const std::shared_ptr<const InstrumentUniverse>& universe, int durationSeconds) {
+    TickServerOptions options;
+    options.port = 0;
+    options.messagesPerSecond = 0.0;
+
+    TickStandInServer server(options);
+    std::string error;
+    if (!server.start(error)) {
+        std::cerr << "Failed to start stand-in server: " << error << std::endl;
+        return false;
+    }
+
+    auto logger = std::make_shared<Logger>("tick_bench.log", false, LogLevel::WARN);
+    auto store = std::make_shared<QuoteStore>(universe);
+
+    TickFeed feed(logger, [store]() { return store; }, "127.0.0.1", server.port(), std::chrono::milliseconds(100));
+
+    std::vector<uint64_t> tokens;
+    for (const auto& instrument : universe->getInstruments()) {
+        tokens.push_back(instrument.instrumentToken);
+    }
+    feed.subscribe(tokens, TickMode::FULL);
+    feed.start();
+
+    auto start = Clock::now();
+    std::this_thread::sleep_for(std::chrono::seconds(durationSeconds));
+    TickFeedStats stats = feed.getStats();
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    feed.stop();
+    server.stop();
+
+    size_t quoted = 0;
+    for (uint32_t ordinal = 0; ordinal < store->size(); ++ordinal) {
+        quoted += store->hasQuote(ordinal) ? 1 : 0;
+    }
+
+    std::cout << fmt::format("Feed: {:.0f} messages/sec, {:.0f} ticks/sec applied, {}/{} instruments quoted, "
+                             "{} decode errors\n",
+                             stats.messages / seconds, stats.applied / seconds, quoted, store->size(),
+                             stats.decodeErrors);
+    return stats.decodeErrors == 0 && quoted == store->size();
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    size_t instrumentCount = 400;
+    int durationSeconds = 5;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--instruments" && i + 1 < argc) {
+            instrumentCount = std::clamp(std::stoi(argv[++i]), 1, 3000);  // Ticker subscription limit
+        } else if (arg == "--seconds" && i + 1 < argc) {
+            durationSeconds = std::max(1, std::stoi(argv[++i]));
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--instruments N] [--seconds S]\n";
+            return 1;
+        }
+    }
+
+    auto universe = makeUniverse(instrumentCount);
+
+    benchmarkCodec(*universe);
+    return benchmarkFeed(universe, durationSeconds) ? 0 : 1;
+}
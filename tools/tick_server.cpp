@@ -0,0 +1,87 @@
+/**
+ * @file tick_server.cpp
+ * @brief Stand-in ticker server for running the tick feed without the live service
+ *
+ * Usage: tick_server [--host ADDR] [--port N] [--rate MSGS_PER_SEC]
+ *                    [--replay FILE] [--record FILE]
+ *
+ * Point the application at it with ticker/enabled = true and matching
+ * ticker/host and ticker/port settings.
+ */
+
+#include <iostream>
+#include <string>
+#include <thread>
+#include <chrono>
+#include <csignal>
+#include <atomic>
+#include "TickStandInServer.hpp"
+
+using namespace BoxStrategy;
+
+namespace {
+
+std::atomic<bool> g_running{true};
+
+void signalHandler(int) {
+    g_running = false;
+}
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program
+              << " [--host ADDR] [--port N] [--rate MSGS_PER_SEC] [--replay FILE] [--record FILE]\n";
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    TickServerOptions options;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--host" && hasValue) {
+            options.host = argv[++i];
+        } else if (arg == "--port" && hasValue) {
+            options.port = static_cast<uint16_t>(std::stoi(argv[++i]));
+        } else if (arg == "--rate" && hasValue) {
+            options.messagesPerSecond = std::stod(argv[++i]);
+        } else if (arg == "--replay" && hasValue) {
+            options.replayFile = argv[++i];
+        } else if (arg == "--record" && hasValue) {
+            options.recordFile = argv[++i];
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    std::signal(SIGINT, signalHandler);
+    std::signal(SIGTERM, signalHandler);
+
+    TickStandInServer server(options);
+
+    std::string error;
+    if (!server.start(error)) {
+        std::cerr << "Failed to start tick server: " << error << std::endl;
+        return 1;
+    }
+
+    std::cout << "Tick server listening on " << options.host << ":" << server.port()
+              << (options.replayFile.empty() ? " (synthetic ticks)" : " (replaying " + options.replayFile + ")")
+              << std::endl;
+
+    uint64_t lastTicks = 0;
+    while (g_running.load()) {
+        std::this_thread::sleep_for(std::chrono::seconds(5));
+
+        uint64_t ticks = server.ticksSent();
+        std::cout << "Sent " << server.messagesSent() << " messages, "
+                  << (ticks - lastTicks) / 5 << " ticks/sec" << std::endl;
+        lastTicks = ticks;
+    }
+
+    server.stop();
+    return 0;
+}